@@ -45,6 +45,12 @@ static unsigned int commit_obj_dep_state = 0;
 /* State of incr_obj instance */
 static two_props_data incr_obj_state = {0, 0};
 
+/* Number of get requests of get_count instance */
+static unsigned int get_count = 0;
+
+/* Number of messages logged by the last set of log_burst instance */
+static unsigned int log_burst = 0;
+
 static te_errno
 commit_obj_prop_get(unsigned int gid, const char *oid, char *value,
                     bool first)
@@ -247,6 +253,63 @@ commit_obj_dep_set(unsigned int gid, const char *oid, const char *value)
     return 0;
 }
 
+static te_errno
+get_count_get(unsigned int gid, const char *oid, char *value)
+{
+    te_string value_str = TE_STRING_EXT_BUF_INIT(value, RCF_MAX_VAL);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    te_string_append(&value_str, "%u", ++get_count);
+    return 0;
+}
+
+static te_errno
+log_burst_get(unsigned int gid, const char *oid, char *value)
+{
+    te_string value_str = TE_STRING_EXT_BUF_INIT(value, RCF_MAX_VAL);
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    te_string_append(&value_str, "%u", log_burst);
+    return 0;
+}
+
+static te_errno
+log_burst_set(unsigned int gid, const char *oid, const char *value)
+{
+    unsigned int value_uint;
+    unsigned int i;
+    te_errno rc;
+
+    UNUSED(gid);
+    UNUSED(oid);
+
+    rc = te_strtoui(value, 10, &value_uint);
+    if (rc != 0)
+        return TE_RC_UPSTREAM(TE_TA_UNIX, rc);
+
+    for (i = 0; i < value_uint; i++)
+        RING("Log burst message %u of %u", i + 1, value_uint);
+
+    log_burst = value_uint;
+    return 0;
+}
+
+static rcf_pch_cfg_object node_log_burst = {
+    .sub_id = "log_burst",
+    .get = (rcf_ch_cfg_get)log_burst_get,
+    .set = (rcf_ch_cfg_set)log_burst_set,
+};
+
+static rcf_pch_cfg_object node_get_count = {
+    .sub_id = "get_count",
+    .brother = &node_log_burst,
+    .get = (rcf_ch_cfg_get)get_count_get,
+};
+
 static rcf_pch_cfg_object node_incr_obj_a = {
     .sub_id = "a",
     .get = (rcf_ch_cfg_get)incr_obj_prop_a_get,
@@ -263,6 +326,7 @@ static rcf_pch_cfg_object node_incr_obj_b = {
 static rcf_pch_cfg_object node_incr_obj = {
     .sub_id = "incr_obj",
     .son = &node_incr_obj_b,
+    .brother = &node_get_count,
 };
 
 static rcf_pch_cfg_object node_commit_obj_dep = {
@@ -304,5 +368,15 @@ static rcf_pch_cfg_object node_selftest = {
 extern te_errno
 ta_unix_conf_selftest_init(void)
 {
-    return rcf_pch_add_node("/agent", &node_selftest);
+    te_errno rc;
+
+    rc = rcf_pch_add_node("/agent", &node_selftest);
+    if (rc != 0)
+        return rc;
+
+    /*
+     * All changes are requested by Configurator except get_count
+     * which shows whether the subtree is synchronised.
+     */
+    return rcf_pch_cfg_track_changes("/agent/selftest");
 }
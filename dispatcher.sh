@@ -324,6 +324,9 @@ Generic options:
   --cs-print-trees              Print configurator trees.
   --cs-log-diff                 Log backup diff unconditionally.
 
+  --rcf-start-parallel=<num>    Maximum number of Test Agents started or
+                                finished concurrently (8 by default).
+
   --builder-debug               Be more verbose when build.
 
   --build-from-scratch          Build everything from scratch.
@@ -436,10 +439,17 @@ Generic options:
                                 Test Agents (useful for Logger debugging).
   --logger-check                Check that log messages received from other TE components are
                                 properly formatted before storing them in the raw log file.
+  --logger-compress             Write the raw log compressed by gzip in segments which may be
+                                decompressed independently (requires Logger built with zlib).
   --logger-listener=<confstr>   Enable streaming live results to the specified listener.
                                 Config string has the following format: <name>[:<runid>].
   --logger-meta-file=<path>     Send meta information to listeners. This option may only be specified
                                 once.
+  --logger-listener-queue-size=<size>
+                                Maximum amount of not yet processed messages
+                                kept for listeners (64M by default; may be
+                                specified in units of K, M, G). Non-Tester
+                                messages are dropped when it is exceeded.
   --logger-max-size=<size>      Maximum size of RAW log (4Gb by default;
                                 negative for unlimited; may be specified in
                                 units of G[igabytes]).
@@ -838,6 +848,8 @@ process_opts()
 
             --cs-*) CS_OPTS="${CS_OPTS} --${1#--cs-}" ;;
 
+            --rcf-*) RCF_OPTS="${RCF_OPTS} --${1#--rcf-}" ;;
+
             --builder-debug)    BUILDER_DEBUG=yes ;;
 
             --build-from-scratch)   BUILDER_FROM_SCRATCH=yes ;;
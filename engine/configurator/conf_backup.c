@@ -271,18 +271,67 @@ free_instances(cfg_instance *list)
     }
 }
 
+/**
+ * Check that oid belongs to the subtree: it is the subtree root itself
+ * or its descendant, so that "/agent:A/interface:eth1" does not contain
+ * "/agent:A/interface:eth10".
+ *
+ * @param subtree  Subtree root OID.
+ * @param oid      Instance oid to check.
+ *
+ * @return @c true if oid belongs to the subtree
+ */
+static bool
+check_oid_in_subtree(const char *subtree, const char *oid)
+{
+    size_t len = strlen(subtree);
+
+    if (strncmp(oid, subtree, len) != 0)
+        return false;
+
+    return len == 0 || subtree[len - 1] == '/' ||
+           oid[len] == '\0' || oid[len] == '/';
+}
+
+/**
+ * Check that oid belongs to subtree from vector of the subtrees
+ *
+ * @param subtrees Vector of the subtrees.
+ * @param oid      Instance oid to check.
+ *
+ * @return @c true if oid belongs to subtree
+ */
+static bool
+check_oid_contains_subtrees(const te_vec *subtrees, const char *oid)
+{
+    char * const *subtree;
+
+    if (subtrees == NULL || te_vec_size(subtrees) == 0)
+        return check_oid_in_subtree("/", oid);
+
+    TE_VEC_FOREACH(subtrees, subtree)
+    {
+        if (check_oid_in_subtree(*subtree, oid))
+            return true;
+    }
+
+    return false;
+}
+
 /**
  * Parse instance nodes of the configuration file to list of instances.
  *
  * @param node        First instance node
+ * @param subtrees    Vector of the subtrees which instances are parsed.
+ *                    May be @c NULL for the root.
  * @param list        Location for instance list pointer
  * @param list_size   Where to save number of instances in the list
  *
  * @return Status code (see te_errno.h).
  */
 static int
-parse_instances(xmlNodePtr node, cfg_instance **list,
-                unsigned int *list_size)
+parse_instances(xmlNodePtr node, const te_vec *subtrees,
+                cfg_instance **list, unsigned int *list_size)
 {
     cfg_instance *prev = NULL;
     xmlNodePtr    cur = node;
@@ -331,6 +380,12 @@ parse_instances(xmlNodePtr node, cfg_instance **list,
                            "instance %s", cur->name);
         }
 
+        if (!check_oid_contains_subtrees(subtrees, (char *)oid))
+        {
+            xmlFree(oid);
+            continue;
+        }
+
         if ((tmp = (cfg_instance *)calloc(sizeof(*tmp), 1)) == NULL)
             RETERR(TE_ENOMEM, "No enough memory");
 
@@ -439,36 +494,6 @@ topo_qsort_predicate(const void *arg1, const void *arg2)
            cfg_all_inst[idx1]->obj->ordinal_number;
 }
 
-/**
- * Check that oid belongs to subtree from vector of the subtrees
- *
- * @param subtrees Vector of the subtrees.
- * @param oid      Instance oid to check.
- *
- * @return @c true if oid belongs to subtree
- */
-static bool
-check_oid_contains_subtrees(const te_vec *subtrees, const char *oid)
-{
-    char * const *subtree;
-
-    if (subtrees == NULL || te_vec_size(subtrees) == 0)
-    {
-        if (strcmp_start("/", oid) == 0)
-            return true;
-        else
-            return false;
-    }
-
-    TE_VEC_FOREACH(subtrees, subtree)
-    {
-        if (strcmp_start(*subtree, oid) == 0)
-            return true;
-    }
-
-    return false;
-}
-
 /**
  * Delete all instances from CS not mentioned in the configuration file
  *
@@ -1109,7 +1134,7 @@ cfg_backup_process_file(xmlNodePtr node, bool restore,
     if ((rc = register_objects(&cur, !restore)) != 0)
         return rc;
 
-    if ((rc = parse_instances(cur, &list, &list_size)) != 0)
+    if ((rc = parse_instances(cur, subtrees, &list, &list_size)) != 0)
         return rc;
 
     if (!restore)
@@ -1157,7 +1182,7 @@ cfg_backup_restore_ta(char *ta)
     {
         cfg_instance *inst = cfg_all_inst[i];
 
-        if (inst == NULL || strncmp(inst->oid, buf, strlen(buf)) != 0)
+        if (inst == NULL || !check_oid_in_subtree(buf, inst->oid))
         {
             continue;
         }
@@ -1366,32 +1391,467 @@ cfg_backup_create_file(const char *filename, const te_vec *subtrees)
     return 0;
 }
 
+/* See description in conf_backup.h */
 te_errno
-cfg_backup_create_filter_file(const char *filename, const te_vec *subtrees)
+cfg_backup_filter_file(const char *filename, const te_vec *subtrees,
+                       const char *target)
 {
-    FILE *f;
-    char * const *subtree;
+    xmlDocPtr  doc;
+    xmlNodePtr root;
+    xmlNodePtr cur;
+    xmlNodePtr next;
+    te_errno   rc = 0;
 
-    f = fopen(filename, "w");
-    if (f == NULL)
+    if ((doc = xmlParseFile(filename)) == NULL)
     {
-        ERROR("Failed to open '%s': %s", filename, strerror(errno));
-        return te_rc_os2te(errno);
+        ERROR("Failed to parse backup file '%s'", filename);
+        return TE_RC(TE_CS, TE_EINVAL);
     }
 
-    fprintf(f, "<?xml version=\"1.0\"?>\n");
-    fprintf(f, "<filters>\n");
+    root = xmlDocGetRootElement(doc);
+    if (root == NULL ||
+        xmlStrcmp(root->name, (const xmlChar *)"backup") != 0)
+    {
+        ERROR("File '%s' is not a backup", filename);
+        xmlFreeDoc(doc);
+        return TE_RC(TE_CS, TE_EINVAL);
+    }
 
-    TE_VEC_FOREACH(subtrees, subtree)
+    for (cur = root->children; cur != NULL; cur = next)
     {
-        fprintf(f, "<subtree>%s</subtree>\n", *subtree);
+        xmlChar *oid;
+        bool     keep;
+
+        next = cur->next;
+        if (xmlStrcmp(cur->name, (const xmlChar *)"instance") != 0)
+            continue;
+
+        oid = xmlGetProp(cur, (const xmlChar *)"oid");
+        keep = oid != NULL &&
+               check_oid_contains_subtrees(subtrees, (char *)oid);
+        xmlFree(oid);
+        if (keep)
+            continue;
+
+        /* Margin before the instance goes away with it */
+        if (cur->prev != NULL && xmlNodeIsText(cur->prev))
+        {
+            xmlNodePtr margin = cur->prev;
+
+            xmlUnlinkNode(margin);
+            xmlFreeNode(margin);
+        }
+        xmlUnlinkNode(cur);
+        xmlFreeNode(cur);
+    }
+
+    if (xmlSaveFile(target, doc) < 0)
+    {
+        ERROR("Failed to save filtered backup to '%s'", target);
+        rc = TE_RC(TE_CS, TE_EIO);
+    }
+
+    xmlFreeDoc(doc);
+    return rc;
+}
+
+/**
+ * Maximum number of in-memory backup snapshots. Snapshots are only
+ * a faster way to verify backups, so the oldest one is dropped when
+ * the limit is reached.
+ */
+#define CFG_BACKUP_SNAPSHOTS_MAX    16
+
+/** Object or instance in the snapshot */
+typedef struct cfg_backup_entry {
+    bool  inst;     /**< Is it an instance? */
+    char *oid;      /**< Object or instance identifier */
+    char *descr;    /**< Attributes of the object or value of
+                         the instance */
+} cfg_backup_entry;
+
+/** In-memory snapshot of the backup */
+typedef struct cfg_backup_snapshot {
+    TAILQ_ENTRY(cfg_backup_snapshot) links; /**< Links of the list */
+    char   *filename;   /**< Name of the backup file */
+    te_vec  entries;    /**< Entries sorted by identifier */
+} cfg_backup_snapshot;
+
+/** List of in-memory backup snapshots, the newest first */
+static TAILQ_HEAD(cfg_backup_snapshots, cfg_backup_snapshot)
+    cfg_backup_snapshots =
+    TAILQ_HEAD_INITIALIZER(cfg_backup_snapshots);
+
+/** Number of in-memory backup snapshots */
+static unsigned int cfg_backup_snapshots_num = 0;
+
+/* Destructor of snapshot entries */
+static void
+cfg_backup_entry_free(const void *item)
+{
+    const cfg_backup_entry *entry = item;
+
+    free(entry->oid);
+    free(entry->descr);
+}
+
+/* Comparison function for sorting snapshot entries */
+static int
+cfg_backup_entry_compare(const void *pa, const void *pb)
+{
+    return strcmp(((const cfg_backup_entry *)pa)->oid,
+                  ((const cfg_backup_entry *)pb)->oid);
+}
+
+/**
+ * Put description of the object and its (grand-...)children to
+ * the snapshot entries in the same way as put_object() does.
+ *
+ * @param entries   snapshot entries
+ * @param obj       object
+ */
+static void
+snapshot_object(te_vec *entries, cfg_object *obj)
+{
+    if (obj != &cfg_obj_root && !cfg_object_agent(obj))
+    {
+        te_string        descr = TE_STRING_INIT;
+        cfg_dependency  *dep;
+        cfg_backup_entry entry;
+
+        te_string_append(&descr, "access=\"%s\" type=\"%s\"",
+                         te_enum_map_from_value(cfg_cva_mapping,
+                                                obj->access),
+                         te_enum_map_from_value(cfg_cvt_mapping,
+                                                obj->type));
+        if (obj->def_val != NULL)
+            te_string_append(&descr, " default=\"%s\"", obj->def_val);
+        if (obj->unit)
+            te_string_append(&descr, " unit=\"true\"");
+        for (dep = obj->depends_on; dep != NULL; dep = dep->next)
+        {
+            te_string_append(&descr, " depends=\"%s:%s\"",
+                             dep->depends->oid,
+                             dep->object_wide ? "object" : "instance");
+        }
+
+        entry.inst = false;
+        entry.oid = TE_STRDUP(obj->oid);
+        te_string_move(&entry.descr, &descr);
+        TE_VEC_APPEND(entries, entry);
+    }
+    for (obj = obj->son; obj != NULL; obj = obj->brother)
+        snapshot_object(entries, obj);
+}
+
+/**
+ * Put the object instance and its (grand-...)children to the snapshot
+ * entries in the same way as put_instance() does.
+ *
+ * @param entries   snapshot entries
+ * @param inst      object instance
+ *
+ * @return Status code.
+ */
+static te_errno
+snapshot_instance(te_vec *entries, cfg_instance *inst)
+{
+    te_errno rc;
+
+    if (inst != &cfg_inst_root && !cfg_inst_agent(inst) &&
+        !cfg_instance_volatile(inst))
+    {
+        cfg_backup_entry entry;
+
+        entry.inst = true;
+        entry.descr = NULL;
+        if (inst->obj->type != CVT_NONE)
+        {
+            rc = cfg_types[inst->obj->type].val2str(inst->val,
+                                                    &entry.descr);
+            if (rc != 0)
+            {
+                ERROR("Conversion failed for instance %s type %d",
+                      inst->oid, inst->obj->type);
+                return rc;
+            }
+        }
+        entry.oid = TE_STRDUP(inst->oid);
+        TE_VEC_APPEND(entries, entry);
+    }
+    for (inst = inst->son; inst != NULL; inst = inst->brother)
+    {
+        rc = snapshot_instance(entries, inst);
+        if (rc != 0)
+            return rc;
     }
 
-    fprintf(f, "</filters>\n");
-    fclose(f);
     return 0;
 }
 
+/**
+ * Take snapshot of the current configuration with the same contents
+ * as cfg_backup_create_file() puts to the backup file.
+ *
+ * @param subtrees      Vector of the subtrees. @c NULL or empty vector
+ *                      for all the subtrees
+ * @param entries       Vector of entries to be filled in and sorted
+ *
+ * @return Status code.
+ */
+static te_errno
+snapshot_take(const te_vec *subtrees, te_vec *entries)
+{
+    te_errno rc = 0;
+
+    *entries = TE_VEC_INIT_DESTROY(cfg_backup_entry,
+                                   cfg_backup_entry_free);
+
+    snapshot_object(entries, &cfg_obj_root);
+
+    if (subtrees != NULL && te_vec_size(subtrees) != 0)
+    {
+        char * const *subtree;
+
+        TE_VEC_FOREACH(subtrees, subtree)
+        {
+            cfg_instance *inst = cfg_get_ins_by_ins_id_str(*subtree);
+
+            if (inst == NULL)
+            {
+                ERROR("Failed to find instance with OID %s", *subtree);
+                rc = TE_ENOENT;
+                break;
+            }
+
+            rc = snapshot_instance(entries, inst);
+            if (rc != 0)
+                break;
+        }
+    }
+    else
+    {
+        rc = snapshot_instance(entries, &cfg_inst_root);
+    }
+
+    if (rc != 0)
+    {
+        te_vec_free(entries);
+        return rc;
+    }
+
+    te_vec_sort(entries, cfg_backup_entry_compare);
+    return 0;
+}
+
+/**
+ * Find in-memory snapshot of the backup.
+ *
+ * @param filename      Name of the backup file
+ *
+ * @return Snapshot or @c NULL.
+ */
+static cfg_backup_snapshot *
+snapshot_find(const char *filename)
+{
+    cfg_backup_snapshot *snapshot;
+
+    TAILQ_FOREACH(snapshot, &cfg_backup_snapshots, links)
+    {
+        if (strcmp(snapshot->filename, filename) == 0)
+            return snapshot;
+    }
+
+    return NULL;
+}
+
+/**
+ * Remove in-memory snapshot from the list and free it.
+ *
+ * @param snapshot      Snapshot
+ */
+static void
+snapshot_free(cfg_backup_snapshot *snapshot)
+{
+    TAILQ_REMOVE(&cfg_backup_snapshots, snapshot, links);
+    cfg_backup_snapshots_num--;
+
+    te_vec_free(&snapshot->entries);
+    free(snapshot->filename);
+    free(snapshot);
+}
+
+/* See description in conf_backup.h */
+te_errno
+cfg_backup_snapshot_create(const char *filename, const te_vec *subtrees)
+{
+    cfg_backup_snapshot *snapshot;
+    te_vec               entries;
+    te_errno             rc;
+
+    rc = snapshot_take(subtrees, &entries);
+    if (rc != 0)
+        return rc;
+
+    cfg_backup_snapshot_release(filename);
+    if (cfg_backup_snapshots_num == CFG_BACKUP_SNAPSHOTS_MAX)
+        snapshot_free(TAILQ_LAST(&cfg_backup_snapshots, cfg_backup_snapshots));
+
+    snapshot = TE_ALLOC(sizeof(*snapshot));
+    snapshot->filename = TE_STRDUP(filename);
+    snapshot->entries = entries;
+
+    TAILQ_INSERT_HEAD(&cfg_backup_snapshots, snapshot, links);
+    cfg_backup_snapshots_num++;
+
+    return 0;
+}
+
+/* See description in conf_backup.h */
+void
+cfg_backup_snapshot_release(const char *filename)
+{
+    cfg_backup_snapshot *snapshot = snapshot_find(filename);
+
+    if (snapshot != NULL)
+        snapshot_free(snapshot);
+}
+
+/* See description in conf_backup.h */
+bool
+cfg_backup_snapshot_exists(const char *filename)
+{
+    return snapshot_find(filename) != NULL;
+}
+
+/**
+ * Check that snapshot entry should be compared.
+ *
+ * @param entry         Entry
+ * @param subtrees      Vector of the subtrees to compare. @c NULL or
+ *                      empty vector for all the subtrees
+ *
+ * @return @c true if the entry is an object or an instance of one of
+ *         the subtrees.
+ */
+static bool
+snapshot_entry_selected(const cfg_backup_entry *entry,
+                        const te_vec *subtrees)
+{
+    return !entry->inst || check_oid_contains_subtrees(subtrees, entry->oid);
+}
+
+/**
+ * Append description of the snapshot entry to the list of differences.
+ *
+ * @param diff      List of differences
+ * @param sign      @c '-' for the backup entry, @c '+' for the current one
+ * @param entry     Entry
+ */
+static void
+snapshot_diff_entry(te_string *diff, char sign,
+                    const cfg_backup_entry *entry)
+{
+    if (!entry->inst)
+    {
+        te_string_append(diff, "%c  <object oid=\"%s\" %s/>\n",
+                         sign, entry->oid, entry->descr);
+    }
+    else if (entry->descr == NULL)
+    {
+        te_string_append(diff, "%c  <instance oid=\"%s\"/>\n",
+                         sign, entry->oid);
+    }
+    else
+    {
+        te_string_append(diff, "%c  <instance oid=\"%s\" value=\"%s\"/>\n",
+                         sign, entry->oid, entry->descr);
+    }
+}
+
+/* See description in conf_backup.h */
+te_errno
+cfg_backup_snapshot_verify(const char *filename, const te_vec *subtrees,
+                           te_string *diff)
+{
+    cfg_backup_snapshot *snapshot = snapshot_find(filename);
+    te_vec               current;
+    size_t               n_backup;
+    size_t               n_current;
+    size_t               i = 0;
+    size_t               j = 0;
+    bool                 differs = false;
+    te_errno             rc;
+
+    if (snapshot == NULL)
+        return TE_ENOENT;
+
+    rc = snapshot_take(subtrees, &current);
+    if (rc != 0)
+        return rc;
+
+    n_backup = te_vec_size(&snapshot->entries);
+    n_current = te_vec_size(&current);
+
+    /* Both vectors are sorted by identifier, so merge them */
+    while (i < n_backup || j < n_current)
+    {
+        const cfg_backup_entry *bkp = NULL;
+        const cfg_backup_entry *cur = NULL;
+        int                     cmp;
+
+        if (i < n_backup)
+        {
+            bkp = te_vec_get(&snapshot->entries, i);
+            if (!snapshot_entry_selected(bkp, subtrees))
+            {
+                i++;
+                continue;
+            }
+        }
+        if (j < n_current)
+            cur = te_vec_get(&current, j);
+
+        if (bkp == NULL)
+            cmp = 1;
+        else if (cur == NULL)
+            cmp = -1;
+        else
+            cmp = strcmp(bkp->oid, cur->oid);
+
+        if (cmp < 0)
+        {
+            snapshot_diff_entry(diff, '-', bkp);
+            i++;
+        }
+        else if (cmp > 0)
+        {
+            snapshot_diff_entry(diff, '+', cur);
+            j++;
+        }
+        else
+        {
+            if (bkp->inst != cur->inst ||
+                (bkp->descr == NULL) != (cur->descr == NULL) ||
+                (bkp->descr != NULL &&
+                 strcmp(bkp->descr, cur->descr) != 0))
+            {
+                snapshot_diff_entry(diff, '-', bkp);
+                snapshot_diff_entry(diff, '+', cur);
+                differs = true;
+            }
+            i++;
+            j++;
+            continue;
+        }
+        differs = true;
+    }
+
+    te_vec_free(&current);
+
+    return differs ? TE_EBACKUP : 0;
+}
+
 static te_errno
 cfg_backup_wrapper(const char *filename, const te_vec *subtrees, uint8_t op)
 {
@@ -11,6 +11,7 @@
 #define __TE_CONF_BACKUP_H__
 
 #include "te_vector.h"
+#include "te_string.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,15 +54,63 @@ extern int cfg_backup_create_file(const char *filename,
                                   const te_vec *subtrees);
 
 /**
- * Create file XML file with subtrees to filter backup file
+ * Create backup file with instances of the subtrees only.
  *
- * @param filename Name of the filter file
+ * @param filename Name of the backup file
  * @param subtrees Vector of the subtrees
+ * @param target   Name of the file to be created
  *
  * @return Status code
  */
-extern te_errno cfg_backup_create_filter_file(const char *filename,
-                                              const te_vec *subtrees);
+extern te_errno cfg_backup_filter_file(const char *filename,
+                                       const te_vec *subtrees,
+                                       const char *target);
+
+/**
+ * Take in-memory snapshot of the current configuration with the same
+ * contents as the backup file created by cfg_backup_create_file().
+ *
+ * @param filename Name of the backup file
+ * @param subtrees Vector of the subtrees. @c NULL for all the subtrees
+ *
+ * @return Status code
+ */
+extern te_errno cfg_backup_snapshot_create(const char *filename,
+                                           const te_vec *subtrees);
+
+/**
+ * Release in-memory snapshot of the backup if it exists.
+ *
+ * @param filename Name of the backup file
+ */
+extern void cfg_backup_snapshot_release(const char *filename);
+
+/**
+ * Check whether in-memory snapshot of the backup exists.
+ *
+ * @param filename Name of the backup file
+ *
+ * @return @c true if the snapshot exists.
+ */
+extern bool cfg_backup_snapshot_exists(const char *filename);
+
+/**
+ * Compare the current configuration with in-memory snapshot of
+ * the backup.
+ *
+ * @param filename Name of the backup file
+ * @param subtrees Vector of the subtrees to compare. @c NULL for all
+ *                 the subtrees
+ * @param diff     String to append the differences to
+ *
+ * @return Status code
+ * @retval 0            The configuration does not differ from the backup
+ * @retval TE_EBACKUP   The configuration differs from the backup
+ * @retval TE_ENOENT    There is no snapshot of the backup
+ */
+extern te_errno cfg_backup_snapshot_verify(const char *filename,
+                                           const te_vec *subtrees,
+                                           te_string *diff);
 
 /**
  * Verify backup configuration file
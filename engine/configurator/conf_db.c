@@ -10,6 +10,7 @@
 
 #include "conf_defs.h"
 #include "te_alloc.h"
+#include "te_queue.h"
 #include "te_string.h"
 
 /* These must not be greater than CFG_HANDLE_MAX_INDEX + 1 */
@@ -118,14 +119,373 @@ uint64_t cfg_all_inst_size;
 /** Maximum index ever used in the cfg_all_inst */
 static uint64_t cfg_all_inst_max = 1;
 
+/** Index in the cfg_all_inst below which all entries are used */
+static uint64_t cfg_all_inst_used = 1;
+
 /** Unique sequence number of the next instance */
 uint32_t cfg_inst_seq_num = 1;
 
 /** Delay for configuration changes accommodation */
 uint32_t cfg_conf_delay;
 
+/** Minimum number of buckets in a hash index of instances */
+#define CFG_INST_HASH_MIN_SIZE  1024
+
+/** FNV-1a hash offset basis */
+#define CFG_HASH_INIT   2166136261u
+
+/** FNV-1a hash prime */
+#define CFG_HASH_PRIME  16777619u
+
+/** Hash index of object instances */
+typedef struct cfg_inst_hash {
+    cfg_instance  **buckets;    /**< Chains of instances */
+    size_t          size;       /**< Number of buckets (power of two) */
+    size_t          count;      /**< Number of instances in the index */
+} cfg_inst_hash;
+
+/** Hash indexes of object instances */
+static cfg_inst_hash cfg_inst_hashes[CFG_INST_INDEX_NUM];
+
 /* Locals */
-static int pattern_match(char *pattern, char *str);
+static void cfg_pattern_cache_destroy(void);
+
+/**
+ * Continue calculation of the hash with a string including its
+ * terminating null character.
+ *
+ * @param hash      Hash calculated so far
+ * @param str       String
+ *
+ * @return Updated hash.
+ */
+static uint32_t
+cfg_hash_str(uint32_t hash, const char *str)
+{
+    const unsigned char *p = (const unsigned char *)str;
+
+    do {
+        hash = (hash ^ *p) * CFG_HASH_PRIME;
+    } while (*p++ != '\0');
+
+    return hash;
+}
+
+/**
+ * Calculate hash of the son key.
+ *
+ * @param father    Father instance
+ * @param subid     Object sub-identifier of the son
+ * @param name      Name of the son
+ *
+ * @return Hash value.
+ */
+static uint32_t
+cfg_hash_son(const cfg_instance *father, const char *subid, const char *name)
+{
+    uint64_t handle = father->handle;
+    uint32_t hash = CFG_HASH_INIT;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(handle); i++, handle >>= 8)
+        hash = (hash ^ (handle & 0xff)) * CFG_HASH_PRIME;
+
+    return cfg_hash_str(cfg_hash_str(hash, subid), name);
+}
+
+/**
+ * Double the number of buckets in the hash index.
+ *
+ * @param idx       Index
+ */
+static void
+cfg_inst_hash_grow(cfg_inst_index idx)
+{
+    cfg_inst_hash  *h = &cfg_inst_hashes[idx];
+    size_t          size = MAX(h->size * 2, CFG_INST_HASH_MIN_SIZE);
+    cfg_instance  **buckets = TE_ALLOC(size * sizeof(*buckets));
+    cfg_instance   *inst;
+    cfg_instance   *next;
+    size_t          i;
+
+    for (i = 0; i < h->size; i++)
+    {
+        for (inst = h->buckets[i]; inst != NULL; inst = next)
+        {
+            cfg_instance **bucket = &buckets[inst->hash[idx] & (size - 1)];
+
+            next = inst->hash_next[idx];
+            inst->hash_next[idx] = *bucket;
+            *bucket = inst;
+        }
+    }
+
+    free(h->buckets);
+    h->buckets = buckets;
+    h->size = size;
+}
+
+/**
+ * Add the instance to the hash index.
+ *
+ * @param idx       Index
+ * @param inst      Instance
+ * @param hash      Hash of the instance key
+ */
+static void
+cfg_inst_hash_add(cfg_inst_index idx, cfg_instance *inst, uint32_t hash)
+{
+    cfg_inst_hash  *h = &cfg_inst_hashes[idx];
+    cfg_instance  **bucket;
+
+    if (h->count >= h->size)
+        cfg_inst_hash_grow(idx);
+
+    inst->hash[idx] = hash;
+    bucket = &h->buckets[hash & (h->size - 1)];
+    inst->hash_next[idx] = *bucket;
+    *bucket = inst;
+    h->count++;
+}
+
+/**
+ * Remove the instance from the hash index.
+ *
+ * @param idx       Index
+ * @param inst      Instance
+ */
+static void
+cfg_inst_hash_del(cfg_inst_index idx, cfg_instance *inst)
+{
+    cfg_inst_hash  *h = &cfg_inst_hashes[idx];
+    cfg_instance  **p;
+
+    if (h->size == 0)
+        return;
+
+    for (p = &h->buckets[inst->hash[idx] & (h->size - 1)];
+         *p != NULL; p = &(*p)->hash_next[idx])
+    {
+        if (*p == inst)
+        {
+            *p = inst->hash_next[idx];
+            inst->hash_next[idx] = NULL;
+            h->count--;
+            return;
+        }
+    }
+}
+
+/**
+ * Free all hash indexes of instances.
+ */
+static void
+cfg_inst_hash_destroy(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < CFG_INST_INDEX_NUM; i++)
+    {
+        free(cfg_inst_hashes[i].buckets);
+        memset(&cfg_inst_hashes[i], 0, sizeof(cfg_inst_hashes[i]));
+    }
+}
+
+/**
+ * Find the instance by OID with the hash index. Instances scheduled for
+ * removal and their descendants are skipped.
+ *
+ * @param oid_s     Instance OID exactly as it was added
+ *
+ * @return Instance or @c NULL.
+ */
+static cfg_instance *
+cfg_db_find_by_oid(const char *oid_s)
+{
+    const cfg_inst_hash *h = &cfg_inst_hashes[CFG_INST_INDEX_OID];
+    uint32_t             hash;
+    cfg_instance        *inst;
+    cfg_instance        *p;
+
+    if (h->size == 0)
+        return NULL;
+
+    hash = cfg_hash_str(CFG_HASH_INIT, oid_s);
+    for (inst = h->buckets[hash & (h->size - 1)]; inst != NULL;
+         inst = inst->hash_next[CFG_INST_INDEX_OID])
+    {
+        if (inst->hash[CFG_INST_INDEX_OID] != hash ||
+            strcmp(inst->oid, oid_s) != 0)
+            continue;
+
+        for (p = inst; p != NULL && !p->remove; p = p->father);
+        if (p == NULL)
+            return inst;
+    }
+
+    return NULL;
+}
+
+/**
+ * Find the son of the instance with the hash index. Instances scheduled
+ * for removal are skipped.
+ *
+ * @param father    Father instance
+ * @param subid     Object sub-identifier of the son
+ * @param name      Name of the son
+ *
+ * @return Son instance or @c NULL.
+ */
+static cfg_instance *
+cfg_db_find_son(const cfg_instance *father, const char *subid,
+                const char *name)
+{
+    const cfg_inst_hash *h = &cfg_inst_hashes[CFG_INST_INDEX_SON];
+    uint32_t             hash;
+    cfg_instance        *inst;
+
+    if (h->size == 0)
+        return NULL;
+
+    hash = cfg_hash_son(father, subid, name);
+    for (inst = h->buckets[hash & (h->size - 1)]; inst != NULL;
+         inst = inst->hash_next[CFG_INST_INDEX_SON])
+    {
+        if (inst->hash[CFG_INST_INDEX_SON] == hash &&
+            inst->father == father && !inst->remove &&
+            strcmp(inst->obj->subid, subid) == 0 &&
+            strcmp(inst->name, name) == 0)
+            return inst;
+    }
+
+    return NULL;
+}
+
+/**
+ * Find the instance by parsed OID walking from the root with the hash
+ * index of sons.
+ *
+ * @param oid       Parsed instance OID
+ * @param len       Number of sub-identifiers to walk
+ *
+ * @return Instance or @c NULL.
+ */
+static cfg_instance *
+cfg_db_find_by_ids(const cfg_oid *oid, int len)
+{
+    const cfg_inst_subid   *ids = (const cfg_inst_subid *)(oid->ids);
+    cfg_instance           *inst = &cfg_inst_root;
+    int                     i;
+
+    if (strcmp(inst->obj->subid, ids[0].subid) != 0 ||
+        strcmp(inst->name, ids[0].name) != 0)
+        return NULL;
+
+    for (i = 1; i < len && inst != NULL; i++)
+        inst = cfg_db_find_son(inst, ids[i].subid, ids[i].name);
+
+    return inst;
+}
+
+/* See the description in conf_db.h */
+void
+cfg_db_link_inst(cfg_instance *inst, cfg_instance *prev)
+{
+    cfg_instance *father = inst->father;
+
+    inst->son = NULL;
+    inst->last_son = NULL;
+    inst->prev_brother = prev;
+    if (prev != NULL)
+    {
+        inst->brother = prev->brother;
+        prev->brother = inst;
+    }
+    else
+    {
+        inst->brother = father->son;
+        father->son = inst;
+    }
+    if (inst->brother != NULL)
+        inst->brother->prev_brother = inst;
+    else
+        father->last_son = inst;
+
+    cfg_inst_hash_add(CFG_INST_INDEX_OID, inst,
+                      cfg_hash_str(CFG_HASH_INIT, inst->oid));
+    cfg_inst_hash_add(CFG_INST_INDEX_SON, inst,
+                      cfg_hash_son(father, inst->obj->subid, inst->name));
+}
+
+/**
+ * Unlink the instance from its father and remove it from the database
+ * indexes.
+ *
+ * @param inst      Instance
+ */
+static void
+cfg_db_unlink_inst(cfg_instance *inst)
+{
+    cfg_instance *father = inst->father;
+
+    if (inst->prev_brother != NULL)
+        inst->prev_brother->brother = inst->brother;
+    else
+        father->son = inst->brother;
+
+    if (inst->brother != NULL)
+        inst->brother->prev_brother = inst->prev_brother;
+    else
+        father->last_son = inst->prev_brother;
+
+    cfg_inst_hash_del(CFG_INST_INDEX_OID, inst);
+    cfg_inst_hash_del(CFG_INST_INDEX_SON, inst);
+}
+
+/**
+ * Find a free entry in the pool of instances growing the pool if
+ * necessary.
+ *
+ * @param idx       Location for the entry index
+ *
+ * @return Status code.
+ */
+static te_errno
+cfg_db_alloc_inst_index(uint64_t *idx)
+{
+    uint64_t i;
+
+    for (i = cfg_all_inst_used;
+         i < cfg_all_inst_size && cfg_all_inst[i] != NULL; i++);
+
+    if (i > CFG_HANDLE_MAX_INDEX)
+    {
+        ERROR("%s(): no more instance indexes is available",
+              __FUNCTION__);
+        return TE_ETOOMANY;
+    }
+
+    if (i == cfg_all_inst_size)
+    {
+        /* Grow geometrically to add many instances in linear time */
+        uint64_t  add = MAX(cfg_all_inst_size, CFG_INST_NUM);
+        void     *tmp = realloc(cfg_all_inst,
+                                sizeof(void *) * (cfg_all_inst_size + add));
+
+        if (tmp == NULL)
+            return TE_ENOMEM;
+
+        memset(tmp + sizeof(void *) * cfg_all_inst_size, 0,
+               sizeof(void *) * add);
+
+        cfg_all_inst = (cfg_instance **)tmp;
+        cfg_all_inst_size += add;
+    }
+
+    cfg_all_inst_used = i;
+    *idx = i;
+    return 0;
+}
 
 /**
  * Description for a dependency referenced
@@ -486,8 +846,12 @@ cfg_db_init(void)
         return TE_ENOMEM;
     }
     cfg_all_inst_size = CFG_INST_NUM;
+    cfg_all_inst_used = 1;
     cfg_all_inst[0] = &cfg_inst_root;
     cfg_inst_root.son = NULL;
+    cfg_inst_root.last_son = NULL;
+    cfg_inst_hash_add(CFG_INST_INDEX_OID, &cfg_inst_root,
+                      cfg_hash_str(CFG_HASH_INIT, cfg_inst_root.oid));
 
     cfg_create_dep(&cfg_obj_agent_rsrc, &cfg_obj_agent_rsrc_shared, true);
     cfg_create_dep(&cfg_obj_agent_rsrc, &cfg_obj_agent_rsrc_timeout, true);
@@ -521,6 +885,8 @@ cfg_db_destroy(void)
     }
     free(cfg_all_inst);
     cfg_all_inst = NULL;
+    cfg_inst_hash_destroy();
+    cfg_pattern_cache_destroy();
 
     INFO("Destroy objects");
     for (i = CFG_OBJ_HANDLE_NUM_RSRVD; i < cfg_all_obj_size; i++)
@@ -1224,6 +1590,334 @@ cfg_process_msg_pattern(cfg_pattern_msg *msg)
 #undef RETERR
 }   /* cfg_process_msg_pattern() */
 
+/** Maximum number of compiled patterns kept for reuse */
+#define CFG_PATTERN_CACHE_SIZE  32
+
+/** Kinds of compiled pattern strings */
+typedef enum cfg_pattern_kind {
+    CFG_PATTERN_EXACT,      /**< String without wildcard */
+    CFG_PATTERN_ANY,        /**< String starting with wildcard matches
+                                 everything */
+    CFG_PATTERN_GLOB,       /**< Prefix and suffix around wildcard */
+} cfg_pattern_kind;
+
+/** Compiled pattern of sub-identifier or instance name */
+typedef struct cfg_pattern_str {
+    cfg_pattern_kind    kind;       /**< Kind of the pattern */
+    const char         *str;        /**< Pattern string */
+    size_t              prefix_len; /**< Length of the prefix before
+                                         wildcard */
+    const char         *suffix;     /**< Suffix after wildcard */
+    size_t              suffix_len; /**< Length of the suffix */
+} cfg_pattern_str;
+
+/** Compiled pattern of one OID component */
+typedef struct cfg_pattern_id {
+    cfg_pattern_str subid;  /**< Object sub-identifier */
+    cfg_pattern_str name;   /**< Instance name */
+} cfg_pattern_id;
+
+/** Compiled pattern */
+typedef struct cfg_pattern {
+    TAILQ_ENTRY(cfg_pattern)    links;  /**< Links of the cache */
+    char                       *str;    /**< Pattern string */
+    cfg_oid                    *oid;    /**< Parsed pattern owning strings
+                                             of components */
+    cfg_pattern_id             *ids;    /**< Components */
+} cfg_pattern;
+
+/** List of compiled patterns */
+typedef TAILQ_HEAD(cfg_patterns, cfg_pattern) cfg_patterns;
+
+/** Cache of recently used compiled patterns */
+static cfg_patterns cfg_pattern_cache =
+    TAILQ_HEAD_INITIALIZER(cfg_pattern_cache);
+
+/** Number of compiled patterns in the cache */
+static unsigned int cfg_pattern_cache_len = 0;
+
+/** Handles matching a pattern */
+typedef struct cfg_pattern_matches {
+    cfg_handle     *handles;    /**< Array of handles */
+    unsigned int    num;        /**< Number of handles */
+    unsigned int    size;       /**< Size of the array */
+} cfg_pattern_matches;
+
+/**
+ * Compile pattern of sub-identifier or instance name.
+ *
+ * @param str       Pattern string possibly containing '*'
+ * @param pstr      Location for compiled pattern
+ */
+static void
+cfg_pattern_str_compile(const char *str, cfg_pattern_str *pstr)
+{
+    const char *star = strchr(str, '*');
+
+    pstr->str = str;
+    if (star == NULL)
+    {
+        pstr->kind = CFG_PATTERN_EXACT;
+    }
+    else if (star == str)
+    {
+        pstr->kind = CFG_PATTERN_ANY;
+    }
+    else
+    {
+        /* Only the first wildcard is special */
+        pstr->kind = CFG_PATTERN_GLOB;
+        pstr->prefix_len = star - str;
+        pstr->suffix = star + 1;
+        pstr->suffix_len = strlen(pstr->suffix);
+    }
+}
+
+/**
+ * Decide if the string matches the compiled pattern.
+ *
+ * @param pstr      Compiled pattern
+ * @param str       String to match
+ *
+ * @return @c true if the string matches.
+ */
+static bool
+cfg_pattern_str_match(const cfg_pattern_str *pstr, const char *str)
+{
+    size_t len;
+
+    switch (pstr->kind)
+    {
+        case CFG_PATTERN_EXACT:
+            return strcmp(pstr->str, str) == 0;
+
+        case CFG_PATTERN_ANY:
+            return true;
+
+        case CFG_PATTERN_GLOB:
+            len = strlen(str);
+            return len >= pstr->prefix_len + pstr->suffix_len &&
+                   strncmp(pstr->str, str, pstr->prefix_len) == 0 &&
+                   strcmp(pstr->suffix, str + len - pstr->suffix_len) == 0;
+    }
+
+    return false;
+}
+
+/**
+ * Free compiled pattern.
+ *
+ * @param pattern   Compiled pattern
+ */
+static void
+cfg_pattern_free(cfg_pattern *pattern)
+{
+    free(pattern->ids);
+    cfg_free_oid(pattern->oid);
+    free(pattern->str);
+    free(pattern);
+}
+
+/**
+ * Free all compiled patterns in the cache.
+ */
+static void
+cfg_pattern_cache_destroy(void)
+{
+    cfg_pattern *pattern;
+
+    while ((pattern = TAILQ_FIRST(&cfg_pattern_cache)) != NULL)
+    {
+        TAILQ_REMOVE(&cfg_pattern_cache, pattern, links);
+        cfg_pattern_free(pattern);
+    }
+    cfg_pattern_cache_len = 0;
+}
+
+/**
+ * Get compiled pattern from the cache or compile it and put to the cache.
+ *
+ * @param str       Pattern string
+ *
+ * @return Compiled pattern or @c NULL if the pattern format is incorrect.
+ */
+static const cfg_pattern *
+cfg_pattern_get(const char *str)
+{
+    cfg_pattern *pattern;
+    cfg_oid     *oid;
+    int          i;
+
+    TAILQ_FOREACH(pattern, &cfg_pattern_cache, links)
+    {
+        if (strcmp(pattern->str, str) == 0)
+        {
+            TAILQ_REMOVE(&cfg_pattern_cache, pattern, links);
+            TAILQ_INSERT_HEAD(&cfg_pattern_cache, pattern, links);
+            return pattern;
+        }
+    }
+
+    oid = cfg_convert_oid_str(str);
+    if (oid == NULL)
+        return NULL;
+
+    pattern = TE_ALLOC(sizeof(*pattern));
+    pattern->str = TE_STRDUP(str);
+    pattern->oid = oid;
+    pattern->ids = TE_ALLOC(oid->len * sizeof(*pattern->ids));
+    for (i = 0; i < oid->len; i++)
+    {
+        if (oid->inst)
+        {
+            cfg_inst_subid *s = (cfg_inst_subid *)(oid->ids) + i;
+
+            cfg_pattern_str_compile(s->subid, &pattern->ids[i].subid);
+            cfg_pattern_str_compile(s->name, &pattern->ids[i].name);
+        }
+        else
+        {
+            cfg_object_subid *s = (cfg_object_subid *)(oid->ids) + i;
+
+            cfg_pattern_str_compile(s->subid, &pattern->ids[i].subid);
+        }
+    }
+
+    TAILQ_INSERT_HEAD(&cfg_pattern_cache, pattern, links);
+    if (++cfg_pattern_cache_len > CFG_PATTERN_CACHE_SIZE)
+    {
+        cfg_pattern *last = TAILQ_LAST(&cfg_pattern_cache, cfg_patterns);
+
+        TAILQ_REMOVE(&cfg_pattern_cache, last, links);
+        cfg_pattern_free(last);
+        cfg_pattern_cache_len--;
+    }
+
+    return pattern;
+}
+
+/**
+ * Add a handle to the array of matches.
+ *
+ * @param matches   Matches
+ * @param handle    Handle
+ */
+static void
+cfg_pattern_matches_add(cfg_pattern_matches *matches, cfg_handle handle)
+{
+    if (matches->num == matches->size)
+    {
+        matches->size = MAX(matches->size * 2, 16);
+        TE_REALLOC(matches->handles,
+                   matches->size * sizeof(*matches->handles));
+    }
+    matches->handles[matches->num++] = handle;
+}
+
+/**
+ * Find instances matching the compiled pattern in the subtree of the
+ * instance matching the pattern up to the given component.
+ *
+ * Sons matching a component without wildcards are looked up in the
+ * index, other sons are matched one by one.
+ *
+ * @param pattern   Compiled instance pattern
+ * @param level     Component matched by the instance
+ * @param inst      Instance
+ * @param matches   Matches
+ */
+static void
+cfg_pattern_find_inst(const cfg_pattern *pattern, int level,
+                      cfg_instance *inst, cfg_pattern_matches *matches)
+{
+    const cfg_pattern_id   *id;
+    cfg_instance           *son;
+
+    if (++level == pattern->oid->len)
+    {
+        cfg_pattern_matches_add(matches, inst->handle);
+        return;
+    }
+
+    id = &pattern->ids[level];
+    if (id->subid.kind == CFG_PATTERN_EXACT &&
+        id->name.kind == CFG_PATTERN_EXACT)
+    {
+        const cfg_inst_hash *h = &cfg_inst_hashes[CFG_INST_INDEX_SON];
+        uint32_t             hash;
+
+        if (h->size == 0)
+            return;
+
+        /* Instances scheduled for removal match patterns as well */
+        hash = cfg_hash_son(inst, id->subid.str, id->name.str);
+        for (son = h->buckets[hash & (h->size - 1)]; son != NULL;
+             son = son->hash_next[CFG_INST_INDEX_SON])
+        {
+            if (son->hash[CFG_INST_INDEX_SON] == hash &&
+                son->father == inst &&
+                strcmp(son->obj->subid, id->subid.str) == 0 &&
+                strcmp(son->name, id->name.str) == 0)
+                cfg_pattern_find_inst(pattern, level, son, matches);
+        }
+        return;
+    }
+
+    for (son = inst->son; son != NULL; son = son->brother)
+    {
+        if (cfg_pattern_str_match(&id->subid, son->obj->subid) &&
+            cfg_pattern_str_match(&id->name, son->name))
+            cfg_pattern_find_inst(pattern, level, son, matches);
+    }
+}
+
+/**
+ * Find objects matching the compiled pattern in the subtree of the
+ * object matching the pattern up to the given component.
+ *
+ * @param pattern   Compiled object pattern
+ * @param level     Component matched by the object
+ * @param obj       Object
+ * @param matches   Matches
+ */
+static void
+cfg_pattern_find_obj(const cfg_pattern *pattern, int level,
+                     cfg_object *obj, cfg_pattern_matches *matches)
+{
+    const cfg_pattern_id   *id;
+    cfg_object             *son;
+
+    if (++level == pattern->oid->len)
+    {
+        cfg_pattern_matches_add(matches, obj->handle);
+        return;
+    }
+
+    id = &pattern->ids[level];
+    for (son = obj->son; son != NULL; son = son->brother)
+    {
+        if (cfg_pattern_str_match(&id->subid, son->subid))
+            cfg_pattern_find_obj(pattern, level, son, matches);
+    }
+}
+
+/**
+ * Compare handles by index in the array of objects or instances.
+ *
+ * @param a         The first handle
+ * @param b         The second handle
+ *
+ * @return Result of comparison like strcmp().
+ */
+static int
+cfg_pattern_handle_cmp(const void *a, const void *b)
+{
+    uint32_t idx_a = CFG_INST_HANDLE_TO_INDEX(*(const cfg_handle *)a);
+    uint32_t idx_b = CFG_INST_HANDLE_TO_INDEX(*(const cfg_handle *)b);
+
+    return idx_a < idx_b ? -1 : idx_a > idx_b;
+}
+
 /**
  * Find all objects or object instances matching a pattern.
  *
@@ -1242,150 +1936,61 @@ cfg_db_find_pattern(const char *pattern,
                     unsigned int *p_nmatches,
                     cfg_handle **p_matches)
 {
-    cfg_handle  *matches = NULL;
-    cfg_handle  *result_matches = NULL;
-    int         nof_matches = 0;
-    cfg_oid     *idsplit = NULL;
-
-    uint64_t i;
-    int k;
-
-    bool all = false;
-    bool inst;
-
-#define RETERR(_rc) \
-    do {                            \
-        if (idsplit)                \
-            cfg_free_oid(idsplit);  \
-        return TE_RC(TE_CS, _rc);   \
-    } while (0)
+    cfg_pattern_matches  matches = { NULL, 0, 0 };
+    const cfg_pattern   *compiled;
+    uint64_t             i;
 
     if (strcmp(pattern, "*") == 0)
     {
-        all = true;
-        inst = false;
         RING("pattern: %s, file: %s, line: %d\n",
              pattern, __FILE__, __LINE__);
+        for (i = 0; i < cfg_all_obj_size; i++)
+        {
+            if (cfg_all_obj[i] != NULL)
+                cfg_pattern_matches_add(&matches, cfg_all_obj[i]->handle);
+        }
     }
     else if (strcmp(pattern, "*:*") == 0)
     {
-        all = true;
-        inst = true;
-    }
-    else if ((idsplit = cfg_convert_oid_str(pattern)) == NULL)
-        return TE_RC(TE_CS, TE_EINVAL);
-    else
-        inst = idsplit->inst;
-
-    if (inst)
-    {
-        matches = calloc(cfg_all_inst_size, sizeof(cfg_handle));
-        if (matches == NULL)
-            RETERR(TE_ENOMEM);
-
         for (i = 0; i < cfg_all_inst_size; i++)
         {
-            cfg_inst_subid *s1;
-            cfg_inst_subid *s2;
-            cfg_oid        *tmp_idsplit;
-
-            if (cfg_all_inst[i] == NULL)
-                continue;
-
-            if (all)
-            {
-                matches[nof_matches++] = cfg_all_inst[i]->handle;
-                continue;
-            }
-
-            tmp_idsplit = cfg_convert_oid_str(cfg_all_inst[i]->oid);
-            if (tmp_idsplit == NULL)
-                RETERR(TE_ENOMEM);
-
-            if (tmp_idsplit->len != idsplit->len)
-            {
-                cfg_free_oid(tmp_idsplit);
-                continue;
-            }
-            s1 = (cfg_inst_subid *)(idsplit->ids);
-            s2 = (cfg_inst_subid *)(tmp_idsplit->ids);
-            for (k = 0; k < idsplit->len; k++, s1++, s2++)
-            {
-                if ((s1->subid[0] != '*' &&
-                     pattern_match(s1->subid, s2->subid) != 0) ||
-                    (s1->name[0] != '*' &&
-                     pattern_match(s1->name, s2->name) != 0))
-                {
-                    break;
-                }
-            }
-            cfg_free_oid(tmp_idsplit);
-            if (k == idsplit->len)
-                matches[nof_matches++] = cfg_all_inst[i]->handle;
+            if (cfg_all_inst[i] != NULL)
+                cfg_pattern_matches_add(&matches, cfg_all_inst[i]->handle);
         }
     }
+    else if ((compiled = cfg_pattern_get(pattern)) == NULL)
+    {
+        return TE_RC(TE_CS, TE_EINVAL);
+    }
     else
     {
-        matches = calloc(cfg_all_obj_size, sizeof(cfg_handle));
-        if (matches == NULL)
-            RETERR(TE_ENOMEM);
-
-        for (i = 0; i < cfg_all_obj_size; i++)
+        /* Matches are reported in order of handle indexes */
+        if (compiled->oid->inst)
         {
-            cfg_object_subid *s1;
-            cfg_object_subid *s2;
-            cfg_oid          *tmp_idsplit;
-
-            if (cfg_all_obj[i] == NULL)
-                continue;
-
-            if (all)
-            {
-                matches[nof_matches++] = cfg_all_obj[i]->handle;
-                continue;
-            }
-
-            tmp_idsplit = cfg_convert_oid_str(cfg_all_obj[i]->oid);
-            if (tmp_idsplit == NULL)
-                RETERR(TE_ENOMEM);
-
-            if (tmp_idsplit->len != idsplit->len)
-            {
-                cfg_free_oid(tmp_idsplit);
-                continue;
-            }
-            s1 = (cfg_object_subid *)(idsplit->ids);
-            s2 = (cfg_object_subid *)(tmp_idsplit->ids);
-            for (k = 0; k < idsplit->len; k++, s1++, s2++)
-            {
-                if (s1->subid[0] != '*' &&
-                    pattern_match(s1->subid, s2->subid) != 0)
-                {
-                    break;
-                }
-            }
-            cfg_free_oid(tmp_idsplit);
-            if (k == idsplit->len)
-                matches[nof_matches++] = cfg_all_obj[i]->handle;
+            if (cfg_pattern_str_match(&compiled->ids[0].subid,
+                                      cfg_inst_root.obj->subid) &&
+                cfg_pattern_str_match(&compiled->ids[0].name,
+                                      cfg_inst_root.name))
+                cfg_pattern_find_inst(compiled, 0, &cfg_inst_root,
+                                      &matches);
+        }
+        else
+        {
+            if (cfg_pattern_str_match(&compiled->ids[0].subid,
+                                      cfg_obj_root.subid))
+                cfg_pattern_find_obj(compiled, 0, &cfg_obj_root, &matches);
         }
-    }
-
-    cfg_free_oid(idsplit);
 
-    result_matches = realloc(matches, nof_matches * sizeof(cfg_handle));
-    if (result_matches == NULL)
-    {
-        if (nof_matches != 0)
+        if (matches.num > 1)
         {
-            free(matches);
-            return TE_RC(TE_CS, TE_ENOMEM);
+            qsort(matches.handles, matches.num, sizeof(*matches.handles),
+                  cfg_pattern_handle_cmp);
         }
     }
 
-    *p_matches = result_matches;
-    *p_nmatches = nof_matches;
+    *p_matches = matches.handles;
+    *p_nmatches = matches.num;
     return 0;
-#undef RETERR
 }   /* cfg_db_find_pattern() */
 
 /*
@@ -1421,32 +2026,11 @@ cfg_add_with_obj_and_parent(cfg_instance *par_inst, cfg_object *obj,
     if (ret != (int)oid_s_len)
         return TE_ENOBUFS;
 
-    for (i = 0; i < cfg_all_inst_size && cfg_all_inst[i] != NULL; i++);
-
-    if (i > CFG_HANDLE_MAX_INDEX)
+    ret = cfg_db_alloc_inst_index(&i);
+    if (ret != 0)
     {
-        ERROR("%s(): no more instance indexes is available",
-              __FUNCTION__);
         free(oid_s);
-        return TE_ETOOMANY;
-    }
-
-    if (i == cfg_all_inst_size)
-    {
-        void *tmp = realloc(cfg_all_inst,
-            sizeof(void *) * (cfg_all_inst_size + CFG_INST_NUM));
-
-        if (tmp == NULL)
-        {
-            free(oid_s);
-            return TE_ENOMEM;
-        }
-
-        memset(tmp + sizeof(void *) * cfg_all_inst_size, 0,
-             sizeof(void *) * CFG_INST_NUM);
-
-        cfg_all_inst = (cfg_instance **)tmp;
-        cfg_all_inst_size += CFG_INST_NUM;
+        return ret;
     }
 
     cfg_all_inst[i] = (cfg_instance *)calloc(sizeof(cfg_instance), 1);
@@ -1481,9 +2065,7 @@ cfg_add_with_obj_and_parent(cfg_instance *par_inst, cfg_object *obj,
     cfg_all_inst[i]->name[0] = '\0';
     cfg_all_inst[i]->obj = obj;
     cfg_all_inst[i]->father = par_inst;
-    cfg_all_inst[i]->son = NULL;
-    cfg_all_inst[i]->brother = par_inst->son;
-    par_inst->son =  cfg_all_inst[i];
+    cfg_db_link_inst(cfg_all_inst[i], NULL);
     *inst = cfg_all_inst[i];
 
     return 0;
@@ -1605,11 +2187,12 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
 {
     cfg_oid        *oid = cfg_convert_oid_str(oid_s);
     cfg_object     *obj;
-    cfg_instance   *father = &cfg_inst_root;
+    cfg_instance   *father;
     cfg_instance   *inst;
     cfg_instance   *prev;
     cfg_inst_subid *s;
-    uint64_t        i = 0;
+    uint64_t        i;
+    te_errno        rc;
 
     if (oid == NULL)
     {
@@ -1626,29 +2209,13 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
     if (!oid->inst)
         RET(TE_EINVAL);
 
-    s = (cfg_inst_subid *)(oid->ids);
-
     /* Look for the father first */
-    while (true)
-    {
-        for (;
-             father != NULL &&
-                 (strcmp(father->obj->subid, s->subid) != 0 ||
-                  strcmp(father->name, s->name) != 0 ||
-                  father->remove);
-             father = father->brother);
-
-        s++;
-
-        if (++i == oid->len - 1 || father == NULL)
-            break;
-
-        father = father->son;
-    }
-
+    father = cfg_db_find_by_ids(oid, oid->len - 1);
     if (father == NULL)
         RET(TE_ENOENT);
 
+    s = (cfg_inst_subid *)(oid->ids) + oid->len - 1;
+
     /* Find an object for the instance */
     for (obj = father->obj->son;
          obj != NULL && strcmp(obj->subid, s->subid) != 0;
@@ -1677,37 +2244,21 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
     }
 
     /* Try to find instance with the same name */
-    for (inst = father->son, prev = NULL;
-         inst != NULL && (strcmp(inst->oid, oid_s) < 0 || inst->remove);
-         prev = inst, inst = inst->brother);
-
-    if (inst != NULL && strcmp(inst->oid, oid_s) == 0)
+    if (cfg_db_find_son(father, s->subid, s->name) != NULL)
         RET(TE_EEXIST);
 
-    /* Now look for empty slot in the object instances array */
-    for (i = 0; i < cfg_all_inst_size && cfg_all_inst[i] != NULL; i++);
-
-    if (i > CFG_HANDLE_MAX_INDEX)
-    {
-        ERROR("%s(): no more instance indexes is available",
-              __FUNCTION__);
-        RET(TE_ETOOMANY);
-    }
-
-    if (i == cfg_all_inst_size)
-    {
-        void *tmp = realloc(cfg_all_inst,
-            sizeof(void *) * (cfg_all_inst_size + CFG_INST_NUM));
-
-        if (tmp == NULL)
-            RET(TE_ENOMEM);
-
-        memset(tmp + sizeof(void *) * cfg_all_inst_size, 0,
-               sizeof(void *) * CFG_INST_NUM);
+    /*
+     * Keep brothers sorted by OID: look for the place from the end since
+     * instances are usually added in order.
+     */
+    for (prev = father->last_son;
+         prev != NULL && strcmp(prev->oid, oid_s) > 0;
+         prev = prev->prev_brother);
 
-        cfg_all_inst = (cfg_instance **)tmp;
-        cfg_all_inst_size += CFG_INST_NUM;
-    }
+    /* Now look for empty slot in the object instances array */
+    rc = cfg_db_alloc_inst_index(&i);
+    if (rc != 0)
+        RET(rc);
 
     inst = cfg_all_inst[i] =
         (cfg_instance *)calloc(sizeof(cfg_instance), 1);
@@ -1753,18 +2304,7 @@ cfg_db_add(const char *oid_s, cfg_handle *handle,
     strcpy(inst->name, s->name);
     inst->obj = obj;
     inst->father = father;
-    inst->son = NULL;
-
-    if (prev)
-    {
-        inst->brother = prev->brother;
-        prev->brother = inst;
-    }
-    else
-    {
-        inst->brother = father->son;
-        father->son = inst;
-    }
+    cfg_db_link_inst(inst, prev);
 
     *handle = inst->handle;
     if (cfg_all_inst_max < i)
@@ -1833,7 +2373,9 @@ delete_son(cfg_instance *father, cfg_instance *son)
 {
     cfg_instance *tmp;
     cfg_instance *next;
-    cfg_instance *brother;
+    uint64_t      idx = CFG_INST_HANDLE_TO_INDEX(son->handle);
+
+    assert(son->father == father);
 
     for (tmp = son->son; tmp != NULL; tmp = next)
     {
@@ -1841,22 +2383,11 @@ delete_son(cfg_instance *father, cfg_instance *son)
         delete_son(son, tmp);
     }
 
-    if (father->son == son)
-    {
-        father->son = son->brother;
-    }
-    else
-    {
-        for (brother = father->son;
-             brother->brother != son;
-             brother = brother->brother);
-
-        assert(brother != NULL);
-        brother->brother = son->brother;
-    }
+    cfg_db_unlink_inst(son);
 
     /* Delete from the array of object instances */
-    cfg_all_inst[CFG_INST_HANDLE_TO_INDEX(son->handle)] = NULL;
+    cfg_all_inst[idx] = NULL;
+    cfg_all_inst_used = MIN(cfg_all_inst_used, idx);
 
     /* Free memory allocated for the instance */
     if (son->obj->type != CVT_NONE)
@@ -1958,8 +2489,17 @@ cfg_db_get(cfg_handle handle, cfg_inst_val *val)
 int
 cfg_db_find(const char *oid_s, cfg_handle *handle)
 {
-    cfg_oid *oid = NULL;
-    int      i = 0;
+    cfg_oid      *oid = NULL;
+    cfg_instance *inst;
+    int           i = 0;
+
+    /* Instance OIDs are usually passed exactly as they are stored */
+    inst = cfg_db_find_by_oid(oid_s);
+    if (inst != NULL)
+    {
+        *handle = inst->handle;
+        return 0;
+    }
 
     if ((oid = cfg_convert_oid_str(oid_s)) == NULL)
        return TE_EINVAL;
@@ -1979,37 +2519,24 @@ cfg_db_find(const char *oid_s, cfg_handle *handle)
 
     if (oid->inst)
     {
-        cfg_instance *tmp = &cfg_inst_root;
+        cfg_inst_subid *ids = (cfg_inst_subid *)(oid->ids);
+        cfg_instance *tmp = cfg_db_find_by_ids(oid, 1);
         cfg_instance *last_subinst = NULL;
         bool not_added_ancestor = false;
 
-        while (true)
+        /*
+         * Instance which is scheduled for removal after commit
+         * is skipped here. It does not make sense to perform
+         * some operations on a deleted instance.
+         */
+        for (i = 1; tmp != NULL && i < oid->len; i++)
         {
-            /*
-             * Instance which is scheduled for removal after commit
-             * is skipped here. It does not make sense to perform
-             * some operations on a deleted instance.
-             */
-            for (;
-                 tmp != NULL &&
-                 (!(strcmp(tmp->obj->subid,
-                           ((cfg_inst_subid *)(oid->ids))[i].subid) == 0 &&
-                    strcmp(tmp->name,
-                           ((cfg_inst_subid *)(oid->ids))[i].name) == 0)
-                  || tmp->remove);
-                 tmp = tmp->brother);
-
-            if (++i == oid->len || tmp == NULL)
-            {
-                break;
-            }
-
             if (tmp->obj->access == CFG_READ_CREATE && !tmp->added)
                 not_added_ancestor = true;
 
             last_subinst = tmp;
 
-            tmp = tmp->son;
+            tmp = cfg_db_find_son(tmp, ids[i].subid, ids[i].name);
         }
         if (tmp == NULL)
         {
@@ -2225,43 +2752,6 @@ cfg_get_ins_by_ins_id_str(const char *ins_id_str)
     return ins;
 }
 
-/**
- * Decide if the string matches to pattern
- *
- * @param pattern        pattern
- * @param string        string to match
- *
- * @return
- *    0  - string matches to pattern
- *    -1 - string doesn't match to pattern
- */
-static int
-pattern_match(char *pattern, char *str)
-{
-    char *star;
-    char *segment;
-
-    if (pattern == NULL || str == NULL)
-        return -1;
-
-    if ((star = strchr(pattern, '*')) == NULL)
-    {
-        return (strcmp(pattern, str) == 0) ? 0 : -1;
-    }
-    segment = star + 1;
-
-    if (strlen(str) < strlen(segment) + (size_t)(star - pattern))
-        return -1;
-
-    if (strncmp(pattern, str, star - pattern) != 0)
-        return -1;
-
-    if ((strcmp(segment, str + strlen(str) - strlen(segment))) != 0)
-        return -1;
-
-    return 0;
-}
-
 /**
  * Walking by the object path @p oid, find the last volatile or
  * the first wildcard node and return its index
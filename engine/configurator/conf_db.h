@@ -110,6 +110,14 @@ cfg_object_agent(cfg_object *obj)
 #define CFG_GET_OBJ(_handle) \
     (CFG_OBJ_HANDLE_VALID(_handle) ? cfg_all_obj[_handle] : NULL)
 
+/** Hash indexes of object instances in the database */
+typedef enum cfg_inst_index {
+    CFG_INST_INDEX_OID,     /**< By OID */
+    CFG_INST_INDEX_SON,     /**< By father, object sub-identifier and
+                                 name */
+    CFG_INST_INDEX_NUM,     /**< Number of indexes */
+} cfg_inst_index;
+
 /** Configurator object instance */
 typedef struct cfg_instance {
     cfg_handle  handle;             /**< Handle of the instance */
@@ -128,8 +136,17 @@ typedef struct cfg_instance {
     struct cfg_instance *father;    /**< Link to father */
     struct cfg_instance *son;       /**< Link to the first son */
     struct cfg_instance *brother;   /**< Link to the next brother */
+    struct cfg_instance *prev_brother;  /**< Link to the previous
+                                             brother (database only) */
+    struct cfg_instance *last_son;  /**< Link to the last son
+                                         (database only) */
     /*@}*/
 
+    /** Next instances in chains of the database hash indexes */
+    struct cfg_instance *hash_next[CFG_INST_INDEX_NUM];
+    /** Hashes of the instance keys in the database indexes */
+    uint32_t             hash[CFG_INST_INDEX_NUM];
+
     struct cfg_instance *bkp_next;  /**< Pointer to the next instance
                                          in a list of instances to
                                          be restored from backup */
@@ -269,6 +286,17 @@ extern cfg_instance *cfg_get_ins_by_ins_id_str(const char *ins_id_str);
  */
 extern te_errno cfg_add_all_inst_by_obj(cfg_object *obj);
 
+/**
+ * Link a new instance to its father after the brother and add it to
+ * the database indexes. The instance OID, name, object and father
+ * must be filled in.
+ *
+ * @param inst          Instance
+ * @param prev          Previous brother or @c NULL to make the instance
+ *                      the first son
+ */
+extern void cfg_db_link_inst(cfg_instance *inst, cfg_instance *prev);
+
 /**
  * Add instance to the database.
  *
@@ -34,12 +34,6 @@
 /** Format for backup file name for subtree*/
 #define CONF_SUBTREE_BACKUP_NAME "%s/te_cfg_subree_backup_%d_%llu.xml"
 
-/** Name of the XSL filter file for generation subtree backup */
-#define CONF_SUBTREE_BACKUP_FILTER_NAME "subtree_backup.xsl"
-
-/** Name of the file to store a list of the subtrees */
-#define CONF_FILTERS_FILE_NAME  "%s/te_cfg_filter_%d_%llu.xml"
-
 static char  buf[CFG_BUF_LEN];
 static char  tmp_buf[1024];
 static char *tmp_dir = NULL;
@@ -1940,9 +1934,62 @@ log_msg(cfg_msg *msg, bool before)
 #undef GET_STRS
 }
 
+/**
+ * Filter the backup file by the specified subtree and
+ * save the result
+ *
+ * @param current_backup Backup file
+ * @param subtree        Vector of subtrees for which to filter the backup file
+ * @param target_backup  OUT: Result file name
+ *
+ * @return Status code
+ */
+static te_errno
+filter_backup_by_subtrees(const char *current_backup, const te_vec *subtrees,
+                          te_string *target_backup)
+{
+    if (subtrees == NULL || te_vec_size(subtrees) == 0)
+    {
+        te_string_append(target_backup, "%s", current_backup);
+        return 0;
+    }
+
+    te_string_append(target_backup, CONF_SUBTREE_BACKUP_NAME,
+                     tmp_dir, getpid(), get_time_ms());
+
+    return cfg_backup_filter_file(current_backup, subtrees,
+                                  target_backup->ptr);
+}
+
+/**
+ * Log differences of the current DB from the backup.
+ *
+ * @param log           if @c true, log changes
+ * @param error_msg     if not NULL, log failure with specified message
+ * @param diff          differences
+ */
+static void
+log_backup_diff(bool log, const char *msg, const char *diff)
+{
+    if (msg != NULL)
+        WARN("%s\n%s", msg, diff);
+    else if (log)
+    {
+        if (cs_flags & CS_LOG_DIFF)
+            TE_LOG(TE_LL_INFO, TE_LGR_ENTITY, TE_LGR_USER,
+                   "Backup diff:\n%s", diff);
+        else
+            INFO("Backup diff:\n%s", diff);
+    }
+}
+
 /**
  * Check if the current DB changes from the backup.
  *
+ * The DB is compared with in-memory snapshot of the backup if it
+ * exists, otherwise the backup file is compared with the DB written
+ * to the file.
+ *
  * @param filename      backup filename
  * @param log           if @c true, log changes
  * @param error_msg     if not NULL, log failure with specified message
@@ -1950,15 +1997,42 @@ log_msg(cfg_msg *msg, bool before)
  *
  * @return 0 if DB state does not differ from backup; status code otherwise
  */
-static inline te_errno
+static te_errno
 verify_backup(const char *backup, bool log, const char *msg,
               const te_vec *subtrees)
 {
-    char diff_file[RCF_MAX_PATH];
-    int  rc;
+    char        diff_file[RCF_MAX_PATH];
+    te_string   filtered = TE_STRING_INIT;
+    const char *original = backup;
+    int         rc;
+
+    if (cfg_backup_snapshot_exists(backup))
+    {
+        te_string diff = TE_STRING_INIT;
+
+        rc = cfg_backup_snapshot_verify(backup, subtrees, &diff);
+        if (rc == TE_EBACKUP)
+            log_backup_diff(log, msg, diff.ptr);
+        te_string_free(&diff);
 
-    if ((rc = cfg_backup_create_file(filename, subtrees)) != 0)
         return rc;
+    }
+
+    /*
+     * If subtrees is NULL @p filtered string will contain
+     * filename specified by the user
+     */
+    rc = filter_backup_by_subtrees(backup, subtrees, &filtered);
+    if (rc != 0)
+    {
+        ERROR("Backup verification failed: %r", rc);
+        te_string_free(&filtered);
+        return rc;
+    }
+    backup = filtered.ptr;
+
+    if ((rc = cfg_backup_create_file(filename, subtrees)) != 0)
+        goto out;
 
     TE_SPRINTF(diff_file, "%s/te_cs.diff", getenv("TE_TMP"));
     sprintf(tmp_buf, "diff -u %s %s >%s 2>&1", backup,
@@ -1980,6 +2054,11 @@ verify_backup(const char *backup, bool log, const char *msg,
     }
     unlink(diff_file);
 
+out:
+    if (strcmp(backup, original) != 0)
+        unlink(backup);
+    te_string_free(&filtered);
+
     return rc;
 }
 
@@ -2039,79 +2118,6 @@ subtrees_str2vec(const char *str, te_vec *vec, unsigned int subtrees_num)
     return rc;
 }
 
-static te_errno
-get_path_to_xslt_filter(te_string *path)
-{
-    char *dir_name = NULL;
-
-    dir_name = getenv("TE_INSTALL");
-    if (dir_name == NULL)
-    {
-        ERROR("Failed to get TE_INSTALL");
-        return TE_ENOENT;
-    }
-
-    te_string_append(path, "%s/default/share/xsl/%s", dir_name,
-                     CONF_SUBTREE_BACKUP_FILTER_NAME);
-    return 0;
-}
-
-/**
- * Filter the backup file by the specified subtree and
- * save the result
- *
- * @param current_backup Backup file
- * @param subtree        Vector of subtrees for which to filter the backup file
- * @param target_backup  OUT: Result file name
- *
- * @return Status code
- */
-static te_errno
-filter_backup_by_subtrees(const char *current_backup, const te_vec *subtrees,
-                          te_string *target_backup)
-{
-    te_string filter_cmd = TE_STRING_INIT;
-    te_string xslt_file = TE_STRING_INIT;
-    te_string filter_filename = TE_STRING_INIT;
-    te_errno rc;
-
-    if (subtrees == NULL || te_vec_size(subtrees) == 0)
-    {
-        te_string_append(target_backup, "%s", current_backup);
-        return 0;
-    }
-
-    te_string_append(&filter_filename, CONF_FILTERS_FILE_NAME,
-                     tmp_dir, getpid(), get_time_ms());
-
-    rc = cfg_backup_create_filter_file(filter_filename.ptr, subtrees);
-    if (rc != 0)
-        goto out;
-
-    te_string_append(target_backup, CONF_SUBTREE_BACKUP_NAME,
-                     tmp_dir, getpid(), get_time_ms());
-
-    rc = get_path_to_xslt_filter(&xslt_file);
-    if (rc != 0)
-        goto out;
-
-    te_string_append(&filter_cmd,
-                     "xsltproc --stringparam filters %s %s %s > %s",
-                     filter_filename.ptr, xslt_file.ptr,
-                     current_backup, target_backup->ptr);
-
-    rc = system(filter_cmd.ptr);
-    if (rc != 0)
-        ERROR("Failed to extract subtrees from the backup file");
-
-out:
-    te_string_free(&filter_cmd);
-    te_string_free(&xslt_file);
-    te_string_free(&filter_filename);
-
-    return rc;
-}
-
 static te_errno
 delete_rcf_conf_agent(cfg_handle handle)
 {
@@ -2297,6 +2303,14 @@ process_backup(cfg_backup_msg *msg, bool release_dh)
                 break;;
             }
 
+            /* Backup is verified faster with the snapshot */
+            if (cfg_backup_snapshot_create(backup_filename,
+                                           &subtrees_vec) != 0)
+            {
+                WARN("Failed to take snapshot of backup '%s'",
+                     backup_filename);
+            }
+
             if ((msg->rc = cfg_dh_attach_backup(backup_filename)) != 0)
                 unlink(backup_filename);
 
@@ -2308,8 +2322,6 @@ process_backup(cfg_backup_msg *msg, bool release_dh)
         case CFG_BACKUP_RESTORE:
         case CFG_BACKUP_RESTORE_NOHISTORY:
         {
-            te_string backup = TE_STRING_INIT;
-
             msg->rc = check_and_reanimate_agents(NULL);
             if (msg->rc != 0)
                 return;
@@ -2347,73 +2359,46 @@ process_backup(cfg_backup_msg *msg, bool release_dh)
                 cfg_ta_sync("/:", true);
             }
 
-            /*
-             * If subtrees is NULL @p backup string will contain
-             * filename specified by the user
-             */
-            msg->rc = filter_backup_by_subtrees(backup_filename, &subtrees_vec,
-                                                &backup);
-            if (msg->rc != 0)
-            {
-                ERROR("Restore backup failed: %r", msg->rc);
-                te_string_free(&backup);
-                break;
-            }
-
-            msg->rc = parse_config_xml(backup.ptr, NULL, false, &subtrees_vec);
+            /* Instances out of the subtrees are skipped on parsing */
+            msg->rc = parse_config_xml(backup_filename, NULL, false,
+                                       &subtrees_vec);
             rcf_log_cfg_changes(false);
 
             if (release_dh)
                 cfg_dh_release_after(backup_filename);
 
-            te_string_free(&backup);
             break;
         }
 
         case CFG_BACKUP_VERIFY:
         {
             te_errno rc;
-            te_string backup = TE_STRING_INIT;
-
-            /*
-             * If subtrees is NULL @p backup string will contain
-             * filename specified by the user
-             */
-            rc = filter_backup_by_subtrees(backup_filename, &subtrees_vec,
-                                           &backup);
-            if (rc != 0)
-            {
-                ERROR("Backup verification failed: %r", rc);
-                msg->rc = rc;
-                te_string_free(&backup);
-                break;
-            }
 
             rc = check_agents();
             if (rc != 0){
                 ERROR("Backup verification failed: %r", rc);
                 msg->rc = rc;
-                te_string_free(&backup);
                 break;
             }
 
-            msg->rc = verify_backup(backup.ptr, true, NULL, &subtrees_vec);
+            msg->rc = verify_backup(backup_filename, true, NULL,
+                                    &subtrees_vec);
             if (msg->rc != 0)
             {
                 cfg_ta_sync("/:", true);
-                msg->rc = verify_backup(backup.ptr, true, NULL, &subtrees_vec);
+                msg->rc = verify_backup(backup_filename, true, NULL,
+                                        &subtrees_vec);
             }
 
             if (msg->rc == 0 && release_dh)
                 cfg_dh_release_after(backup_filename);
 
-            te_string_free(&backup);
-
             break;
         }
 
         case CFG_BACKUP_RELEASE:
         {
+            cfg_backup_snapshot_release(backup_filename);
             msg->rc = cfg_dh_release_backup(backup_filename);
             break;
         }
@@ -2435,7 +2420,10 @@ create_backup(char **bkp_filename)
                                        sizeof(max_commit_subtree));
 
     if (*bkp_filename != NULL)
+    {
+        cfg_backup_snapshot_release(*bkp_filename);
         cfg_dh_release_backup(*bkp_filename);
+    }
 
     bkp_msg->type = CFG_BACKUP;
     bkp_msg->op = CFG_BACKUP_CREATE;
@@ -2535,6 +2523,7 @@ process_reboot(cfg_reboot_msg *msg)
 {
     msg->rc = rcf_ta_reboot(msg->ta_name, NULL, NULL,
                             msg->reboot_type);
+    cfg_ta_ext_forget(msg->ta_name);
     if (msg->rc != 0)
     {
         ERROR("Failed to reboot Test Agent %s: %r", msg->ta_name, msg->rc);
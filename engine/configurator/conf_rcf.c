@@ -172,6 +172,7 @@ cfg_rcf_add_ta(cfg_instance *ta)
 
     rc = rcf_add_ta(ta->name, ta->val.val_str, rcflib->val.val_str,
                     confstr.ptr, flags);
+    cfg_ta_ext_forget(ta->name);
     if (rc == 0)
     {
         rc = cfg_rcf_ta_sync(ta->name);
@@ -201,6 +202,7 @@ cfg_rcf_del_ta(cfg_instance *ta)
     rc = rcf_del_ta(ta->name);
     if (rc != 0)
         ERROR("Cannot delete test agent '%s': %r", ta->name, rc);
+    cfg_ta_ext_forget(ta->name);
 
     rc_sync = cfg_rcf_ta_sync(ta->name);
     if (rc_sync != 0)
@@ -10,6 +10,7 @@
 #include "te_str.h"
 #include "conf_defs.h"
 #include "rcf_api.h"
+#include "rcf_proto_bin.h"
 #include "te_queue.h"
 #include "te_alloc.h"
 
@@ -138,11 +139,8 @@ cfg_ta_add_agent_instances()
         sprintf(cfg_all_inst[i]->oid, CFG_TA_PREFIX"%s", ta);
         CFG_NEW_INST_HANDLE(cfg_all_inst[i]->handle, i);
         cfg_all_inst[i]->obj = cfg_all_obj[1];
-        if (i == 1)
-            cfg_all_inst[0]->son = cfg_all_inst[i];
-        else
-            cfg_all_inst[i - 1]->brother = cfg_all_inst[i];
         cfg_all_inst[i]->father = &cfg_inst_root;
+        cfg_db_link_inst(cfg_all_inst[i], cfg_inst_root.last_son);
     }
     free(ta_list.list);
     return 0;
@@ -164,6 +162,7 @@ cfg_ta_reboot_all(void)
              ta += strlen(ta) + 1)
         {
             rcf_ta_reboot(ta, NULL, NULL, RCF_REBOOT_TYPE_FORCE);
+            cfg_ta_ext_forget(ta);
         }
         free(ta_list.list);
     }
@@ -177,16 +176,187 @@ cfg_ta_log_syncing(bool flag)
     do_log_syncing = flag;
 }
 
+/** Generation of the TA subtree at its last synchronisation */
+typedef struct ta_gen_t {
+    SLIST_ENTRY(ta_gen_t) links;    /**< Links of the list */
+    char *generation;   /**< Generation reported by the TA */
+    char  oid[];        /**< Subtree root instance identifier */
+} ta_gen_t;
+
+/** Configuration protocol extensions supported by Test Agent */
+typedef struct ta_ext_t {
+    SLIST_ENTRY(ta_ext_t) links;    /**< Links of the cache */
+    bool bulk;          /**< Is bulk configure get supported? */
+    bool gen;           /**< Are subtree generations supported? */
+    SLIST_HEAD(, ta_gen_t) gens;    /**< Synchronised subtrees */
+    char name[];        /**< Test Agent name */
+} ta_ext_t;
+
+/** Cache of protocol extensions supported by Test Agents */
+static SLIST_HEAD(, ta_ext_t) ta_ext_cache =
+    SLIST_HEAD_INITIALIZER(ta_ext_cache);
+
+/**
+ * Extensions used if the TA is not asked successfully: nothing is
+ * supported and nothing is remembered.
+ */
+static ta_ext_t ta_ext_none;
+
+/**
+ * Get entry of the protocol extensions cache for the TA asking the TA
+ * if the entry does not exist.
+ *
+ * @param ta      Test Agent name
+ *
+ * @return Cache entry or @ref ta_ext_none if the TA cannot be asked.
+ */
+static ta_ext_t *
+ta_ext_get(const char *ta)
+{
+    char      protocols[RCF_MAX_VAL];
+    ta_ext_t *entry;
+    te_errno  rc;
+
+    SLIST_FOREACH(entry, &ta_ext_cache, links)
+    {
+        if (strcmp(entry->name, ta) == 0)
+            return entry;
+    }
+
+    /*
+     * Test Agents of old versions do not know the variable. The answer
+     * is not cached, since the failure may be caused by the TA restart.
+     */
+    rc = rcf_ta_get_var(ta, 0, RCF_PROTO_VAR, RCF_STRING,
+                        sizeof(protocols), protocols);
+    if (rc != 0)
+    {
+        VERB("Failed to get protocol extensions of TA '%s': %r", ta, rc);
+        ta_ext_none.bulk = ta_ext_none.gen = false;
+        return &ta_ext_none;
+    }
+
+    entry = TE_ALLOC(sizeof(*entry) + strlen(ta) + 1);
+    strcpy(entry->name, ta);
+    SLIST_INIT(&entry->gens);
+    entry->bulk = strstr(protocols, RCF_PROTO_CFG_BULK) != NULL;
+    entry->gen = strstr(protocols, RCF_PROTO_CFG_GEN) != NULL;
+    VERB("TA '%s' supports bulk configure get: %s, subtree generations: %s",
+         ta, entry->bulk ? "yes" : "no", entry->gen ? "yes" : "no");
+
+    SLIST_INSERT_HEAD(&ta_ext_cache, entry, links);
+
+    return entry;
+}
+
+/* See description in conf_ta.h */
+void
+cfg_ta_ext_forget(const char *ta)
+{
+    ta_ext_t *entry;
+    ta_gen_t *gen;
+
+    SLIST_FOREACH(entry, &ta_ext_cache, links)
+    {
+        if (strcmp(entry->name, ta) == 0)
+            break;
+    }
+    if (entry == NULL)
+        return;
+
+    SLIST_REMOVE(&ta_ext_cache, entry, ta_ext_t, links);
+    while ((gen = SLIST_FIRST(&entry->gens)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&entry->gens, links);
+        free(gen->generation);
+        free(gen);
+    }
+    free(entry);
+}
+
+/**
+ * Find generation of the TA subtree at its last synchronisation.
+ *
+ * @param ext     TA protocol extensions
+ * @param oid     subtree root instance identifier
+ *
+ * @return Generation entry or @c NULL.
+ */
+static ta_gen_t *
+ta_gen_find(ta_ext_t *ext, const char *oid)
+{
+    ta_gen_t *entry;
+
+    SLIST_FOREACH(entry, &ext->gens, links)
+    {
+        if (strcmp(entry->oid, oid) == 0)
+            return entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get current generation of the TA subtree.
+ *
+ * @param ta      Test Agent name
+ * @param oid     subtree root instance identifier
+ * @param buf     buffer for the generation
+ * @param len     length of the buffer
+ *
+ * @return Status code, @c TE_EOPNOTSUPP if changes of the subtree are
+ *         not tracked by the TA.
+ */
+static te_errno
+ta_gen_get(const char *ta, const char *oid, char *buf, size_t len)
+{
+    char     *gen_oid;
+    te_errno  rc;
+
+    gen_oid = TE_ALLOC(strlen(oid) + sizeof(RCF_PROTO_CFG_GEN_SUFFIX));
+    sprintf(gen_oid, "%s%s", oid, RCF_PROTO_CFG_GEN_SUFFIX);
+
+    rc = rcf_ta_cfg_get(ta, 0, gen_oid, buf, len);
+    free(gen_oid);
+
+    return rc;
+}
+
+/**
+ * Remember generation of the TA subtree at its synchronisation.
+ *
+ * @param ext           TA protocol extensions
+ * @param oid           subtree root instance identifier
+ * @param generation    generation
+ */
+static void
+ta_gen_update(ta_ext_t *ext, const char *oid, const char *generation)
+{
+    ta_gen_t *entry = ta_gen_find(ext, oid);
+
+    if (entry == NULL)
+    {
+        entry = TE_ALLOC(sizeof(*entry) + strlen(oid) + 1);
+        strcpy(entry->oid, oid);
+        SLIST_INSERT_HEAD(&ext->gens, entry, links);
+    }
+
+    free(entry->generation);
+    entry->generation = TE_STRDUP(generation);
+}
+
 /**
  * Synchronize one object instance on the TA.
  *
  * @param ta      Test Agent name
  * @param oid     object instance identifier
+ * @param value   value of the instance got from the TA or @c NULL
+ *                to get it
  *
  * @return status code (see te_errno.h)
  */
 static int
-sync_ta_instance(const char *ta, const char *oid)
+sync_ta_instance(const char *ta, const char *oid, char *value)
 {
     cfg_object   *obj = cfg_get_object(oid);
     cfg_handle    handle = CFG_HANDLE_INVALID;
@@ -221,7 +391,11 @@ sync_ta_instance(const char *ta, const char *oid)
         return rc;
     }
 
-    while (true)
+    /* Value got by bulk configure get is used as is */
+    if (value != NULL)
+        rc = 0;
+
+    while (value == NULL)
     {
         rc = rcf_ta_cfg_get(ta, 0, oid, cfg_get_buf, cfg_get_buf_len);
         if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
@@ -238,6 +412,7 @@ sync_ta_instance(const char *ta, const char *oid)
         else if (TE_RC_GET_ERROR(rc) == TE_ENOENT || rc == 0 ||
                  (TE_RC_GET_ERROR(rc) == TE_ENOENT && obj->vol))
         {
+            value = cfg_get_buf;
             break;
         }
         else
@@ -256,13 +431,13 @@ sync_ta_instance(const char *ta, const char *oid)
 
     if (do_log_syncing)
     {
-        RING("Syncing %s on %s -> %s", ta, oid, cfg_get_buf);
+        RING("Syncing %s on %s -> %s", ta, oid, value);
     }
 
-    if ((rc = cfg_types[obj->type].str2val(cfg_get_buf, &val)) != 0)
+    if ((rc = cfg_types[obj->type].str2val(value, &val)) != 0)
     {
         ERROR("Conversion of '%s' to value type %s(%d) for OID '%s' "
-                "failed", cfg_get_buf,
+                "failed", value,
                 te_enum_map_from_any_value(cfg_cvt_mapping, obj->type,
                                            "unknown type"),
                 obj->type, oid);
@@ -400,8 +575,23 @@ oid_tree_free(void *unused)
     UNUSED(unused);
 }
 
+/** Instance got by bulk configure get */
+typedef struct bulk_entry_t {
+    const char *oid;    /**< Instance identifier */
+    char       *value;  /**< Value or @c NULL if it is not got */
+} bulk_entry_t;
+
+/* Comparison function for sorting instances got by bulk get */
+static int
+bulk_entry_compare(const void *pa, const void *pb)
+{
+    return strcmp(((const bulk_entry_t *)pa)->oid,
+                  ((const bulk_entry_t *)pb)->oid);
+}
+
 /**
- * Synchronize tree of object instances on the TA.
+ * Synchronize tree of object instances on the TA getting identifiers
+ * and values of all instances by single bulk configure get.
  *
  * @param ta      Test Agent name
  * @param oid     root object instance identifier
@@ -409,7 +599,132 @@ oid_tree_free(void *unused)
  * @return status code (see te_errno.h)
  */
 static int
-sync_ta_subtree(const char *ta, const char *oid)
+sync_ta_subtree_bulk(const char *ta, const char *oid)
+{
+    char         *bulk_oid;
+    char         *answer;
+    char         *limit;
+    char         *p;
+    te_string     list = TE_STRING_INIT;
+    bulk_entry_t *entries = NULL;
+    unsigned int  n_entries = 0;
+    unsigned int  max_entries = 0;
+    bool          root_found = false;
+    cfg_handle   *handles = NULL;
+    unsigned int  h_num;
+    unsigned int  i;
+    int           rc;
+
+    bulk_oid = TE_ALLOC(strlen(oid) + sizeof(RCF_PROTO_CFG_BULK_SUFFIX));
+    sprintf(bulk_oid, "%s%s", oid, RCF_PROTO_CFG_BULK_SUFFIX);
+
+    while (true)
+    {
+        rc = rcf_ta_cfg_get(ta, 0, bulk_oid, cfg_get_buf, cfg_get_buf_len);
+        if (TE_RC_GET_ERROR(rc) != TE_ESMALLBUF)
+            break;
+
+        cfg_get_buf_len <<= 1;
+        TE_REALLOC(cfg_get_buf, cfg_get_buf_len);
+    }
+    free(bulk_oid);
+    if (rc != 0)
+        return rc;
+
+    /*
+     * Values of instances missing in the answer are got into
+     * the buffer, so take the answer away.
+     */
+    answer = cfg_get_buf;
+    limit = answer + cfg_get_buf_len;
+    cfg_get_buf = TE_ALLOC(cfg_get_buf_len);
+
+    for (p = answer; p < limit && *p != '\0'; )
+    {
+        bulk_entry_t *entry;
+
+        if (n_entries == max_entries)
+        {
+            max_entries = MAX(max_entries * 2, 64);
+            TE_REALLOC(entries, max_entries * sizeof(*entries));
+        }
+        entry = &entries[n_entries];
+
+        entry->oid = p;
+        p += strnlen(p, limit - p) + 1;
+        if (p >= limit)
+            break;
+        entry->value = p;
+        p += strnlen(p, limit - p) + 1;
+        if (p > limit)
+            break;
+
+        if (strcmp(entry->oid, oid) == 0)
+            root_found = true;
+        n_entries++;
+    }
+    if (p >= limit)
+    {
+        ERROR("Malformed answer on bulk get of '%s' from TA '%s'", oid, ta);
+        rc = TE_EFMT;
+        goto cleanup;
+    }
+
+    /* The root is synchronized even if it is absent on the TA */
+    if (!root_found)
+    {
+        if (n_entries == max_entries)
+            TE_REALLOC(entries, ++max_entries * sizeof(*entries));
+        entries[n_entries].oid = oid;
+        entries[n_entries].value = NULL;
+        n_entries++;
+    }
+
+    /* Parents go before children */
+    if (n_entries > 1)
+        qsort(entries, n_entries, sizeof(*entries), bulk_entry_compare);
+
+    for (i = 0; i < n_entries; i++)
+        te_string_append(&list, "%s ", entries[i].oid);
+
+    rc = cfg_db_find_pattern(oid, &h_num, &handles);
+    if (rc != 0)
+        goto cleanup;
+
+    for (i = 0; i < h_num; i++)
+        remove_excessive(CFG_GET_INST(handles[i]), list.ptr);
+
+    for (i = 0; i < n_entries; i++)
+    {
+        if (i > 0 && strcmp(entries[i].oid, entries[i - 1].oid) == 0)
+            continue;
+
+        rc = sync_ta_instance(ta, entries[i].oid, entries[i].value);
+        if (rc != 0)
+            break;
+    }
+
+cleanup:
+    free(handles);
+    te_string_free(&list);
+    free(entries);
+    free(answer);
+
+    return rc;
+}
+
+/**
+ * Synchronize tree of object instances on the TA getting all instances
+ * from the TA.
+ *
+ * @param ta      Test Agent name
+ * @param oid     root object instance identifier
+ * @param ext     TA protocol extensions
+ *
+ * @return status code (see te_errno.h)
+ */
+static int
+sync_ta_subtree_all(const char *ta, const char *oid, ta_ext_t *ext)
 {
     char  *tmp;
     char  *next;
@@ -424,8 +739,27 @@ sync_ta_subtree(const char *ta, const char *oid)
     int         h_num;
     int         i;
 
-    if (do_log_syncing)
-        RING("Synchronize TA '%s' subtree '%s'", ta, oid);
+    if (ext->bulk)
+    {
+        rc = rcf_ta_cfg_group(ta, 0, true);
+        if (rc != 0)
+        {
+            ERROR("rcf_ta_cfg_group() failed");
+            return rc;
+        }
+
+        rc = sync_ta_subtree_bulk(ta, oid);
+        rcf_ta_cfg_group(ta, 0, false);
+        if (TE_RC_GET_ERROR(rc) != TE_EFMT &&
+            TE_RC_GET_ERROR(rc) != TE_EPROTO)
+        {
+            return rc;
+        }
+
+        WARN("Bulk get of '%s' from TA '%s' failed (%r), "
+             "get instances one by one", oid, ta, rc);
+        ext->bulk = false;
+    }
 
     /* Take all instances from the TA */
     if ((wildcard_oid = malloc(strlen(oid) + sizeof("/..."))) == NULL)
@@ -528,7 +862,7 @@ sync_ta_subtree(const char *ta, const char *oid)
     twalk(oid_tree_root, oid_tree_action);
     TAILQ_FOREACH(entry, &oid_queue, links)
     {
-        if ((rc = sync_ta_instance(ta, entry->oid)) != 0)
+        if ((rc = sync_ta_instance(ta, entry->oid, NULL)) != 0)
             break;
     }
 
@@ -541,6 +875,51 @@ sync_ta_subtree(const char *ta, const char *oid)
     return rc;
 }
 
+/**
+ * Synchronize tree of object instances on the TA if it is changed since
+ * the previous synchronisation.
+ *
+ * @param ta      Test Agent name
+ * @param oid     root object instance identifier
+ *
+ * @return status code (see te_errno.h)
+ */
+static int
+sync_ta_subtree(const char *ta, const char *oid)
+{
+    ta_ext_t *ext = ta_ext_get(ta);
+    ta_gen_t *synced;
+    char      generation[RCF_MAX_VAL] = "";
+    int       rc;
+
+    if (ext->gen && ta_gen_get(ta, oid, generation, sizeof(generation)) == 0)
+    {
+        synced = ta_gen_find(ext, oid);
+        if (synced != NULL && strcmp(synced->generation, generation) == 0)
+        {
+            if (do_log_syncing)
+                RING("TA '%s' subtree '%s' is not changed", ta, oid);
+            return 0;
+        }
+    }
+    else
+    {
+        /* Changes are not tracked */
+        generation[0] = '\0';
+    }
+
+    if (do_log_syncing)
+        RING("Synchronize TA '%s' subtree '%s'", ta, oid);
+
+    rc = sync_ta_subtree_all(ta, oid, ext);
+    if (rc == 0 && generation[0] != '\0')
+        ta_gen_update(ext, oid, generation);
+    else if (TE_RC_GET_ERROR(rc) == TE_ETADEAD)
+        cfg_ta_ext_forget(ta);
+
+    return rc;
+}
+
 /**
  * Synchronize object instances tree with Test Agents.
  *
@@ -604,13 +983,15 @@ cfg_ta_sync(char *oid, bool subtree)
         if (found) /** This is the normal case */
         {
             rc = subtree ? sync_ta_subtree(ta, oid) :
-                           sync_ta_instance(ta, oid);
+                           sync_ta_instance(ta, oid, NULL);
         }
         else /** The specified agent is deleted by RCF */
         {
             char oid_s[sizeof(CFG_TA_PREFIX) +
                        CFG_INST_NAME_MAX] = CFG_TA_PREFIX;
 
+            cfg_ta_ext_forget(ta);
+
             if (do_log_syncing)
                 RING("Deleting non-existent TA '%s'...", ta);
 
@@ -1056,6 +1437,7 @@ conf_ta_reboot_agents(const te_vec *agents)
     {
         rc = rcf_ta_reboot(*ta, NULL, NULL,
                            RCF_REBOOT_TYPE_FORCE);
+        cfg_ta_ext_forget(*ta);
         if (rc != 0)
         {
             ERROR("Failed to reboot TA %s: %r", *ta, rc);
@@ -114,6 +114,16 @@ extern int cfg_ta_sync_dependants(cfg_instance *inst,
  */
 extern void cfg_ta_log_syncing(bool flag);
 
+/**
+ * Forget configuration protocol extensions supported by the Test Agent
+ * and generations of its synchronised subtrees. It should be called
+ * when the Test Agent is restarted, added or deleted, since the new
+ * Test Agent may support other extensions.
+ *
+ * @param ta            Test Agent name
+ */
+extern void cfg_ta_ext_forget(const char *ta);
+
 /**
  * Perform check whether local commands sequence is started or not.
  * If started then set msg @a _cfg_msg rc to TE_EACCES and return from the
@@ -28,6 +28,7 @@
 #endif
 
 #include "te_str.h"
+#include "te_units.h"
 #include "te_raw_log.h"
 #include "te_log_fmt.h"
 #include "logger_int.h"
@@ -35,6 +36,7 @@
 #include "logger_ten.h"
 #include "logger_listener.h"
 #include "logger_stream.h"
+#include "logger_writer.h"
 
 #define LGR_TA_MAX_BUF      0x4000 /* FIXME */
 
@@ -46,9 +48,6 @@
 
 #define SET_MSEC(_poll) ((_poll) % 1000000)
 
-/* Raw log file length checking period */
-#define RAW_FILE_CHECK_PERIOD 100
-
 /* Finished TA checking period */
 #define TA_FINISH_CHECK_PERIOD 50
 
@@ -62,10 +61,12 @@ snif_polling_sets_t snifp_sets;
 /* Path to the directory for logs */
 const char *te_log_dir = NULL;
 
-/* Raw log file */
-static FILE    *raw_file = NULL;
-/* Mutex protecting raw log file */
-static pthread_mutex_t raw_file_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Raw log file descriptor */
+static int      raw_fd = -1;
+/* Raw log index file descriptor */
+static int      raw_index_fd = -1;
+/* Raw log segments file descriptor (if raw log is compressed) */
+static int      raw_seg_fd = -1;
 /* Raw log file location */
 static char    *te_log_raw = NULL;
 
@@ -77,9 +78,8 @@ static char    *te_log_raw = NULL;
 static int64_t raw_log_max_size = (1LLU << 32);
 /* Is the raw log file length bigger than raw_log_max_size */
 static bool raw_log_too_big = false;
-
-/* raw log file check counter */
-static int      raw_file_check_cnt = 0;
+/* Raw log file length including messages queued for writing */
+static uint64_t raw_log_size = 0;
 
 /** Logger PID */
 static pid_t    pid;
@@ -96,12 +96,15 @@ static unsigned int         lgr_flags = 0;
 #define LOGGER_CHECK        0x04    /**< Check messages before store in
                                          raw log file */
 #define LOGGER_SHUTDOWN     0x10    /**< Logger is shuting down */
+#define LOGGER_COMPRESS     0x20    /**< Compress raw log file */
 /*@}*/
 
 /** @name Logger command-line option flags */
 #define LOGGER_OPT_LISTENER    1    /**< Force a listener to be enabled */
 #define LOGGER_OPT_METAFILE    2    /**< Path to the meta.json file */
 #define LOGGER_OPT_MAXSIZE     3    /**< Maximum length of the RAW log */
+#define LOGGER_OPT_QUEUE_SIZE  4    /**< Maximum length of the listener
+                                         queue */
 /*@}*/
 
 static char *cfg_file = NULL;
@@ -182,14 +185,7 @@ append_err_message(const char *fmt, ...)
     }
     else
     {
-        pthread_mutex_lock(&raw_file_mutex);
-
-        if (fwrite(data.buf, data.ptr - data.buf, 1, raw_file) != 1)
-            perror("fwrite() failure");
-        if (fflush(raw_file) != 0)
-            perror("fflush(raw_file) failed");
-
-        pthread_mutex_unlock(&raw_file_mutex);
+        lgr_writer_post(data.buf, data.ptr - data.buf);
     }
 
     free(data.buf);
@@ -205,8 +201,8 @@ append_err_message(const char *fmt, ...)
 void
 lgr_register_message(const void *buf, size_t len)
 {
-    struct stat            raw_file_stat;
     te_errno               rc;
+    uint64_t               size;
 
     if (((lgr_flags & LOGGER_CHECK) && !lgr_message_valid(buf, len)))
         return;
@@ -222,36 +218,103 @@ lgr_register_message(const void *buf, size_t len)
     if (raw_log_too_big)
         return;
 
-    if (raw_log_max_size >= 0 && raw_file_check_cnt-- <= 0)
+    if (raw_log_max_size >= 0)
     {
-        raw_file_check_cnt = RAW_FILE_CHECK_PERIOD;
-        rc = stat(te_log_raw, &raw_file_stat);
-        if (rc < 0)
-        {
-            ERROR("FATAL ERROR: raw log file '%s' stat() failure: "
-                  "errno=%d", te_log_raw, errno);
-            return;
-        }
-        /* RAW log is too big now, ignore new messages */
-        if (raw_file_stat.st_size > (off64_t)raw_log_max_size)
-        {
-            raw_log_too_big = true;
-
-            fprintf(stderr, "\nRAW LOG HAS REACHED SIZE LIMIT, ALL THE "
-                    "NEXT MESSAGES WILL BE LOST\n");
-            append_err_message("Raw log has reached limit of %llu bytes, "
-                               "new log messages are ignored and lost now",
-                               (long long unsigned)raw_log_max_size);
-            return;
-        }
+        size = __atomic_load_n(&raw_log_size, __ATOMIC_RELAXED);
+        do {
+            /* RAW log is too big now, ignore new messages */
+            if (size > (uint64_t)raw_log_max_size)
+            {
+                if (!__atomic_exchange_n(&raw_log_too_big, true,
+                                         __ATOMIC_RELAXED))
+                {
+                    fprintf(stderr, "\nRAW LOG HAS REACHED SIZE LIMIT, "
+                            "ALL THE NEXT MESSAGES WILL BE LOST\n");
+                    append_err_message("Raw log has reached limit of %llu "
+                                       "bytes, new log messages are "
+                                       "ignored and lost now",
+                                       (long long unsigned)
+                                           raw_log_max_size);
+                }
+                return;
+            }
+        } while (!__atomic_compare_exchange_n(&raw_log_size, &size,
+                                              size + len, true,
+                                              __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED));
     }
 
-    pthread_mutex_lock(&raw_file_mutex);
-    if (fwrite(buf, len, 1, raw_file) != 1)
-        perror("fwrite() failure");
-    if (fflush(raw_file) != 0)
-        perror("fflush(raw_file) failed");
-    pthread_mutex_unlock(&raw_file_mutex);
+    lgr_writer_post(buf, len);
+}
+
+/**
+ * Register log messages from a batch sent by Logger TEN library.
+ *
+ * @param buf       Batch contents following the header
+ * @param len       Length of the batch contents
+ */
+static void
+lgr_register_batch(const uint8_t *buf, size_t len)
+{
+    uint32_t msg_len;
+
+    while (len > 0)
+    {
+        if (len < sizeof(msg_len))
+            break;
+
+        memcpy(&msg_len, buf, sizeof(msg_len));
+        msg_len = ntohl(msg_len);
+        buf += sizeof(msg_len);
+        len -= sizeof(msg_len);
+
+        if (msg_len > len)
+            break;
+
+        lgr_register_message(buf, msg_len);
+        buf += msg_len;
+        len -= msg_len;
+    }
+
+    if (len > 0)
+        ERROR("Malformed batch of log messages, %zu bytes are ignored", len);
+}
+
+/**
+ * Prepare the raw log file to be written compressed: open the raw log
+ * segments file and truncate the raw log file. The raw log file may
+ * contain the log version only (written by te_log_init), otherwise
+ * it is not compressed.
+ */
+static void
+raw_log_compress_prepare(void)
+{
+    char *seg_path = NULL;
+
+    if (raw_log_size > sizeof(te_log_version))
+    {
+        fputs("Raw log file is not empty, it is not compressed\n", stderr);
+        return;
+    }
+
+    if (te_asprintf(&seg_path, "%s%s",
+                    te_log_raw, TE_RAW_LOG_SEGMENTS_SUFFIX) < 0)
+        return;
+
+    raw_seg_fd = open(seg_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    free(seg_path);
+    if (raw_seg_fd < 0)
+    {
+        perror("open() of raw log segments failure");
+        return;
+    }
+
+    if (ftruncate(raw_fd, 0) != 0)
+    {
+        perror("ftruncate() of raw log failure");
+        close(raw_seg_fd);
+        raw_seg_fd = -1;
+    }
 }
 
 static pthread_mutex_t add_remove_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -403,6 +466,7 @@ te_handler(void)
             unsigned int const ml = te_log_raw_get_nfl(buf);
             unsigned int const sl = strlen(LGR_SHUTDOWN);
             unsigned int const pl = strlen(LGR_SRV_FOR_TA_PREFIX);
+            unsigned int const bl = strlen(LGR_SRV_BATCH);
             unsigned int       data_len;
 
             if (ml + sizeof(te_log_nfl) == len &&
@@ -479,6 +543,13 @@ te_handler(void)
                           err_buf);
                 }
             }
+            /* Check whether it is a batch of log messages */
+            else if (ml == bl && ml + sizeof(te_log_nfl) <= len &&
+                     strncmp(msg, LGR_SRV_BATCH, bl) == 0)
+            {
+                lgr_register_batch((const uint8_t *)msg + bl,
+                                   len - sizeof(te_log_nfl) - bl);
+            }
             else
             {
                 lgr_register_message(buf, len);
@@ -513,6 +584,10 @@ ta_flush_done(struct ipc_server *srv)
         ERROR("FATAL ERROR: Failed to read flush request: %r", rc);
         return rc;
     }
+
+    /* Flushed messages must be in the raw log file before the answer */
+    lgr_writer_sync();
+
     rc = ipc_send_answer(srv, ipcsc_p, buf, len);
     if (rc != 0)
     {
@@ -528,7 +603,8 @@ ta_flush_done(struct ipc_server *srv)
 /**
  * This is an entry point of TA log message gatherer.
  * This routine periodically polls appropriate TA to get
- * TA local log. Besides, log is solicited if flush is requested.
+ * TA local log. Besides, log is solicited if flush is requested
+ * or if TA reports that it has more messages than fit in one bulk.
  *
  * @param  ta   Location of TA parameters.
  *
@@ -551,6 +627,8 @@ ta_handler(void *ta)
     unsigned long int   polling;
     struct timeval      poll_ts;    /**< The last poll time stamp */
     struct timeval      now;        /**< Current time */
+    bool                more = false; /**< TA has more messages to
+                                           pass right away */
 
     /* Flush variavles */
     bool do_flush = false;
@@ -612,7 +690,11 @@ ta_handler(void *ta)
 
         /*
          * If we are not flushing, wait for polling timeout or
-         * flush request
+         * flush request. If TA has reported that it has more
+         * messages, just check for flush request and get them
+         * immediately: TA log buffer is drained at the pace the
+         * Logger is able to store messages and periodic polling
+         * is used only when TA has nothing more to pass.
          */
         if (!do_flush)
         {
@@ -631,9 +713,10 @@ ta_handler(void *ta)
 
             /*
              * Calculate period of time we should wait
-             * before next get log.
+             * before next get log (do not wait if TA has
+             * more messages).
              */
-            if (poll_ts.tv_sec >= now.tv_sec)
+            if (!more && poll_ts.tv_sec >= now.tv_sec)
             {
                 delay.tv_sec = poll_ts.tv_sec - now.tv_sec;
 
@@ -682,7 +765,8 @@ ta_handler(void *ta)
         gettimeofday(&poll_ts, NULL);
 
         *log_file = '\0';
-        if ((rc = rcf_ta_get_log(inst->agent, log_file)) != 0)
+        more = false;
+        if ((rc = rcf_ta_get_log_ext(inst->agent, log_file, &more)) != 0)
         {
             /* Any error interrupts flush operation */
             if (do_flush)
@@ -706,7 +790,7 @@ ta_handler(void *ta)
             else
             {
                 /* The rest of errors are considered as fatal */
-                ERROR("rcf_ta_get_log(ta_name='%s') returned fatal error "
+                ERROR("rcf_ta_get_log_ext(ta_name='%s') returned fatal error "
                       "%r, stop gathering logs from this TA",
                       inst->agent, rc);
                 break;
@@ -922,6 +1006,7 @@ process_cmd_line_opts(int argc, const char **argv)
     char        *meta_path;
     char        *listener_conf;
     char        *max_size;
+    char        *queue_size;
 
     const char *cfg = NULL;
 
@@ -960,6 +1045,20 @@ process_cmd_line_opts(int argc, const char **argv)
           "unlimited; may be specified in units of G[igabytes])",
           "size" },
 
+        { "listener-queue-size", '\0',
+          POPT_ARG_STRING, &queue_size, LOGGER_OPT_QUEUE_SIZE,
+          "Maximum total length of messages waiting to be processed for "
+          "listeners (64M by default, 0 for unlimited); other than Tester "
+          "messages are dropped if it is reached.",
+          "size" },
+
+        { "compress", '\0',
+          POPT_ARG_NONE | POPT_BIT_SET, &lgr_flags, LOGGER_COMPRESS,
+          "Write the raw log compressed in independently decompressible "
+          "segments (the raw log file must be empty or contain the log "
+          "version only).",
+          NULL },
+
         POPT_AUTOHELP
         POPT_TABLEEND
     };
@@ -1023,6 +1122,26 @@ process_cmd_line_opts(int argc, const char **argv)
                 break;
             }
 
+            case LOGGER_OPT_QUEUE_SIZE:
+            {
+                te_unit  unit;
+                te_errno rc;
+
+                rc = te_unit_from_string(queue_size, &unit);
+                if (rc != 0 || te_unit_bin_unpack(unit) < 0)
+                {
+                    fprintf(stderr, "Failed to parse "
+                            "--listener-queue-size=%s\n", queue_size);
+                    free(queue_size);
+                    poptFreeContext(optCon);
+                    return EXIT_FAILURE;
+                }
+
+                listener_queue.max_len = te_unit_bin_unpack(unit);
+                free(queue_size);
+                break;
+            }
+
             default:
                 fprintf(stderr, "Unexpected option number %d", rc);
                 poptFreeContext(optCon);
@@ -1158,9 +1277,11 @@ main(int argc, const char *argv[])
     pthread_t   te_thread;
     pthread_t   listener_thread;
     ta_inst    *ta_el;
+    struct stat raw_stat;
+    char       *raw_index_path = NULL;
 
     te_log_init("Logger", lgr_log_message);
-    rc = msg_queue_init(&listener_queue);
+    rc = msg_queue_init(&listener_queue, LGR_LISTENER_QUEUE_MAX_LEN);
     if (rc != 0)
     {
         ERROR("Failed to initialize the listeners queue: %r", rc);
@@ -1191,12 +1312,60 @@ main(int argc, const char *argv[])
         return EXIT_FAILURE;
     }
     /* Open raw log file for addition */
-    raw_file = fopen(te_log_raw, "ab");
-    if (raw_file == NULL)
+    raw_fd = open(te_log_raw, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (raw_fd < 0)
+    {
+        perror("open() failure");
+        return EXIT_FAILURE;
+    }
+    if (fstat(raw_fd, &raw_stat) != 0)
     {
-        perror("fopen() failure");
+        perror("fstat() failure");
+        close(raw_fd);
         return EXIT_FAILURE;
     }
+    raw_log_size = raw_stat.st_size;
+
+    /*
+     * Open raw log index file, the Logger may work without it.
+     * If the raw log contains the log version only, it is a new one
+     * (it is also recreated to be compressed), so the index left
+     * from the previous raw log is dropped.
+     */
+    if (te_asprintf(&raw_index_path, "%s%s",
+                    te_log_raw, TE_RAW_LOG_INDEX_SUFFIX) > 0)
+    {
+        raw_index_fd = open(raw_index_path,
+                            O_WRONLY | O_APPEND | O_CREAT |
+                            (raw_log_size <= sizeof(te_log_version) ?
+                             O_TRUNC : 0), 0666);
+        if (raw_index_fd < 0)
+            perror("open() of raw log index failure");
+        free(raw_index_path);
+    }
+
+    if (lgr_flags & LOGGER_COMPRESS)
+        raw_log_compress_prepare();
+
+    lgr_writer_init(raw_fd, raw_index_fd);
+
+    if (raw_seg_fd >= 0)
+    {
+        te_log_version version = TE_LOG_VERSION;
+
+        rc = lgr_writer_compress(raw_seg_fd);
+        if (rc != 0)
+        {
+            fprintf(stderr, "Raw log is not compressed: %s\n",
+                    te_rc_err2str(rc));
+            close(raw_seg_fd);
+            raw_seg_fd = -1;
+        }
+
+        /* The raw log file is truncated, restore the log version */
+        lgr_writer_post(&version, sizeof(version));
+        raw_log_size = sizeof(version);
+    }
     /* Further we must goto 'exit' in the case of failure */
 
     /* Initialize IPC before any servers creation */
@@ -1248,6 +1417,13 @@ main(int argc, const char *argv[])
     /* Store my PID in global variable */
     pid = getpid();
 
+    rc = lgr_writer_start();
+    if (rc != 0)
+    {
+        ERROR("Failed to start raw log writer: %r", rc);
+        goto exit;
+    }
+
     /* Apply default sniffer settings */
     sniffer_polling_sets_start_init();
     /* Parse configuration file */
@@ -1459,14 +1635,24 @@ exit:
 
     RING("Shutdown is completed");
 
-    if (fflush(raw_file) != 0)
+    if (lgr_writer_stop() != 0)
+    {
+        fputs("Failed to stop raw log writer\n", stderr);
+        result = EXIT_FAILURE;
+    }
+    if (close(raw_fd) != 0)
+    {
+        perror("close() failed");
+        result = EXIT_FAILURE;
+    }
+    if (raw_index_fd >= 0 && close(raw_index_fd) != 0)
     {
-        perror("fflush() failed");
+        perror("close() of raw log index failed");
         result = EXIT_FAILURE;
     }
-    if (fclose(raw_file) != 0)
+    if (raw_seg_fd >= 0 && close(raw_seg_fd) != 0)
     {
-        perror("fclose() failed");
+        perror("close() of raw log segments failed");
         result = EXIT_FAILURE;
     }
 
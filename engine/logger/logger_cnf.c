@@ -820,6 +820,8 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
     yaml_node_t      *buffer_size = NULL;
     yaml_node_t      *buffers_num = NULL;
     yaml_node_t      *trail_slash = NULL;
+    yaml_node_t      *compression = NULL;
+    yaml_node_t      *http2       = NULL;
     const char       *name_str    = NULL;
     const char       *url_str     = NULL;
     const char       *enabled_str = NULL;
@@ -828,6 +830,8 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
     const char       *buffer_size_str = NULL;
     const char       *buffers_num_str = NULL;
     const char       *trail_slash_str = NULL;
+    const char       *compression_str = NULL;
+    const char       *http2_str       = NULL;
     unsigned long     tmp;
 
     log_listener_conf *current_conf;
@@ -864,6 +868,10 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
             buffers_num = v;
         else if (strcmp(key, "trailing_slash") == 0)
             trail_slash = v;
+        else if (strcmp(key, "compression") == 0)
+            compression = v;
+        else if (strcmp(key, "http2") == 0)
+            http2 = v;
     }
 
     current = &listeners[listeners_num];
@@ -1016,6 +1024,40 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
     if (te_yaml_value_is_true(trail_slash_str))
         current->trailing_slash = true;
 
+    current->compress = false;
+    compression_str = te_yaml_scalar_value(compression);
+    if (compression != NULL && compression_str == NULL)
+    {
+        ERROR("%s(%s): Compression is not a scalar", __FUNCTION__, name_str);
+        return -1;
+    }
+    if (compression_str != NULL)
+    {
+        if (strcmp(compression_str, "gzip") == 0)
+        {
+#ifdef HAVE_ZLIB_H
+            current->compress = true;
+#else
+            ERROR("%s(%s): Logger is built without zlib, gzip compression "
+                  "is not supported", __FUNCTION__, name_str);
+            return -1;
+#endif
+        }
+        else if (strcmp(compression_str, "none") != 0)
+        {
+            ERROR("%s(%s): Unsupported compression '%s'",
+                  __FUNCTION__, name_str, compression_str);
+            return -1;
+        }
+    }
+
+    http2_str = te_yaml_scalar_value(http2);
+    if (http2 != NULL && http2_str == NULL)
+    {
+        ERROR("%s(%s): Http2 is not a scalar", __FUNCTION__, name_str);
+        return -1;
+    }
+
     msg_buffer_init(&current->buffer);
     current->state = LISTENER_INIT;
     current->curl_handle = curl_easy_init();
@@ -1026,6 +1068,7 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
         return -1;
     }
     current->buffer_in = (te_dbuf)TE_DBUF_INIT(100);
+    current->buffer_gz = (te_dbuf)TE_DBUF_INIT(100);
 
     current->buffer_out = (te_string)TE_STRING_INIT;
 
@@ -1100,12 +1143,32 @@ add_listener(yaml_document_t *d, yaml_node_t *listener)
     SET_CURL_OPT(CURLOPT_WRITEFUNCTION, handle_http_response);
     SET_CURL_OPT(CURLOPT_WRITEDATA, current);
 
+    /*
+     * Use HTTP/2 over HTTPS (HTTP/1.1 is used if the server does not
+     * support it), requests of listeners served by the same host are
+     * multiplexed over a single connection then.
+     */
+    if (te_yaml_value_is_true(http2_str))
+    {
+#if LIBCURL_VERSION_NUM >= 0x072f00
+        SET_CURL_OPT(CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+        SET_CURL_OPT(CURLOPT_PIPEWAIT, 1L);
+#else
+        WARN("TE is built against libcurl that doesn't support HTTP/2");
+#endif
+    }
+
     /* All requests will be POSTs, prepare headers here */
     /* TE will only send JSON */
     current->headers = curl_slist_append(NULL, "Content-Type: application/json");
     /* Don't wait for server's confirmation before sending request body */
     if (current->headers != NULL)
         current->headers = curl_slist_append(current->headers, "Expect:");
+    if (current->headers != NULL && current->compress)
+    {
+        current->headers = curl_slist_append(current->headers,
+                                             "Content-Encoding: gzip");
+    }
     if (current->headers == NULL)
     {
         ERROR("%s(%s): curl_slist_append failed", __FUNCTION__, name_str);
@@ -1150,8 +1213,6 @@ handle_listeners(yaml_document_t *d, yaml_node_t *section)
         return -1;
     }
 
-    listeners_enabled = true;
-
     for (item = section->data.sequence.items.start;
          item < section->data.sequence.items.top; item++)
     {
@@ -1169,6 +1230,9 @@ handle_listeners(yaml_document_t *d, yaml_node_t *section)
 
     }
 
+    /* Nobody would consume the messages if all listeners are disabled */
+    listeners_enabled = listeners_num > 0;
+
     return 0;
 }
 
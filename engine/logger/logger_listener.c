@@ -12,6 +12,9 @@
 #include <stddef.h>
 #include <signal.h>
 #include <sys/time.h>
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
 
 #include "te_defs.h"
 #include "te_str.h"
@@ -24,12 +27,80 @@ size_t            listener_confs_num;
 log_listener      listeners[LOG_MAX_LISTENERS];
 size_t            listeners_num;
 
+/**
+ * Compress a request body with gzip.
+ *
+ * @param listener          listener description
+ * @param data              request body
+ * @param data_len          length of the request body
+ *
+ * @returns Status code
+ */
+static te_errno
+listener_compress(log_listener *listener, const void *data, size_t data_len)
+{
+#ifdef HAVE_ZLIB_H
+    z_stream strm;
+    size_t   bound;
+    int      ret;
+
+    memset(&strm, 0, sizeof(strm));
+    /* 16 is added to the window bits to get gzip header and trailer */
+    ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK)
+    {
+        ERROR("Listener %s: failed to initialize compression: %d",
+              listener->name, ret);
+        return TE_EFAIL;
+    }
+
+    bound = deflateBound(&strm, data_len);
+    te_dbuf_reset(&listener->buffer_gz);
+    te_dbuf_append(&listener->buffer_gz, NULL, bound);
+
+    strm.next_in = (Bytef *)data;
+    strm.avail_in = data_len;
+    strm.next_out = listener->buffer_gz.ptr;
+    strm.avail_out = bound;
+    ret = deflate(&strm, Z_FINISH);
+    deflateEnd(&strm);
+    if (ret != Z_STREAM_END)
+    {
+        ERROR("Listener %s: failed to compress request: %d",
+              listener->name, ret);
+        return TE_EFAIL;
+    }
+
+    listener->buffer_gz.len = bound - strm.avail_out;
+    return 0;
+#else
+    UNUSED(data);
+    UNUSED(data_len);
+    ERROR("Listener %s: Logger is built without compression support",
+          listener->name);
+    return TE_EOPNOTSUPP;
+#endif
+}
+
 static te_errno
 listener_prepare_request(log_listener *listener, const char *url_suffix,
                          void *data, long data_len)
 {
     char *url;
 
+    listener->stats.bytes += data_len;
+    if (listener->compress)
+    {
+        te_errno rc = listener_compress(listener, data, data_len);
+
+        if (rc != 0)
+            return rc;
+        data = listener->buffer_gz.ptr;
+        data_len = listener->buffer_gz.len;
+    }
+    listener->stats.bytes_sent += data_len;
+
     te_dbuf_reset(&listener->buffer_in);
     url = te_string_fmt("%s%s", listener->url, url_suffix);
     if (url == NULL)
@@ -202,7 +273,10 @@ listener_add_msg(log_listener *listener, const refcnt_buffer *msg)
     while (listener->buffer.n_items > 1 &&
            listener->buffer.total_length >
              listener->buffer_size * listener->buffers_num)
+    {
         msg_buffer_remove_first(&listener->buffer);
+        listener->stats.msgs_dropped++;
+    }
 
     return 0;
 }
@@ -224,6 +298,7 @@ listener_dump(log_listener *listener)
         te_string_append(&listener->buffer_out, "%.*s", item->len, item->buf);
         /* No need to store another copy of the message */
         msg_buffer_remove_first(&listener->buffer);
+        listener->stats.msgs_sent++;
         if (listener->buffer_out.len > listener->buffer_size)
             break;
         if (!TAILQ_EMPTY(&listener->buffer.items))
@@ -419,8 +494,10 @@ listener_finish_request(log_listener *listener, CURLcode result)
         listener_free(listener);
         return TE_EINVAL;
     }
+    listener->stats.requests++;
     if (result != CURLE_OK)
     {
+        listener->stats.failures++;
         ERROR("Listener %s: request failed: %s", listener->name,
               curl_easy_strerror(result));
         /*
@@ -540,11 +617,25 @@ listener_finish(log_listener *listener)
 void
 listener_free(log_listener *listener)
 {
+    if (listener->state != LISTENER_FINISHED)
+    {
+        RING("Listener %s: %llu requests (%llu failed), %llu messages "
+             "sent in %llu bytes (%llu bytes transferred), %llu messages "
+             "dropped", listener->name,
+             (unsigned long long)listener->stats.requests,
+             (unsigned long long)listener->stats.failures,
+             (unsigned long long)listener->stats.msgs_sent,
+             (unsigned long long)listener->stats.bytes,
+             (unsigned long long)listener->stats.bytes_sent,
+             (unsigned long long)listener->stats.msgs_dropped);
+    }
+
     curl_easy_cleanup(listener->curl_handle);
     listener->curl_handle = NULL;
     curl_slist_free_all(listener->headers);
     listener->headers = NULL;
     te_dbuf_free(&listener->buffer_in);
+    te_dbuf_free(&listener->buffer_gz);
     te_string_free(&listener->buffer_out);
     msg_buffer_free(&listener->buffer);
     listener->state = LISTENER_FINISHED;
@@ -55,6 +55,18 @@ extern te_errno listener_conf_add(const char *confstr);
 /** Find the user-supplied configuration for a given listener */
 extern log_listener_conf *listener_conf_get(const char *name);
 
+/** Listener statistics logged when the listener finishes */
+typedef struct log_listener_stats {
+    uint64_t requests;      /**< Number of completed HTTP requests */
+    uint64_t failures;      /**< Number of failed HTTP requests */
+    uint64_t msgs_sent;     /**< Number of messages sent */
+    uint64_t msgs_dropped;  /**< Number of messages dropped since
+                                 the message buffer was full */
+    uint64_t bytes;         /**< Total length of request bodies */
+    uint64_t bytes_sent;    /**< Total length of request bodies
+                                 after compression */
+} log_listener_stats;
+
 /** Log message listener */
 typedef struct log_listener {
     char               name[LOG_MAX_LISTENER_NAME]; /**< Name */
@@ -75,6 +87,10 @@ typedef struct log_listener {
     te_string          buffer_out;  /**< Buffer for outgoing data */
     bool trailing_slash; /**< Whether to add a trailing slash to
                                             URLs (for Django compatibility) */
+    bool compress;       /**< Whether to compress request bodies
+                              with gzip */
+    te_dbuf            buffer_gz;   /**< Buffer for compressed data */
+    log_listener_stats stats;       /**< Statistics */
 } log_listener;
 
 /**
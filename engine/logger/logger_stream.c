@@ -11,10 +11,12 @@
 
 #include <poll.h>
 #include <limits.h>
+#include <arpa/inet.h>
 #include <jansson.h>
 
 #include "te_defs.h"
 #include "te_str.h"
+#include "te_raw_log.h"
 #include "log_bufs.h"
 #include "logger_api.h"
 #include "logger_internal.h"
@@ -33,16 +35,42 @@ double start_ts = 0.0;
 
 /* See description in logger_stream.h */
 te_errno
-msg_queue_init(msg_queue *queue)
+msg_queue_init(msg_queue *queue, size_t max_len)
 {
     memset(queue, 0, sizeof(*queue));
     TAILQ_INIT(&queue->items);
+    queue->max_len = max_len;
     queue->shutdown = false;
     pthread_mutex_init(&queue->mutex, NULL);
     queue->eventfd = eventfd(0, 0);
     return 0;
 }
 
+/**
+ * Check whether a raw log message is logged by Tester. Such messages
+ * (test progress and results, the execution plan) are not dropped when
+ * the listener queue is full.
+ */
+static bool
+msg_is_from_tester(const char *buf, size_t len)
+{
+    static const char entity[] = TE_LOG_CMSG_ENTITY_TESTER;
+
+    size_t     offset = TE_LOG_MSG_COMMON_HDR_SZ + sizeof(te_log_id);
+    te_log_nfl entity_len;
+
+    if (len < offset + sizeof(entity_len))
+        return false;
+
+    memcpy(&entity_len, buf + offset, sizeof(entity_len));
+    entity_len = ntohs(entity_len);
+    offset += sizeof(entity_len);
+
+    return entity_len == sizeof(entity) - 1 &&
+           len >= offset + entity_len &&
+           memcmp(buf + offset, entity, entity_len) == 0;
+}
+
 /* See description in logger_stream.h */
 te_errno
 msg_queue_post(msg_queue *queue, const char *buf, size_t len)
@@ -51,6 +79,27 @@ msg_queue_post(msg_queue *queue, const char *buf, size_t len)
     te_errno      rc;
     refcnt_buffer *item;
 
+    /*
+     * The limit is checked before the message is copied, so it may be
+     * exceeded by the messages posted by other threads concurrently.
+     */
+    if (queue->max_len != 0 && !msg_is_from_tester(buf, len))
+    {
+        bool full;
+
+        pthread_mutex_lock(&queue->mutex);
+        full = queue->len + len > queue->max_len;
+        if (full)
+        {
+            queue->stats.dropped++;
+            queue->stats.dropped_bytes += len;
+        }
+        pthread_mutex_unlock(&queue->mutex);
+
+        if (full)
+            return TE_ENOBUFS;
+    }
+
     item = TE_ALLOC(sizeof(*item));
 
     rc = refcnt_buffer_init_copy(item, buf, len);
@@ -66,6 +115,10 @@ msg_queue_post(msg_queue *queue, const char *buf, size_t len)
         return TE_EFAIL;
     }
     TAILQ_INSERT_TAIL(&queue->items, item, links);
+    queue->len += len;
+    queue->stats.posted++;
+    if (queue->len > queue->stats.max_len)
+        queue->stats.max_len = queue->len;
     pthread_mutex_unlock(&queue->mutex);
 
     inc = 1;
@@ -86,12 +139,22 @@ msg_queue_extract(msg_queue *queue, refcnt_buffer_list *list,
     {
         *list = queue->items;
         TAILQ_INIT(&queue->items);
+        queue->len = 0;
     }
     if (shutdown != NULL)
         *shutdown = queue->shutdown;
     pthread_mutex_unlock(&queue->mutex);
 }
 
+/* See description in logger_stream.h */
+void
+msg_queue_get_stats(msg_queue *queue, msg_queue_stats *stats)
+{
+    pthread_mutex_lock(&queue->mutex);
+    *stats = queue->stats;
+    pthread_mutex_unlock(&queue->mutex);
+}
+
 /* See description in logger_stream.h */
 void
 msg_queue_shutdown(msg_queue *queue)
@@ -186,9 +249,13 @@ listeners_conf_dump(void)
         te_log_buf_append(buffer, "  interval: %d\n", listener->interval);
         te_log_buf_append(buffer, "  buffer_size: %lu\n", listener->buffer_size);
         te_log_buf_append(buffer, "  buffers_num: %lu\n", listener->buffers_num);
+        te_log_buf_append(buffer, "  compression: %s\n",
+                          listener->compress ? "gzip" : "none");
         te_log_buf_append(buffer, "\n");
     }
 
+    te_log_buf_append(buffer, "Queue size: %zu\n\n", listener_queue.max_len);
+
     te_log_buf_append(buffer, "Filters:\n");
     for (i = 0; i < streaming_filters_num; i++)
     {
@@ -466,11 +533,26 @@ process_queue(void)
     queue_event         evt = QEVENT_NONE;
     bool queue_shutdown;
     bool failure = false;
+    static bool drops_reported = false;
 
     msg_queue_extract(&listener_queue, &messages, &queue_shutdown);
     if (queue_shutdown)
         evt |= QEVENT_FINISH;
 
+    if (!drops_reported)
+    {
+        msg_queue_stats stats;
+
+        msg_queue_get_stats(&listener_queue, &stats);
+        if (stats.dropped != 0)
+        {
+            WARN("Listener queue is full (%zu bytes), messages other than "
+                 "Tester ones are dropped until listeners catch up",
+                 listener_queue.max_len);
+            drops_reported = true;
+        }
+    }
+
     TAILQ_FOREACH_SAFE(item, &messages, links, tmp)
     {
         te_errno rc;
@@ -607,6 +689,7 @@ listeners_thread(void *arg)
     queue_event     events_happened = QEVENT_NONE;
     int             listeners_running;
     int             poll_timeout;
+    msg_queue_stats queue_stats;
 
     UNUSED(arg);
 
@@ -637,6 +720,13 @@ listeners_thread(void *arg)
     SET_CURLM_OPT(CURLMOPT_SOCKETFUNCTION, socket_cb);
     SET_CURLM_OPT(CURLMOPT_TIMERDATA, &curl_timeout);
     SET_CURLM_OPT(CURLMOPT_TIMERFUNCTION, timer_cb);
+#ifdef CURLPIPE_MULTIPLEX
+    /*
+     * Let listeners served by the same host share a connection
+     * if HTTP/2 is negotiated.
+     */
+    SET_CURLM_OPT(CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
 #undef SET_CURLM_OPT
 
     gettimeofday(&now, NULL);
@@ -824,6 +914,14 @@ listeners_thread(void *arg)
     json_decref(trc_tags);
 
     curl_multi_cleanup(curl_mhandle);
+
+    msg_queue_get_stats(&listener_queue, &queue_stats);
+    RING("Listener queue: %llu messages queued, %llu messages (%llu bytes) "
+         "dropped, at most %zu bytes queued at once",
+         (unsigned long long)queue_stats.posted,
+         (unsigned long long)queue_stats.dropped,
+         (unsigned long long)queue_stats.dropped_bytes,
+         queue_stats.max_len);
     RING("Listener thread finished");
     return NULL;
 }
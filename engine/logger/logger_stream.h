@@ -21,12 +21,33 @@
 extern "C" {
 #endif
 
+/** Default maximum total length of messages in the listener queue */
+#define LGR_LISTENER_QUEUE_MAX_LEN  (64 << 20)
+
+/** Message queue statistics */
+typedef struct msg_queue_stats {
+    uint64_t posted;        /**< Number of queued messages */
+    uint64_t dropped;       /**< Number of dropped messages */
+    uint64_t dropped_bytes; /**< Total length of dropped messages */
+    size_t   max_len;       /**< Maximum total length of queued messages */
+} msg_queue_stats;
+
 /**
  * Thread safe message queue for communication between
  * Logger threads and listener server thread.
+ *
+ * The queue is bounded by the total length of queued messages. If
+ * the consumer falls behind and the limit is reached, new messages are
+ * dropped, except Tester control messages (they carry the execution
+ * plan and test results, and they are never dropped). Logger threads
+ * are never blocked by the queue.
  */
 typedef struct msg_queue {
-    refcnt_buffer_list items; /**< Messages */
+    refcnt_buffer_list items;   /**< Messages */
+    size_t             len;     /**< Total length of queued messages */
+    size_t             max_len; /**< Maximum total length of queued
+                                     messages, @c 0 means no limit */
+    msg_queue_stats    stats;   /**< Statistics */
 
     bool shutdown; /**< Whether the queue is being shutdown */
     pthread_mutex_t mutex;    /**< Mutex for consumer-producer synchronization */
@@ -37,10 +58,12 @@ typedef struct msg_queue {
  * Initialize a message queue.
  *
  * @param queue         Message queue
+ * @param max_len       Maximum total length of queued messages
+ *                      (@c 0 means no limit)
  *
  * @returns Status code
  */
-extern te_errno msg_queue_init(msg_queue *queue);
+extern te_errno msg_queue_init(msg_queue *queue, size_t max_len);
 
 /**
  * Post a message on the queue.
@@ -53,6 +76,7 @@ extern te_errno msg_queue_init(msg_queue *queue);
  * @param len           Message length
  *
  * @returns Status code
+ * @retval TE_ENOBUFS   The queue is full, the message is dropped.
  */
 extern te_errno msg_queue_post(msg_queue *queue, const char *buf, size_t len);
 
@@ -69,6 +93,14 @@ extern te_errno msg_queue_post(msg_queue *queue, const char *buf, size_t len);
 extern void msg_queue_extract(msg_queue *queue, refcnt_buffer_list *list,
                               bool *shutdown);
 
+/**
+ * Get statistics of a message queue.
+ *
+ * @param queue         Message queue
+ * @param stats         Where to store the statistics
+ */
+extern void msg_queue_get_stats(msg_queue *queue, msg_queue_stats *stats);
+
 /** Notify the consumer that there will not be any new messages */
 extern void msg_queue_shutdown(msg_queue *queue);
 
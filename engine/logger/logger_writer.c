@@ -0,0 +1,992 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TE project. Logger subsystem.
+ *
+ * Raw log file writer implementation.
+ *
+ * Every thread registering log messages has its own queue, so
+ * producers do not contend with each other. The writer thread
+ * periodically takes all the queued data and writes it to the raw
+ * log file with a single writev() call.
+ *
+ * The order of messages in the raw log must be the order of their
+ * registration, since RGT attaches a message to the test which is
+ * open at that point of the log. Each message gets a global sequence
+ * number when it is queued. Queues keep runs of messages with
+ * consecutive sequence numbers and the writer merges runs of all the
+ * queues by their sequence numbers.
+ *
+ * Along with the raw log the writer maintains its index (see
+ * te_raw_log_index_entry). Producers note candidate entries with
+ * offsets relative to their queues and the writer selects the ones
+ * to be written, since the final order of messages is known to it only.
+ *
+ * The raw log may be compressed as a sequence of independent gzip
+ * members (segments) with their offsets listed in a separate file
+ * (see te_raw_log_segment_entry). All the offsets used by the writer
+ * refer to decompressed data.
+ *
+ * The writer may log via TE logging API only when it does not hold
+ * file_lock, since the message is registered by the writer itself.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Raw log writer"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/uio.h>
+#if HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+
+#include "te_defs.h"
+#include "te_alloc.h"
+#include "te_dbuf.h"
+#include "te_queue.h"
+#include "te_raw_log.h"
+#include "logger_api.h"
+#include "logger_defs.h"
+#include "logger_writer.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/** Candidate raw log index entry */
+typedef struct lgr_writer_index_cand {
+    size_t                  offset; /**< Offset of the message in
+                                         the queue buffer */
+    te_raw_log_index_entry  entry;  /**< Entry without offset */
+} lgr_writer_index_cand;
+
+/** Run of queued messages with consecutive sequence numbers */
+typedef struct lgr_writer_run {
+    uint64_t    seq;    /**< Sequence number of the first message */
+    size_t      offset; /**< Offset of the first message in the queue
+                             buffer */
+} lgr_writer_run;
+
+/** Queue of messages registered by a single thread */
+typedef struct lgr_writer_queue {
+    SLIST_ENTRY(lgr_writer_queue) links;    /**< List links */
+
+    pthread_mutex_t lock;       /**< Protects the fields below */
+    pthread_cond_t  room;       /**< Signalled when @p pending is taken
+                                     by the writer */
+    te_dbuf         pending;    /**< Messages to be written */
+    te_dbuf         runs;       /**< Runs of messages in @p pending */
+    te_dbuf         index;      /**< Index entry candidates for
+                                     @p pending */
+    uint64_t        last_seq;   /**< Sequence number of the last
+                                     message */
+    te_log_id       last_id;    /**< Log ID of the last candidate */
+    size_t          last_off;   /**< Offset of the last candidate */
+    bool            orphaned;   /**< The owner thread has exited */
+
+    te_dbuf         spare;      /**< Buffer being written, owned by
+                                     the writer thread */
+    te_dbuf         spare_runs;     /**< Runs of messages in @p spare */
+    te_dbuf         spare_index;    /**< Index entry candidates for
+                                         @p spare */
+    size_t          spare_cand;     /**< First index entry candidate
+                                         of @p spare not written yet */
+} lgr_writer_queue;
+
+/** Part of a queue buffer to be written */
+typedef struct lgr_writer_chunk {
+    uint64_t            seq;    /**< Sequence number of the first
+                                     message */
+    lgr_writer_queue   *q;      /**< Queue */
+    size_t              start;  /**< Offset of the chunk in the
+                                     queue buffer */
+    size_t              end;    /**< Offset of the chunk end */
+} lgr_writer_chunk;
+
+/** Raw log file descriptor */
+static int writer_fd = -1;
+/** Raw log index file descriptor or @c -1 */
+static int writer_index_fd = -1;
+
+/**
+ * Serializes writing to the raw log and index files and protects
+ * the state below.
+ */
+static pthread_mutex_t file_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Current raw log file length */
+static uint64_t writer_offset = 0;
+/** Raw log offset of the last written index entry */
+static uint64_t index_last_off = 0;
+/** Log ID of the last message written */
+static te_log_id index_last_id = 0;
+/** Is an index entry written? */
+static bool index_started = false;
+/** Index entries to be written */
+static te_dbuf index_out = TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+/**
+ * Error of writing to the raw log files. Nothing is written
+ * after it.
+ */
+static int writer_errno = 0;
+
+/** Raw log segments file descriptor or @c -1 if it is not compressed */
+static int writer_seg_fd = -1;
+#if HAVE_ZLIB_H
+/** Compression stream of the current segment */
+static z_stream seg_stream;
+/** Is a segment started? */
+static bool seg_open = false;
+/** Length of decompressed data in the current segment */
+static size_t seg_len = 0;
+/** Current compressed raw log file length */
+static uint64_t writer_file_offset = 0;
+#endif
+
+/** Protects the writer state below */
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Wakes up the writer thread */
+static pthread_cond_t writer_wake = PTHREAD_COND_INITIALIZER;
+/** Signalled when the writer completes a pass */
+static pthread_cond_t writer_pass_done = PTHREAD_COND_INITIALIZER;
+
+/** List of all the producer queues */
+static SLIST_HEAD(, lgr_writer_queue) writer_queues =
+    SLIST_HEAD_INITIALIZER(writer_queues);
+
+/** Is the writer thread running? */
+static bool writer_running = false;
+/** Is the writer thread requested to stop? */
+static bool writer_stopping = false;
+/** Writer thread */
+static pthread_t writer_thread;
+
+/** Number of passes requested by lgr_writer_sync() */
+static uint64_t sync_requested = 0;
+/** Number of requested passes which are completed */
+static uint64_t sync_done = 0;
+
+/** Amount of queued data not taken by the writer yet */
+static size_t writer_queued = 0;
+
+/** Sequence number of the next queued message */
+static uint64_t writer_seq = 0;
+
+/** Number of threads which are queueing a message right now */
+static unsigned int writer_posters = 0;
+
+/** Thread-specific key of the producer queue */
+static pthread_key_t queue_key;
+
+/**
+ * Write I/O vector to a file completely. Nothing is written after
+ * a failure.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param fd            File descriptor.
+ * @param iov           I/O vector (modified).
+ * @param iovcnt        Number of elements in @p iov.
+ *
+ * @return Number of bytes written.
+ */
+static size_t
+writer_writev(int fd, struct iovec *iov, int iovcnt)
+{
+    size_t total = 0;
+
+    if (writer_errno != 0)
+        return 0;
+
+    while (iovcnt > 0)
+    {
+        ssize_t n = writev(fd, iov, MIN(iovcnt, IOV_MAX));
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            __atomic_store_n(&writer_errno, errno, __ATOMIC_RELAXED);
+            break;
+        }
+        total += n;
+
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (uint8_t *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+
+    return total;
+}
+
+/**
+ * Report the raw log write failure once. It is called by the writer
+ * thread only, since producers may hold the Logger's own logging lock.
+ *
+ * @note It must not be called under file_lock.
+ */
+static void
+writer_report_error(void)
+{
+    static bool reported = false;
+
+    int err = __atomic_load_n(&writer_errno, __ATOMIC_RELAXED);
+
+    if (err == 0 || __atomic_exchange_n(&reported, true, __ATOMIC_RELAXED))
+        return;
+
+    ERROR("Failed to write raw log, the next messages are lost: %r",
+          TE_OS_RC(TE_LOGGER, err));
+}
+
+#if HAVE_ZLIB_H
+/**
+ * Compress data and write the result to the raw log file.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param data          Data to compress.
+ * @param len           Data length.
+ * @param flush         Flush mode of deflate().
+ *
+ * @return @c true on success.
+ */
+static bool
+seg_deflate(const void *data, size_t len, int flush)
+{
+    static uint8_t out[1 << 16];
+
+    struct iovec iov;
+    int          rc;
+
+    seg_stream.next_in = (Bytef *)data;
+    seg_stream.avail_in = len;
+    do {
+        seg_stream.next_out = out;
+        seg_stream.avail_out = sizeof(out);
+        rc = deflate(&seg_stream, flush);
+        if (rc == Z_STREAM_ERROR)
+        {
+            fputs("Failed to compress raw log\n", stderr);
+            return false;
+        }
+
+        iov.iov_base = out;
+        iov.iov_len = sizeof(out) - seg_stream.avail_out;
+        writer_file_offset += writer_writev(writer_fd, &iov, 1);
+    } while (seg_stream.avail_out == 0);
+
+    return true;
+}
+
+/**
+ * Start a new segment of the compressed raw log.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param raw_offset    Decompressed data offset of the segment.
+ */
+static void
+seg_start(uint64_t raw_offset)
+{
+    te_raw_log_segment_entry entry;
+    struct iovec             iov = { .iov_base = &entry,
+                                     .iov_len = sizeof(entry) };
+
+    deflateReset(&seg_stream);
+
+    entry.raw_offset_hi = htonl(raw_offset >> 32);
+    entry.raw_offset_lo = htonl(raw_offset & UINT32_MAX);
+    entry.file_offset_hi = htonl(writer_file_offset >> 32);
+    entry.file_offset_lo = htonl(writer_file_offset & UINT32_MAX);
+    writer_writev(writer_seg_fd, &iov, 1);
+
+    seg_open = true;
+    seg_len = 0;
+}
+
+/**
+ * Finish the current segment of the compressed raw log.
+ *
+ * @note It should be called under file_lock only.
+ */
+static void
+seg_finish(void)
+{
+    seg_deflate(NULL, 0, Z_FINISH);
+    seg_open = false;
+}
+
+/**
+ * Compress I/O vector data to the raw log file. The data is flushed
+ * so that it may be decompressed completely by a reader.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param iov           I/O vector.
+ * @param iovcnt        Number of elements in @p iov.
+ *
+ * @return Number of bytes of decompressed data written.
+ */
+static size_t
+seg_write(const struct iovec *iov, int iovcnt)
+{
+    size_t total = 0;
+    int    i;
+
+    for (i = 0; i < iovcnt; i++)
+    {
+        const uint8_t *data = iov[i].iov_base;
+        size_t         len = iov[i].iov_len;
+        size_t         n;
+
+        while (len > 0)
+        {
+            if (!seg_open)
+                seg_start(writer_offset + total);
+
+            n = MIN(len, LGR_WRITER_SEGMENT_SIZE - seg_len);
+            if (!seg_deflate(data, n, Z_NO_FLUSH))
+                return total;
+
+            data += n;
+            len -= n;
+            total += n;
+            seg_len += n;
+
+            if (seg_len == LGR_WRITER_SEGMENT_SIZE)
+                seg_finish();
+        }
+    }
+
+    if (seg_open)
+        seg_deflate(NULL, 0, Z_SYNC_FLUSH);
+
+    return total;
+}
+#endif
+
+/**
+ * Write I/O vector data to the raw log file, compress it if
+ * required.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param iov           I/O vector (modified).
+ * @param iovcnt        Number of elements in @p iov.
+ *
+ * @return Number of bytes of raw log data written.
+ */
+static size_t
+raw_write(struct iovec *iov, int iovcnt)
+{
+    if (writer_errno != 0)
+        return 0;
+
+#if HAVE_ZLIB_H
+    if (writer_seg_fd >= 0)
+        return seg_write(iov, iovcnt);
+#endif
+    return writer_writev(writer_fd, iov, iovcnt);
+}
+
+/**
+ * Fill in an index entry from the raw log message header.
+ *
+ * @param buf           Message.
+ * @param len           Message length.
+ * @param entry         Entry to fill in (without offset).
+ *
+ * @return @c true if the message header is valid.
+ */
+static bool
+index_entry_parse(const uint8_t *buf, size_t len,
+                  te_raw_log_index_entry *entry)
+{
+    if (len < TE_LOG_MSG_COMMON_HDR_SZ + sizeof(te_log_id) ||
+        buf[0] != TE_LOG_VERSION)
+        return false;
+
+    buf += sizeof(te_log_version);
+    memcpy(&entry->ts_sec, buf, sizeof(entry->ts_sec));
+    buf += sizeof(entry->ts_sec);
+    memcpy(&entry->ts_usec, buf, sizeof(entry->ts_usec));
+    buf += sizeof(entry->ts_usec);
+    memcpy(&entry->level, buf, sizeof(entry->level));
+    buf += sizeof(entry->level);
+    memcpy(&entry->id, buf, sizeof(entry->id));
+    entry->reserved = 0;
+
+    return true;
+}
+
+/**
+ * Select index entries to be written from candidates and add them
+ * to the output buffer.
+ *
+ * @note It should be called under file_lock only.
+ *
+ * @param cands         Candidates.
+ * @param n_cands       Number of candidates.
+ * @param base          Raw log offset of the candidates data.
+ */
+static void
+index_add(const lgr_writer_index_cand *cands, size_t n_cands,
+          uint64_t base)
+{
+    te_raw_log_index_entry entry;
+    uint64_t               offset;
+    size_t                 i;
+
+    for (i = 0; i < n_cands; i++)
+    {
+        entry = cands[i].entry;
+        offset = base + cands[i].offset;
+
+        if (!index_started || entry.id != index_last_id ||
+            (ntohs(entry.level) & TE_LL_CONTROL) != 0 ||
+            offset - index_last_off >= TE_RAW_LOG_INDEX_PERIOD)
+        {
+            entry.offset_hi = htonl(offset >> 32);
+            entry.offset_lo = htonl(offset & UINT32_MAX);
+            if (te_dbuf_append(&index_out, &entry, sizeof(entry)) != 0)
+                return;
+
+            index_started = true;
+            index_last_off = offset;
+        }
+        index_last_id = entry.id;
+    }
+}
+
+/**
+ * Write index entries from the output buffer to the index file.
+ *
+ * @note It should be called under file_lock only.
+ */
+static void
+index_write(void)
+{
+    struct iovec iov = { .iov_base = index_out.ptr,
+                         .iov_len = index_out.len };
+
+    if (index_out.len == 0)
+        return;
+
+    writer_writev(writer_index_fd, &iov, 1);
+
+    te_dbuf_reset(&index_out);
+}
+
+/**
+ * Mark the queue of an exiting thread as orphaned. The queue is
+ * freed by the writer once its contents are written.
+ *
+ * @param value         Producer queue.
+ */
+static void
+queue_destructor(void *value)
+{
+    lgr_writer_queue *q = value;
+
+    pthread_mutex_lock(&q->lock);
+    q->orphaned = true;
+    pthread_mutex_unlock(&q->lock);
+}
+
+/**
+ * Get the queue of the calling thread, create it if necessary.
+ *
+ * @return Producer queue.
+ */
+static lgr_writer_queue *
+get_queue(void)
+{
+    lgr_writer_queue *q = pthread_getspecific(queue_key);
+
+    if (q != NULL)
+        return q;
+
+    q = TE_ALLOC(sizeof(*q));
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->room, NULL);
+    q->pending = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    q->runs = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    q->index = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    q->spare = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    q->spare_runs = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+    q->spare_index = (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+
+    pthread_mutex_lock(&writer_lock);
+    SLIST_INSERT_HEAD(&writer_queues, q, links);
+    pthread_mutex_unlock(&writer_lock);
+
+    pthread_setspecific(queue_key, q);
+
+    return q;
+}
+
+/**
+ * Add an index entry candidate for the message to be appended to
+ * the queue if the message may start a new index entry.
+ *
+ * @note It should be called under the queue lock only.
+ *
+ * @param q             Producer queue.
+ * @param buf           Message.
+ * @param len           Message length.
+ * @param new_run       Does the message start a new run? Messages
+ *                      of other queues may precede it in the raw log.
+ */
+static void
+queue_index(lgr_writer_queue *q, const void *buf, size_t len,
+            bool new_run)
+{
+    lgr_writer_index_cand cand = { .offset = q->pending.len };
+
+    if (!index_entry_parse(buf, len, &cand.entry))
+        return;
+
+    if (new_run || cand.entry.id != q->last_id ||
+        (ntohs(cand.entry.level) & TE_LL_CONTROL) != 0 ||
+        cand.offset - q->last_off >= TE_RAW_LOG_INDEX_PERIOD)
+    {
+        if (te_dbuf_append(&q->index, &cand, sizeof(cand)) != 0)
+            return;
+        q->last_id = cand.entry.id;
+        q->last_off = cand.offset;
+    }
+}
+
+/**
+ * Free the queue. It must be removed from the list already.
+ *
+ * @param q             Producer queue.
+ */
+static void
+free_queue(lgr_writer_queue *q)
+{
+    te_dbuf_free(&q->pending);
+    te_dbuf_free(&q->runs);
+    te_dbuf_free(&q->index);
+    te_dbuf_free(&q->spare);
+    te_dbuf_free(&q->spare_runs);
+    te_dbuf_free(&q->spare_index);
+    pthread_cond_destroy(&q->room);
+    pthread_mutex_destroy(&q->lock);
+    free(q);
+}
+
+/**
+ * Compare chunks by sequence numbers of their first messages.
+ *
+ * @param a             The first chunk.
+ * @param b             The second chunk.
+ *
+ * @return Result of comparison as required by qsort().
+ */
+static int
+chunk_cmp(const void *a, const void *b)
+{
+    uint64_t seq_a = ((const lgr_writer_chunk *)a)->seq;
+    uint64_t seq_b = ((const lgr_writer_chunk *)b)->seq;
+
+    return seq_a < seq_b ? -1 : seq_a > seq_b;
+}
+
+/**
+ * Take all the queued data and write it to the raw log file in
+ * the order of registration.
+ * It is called by the writer thread only.
+ *
+ * @param locked        Is file_lock held by the caller?
+ */
+static void
+writer_pass(bool locked)
+{
+    static struct iovec      *iov = NULL;
+    static lgr_writer_chunk  *chunks = NULL;
+    static size_t             max_chunks = 0;
+
+    lgr_writer_queue  **prev;
+    lgr_writer_queue   *q;
+    size_t              n_chunks = 0;
+    size_t              total = 0;
+    uint64_t            base;
+    size_t              i;
+
+    pthread_mutex_lock(&writer_lock);
+    /*
+     * All the queues are locked at once, so every message left in
+     * the queues is registered after all the taken ones.
+     */
+    SLIST_FOREACH(q, &writer_queues, links)
+        pthread_mutex_lock(&q->lock);
+
+    for (prev = &SLIST_FIRST(&writer_queues); (q = *prev) != NULL; )
+    {
+        const lgr_writer_run   *runs;
+        size_t                  n_runs;
+        te_dbuf                 tmp;
+        bool                    orphaned;
+
+        tmp = q->pending;
+        q->pending = q->spare;
+        q->spare = tmp;
+        tmp = q->runs;
+        q->runs = q->spare_runs;
+        q->spare_runs = tmp;
+        tmp = q->index;
+        q->index = q->spare_index;
+        q->spare_index = tmp;
+        q->spare_cand = 0;
+        orphaned = q->orphaned;
+        pthread_cond_broadcast(&q->room);
+        pthread_mutex_unlock(&q->lock);
+
+        if (q->spare.len == 0 && orphaned)
+        {
+            *prev = SLIST_NEXT(q, links);
+            free_queue(q);
+            continue;
+        }
+
+        runs = (const lgr_writer_run *)q->spare_runs.ptr;
+        n_runs = q->spare_runs.len / sizeof(*runs);
+        for (i = 0; i < n_runs; i++)
+        {
+            if (n_chunks == max_chunks)
+            {
+                max_chunks = MAX(max_chunks * 2, 16);
+                TE_REALLOC(chunks, max_chunks * sizeof(*chunks));
+                TE_REALLOC(iov, max_chunks * sizeof(*iov));
+            }
+            chunks[n_chunks].seq = runs[i].seq;
+            chunks[n_chunks].q = q;
+            chunks[n_chunks].start = runs[i].offset;
+            chunks[n_chunks].end = i + 1 < n_runs ? runs[i + 1].offset :
+                                                    q->spare.len;
+            n_chunks++;
+        }
+        total += q->spare.len;
+
+        prev = &SLIST_NEXT(q, links);
+    }
+    pthread_mutex_unlock(&writer_lock);
+
+    if (n_chunks == 0)
+        return;
+
+    __atomic_sub_fetch(&writer_queued, total, __ATOMIC_RELAXED);
+
+    qsort(chunks, n_chunks, sizeof(*chunks), chunk_cmp);
+
+    /*
+     * Taken queues cannot be freed until the next pass, so their
+     * spare buffers may be accessed without the lock.
+     */
+    if (!locked)
+        pthread_mutex_lock(&file_lock);
+    base = writer_offset;
+    for (i = 0; i < n_chunks; i++)
+    {
+        lgr_writer_chunk            *c = &chunks[i];
+        const lgr_writer_index_cand *cands;
+        size_t                       n_cands;
+        size_t                       first = c->q->spare_cand;
+
+        iov[i].iov_base = c->q->spare.ptr + c->start;
+        iov[i].iov_len = c->end - c->start;
+
+        if (writer_index_fd >= 0)
+        {
+            cands = (const lgr_writer_index_cand *)c->q->spare_index.ptr;
+            n_cands = c->q->spare_index.len / sizeof(*cands);
+            while (c->q->spare_cand < n_cands &&
+                   cands[c->q->spare_cand].offset < c->end)
+                c->q->spare_cand++;
+
+            index_add(cands + first, c->q->spare_cand - first,
+                      base - c->start);
+        }
+        base += iov[i].iov_len;
+    }
+    writer_offset += raw_write(iov, n_chunks);
+    index_write();
+    if (!locked)
+    {
+        pthread_mutex_unlock(&file_lock);
+        writer_report_error();
+    }
+
+    for (i = 0; i < n_chunks; i++)
+    {
+        te_dbuf_reset(&chunks[i].q->spare);
+        te_dbuf_reset(&chunks[i].q->spare_runs);
+        te_dbuf_reset(&chunks[i].q->spare_index);
+    }
+}
+
+/**
+ * Entry point of the writer thread.
+ *
+ * @param arg           Unused.
+ *
+ * @return @c NULL
+ */
+static void *
+writer_loop(void *arg)
+{
+    bool     stop;
+    uint64_t requested;
+
+    UNUSED(arg);
+
+    pthread_mutex_lock(&writer_lock);
+    do {
+        if (!writer_stopping && sync_requested == sync_done &&
+            __atomic_load_n(&writer_queued, __ATOMIC_RELAXED) <
+                LGR_WRITER_BATCH_SIZE)
+        {
+            struct timespec deadline;
+
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += LGR_WRITER_LATENCY_MS / 1000;
+            deadline.tv_nsec += TE_MS2NS(LGR_WRITER_LATENCY_MS % 1000);
+            if (deadline.tv_nsec >= TE_SEC2NS(1))
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= TE_SEC2NS(1);
+            }
+            pthread_cond_timedwait(&writer_wake, &writer_lock, &deadline);
+        }
+
+        stop = writer_stopping;
+        requested = sync_requested;
+        pthread_mutex_unlock(&writer_lock);
+
+        writer_pass(false);
+
+        pthread_mutex_lock(&writer_lock);
+        sync_done = requested;
+        pthread_cond_broadcast(&writer_pass_done);
+    } while (!stop);
+
+    /*
+     * Producers check the flag under the queue lock, so after
+     * the final pass below nothing is added to the queues. Producers
+     * which see the flag cleared write to the file directly, so
+     * the file is locked until the queued messages are written.
+     */
+    pthread_mutex_lock(&file_lock);
+    __atomic_store_n(&writer_running, false, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&writer_lock);
+
+    writer_pass(true);
+    pthread_mutex_unlock(&file_lock);
+    writer_report_error();
+
+    return NULL;
+}
+
+/* See description in logger_writer.h */
+void
+lgr_writer_init(int fd, int index_fd)
+{
+    off_t offset = lseek(fd, 0, SEEK_END);
+
+    writer_fd = fd;
+    writer_offset = offset < 0 ? 0 : offset;
+    writer_index_fd = index_fd;
+}
+
+/* See description in logger_writer.h */
+te_errno
+lgr_writer_compress(int seg_fd)
+{
+#if HAVE_ZLIB_H
+    off_t offset = lseek(writer_fd, 0, SEEK_END);
+
+    /* Window bits are increased by 16 to produce gzip format */
+    if (deflateInit2(&seg_stream, LGR_WRITER_COMPRESS_LEVEL, Z_DEFLATED,
+                     MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return TE_RC(TE_LOGGER, TE_ENOMEM);
+
+    writer_file_offset = offset < 0 ? 0 : offset;
+    writer_seg_fd = seg_fd;
+
+    return 0;
+#else
+    UNUSED(seg_fd);
+    return TE_RC(TE_LOGGER, TE_EOPNOTSUPP);
+#endif
+}
+
+/* See description in logger_writer.h */
+te_errno
+lgr_writer_start(void)
+{
+    int rc;
+
+    rc = pthread_key_create(&queue_key, queue_destructor);
+    if (rc != 0)
+        return TE_OS_RC(TE_LOGGER, rc);
+
+    __atomic_store_n(&writer_running, true, __ATOMIC_RELAXED);
+    rc = pthread_create(&writer_thread, NULL, writer_loop, NULL);
+    if (rc != 0)
+    {
+        __atomic_store_n(&writer_running, false, __ATOMIC_RELAXED);
+        pthread_key_delete(queue_key);
+        return TE_OS_RC(TE_LOGGER, rc);
+    }
+
+    return 0;
+}
+
+/* See description in logger_writer.h */
+void
+lgr_writer_post(const void *buf, size_t len)
+{
+    lgr_writer_queue *q;
+    lgr_writer_run    run;
+    bool              new_run;
+    size_t            queued;
+
+    /* lgr_writer_stop() waits for queueing threads to free queues */
+    __atomic_add_fetch(&writer_posters, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&writer_running, __ATOMIC_SEQ_CST))
+    {
+        q = get_queue();
+
+        pthread_mutex_lock(&q->lock);
+        while (q->pending.len >= LGR_WRITER_QUEUE_MAX && writer_running)
+            pthread_cond_wait(&q->room, &q->lock);
+
+        if (writer_running)
+        {
+            run.seq = __atomic_fetch_add(&writer_seq, 1, __ATOMIC_RELAXED);
+            run.offset = q->pending.len;
+            new_run = q->pending.len == 0 || run.seq != q->last_seq + 1;
+            q->last_seq = run.seq;
+
+            if (new_run &&
+                te_dbuf_append(&q->runs, &run, sizeof(run)) != 0)
+            {
+                fputs("Failed to queue raw log message\n", stderr);
+            }
+            else
+            {
+                if (writer_index_fd >= 0)
+                    queue_index(q, buf, len, new_run);
+                if (te_dbuf_append(&q->pending, buf, len) != 0)
+                    fputs("Failed to queue raw log message\n", stderr);
+            }
+            pthread_mutex_unlock(&q->lock);
+            __atomic_sub_fetch(&writer_posters, 1, __ATOMIC_SEQ_CST);
+
+            queued = __atomic_add_fetch(&writer_queued, len,
+                                        __ATOMIC_RELAXED);
+            if (queued >= LGR_WRITER_BATCH_SIZE &&
+                queued - len < LGR_WRITER_BATCH_SIZE)
+            {
+                pthread_mutex_lock(&writer_lock);
+                pthread_cond_signal(&writer_wake);
+                pthread_mutex_unlock(&writer_lock);
+            }
+            return;
+        }
+        pthread_mutex_unlock(&q->lock);
+    }
+    __atomic_sub_fetch(&writer_posters, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_lock(&file_lock);
+    if (writer_index_fd >= 0)
+    {
+        lgr_writer_index_cand cand = { .offset = 0 };
+
+        if (index_entry_parse(buf, len, &cand.entry))
+            index_add(&cand, 1, writer_offset);
+    }
+    writer_offset += raw_write(&(struct iovec){ .iov_base = (void *)buf,
+                                                .iov_len = len }, 1);
+    index_write();
+    pthread_mutex_unlock(&file_lock);
+}
+
+/* See description in logger_writer.h */
+void
+lgr_writer_sync(void)
+{
+    uint64_t ticket;
+
+    pthread_mutex_lock(&writer_lock);
+    ticket = ++sync_requested;
+    pthread_cond_signal(&writer_wake);
+    while (writer_running && sync_done < ticket)
+        pthread_cond_wait(&writer_pass_done, &writer_lock);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+/* See description in logger_writer.h */
+te_errno
+lgr_writer_stop(void)
+{
+    lgr_writer_queue *q;
+    int               rc;
+
+    pthread_mutex_lock(&writer_lock);
+    if (!writer_running)
+    {
+        pthread_mutex_unlock(&writer_lock);
+        return 0;
+    }
+    writer_stopping = true;
+    pthread_cond_signal(&writer_wake);
+    pthread_mutex_unlock(&writer_lock);
+
+    rc = pthread_join(writer_thread, NULL);
+    if (rc != 0)
+        return TE_OS_RC(TE_LOGGER, rc);
+
+    /*
+     * Threads which have seen the writer running are done with
+     * their queues when the counter drops to zero, and later ones
+     * write to the file directly.
+     */
+    while (__atomic_load_n(&writer_posters, __ATOMIC_SEQ_CST) != 0)
+        sched_yield();
+
+    pthread_key_delete(queue_key);
+    while ((q = SLIST_FIRST(&writer_queues)) != NULL)
+    {
+        SLIST_REMOVE_HEAD(&writer_queues, links);
+        free_queue(q);
+    }
+
+#if HAVE_ZLIB_H
+    /* Messages written after that start a new segment */
+    pthread_mutex_lock(&file_lock);
+    if (seg_open)
+        seg_finish();
+    pthread_mutex_unlock(&file_lock);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief TE project. Logger subsystem.
+ *
+ * Raw log file writer: log messages registered by Logger threads
+ * are collected in per-thread queues and written to the raw log
+ * file in large batches by a dedicated thread in the order of
+ * registration. If writing fails, the error is logged and nothing
+ * is written after it. The raw log index
+ * is written along with it.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_LOGGER_WRITER_H__
+#define __TE_LOGGER_WRITER_H__
+
+#include "te_defs.h"
+#include "te_errno.h"
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximum time in milliseconds a message may stay in a queue
+ * before it is written to the raw log file.
+ */
+#define LGR_WRITER_LATENCY_MS   100
+
+/**
+ * Amount of queued data in bytes which wakes up the writer
+ * before #LGR_WRITER_LATENCY_MS expires.
+ */
+#define LGR_WRITER_BATCH_SIZE   (1 << 20)
+
+/**
+ * Amount of data in bytes in a single producer queue after which
+ * the producer waits for the writer to catch up.
+ */
+#define LGR_WRITER_QUEUE_MAX    (64 << 20)
+
+/** Amount of raw log data in bytes in a compressed raw log segment */
+#define LGR_WRITER_SEGMENT_SIZE (4 << 20)
+
+/** Compression level of the raw log, the fastest one is used */
+#define LGR_WRITER_COMPRESS_LEVEL   1
+
+/**
+ * Set the raw log file descriptor. Until the writer thread is
+ * started, messages are written to the file directly.
+ *
+ * @param fd            Raw log file descriptor opened for appending.
+ * @param index_fd      Raw log index file descriptor opened for
+ *                      appending or @c -1 if the index is not needed.
+ */
+extern void lgr_writer_init(int fd, int index_fd);
+
+/**
+ * Write the raw log compressed in independent segments (see
+ * te_raw_log_segment_entry). It should be called after
+ * lgr_writer_init() before any message is posted.
+ *
+ * @param seg_fd        Raw log segments file descriptor opened for
+ *                      appending.
+ *
+ * @return Status code.
+ * @retval TE_EOPNOTSUPP    The Logger is built without zlib.
+ */
+extern te_errno lgr_writer_compress(int seg_fd);
+
+/**
+ * Start the writer thread.
+ *
+ * @return Status code.
+ */
+extern te_errno lgr_writer_start(void);
+
+/**
+ * Queue a message to be written to the raw log file.
+ * A copy of the message is made. Messages are written in the order
+ * of the calls, regardless of the calling threads.
+ *
+ * @param buf           Message.
+ * @param len           Message length.
+ */
+extern void lgr_writer_post(const void *buf, size_t len);
+
+/**
+ * Wait until all the messages queued before the call are written
+ * to the raw log file.
+ */
+extern void lgr_writer_sync(void);
+
+/**
+ * Write all the queued messages, stop the writer thread and free
+ * the queues. Messages posted after that are written to the file
+ * directly.
+ *
+ * @return Status code.
+ */
+extern te_errno lgr_writer_stop(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* __TE_LOGGER_WRITER_H__ */
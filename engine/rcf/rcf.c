@@ -46,6 +46,12 @@
 #ifdef HAVE_SIGNAL_H
 #include <signal.h>
 #endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
 #if HAVE_POPT_H
 #include <popt.h>
 #else
@@ -57,17 +63,22 @@
 #include <libxml/xinclude.h>
 
 #include <dlfcn.h>
+#include <poll.h>
+#include <sys/epoll.h>
 
 #include "te_alloc.h"
+#include "te_dbuf.h"
 #include "te_stdint.h"
 #include "te_printf.h"
 #include "te_str.h"
+#include "te_time.h"
 #include "rcf.h"
 #include "rcf_tce_parser.h"
 
 #define RCF_NEED_TYPES      1
 #define RCF_NEED_TYPE_LEN   1
 #include "te_proto.h"
+#include "rcf_proto_bin.h"
 
 #include "logger_api.h"
 #include "logger_ten.h"
@@ -98,6 +109,15 @@ ta_check ta_checker;
 #define RCF_FOREGROUND  0x01    /**< Flag to run RCF in foreground */
 static unsigned int flags = 0;  /**< Global flags */
 
+/** Default maximum number of Test Agents started or finished concurrently */
+#define RCF_START_PARALLEL_DEF  8
+
+/** Maximum number of Test Agents started or finished concurrently */
+static int start_parallel = RCF_START_PARALLEL_DEF;
+
+/** Command line option value of --start-parallel */
+#define RCF_OPT_START_PARALLEL  1
+
 static const char *tce_conf_file = NULL;    /**< The TCE configuration file. */
 static rcf_tce_conf_t *tce_conf = NULL;     /**< The TCE configuration. */
 
@@ -110,12 +130,37 @@ static int shutdown_num = 0;    /**< Number of TA which should be
 static struct ipc_server *server = NULL;    /**< IPC Server handle */
 
 static char cmd[RCF_MAX_LEN];   /**< Test Protocol command location */
+static uint8_t cmd_bin[RCF_MAX_LEN];    /**< Binary encoded command */
+static size_t  cmd_bin_len = 0;         /**< Length of the binary encoded
+                                             command attached to @ref cmd
+                                             or @c 0 */
 static char names[RCF_MAX_LEN - sizeof(rcf_msg)];   /**< TA names */
+
+/** Length of the buffer used to transfer file contents */
+#define RCF_FILE_BUF_LEN    (1024 * 1024)
+
+/** Buffer used to transfer file contents (allocated on demand) */
+static char *file_buf = NULL;
+/** Buffer for user requests received via IPC */
+static te_dbuf request_buf = TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
+/** Buffer for answers to user requests in compact layout */
+static te_dbuf answer_buf = TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
 static int  names_len = 0;      /**< Length of TA name list */
 
-/* Backup select parameters */
+/** Interval of polling Test Agents */
 struct timeval tv0;
-fd_set set0;
+
+/**
+ * epoll set watching IPC server file descriptors and @ref ta_epfd.
+ * Test Agent connections are kept in a separate nested set, so that
+ * they may be waited for without IPC clients (e.g. on shutdown).
+ */
+static int rcf_epfd = -1;
+/** epoll set watching connections of Test Agents */
+static int ta_epfd = -1;
+
+/** Maximum number of events retrieved by a single epoll_wait() */
+#define RCF_MAX_EVENTS  64
 
 /** Name of directory for temporary files */
 static char *tmp_dir;
@@ -162,6 +207,7 @@ free_ta_list(void)
         }
 
         free(agent->cold_reboot_ta);
+        rcf_stats_free(agent);
         free(agent);
     }
     agents = NULL;
@@ -195,6 +241,155 @@ rcf_find_user_request(usrreq *req, int sid)
     return NULL;
 }
 
+/**
+ * Get timeout of waiting for events in milliseconds.
+ *
+ * @return Timeout corresponding to @ref tv0.
+ */
+static int
+rcf_poll_timeout(void)
+{
+    return TE_SEC2MS(tv0.tv_sec) + TE_US2MS(tv0.tv_usec);
+}
+
+/**
+ * Add or remove IPC server file descriptor to/from the epoll set.
+ *
+ * @param fd        File descriptor
+ * @param added     Whether @p fd is opened or is going to be closed
+ * @param opaque    Unused
+ */
+static void
+rcf_ipc_fd_handler(int fd, bool added, void *opaque)
+{
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+
+    UNUSED(opaque);
+
+    if (epoll_ctl(rcf_epfd, added ? EPOLL_CTL_ADD : EPOLL_CTL_DEL,
+                  fd, &ev) != 0)
+    {
+        ERROR("Failed to %s IPC file descriptor %d: %r",
+              added ? "watch" : "unwatch", fd, TE_OS_RC(TE_RCF, errno));
+    }
+}
+
+/**
+ * Create epoll sets and start watching IPC server file descriptors.
+ *
+ * @return Status code
+ */
+static te_errno
+rcf_events_init(void)
+{
+    struct epoll_event ev = { .events = EPOLLIN };
+
+    rcf_epfd = epoll_create1(EPOLL_CLOEXEC);
+    ta_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (rcf_epfd < 0 || ta_epfd < 0)
+    {
+        ERROR("Failed to create epoll set: %r", TE_OS_RC(TE_RCF, errno));
+        return TE_RC(TE_RCF, TE_EFAIL);
+    }
+
+    ev.data.fd = ta_epfd;
+    if (epoll_ctl(rcf_epfd, EPOLL_CTL_ADD, ta_epfd, &ev) != 0)
+    {
+        ERROR("Failed to add TA epoll set: %r", TE_OS_RC(TE_RCF, errno));
+        return TE_RC(TE_RCF, TE_EFAIL);
+    }
+
+    ipc_server_set_fd_handler(server, rcf_ipc_fd_handler, NULL);
+
+    return 0;
+}
+
+/**
+ * Stop watching IPC server and release epoll sets.
+ */
+static void
+rcf_events_fini(void)
+{
+    ipc_server_set_fd_handler(server, NULL, NULL);
+
+    if (rcf_epfd >= 0)
+        close(rcf_epfd);
+    if (ta_epfd >= 0)
+        close(ta_epfd);
+    rcf_epfd = ta_epfd = -1;
+}
+
+/**
+ * Start watching the Test Agent connection for incoming data.
+ * If the TA library does not provide a file descriptor, is_ready()
+ * method is polled instead.
+ *
+ * @param agent     Test Agent
+ */
+static void
+rcf_ta_watch(ta *agent)
+{
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = agent };
+    int                fd;
+
+    if (agent->m.get_fd == NULL)
+        return;
+
+    fd = (agent->m.get_fd)(agent->handle);
+    if (fd < 0)
+        return;
+
+    if (epoll_ctl(ta_epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        WARN("Failed to watch connection with TA '%s', it will be "
+             "polled: %r", agent->name, TE_OS_RC(TE_RCF, errno));
+        return;
+    }
+
+    agent->fd = fd;
+    agent->fd_watched = true;
+}
+
+/* See description in rcf.h */
+void
+rcf_ta_unwatch(ta *agent)
+{
+    if (!agent->fd_watched)
+        return;
+
+    if (epoll_ctl(ta_epfd, EPOLL_CTL_DEL, agent->fd, NULL) != 0)
+    {
+        WARN("Failed to unwatch connection with TA '%s': %r",
+             agent->name, TE_OS_RC(TE_RCF, errno));
+    }
+
+    agent->fd_watched = false;
+    agent->fd_ready = false;
+}
+
+/* See description in rcf.h */
+te_errno
+rcf_ta_close(ta *agent)
+{
+    rcf_ta_unwatch(agent);
+    return (agent->m.close)(agent->handle, NULL);
+}
+
+/* See description in rcf.h */
+bool
+rcf_ta_wait_ready(ta *agent)
+{
+    struct pollfd pfd = { .fd = -1, .events = POLLIN };
+
+    if (agent->m.get_fd != NULL)
+        pfd.fd = (agent->m.get_fd)(agent->handle);
+
+    /* A negative descriptor is ignored, so poll() just sleeps then */
+    (void)poll(&pfd, 1, rcf_poll_timeout());
+
+    return (agent->m.is_ready)(agent->handle);
+}
+
 /**
  * Load shared library to control the Test Agent and resolve method
  * routines.
@@ -698,8 +893,6 @@ parse_config(const char *filename)
 static int
 consume_answer(ta *agent)
 {
-    struct timeval tv;
-    fd_set         set;
     time_t         t0, t;
 
     t = t0 = time(NULL);
@@ -707,10 +900,7 @@ consume_answer(ta *agent)
     {
         char *ba;
 
-        set = set0;
-        tv = tv0;
-        select(FD_SETSIZE, &set, NULL, NULL, &tv);
-        if ((agent->m.is_ready)(agent->handle))
+        if (rcf_ta_wait_ready(agent))
         {
             size_t len = sizeof(cmd);
 
@@ -780,6 +970,56 @@ rcf_consistency_check(ta* agent)
     return -1;
 }
 
+/**
+ * Find out whether the Test Agent supports binary encoding of commands
+ * and enable it unless @c TE_RCF_PROTOCOL environment variable requests
+ * text encoding.
+ *
+ * @param agent     Test Agent structure
+ *
+ * @return @c 0 (success) or @c -1 (failure)
+ */
+static int
+rcf_proto_negotiate(ta *agent)
+{
+    const char *env = getenv("TE_RCF_PROTOCOL");
+    int         rc;
+    char       *ptr;
+
+    agent->proto_bin_supported = false;
+    agent->proto_bin = false;
+
+    TE_SPRINTF(cmd, "%s %s string", TE_PROTO_VREAD, RCF_PROTO_VAR);
+    if ((rc = (agent->m.transmit)(agent->handle,
+                                  cmd, strlen(cmd) + 1)) != 0)
+    {
+        ERROR("Failed to transmit command to TA '%s' error=%r",
+              agent->name, rc);
+        return -1;
+    }
+
+    if (consume_answer(agent) != 0)
+        return -1;
+
+    rc = strtol(cmd, &ptr, 10);
+    if (cmd == ptr || rc != 0)
+    {
+        VERB("TA '%s' supports text encoding of commands only",
+             agent->name);
+        return 0;
+    }
+
+    /* Answer is a quoted list of encodings */
+    agent->proto_bin_supported = (strstr(ptr, TE_PROTO_BINARY) != NULL);
+    agent->proto_bin = agent->proto_bin_supported &&
+                       (env == NULL || strcmp(env, RCF_PROTO_TEXT) != 0);
+
+    INFO("TA '%s' supports%s, %s encoding of commands is used",
+         agent->name, ptr, agent->proto_bin ? TE_PROTO_BINARY :
+                                              RCF_PROTO_TEXT);
+    return 0;
+}
+
 /**
  * Send time synchronization command to the Test Agent and wait an answer
  *
@@ -837,6 +1077,8 @@ rcf_answer_user_request(usrreq *req)
     if (req->message->error != 0)
         req->message->data_len = 0;
 
+    rcf_stats_answer(req);
+
     if (req->user != NULL)
     {
         int rc;
@@ -848,8 +1090,17 @@ rcf_answer_user_request(usrreq *req)
              rcf_op_to_string(req->message->opcode),
              ipc_server_client_name(req->user));
 
-        rc = ipc_send_answer(server, req->user, (char *)req->message,
-                             sizeof(rcf_msg) + req->message->data_len);
+        if (req->packed)
+        {
+            rcf_msg_pack(req->message, &answer_buf, NULL);
+            rc = ipc_send_answer(server, req->user, answer_buf.ptr,
+                                 answer_buf.len);
+        }
+        else
+        {
+            rc = ipc_send_answer(server, req->user, (char *)req->message,
+                                 sizeof(rcf_msg) + req->message->data_len);
+        }
         if (rc != 0)
         {
             ERROR("Cannot send an answer to user: error=%r", rc);
@@ -959,7 +1210,7 @@ rcf_set_ta_dead(ta *agent)
         ERROR("TA '%s' is dead", agent->name);
         rcf_answer_all_requests(&(agent->sent), TE_ETADEAD);
         rcf_answer_all_requests(&(agent->waiting), TE_ETADEAD);
-        rc = (agent->m.close)(agent->handle, &set0);
+        rc = rcf_ta_close(agent);
         if (rc != 0)
             ERROR("Failed to close connection with TA '%s': rc=%r",
                   agent->name, rc);
@@ -984,11 +1235,12 @@ rcf_set_ta_unrecoverable(ta *agent)
 
             if (~agent->flags & TA_DEAD)
             {
-                rc = (agent->m.close)(agent->handle, &set0);
+                rc = rcf_ta_close(agent);
                 if (rc != 0)
                     ERROR("Failed to close connection with TA '%s': "
                           "rc=%r", agent->name, rc);
             }
+            rcf_ta_unwatch(agent);
             rc = (agent->m.finish)(agent->handle, NULL);
             if (rc != 0)
                 ERROR("Failed to finish TA '%s': rc=%r",
@@ -999,20 +1251,66 @@ rcf_set_ta_unrecoverable(ta *agent)
     }
 }
 
-/* See description in rcf.h */
-int
-rcf_init_agent(ta *agent)
+/**
+ * Job on a Test Agent which may be run concurrently with jobs on other
+ * Test Agents (start or finish via TA-specific methods).
+ */
+typedef struct ta_job {
+    ta             *agent;      /**< Test Agent */
+    te_errno        rc;         /**< Status of the job */
+    bool            started;    /**< start() method succeeded */
+    struct timeval  ts;         /**< Timestamp of the current phase
+                                     start */
+    double          start_sec;  /**< Duration of start() method call
+                                     (image copy and TA launch) */
+    double          connect_sec; /**< Duration of connect() method call */
+} ta_job;
+
+/**
+ * Get time elapsed since the timestamp and update the timestamp.
+ *
+ * @param ts            Timestamp
+ *
+ * @return Elapsed time in seconds.
+ */
+static double
+rcf_lap_time(struct timeval *ts)
 {
-    int       rc;
+    struct timeval now;
+    struct timeval diff;
+
+    gettimeofday(&now, NULL);
+    te_timersub(&now, ts, &diff);
+    *ts = now;
+
+    return diff.tv_sec + diff.tv_usec / 1000000.0;
+}
+
+/**
+ * Start a Test Agent and connect to it. Only TA-specific methods are
+ * called, so that it may be done concurrently for several Test Agents.
+ *
+ * @param job           Job of the Test Agent
+ */
+static void
+rcf_ta_start(ta_job *job)
+{
+    ta       *agent = job->agent;
+    te_errno  rc;
     te_string str = TE_STRING_INIT;
     rcf_talib_param param = {
         .tce_conf = tce_conf,
     };
 
+    job->started = false;
+    job->start_sec = job->connect_sec = 0;
+    gettimeofday(&job->ts, NULL);
+
     if ((rc = te_kvpair_to_str(&agent->conf, &str)) != 0)
     {
         te_string_free(&str);
-        return rc;
+        job->rc = rc;
+        return;
     }
 
     INFO("Start TA '%s' type=%s confstr='%s'",
@@ -1022,36 +1320,64 @@ rcf_init_agent(ta *agent)
     if (agent->flags & TA_FAKE)
         RING("TA '%s' has been already started", agent->name);
 
-    /* Initially mark TA as dead - no valid connection */
-    agent->flags |= TA_DEAD;
-
-    if ((rc = (agent->m.start)(agent->name, agent->type, &param,
-                               &agent->conf, &(agent->handle),
-                               &(agent->flags))) != 0)
+    rc = (agent->m.start)(agent->name, agent->type, &param,
+                          &agent->conf, &(agent->handle), &(agent->flags));
+    job->start_sec = rcf_lap_time(&job->ts);
+    if (rc != 0)
     {
         RING("Cannot (re-)initialize TA '%s' error=%r",
               agent->name, rc);
+        job->rc = rc;
+        return;
+    }
+    job->started = true;
+
+    INFO("TA '%s' started, trying to connect", agent->name);
+    rc = (agent->m.connect)(agent->handle, NULL, &tv0);
+    job->connect_sec = rcf_lap_time(&job->ts);
+    if (rc != 0)
+        ERROR("Cannot connect to TA '%s' error=%r", agent->name, rc);
 
+    job->rc = rc;
+}
+
+/**
+ * Complete initialization of the started Test Agent: check consistency,
+ * synchronize time and run startup tasks. Startup timing is reported.
+ * Test Agent is marked as "unrecoverable dead" in the case of failure.
+ *
+ * @param job           Job of the Test Agent started by rcf_ta_start()
+ *
+ * @return Status code
+ */
+static int
+rcf_ta_setup(ta_job *job)
+{
+    ta  *agent = job->agent;
+    int  rc = job->rc;
+
+    if (rc != 0)
+    {
         /*
          * It's OK if the agent can't initialize in the REBOOTING state,
          * since it can do it so in the next reboot type.
          */
-        if (agent->reboot_ctx.state != TA_REBOOT_STATE_REBOOTING)
+        if (job->started ||
+            agent->reboot_ctx.state != TA_REBOOT_STATE_REBOOTING)
             rcf_set_ta_unrecoverable(agent);
 
         return rc;
     }
-    INFO("TA '%s' started, trying to connect", agent->name);
-    if ((rc = (agent->m.connect)(agent->handle, &set0, &tv0)) != 0)
-    {
-        ERROR("Cannot connect to TA '%s' error=%r", agent->name, rc);
-        rcf_set_ta_unrecoverable(agent);
-        return rc;
-    }
+
+    /* Initialization may be done later than connection */
+    gettimeofday(&job->ts, NULL);
+
+    rcf_ta_watch(agent);
     agent->flags &= ~(TA_DEAD | TA_REBOOTING);
     INFO("Connected with TA '%s'", agent->name);
 
-    if ((rc = rcf_consistency_check(agent)) != 0)
+    if ((rc = rcf_consistency_check(agent)) != 0 ||
+        (rc = rcf_proto_negotiate(agent)) != 0)
     {
         rcf_set_ta_unrecoverable(agent);
         return rc;
@@ -1068,7 +1394,213 @@ rcf_init_agent(ta *agent)
     else
         agent->conn_locked = false;
 
-    return rc;
+    RING("TA '%s' startup time: start %.3f s, connect %.3f s, "
+         "initialization %.3f s", agent->name, job->start_sec,
+         job->connect_sec, rcf_lap_time(&job->ts));
+
+    return rc;
+}
+
+/**
+ * Prepare the Test Agent to be (re-)started.
+ *
+ * @param agent         Test Agent structure
+ */
+static void
+rcf_ta_prepare_start(ta *agent)
+{
+    /* Initially mark TA as dead - no valid connection */
+    agent->flags |= TA_DEAD;
+    rcf_ta_unwatch(agent);
+}
+
+/* See description in rcf.h */
+int
+rcf_init_agent(ta *agent)
+{
+    ta_job job = { .agent = agent };
+
+    rcf_ta_prepare_start(agent);
+    rcf_ta_start(&job);
+
+    return rcf_ta_setup(&job);
+}
+
+/** Pool of threads running jobs on Test Agents */
+typedef struct ta_job_pool {
+    ta_job             *jobs;       /**< Jobs */
+    unsigned int        n_jobs;     /**< Number of jobs */
+    unsigned int        next;       /**< Index of the next job to run */
+    void              (*func)(ta_job *job); /**< Job function */
+    pthread_mutex_t     lock;       /**< Lock protecting @a next */
+} ta_job_pool;
+
+/**
+ * Thread of the pool running jobs until there are no more jobs.
+ *
+ * @param arg           Pool of threads
+ *
+ * @return @c NULL
+ */
+static void *
+rcf_ta_job_thread(void *arg)
+{
+    ta_job_pool  *pool = arg;
+    unsigned int  i;
+
+    while (true)
+    {
+        pthread_mutex_lock(&pool->lock);
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (i >= pool->n_jobs)
+            break;
+
+        pool->func(&pool->jobs[i]);
+    }
+
+    return NULL;
+}
+
+/**
+ * Run jobs on Test Agents using at most @ref start_parallel threads
+ * and wait for their completion.
+ *
+ * @param jobs          Jobs
+ * @param n_jobs        Number of jobs
+ * @param func          Job function
+ */
+static void
+rcf_ta_jobs_run(ta_job *jobs, unsigned int n_jobs,
+                void (*func)(ta_job *job))
+{
+    ta_job_pool   pool = {
+        .jobs = jobs,
+        .n_jobs = n_jobs,
+        .func = func,
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+    };
+    unsigned int  n_threads = MIN(n_jobs, (unsigned int)start_parallel);
+    pthread_t    *threads;
+    unsigned int  started;
+    int           rc;
+
+    if (n_threads <= 1)
+    {
+        rcf_ta_job_thread(&pool);
+        return;
+    }
+
+    threads = TE_ALLOC(n_threads * sizeof(*threads));
+    for (started = 0; started < n_threads; started++)
+    {
+        rc = pthread_create(&threads[started], NULL, rcf_ta_job_thread,
+                            &pool);
+        if (rc != 0)
+        {
+            WARN("Failed to create thread for Test Agents jobs: %r",
+                 TE_OS_RC(TE_RCF, rc));
+            break;
+        }
+    }
+
+    /* Run jobs in the current thread as well if no thread is created */
+    if (started == 0)
+        rcf_ta_job_thread(&pool);
+
+    while (started > 0)
+        pthread_join(threads[--started], NULL);
+
+    free(threads);
+}
+
+/**
+ * Initialize all Test Agents. Test Agents are started and connected
+ * concurrently, then their initialization is completed one by one.
+ *
+ * @return 0 (success) or -1 (failure)
+ */
+static int
+rcf_init_agents(void)
+{
+    struct timeval  ts;
+    ta_job         *jobs;
+    unsigned int    n_jobs = 0;
+    unsigned int    i;
+    ta             *agent;
+    int             rc = 0;
+
+    if (agents == NULL)
+        return 0;
+
+    gettimeofday(&ts, NULL);
+
+    jobs = TE_ALLOC(ta_num * sizeof(*jobs));
+    for (agent = agents; agent != NULL; agent = agent->next)
+    {
+        rcf_ta_prepare_start(agent);
+        jobs[n_jobs++].agent = agent;
+    }
+
+    rcf_ta_jobs_run(jobs, n_jobs, rcf_ta_start);
+    RING("%u Test Agents are started and connected in %.3f s "
+         "(up to %d concurrently)", n_jobs, rcf_lap_time(&ts),
+         start_parallel);
+
+    for (i = 0; i < n_jobs && rc == 0; i++)
+        rc = rcf_ta_setup(&jobs[i]);
+
+    free(jobs);
+
+    if (rc != 0)
+        return -1;
+
+    RING("Test Agents are initialized in %.3f s", rcf_lap_time(&ts));
+    return 0;
+}
+
+/**
+ * Finish a Test Agent via TA-specific method. It may be done concurrently
+ * for several Test Agents.
+ *
+ * @param job           Job of the Test Agent
+ */
+static void
+rcf_ta_finish(ta_job *job)
+{
+    job->rc = (job->agent->m.finish)(job->agent->handle, NULL);
+}
+
+/**
+ * Get range of the file transferred by fput/fget command.
+ *
+ * @param msg           message with the range in value field
+ * @param offset        location for offset of the part of the file
+ * @param length        location for maximum length of the part
+ *
+ * @return Status code.
+ */
+static te_errno
+rcf_file_range(const rcf_msg *msg, uint64_t *offset, uint64_t *length)
+{
+    unsigned long long off;
+    unsigned long long len;
+    int                n = 0;
+
+    *offset = 0;
+    *length = UINT64_MAX;
+    if (msg->value[0] == '\0')
+        return 0;
+
+    if (sscanf(msg->value, "%llu %llu%n", &off, &len, &n) != 2 ||
+        msg->value[n] != '\0')
+        return TE_RC(TE_RCF, TE_EINVAL);
+
+    *offset = off;
+    *length = len;
+
+    return 0;
 }
 
 /**
@@ -1091,6 +1623,8 @@ save_attachment(ta *agent, rcf_msg *msg, size_t cmdlen, char *ba)
     int file = -1;
     size_t write_len;
     int len;
+    uint64_t offset = 0;
+    uint64_t length;
 
     if (strlen(msg->file) == 0)
     {
@@ -1108,11 +1642,25 @@ save_attachment(ta *agent, rcf_msg *msg, size_t cmdlen, char *ba)
     write_len = (cmdlen > sizeof(cmd)) ? (sizeof(cmd) - (ba - cmd)) :
                                          (size_t)len;
 
-    if ((file = open(msg->file, O_WRONLY | O_CREAT | O_TRUNC,
+    /* Part of the file is written after the previously received parts */
+    if (msg->opcode == RCFOP_FGET)
+        rcf_file_range(msg, &offset, &length);
+
+    if ((file = open(msg->file,
+                     O_WRONLY | O_CREAT | (offset == 0 ? O_TRUNC : 0),
                      S_IRWXU | S_IRWXG | S_IRWXO)) < 0)
     {
         ERROR("Cannot open file %s for writing - skipping", msg->file);
     }
+    else if (offset != 0 &&
+             (ftruncate(file, offset) != 0 ||
+              lseek(file, offset, SEEK_SET) == (off_t)-1))
+    {
+        ERROR("Cannot write to file %s at %llu errno %d - skipping",
+              msg->file, (unsigned long long)offset, errno);
+        close(file);
+        file = -1;
+    }
 
     if (file >= 0 && write(file, ba, write_len) < 0)
     {
@@ -1124,12 +1672,16 @@ save_attachment(ta *agent, rcf_msg *msg, size_t cmdlen, char *ba)
 
     len -= write_len;
 
+    if (len > 0 && file_buf == NULL)
+        file_buf = TE_ALLOC(RCF_FILE_BUF_LEN);
+
     while (len > 0)
     {
-        size_t maxlen = sizeof(cmd);
+        size_t chunk = MIN((size_t)len, RCF_FILE_BUF_LEN);
+        size_t maxlen = chunk;
         int rc;
 
-        rc = (agent->m.receive)(agent->handle, cmd, &maxlen, NULL);
+        rc = (agent->m.receive)(agent->handle, file_buf, &maxlen, NULL);
         if (rc != 0 && rc != TE_RC(TE_COMM, TE_EPENDING))
         {
             ERROR("Failed receive rest of binary attachment TA %s - "
@@ -1142,22 +1694,17 @@ save_attachment(ta *agent, rcf_msg *msg, size_t cmdlen, char *ba)
 
             return;
         }
-        /*
-         * 'len' is greater than zero, therefore cast to unsigned type
-         * size_t is painless.
-         */
-        if (file > 0 &&
-            write(file, cmd, ((size_t)len < sizeof(cmd)) ?
-                                 (size_t)len : sizeof(cmd)) < 0)
+
+        if (file >= 0 && write(file, file_buf, chunk) < 0)
         {
             ERROR("Cannot write to file %s errno %d - skipping",
                   msg->file, errno);
             close(file);
             file = -1;
         }
-        len -= sizeof(cmd);
+        len -= chunk;
     }
-    if (file > 0)
+    if (file >= 0)
         close(file);
 
     msg->flags |= BINARY_ATTACHMENT;
@@ -1381,6 +1928,8 @@ process_reply(ta *agent)
         goto push;
     }
 
+    req->ts_replied = rcf_stats_now();
+
     if (error != 0)
         req->message->error = error;
 
@@ -1411,12 +1960,24 @@ process_reply(ta *agent)
 
         switch (msg->opcode)
         {
+            case RCFOP_VWRITE:
+                if (strcmp(msg->id, RCF_PROTO_VAR) == 0 &&
+                    agent->proto_bin_supported)
+                {
+                    agent->proto_bin = (strcmp(msg->value,
+                                               TE_PROTO_BINARY) == 0);
+                    RING("%s encoding of commands is used for TA '%s'",
+                         agent->proto_bin ? TE_PROTO_BINARY :
+                                            RCF_PROTO_TEXT,
+                         agent->name);
+                }
+                break;
+
             case RCFOP_CONFGRP_START:
             case RCFOP_CONFGRP_END:
             case RCFOP_CONFSET:
             case RCFOP_CONFADD:
             case RCFOP_CONFDEL:
-            case RCFOP_VWRITE:
             case RCFOP_FPUT:
             case RCFOP_FDEL:
             case RCFOP_CSAP_DESTROY:
@@ -1479,6 +2040,18 @@ process_reply(ta *agent)
             }
 
             case RCFOP_GET_LOG:
+                /*
+                 * Tell the Logger whether the agent has more messages
+                 * to pass (older agents never report it). The space
+                 * before the attachment is already cut off, so the
+                 * token may be the last one.
+                 */
+                msg->intparm =
+                    (strcmp(ptr, TE_PROTO_LOG_MORE) == 0 ||
+                     strncmp(ptr, TE_PROTO_LOG_MORE " ",
+                             strlen(TE_PROTO_LOG_MORE " ")) == 0);
+                /*@fallthrough@*/
+
             case RCFOP_FGET:
                 if (ba == NULL)
                     goto bad_protocol;
@@ -1627,6 +2200,82 @@ bad_protocol:
 #undef READ_INT
 }
 
+/**
+ * Transmit a part of the file as binary attachment of the command.
+ * The part is sent directly from the file to the Test Agent connection
+ * if the connection file descriptor is available, otherwise it is read
+ * by large chunks passed to transmit method.
+ *
+ * @param agent         Test Agent structure
+ * @param file          file descriptor
+ * @param offset        offset of the part in the file
+ * @param length        length of the part
+ *
+ * @return Status code.
+ */
+static te_errno
+rcf_transmit_file(ta *agent, int file, uint64_t offset, uint64_t length)
+{
+    ssize_t  len;
+    te_errno rc;
+
+#ifdef HAVE_SYS_SENDFILE_H
+    int      fd = (agent->m.get_fd == NULL) ? -1 :
+                  (agent->m.get_fd)(agent->handle);
+    off_t    off = offset;
+
+    while (fd >= 0 && length > 0)
+    {
+        len = sendfile(fd, file, &off, MIN(length, RCF_FILE_BUF_LEN));
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
+            {
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+
+                if (poll(&pfd, 1, TE_SEC2MS(RCF_CMD_TIMEOUT)) > 0)
+                    continue;
+                return TE_RC(TE_RCF, TE_ETIMEDOUT);
+            }
+            /* Fall back to read() if nothing is sent yet */
+            if ((errno == EINVAL || errno == ENOSYS) &&
+                (uint64_t)off == offset)
+                break;
+
+            return TE_OS_RC(TE_RCF, errno);
+        }
+        if (len == 0)
+            return TE_RC(TE_RCF, TE_EIO);
+
+        offset += len;
+        length -= len;
+    }
+#endif
+
+    if (length > 0 && file_buf == NULL)
+        file_buf = TE_ALLOC(RCF_FILE_BUF_LEN);
+
+    while (length > 0)
+    {
+        len = pread(file, file_buf, MIN(length, RCF_FILE_BUF_LEN), offset);
+        if (len < 0)
+            return TE_OS_RC(TE_RCF, errno);
+        if (len == 0)
+            return TE_RC(TE_RCF, TE_EIO);
+
+        rc = (agent->m.transmit)(agent->handle, file_buf, len);
+        if (rc != 0)
+            return TE_RC(TE_RCF, rc);
+
+        offset += len;
+        length -= len;
+    }
+
+    return 0;
+}
+
 /**
  * Transmit the command and possibly binary attachment to the Test Agent.
  *
@@ -1638,14 +2287,22 @@ bad_protocol:
 static int
 transmit_cmd(ta *agent, usrreq *req)
 {
-    int   rc, len;
-    int   file = -1;
-    char *data = cmd;
+    int       rc, len;
+    int       file = -1;
+    char     *data = cmd;
+    uint64_t  offset = 0;
+    uint64_t  size = 0;
+
+    req->ts_transmit = rcf_stats_now();
 
     if (req->message->flags & BINARY_ATTACHMENT &&
         req->message->opcode != RCFOP_RPC)
     {
         struct stat st;
+        uint64_t    length = UINT64_MAX;
+
+        if (req->message->opcode == RCFOP_FPUT)
+            rcf_file_range(req->message, &offset, &length);
 
         if ((file = open(req->message->file, O_RDONLY)) < 0)
         {
@@ -1663,8 +2320,30 @@ transmit_cmd(ta *agent, usrreq *req)
             return -1;
         }
 
+        if (offset > (uint64_t)st.st_size)
+        {
+            req->message->error = TE_RC(TE_RCF, TE_EINVAL);
+            ERROR("Offset %llu is beyond the end of file '%s'",
+                  (unsigned long long)offset, req->message->file);
+            rcf_answer_user_request(req);
+            close(file);
+            return -1;
+        }
+
+        size = MIN(length, (uint64_t)st.st_size - offset);
+        /* Attachment length is limited on both sides of the connection */
+        if (size > INT_MAX)
+        {
+            req->message->error = TE_RC(TE_RCF, TE_EFBIG);
+            ERROR("File '%s' is too large to be transferred by one command",
+                  req->message->file);
+            rcf_answer_user_request(req);
+            close(file);
+            return -1;
+        }
+
         TE_SNPRINTF(cmd + strlen(cmd), sizeof(cmd) - strlen(cmd),
-                    " attach %u", (unsigned int)st.st_size);
+                    " attach %u", (unsigned int)size);
     }
 
     VERB("Transmit command \"%s\" to TA '%s'", cmd, agent->name);
@@ -1689,6 +2368,14 @@ transmit_cmd(ta *agent, usrreq *req)
 
             return -1;
         }
+        if (cmd_bin_len > 0)
+        {
+            if (data == (char *)cmd_bin)
+                break;
+            data = (char *)cmd_bin;
+            len = cmd_bin_len;
+            continue;
+        }
         if (req->message->opcode == RCFOP_RPC &&
             req->message->flags & BINARY_ATTACHMENT)
         {
@@ -1699,25 +2386,30 @@ transmit_cmd(ta *agent, usrreq *req)
             continue;
         }
 
-        if (file < 0 || (len = read(file, cmd, sizeof(cmd))) == 0)
+        if (file < 0)
             break;
 
-        if (len < 0)
+        rc = rcf_transmit_file(agent, file, offset, size);
+        close(file);
+        file = -1;
+        if (rc != 0)
         {
-            req->message->error = TE_OS_RC(TE_RCF, errno);
-            ERROR("Read from file '%s' failed error=%r",
-                  req->message->file, req->message->error);
-            close(file);
+            req->message->error = rc;
+            ERROR("Failed to transmit file '%s' to TA '%s' error=%r",
+                  req->message->file, agent->name, rc);
             rcf_answer_user_request(req);
+            /* The rest of the attachment is expected by the TA */
+            rcf_set_ta_dead(agent);
             return -1;
         }
-
+        break;
     }
 
     if (file != -1)
         close(file);
 
     VERB("The command is transmitted to %s", agent->name);
+    req->ts_sent = rcf_stats_now();
     req->sent = time(NULL);
     agent->conn_locked = true;
     agent->lock_sid = req->message->sid;
@@ -1834,6 +2526,61 @@ print_value(char *cmd, size_t size, unsigned char type, void *value)
     return ret;
 }
 
+/**
+ * Encode the command in binary form to @ref cmd_bin.
+ *
+ * @param req           user request structure
+ *
+ * @return @c true if the command is encoded, @c false if it should be
+ *         sent in text form
+ */
+static bool
+encode_cmd_bin(usrreq *req)
+{
+    rcf_msg      *msg = req->message;
+    const char   *fields[RCF_PROTO_BIN_MAX_FIELDS] = { msg->id, msg->value };
+    unsigned int  n_fields = 1;
+    unsigned int  type = 0;
+
+    switch (msg->opcode)
+    {
+        case RCFOP_CONFGET:
+        case RCFOP_CONFDEL:
+            req->timeout = RCF_CMD_TIMEOUT;
+            break;
+
+        case RCFOP_CONFADD:
+            n_fields = 2;
+            req->timeout = RCF_CMD_TIMEOUT;
+            break;
+
+        case RCFOP_CONFSET:
+            n_fields = 2;
+            req->timeout = RCF_CONFSET_TIMEOUT;
+            break;
+
+        case RCFOP_VREAD:
+            type = msg->intparm;
+            if (req->timeout == 0)
+                req->timeout = RCF_CMD_TIMEOUT;
+            break;
+
+        case RCFOP_VWRITE:
+            type = msg->intparm;
+            n_fields = 2;
+            req->timeout = RCF_CMD_TIMEOUT;
+            break;
+
+        default:
+            return false;
+    }
+
+    cmd_bin_len = rcf_proto_bin_encode(cmd_bin, sizeof(cmd_bin),
+                                       msg->opcode, type, n_fields, fields);
+
+    return cmd_bin_len > 0;
+}
+
 /* See description in rcf.h */
 int
 rcf_send_cmd(ta *agent, usrreq *req)
@@ -1877,7 +2624,14 @@ rcf_send_cmd(ta *agent, usrreq *req)
         CHECK_SPACE;                                              \
     } while (0)
 
+    cmd_bin_len = 0;
     PUT("SID %d ", msg->sid);
+    if (agent->proto_bin && encode_cmd_bin(req))
+    {
+        PUT(TE_PROTO_BINARY " attach %u", (unsigned int)cmd_bin_len);
+        goto transmit;
+    }
+
     switch (msg->opcode)
     {
         case RCFOP_REBOOT:
@@ -1973,6 +2727,21 @@ rcf_send_cmd(ta *agent, usrreq *req)
                 msg->opcode == RCFOP_FPUT ? TE_PROTO_FPUT :
                 msg->opcode == RCFOP_FDEL ? TE_PROTO_FDEL : TE_PROTO_FGET,
                 msg->data);
+            if (msg->opcode != RCFOP_FDEL && msg->value[0] != '\0')
+            {
+                uint64_t offset;
+                uint64_t length;
+
+                if (rcf_file_range(msg, &offset, &length) != 0)
+                {
+                    ERROR("Invalid file range '%s'", msg->value);
+                    msg->error = TE_RC(TE_RCF, TE_EINVAL);
+                    rcf_answer_user_request(req);
+                    return -1;
+                }
+                PUT(" %" TE_PRINTF_64 "u %" TE_PRINTF_64 "u",
+                    offset, length);
+            }
             req->timeout = RCF_CMD_TIMEOUT_HUGE;
             break;
 
@@ -2140,6 +2909,7 @@ rcf_send_cmd(ta *agent, usrreq *req)
             return -1;
     }
 
+transmit:
 #undef PUT
 
     if (transmit_cmd(agent, req) == 0)
@@ -2157,6 +2927,118 @@ rcf_alloc_usrreq(void)
 
     req = TE_ALLOC(sizeof(usrreq));
     req->message = TE_ALLOC(sizeof(rcf_msg));
+    req->ts_received = rcf_stats_now();
+
+    return req;
+}
+
+/**
+ * Receive a request from the user. Requests in compact layout are
+ * deserialised, legacy fixed-size messages are accepted as is.
+ * Malformed requests which can be identified are answered with
+ * an error.
+ *
+ * @return User request or @c NULL in the case of failure
+ */
+static usrreq *
+receive_user_request(void)
+{
+    struct ipc_server_client   *user = NULL;
+    size_t                      len;
+    size_t                      msg_len;
+    bool                        packed;
+    usrreq                     *req;
+    te_errno                    rc;
+    int                         shm_fd;
+
+    if (request_buf.size < sizeof(rcf_msg))
+        te_dbuf_expand(&request_buf, sizeof(rcf_msg) - request_buf.size);
+
+    len = request_buf.size;
+    rc = ipc_receive_message(server, request_buf.ptr, &len, &user);
+    if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
+    {
+        size_t received = request_buf.size;
+
+        te_dbuf_expand(&request_buf, len);
+        rc = ipc_receive_message(server, request_buf.ptr + received,
+                                 &len, &user);
+        len += received;
+    }
+
+    if (rc != 0)
+    {
+        ERROR("Failed to receive user request: errno %r", rc);
+        return NULL;
+    }
+
+    shm_fd = ipc_server_client_take_fd(server, user);
+
+    packed = rcf_msg_is_packed(request_buf.ptr, len);
+    if (packed)
+    {
+        /* Malformed request is unpacked partially to answer it */
+        msg_len = MAX(rcf_msg_unpacked_len(request_buf.ptr, len),
+                      sizeof(rcf_msg));
+    }
+    else
+    {
+        msg_len = len;
+        if (len < sizeof(rcf_msg))
+        {
+            ERROR("Incorrect user request is received: IPC message "
+                  "size %u is less than %u", (unsigned int)len,
+                  (unsigned int)sizeof(rcf_msg));
+            if (shm_fd >= 0)
+                close(shm_fd);
+            return NULL;
+        }
+    }
+
+    req = rcf_alloc_usrreq();
+    if (msg_len > sizeof(rcf_msg))
+    {
+        free(req->message);
+        req->message = TE_ALLOC(msg_len);
+    }
+    req->user = user;
+    req->packed = packed;
+
+    if (!packed)
+    {
+        memcpy(req->message, request_buf.ptr, sizeof(rcf_msg));
+        if (len != sizeof(rcf_msg) + req->message->data_len)
+        {
+            ERROR("Incorrect user request is received: "
+                  "data_len field does not match to IPC "
+                  "message size: %u != %u + %u", (unsigned int)len,
+                  (unsigned int)req->message->data_len,
+                  (unsigned int)sizeof(rcf_msg));
+            /* Strings of the answer are logged */
+            req->message->ta[sizeof(req->message->ta) - 1] = '\0';
+            req->message->file[sizeof(req->message->file) - 1] = '\0';
+            rc = TE_RC(TE_RCF, TE_EINVAL);
+        }
+        else
+        {
+            memcpy(req->message, request_buf.ptr, len);
+        }
+    }
+    else
+    {
+        rc = rcf_msg_unpack(request_buf.ptr, len, shm_fd, req->message);
+    }
+
+    if (shm_fd >= 0)
+        close(shm_fd);
+
+    if (rc != 0)
+    {
+        req->message->error = rc;
+        req->message->flags &= ~INTERMEDIATE_ANSWER;
+        rcf_answer_user_request(req);
+        return NULL;
+    }
 
     return req;
 }
@@ -2354,6 +3236,47 @@ process_reboot_request(ta *agent, usrreq *req)
 }
 
 
+/**
+ * Get statistics of requests of Test Agents.
+ *
+ * @param ta_name   Test Agent name or empty string for all Test Agents
+ * @param report    Report
+ *
+ * @return Status code.
+ */
+static te_errno
+rcf_stats_report_all(const char *ta_name, te_string *report)
+{
+    ta *agent;
+
+    for (agent = agents; agent != NULL; agent = agent->next)
+    {
+        if (*ta_name == '\0' || strcmp(agent->name, ta_name) == 0)
+        {
+            rcf_stats_report(agent, report);
+            if (*ta_name != '\0')
+                return 0;
+        }
+    }
+
+    return *ta_name == '\0' ? 0 : TE_RC(TE_RCF, TE_ENOENT);
+}
+
+/**
+ * Log statistics of requests of all Test Agents.
+ */
+static void
+rcf_stats_log(void)
+{
+    te_string report = TE_STRING_INIT;
+
+    rcf_stats_report_all("", &report);
+    if (report.len > 0)
+        RING("Statistics of requests:\n%s", te_string_value(&report));
+
+    te_string_free(&report);
+}
+
 /**
  * Process a request from the user: send the command to the Test Agent or
  * put the request to the pending queue.
@@ -2383,6 +3306,23 @@ process_user_request(usrreq *req)
             return;
         }
 
+        case RCFOP_GET_STATS:
+        {
+            te_string   report = TE_STRING_INIT;
+            rcf_msg    *new_msg;
+
+            msg->error = rcf_stats_report_all(msg->ta, &report);
+            new_msg = TE_ALLOC(sizeof(rcf_msg) + report.len + 1);
+            *new_msg = *msg;
+            free(msg);
+            msg = req->message = new_msg;
+            msg->data_len = report.len + 1;
+            memcpy(msg->data, te_string_value(&report), report.len + 1);
+            te_string_free(&report);
+            rcf_answer_user_request(req);
+            return;
+        }
+
         case RCFOP_TACHECK:
             if (ta_checker.req == NULL)
             {
@@ -2637,12 +3577,7 @@ process_user_request(usrreq *req)
 
                         while (time(NULL) - t < RCF_SHUTDOWN_TIMEOUT)
                         {
-                            struct timeval tv  = tv0;
-                            fd_set         set = set0;
-
-                            select(FD_SETSIZE, &set, NULL, NULL, &tv);
-
-                            if ((agt->m.is_ready)(agt->handle))
+                            if (rcf_ta_wait_ready(agt))
                             {
                                 char    answer[16];
                                 char   *ba;
@@ -2661,7 +3596,7 @@ process_user_request(usrreq *req)
 
                                 INFO("Test Agent '%s' is down", agt->name);
                                 agt->flags |= TA_DOWN;
-                                (agt->m.close)(agt->handle, &set0);
+                                rcf_ta_close(agt);
                                 break; /** Leave current 'while' loop */
                             }
                         }
@@ -2670,6 +3605,7 @@ process_user_request(usrreq *req)
                     if (!(agt->flags & TA_DOWN))
                         ERROR("Soft shutdown of TA '%s' failed", agt->name);
 
+                    rcf_ta_unwatch(agt);
                     if (agt->handle != NULL)
                     {
                         if ((agt->m.finish)(agt->handle, NULL) != 0)
@@ -2688,6 +3624,7 @@ process_user_request(usrreq *req)
                     free(agt->type);
                     free(agt->libname);
                     te_kvpair_fini(&agt->conf);
+                    rcf_stats_free(agt);
                     free(agt);
 
                     /* Remove agent from linked list */
@@ -2792,6 +3729,7 @@ process_user_request(usrreq *req)
     }
 
     /* Usual commands */
+    rcf_stats_enqueue(agent, req);
     if (shutdown_num > 0 ||
         agent->reboot_timestamp > 0 ||
         (agent->flags & TA_CHECKING) ||
@@ -2814,14 +3752,19 @@ static void
 rcf_shutdown(void)
 {
     ta *agent;
+    ta_job *jobs;
+    unsigned int n_jobs = 0;
+    unsigned int i;
+    struct timeval ts;
 
-    struct timeval tv;
-    fd_set         set;
+    struct epoll_event events[RCF_MAX_EVENTS];
 
     time_t t = time(NULL);
 
     RING("Shutting down");
 
+    rcf_stats_log();
+
     shutdown_num = ta_num;
 
     for (agent = agents; agent != NULL; agent = agent->next)
@@ -2838,9 +3781,8 @@ rcf_shutdown(void)
 
     while (shutdown_num > 0 && time(NULL) - t < RCF_SHUTDOWN_TIMEOUT)
     {
-        tv = tv0;
-        set = set0;
-        select(FD_SETSIZE, &set, NULL, NULL, &tv);
+        (void)epoll_wait(ta_epfd, events, RCF_MAX_EVENTS,
+                         rcf_poll_timeout());
         for (agent = agents; agent != NULL; agent = agent->next)
         {
             if (agent->flags & (TA_DOWN | TA_DEAD))
@@ -2862,23 +3804,33 @@ rcf_shutdown(void)
 
                 INFO("Test Agent '%s' is down", agent->name);
                 agent->flags |= TA_DOWN;
-                (agent->m.close)(agent->handle, &set0);
+                rcf_ta_close(agent);
                 shutdown_num--;
             }
         }
     }
+    jobs = TE_ALLOC(MAX(ta_num, 1) * sizeof(*jobs));
     for (agent = agents; agent != NULL; agent = agent->next)
     {
         if ((agent->flags & TA_DOWN) == 0)
             ERROR("Soft shutdown of TA '%s' failed", agent->name);
+        rcf_ta_unwatch(agent);
         if (agent->handle != NULL)
-        {
-            if ((agent->m.finish)(agent->handle, NULL) != 0)
-                ERROR("Cannot finish TA '%s'", agent->name);
-            agent->handle = NULL;
-        }
+            jobs[n_jobs++].agent = agent;
+    }
+
+    /* Finishing includes TCE fetch and cleanup on Test Agent hosts */
+    gettimeofday(&ts, NULL);
+    rcf_ta_jobs_run(jobs, n_jobs, rcf_ta_finish);
+    for (i = 0; i < n_jobs; i++)
+    {
+        if (jobs[i].rc != 0)
+            ERROR("Cannot finish TA '%s'", jobs[i].agent->name);
+        jobs[i].agent->handle = NULL;
     }
-    RING("Test Agents are stopped");
+    free(jobs);
+
+    RING("Test Agents are stopped (finished in %.3f s)", rcf_lap_time(&ts));
 }
 
 
@@ -2907,6 +3859,10 @@ process_cmd_line_opts(int argc, const char **argv)
           "Run in foreground (useful for debugging).", NULL },
         { "tce-conf", '\0', POPT_ARG_STRING, &tce_conf_file, 0,
           "Specify file with TCE configuration.", NULL },
+        { "start-parallel", '\0', POPT_ARG_INT, &start_parallel,
+          RCF_OPT_START_PARALLEL,
+          "Maximum number of Test Agents started or finished "
+          "concurrently.", "NUM" },
 
         POPT_AUTOHELP
         POPT_TABLEEND
@@ -2918,7 +3874,27 @@ process_cmd_line_opts(int argc, const char **argv)
 
     poptSetOtherOptionHelp(optCon, "[OPTIONS] <cfg-file>");
 
-    rc = poptGetNextOpt(optCon);
+    while ((rc = poptGetNextOpt(optCon)) >= 0)
+    {
+        switch (rc)
+        {
+            case RCF_OPT_START_PARALLEL:
+                /* It is used as unsigned number of threads */
+                if (start_parallel < 1)
+                {
+                    ERROR("Invalid maximum number of Test Agents started "
+                          "concurrently: %d", start_parallel);
+                    poptFreeContext(optCon);
+                    return EXIT_FAILURE;
+                }
+                break;
+
+            default:
+                ERROR("Unexpected option number %d", rc);
+                poptFreeContext(optCon);
+                return EXIT_FAILURE;
+        }
+    }
     if (rc != -1)
     {
         /* An error occurred during option processing */
@@ -2998,7 +3974,9 @@ main(int argc, const char *argv[])
         goto exit;
     assert(server != NULL);
 
-    FD_ZERO(&set0);
+    if (rcf_events_init() != 0)
+        goto exit;
+
     tv0.tv_sec = RCF_SELECT_TIMEOUT;
     tv0.tv_usec = 0;
 
@@ -3027,13 +4005,10 @@ main(int argc, const char *argv[])
     {
         RING("Empty list with TAs");
     }
-    for (agent = agents; agent != NULL; agent = agent->next)
+    if (rcf_init_agents() != 0)
     {
-        if (rcf_init_agent(agent) != 0)
-        {
-            ERROR("FATAL ERROR: TA initialization failed");
-            goto exit;
-        }
+        ERROR("FATAL ERROR: TA initialization failed");
+        goto exit;
     }
 
     /*
@@ -3049,71 +4024,50 @@ main(int argc, const char *argv[])
     INFO("Initialization is finished");
     while (1)
     {
-        struct timeval  tv = tv0;
-        fd_set          set = set0;
-        size_t          len;
-        time_t          now;
-        int             select_rc;
+        struct epoll_event  events[RCF_MAX_EVENTS];
+        bool                ipc_ready = false;
+        bool                ta_ready = false;
+        time_t              now;
+        int                 events_num;
+        int                 i;
 
         req = NULL;
         rc = -1;
 
-        (void)ipc_get_server_fds(server, &set);
-
-        select_rc = select(FD_SETSIZE, &set, NULL, NULL, &tv);
-        if (select_rc < 0)
+        events_num = epoll_wait(rcf_epfd, events, RCF_MAX_EVENTS,
+                                rcf_poll_timeout());
+        if (events_num < 0)
         {
             if (errno != EINTR)
-                ERROR("Unexpected failure of select(): rc=%d, errno=%d",
-                      select_rc, errno);
+                ERROR("Unexpected failure of epoll_wait(): errno=%d",
+                      errno);
             else
-                INFO("select() has been interrupted by signal");
+                INFO("epoll_wait() has been interrupted by signal");
         }
 
-        if ((select_rc > 0) &&
-            ipc_is_server_ready(server, &set, FD_SETSIZE))
+        for (i = 0; i < events_num; i++)
         {
-            len = sizeof(rcf_msg);
-
-            req = rcf_alloc_usrreq();
-
-            rc = ipc_receive_message(server, req->message,
-                                     &len, &(req->user));
-
-            if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
-            {
-                size_t n = len;
-
-                len += sizeof(rcf_msg);
-                if ((req->message =
-                         (rcf_msg *)realloc(req->message, len)) == NULL)
-                {
-                    ERROR("Cannot allocate memory for user request");
-                    free(req);
-                    continue;
-                }
-                rc = ipc_receive_message(server, req->message + 1,
-                                         &n, &(req->user));
-            }
+            if (events[i].data.fd == ta_epfd)
+                ta_ready = true;
+            else if (ipc_server_fd_ready(server, events[i].data.fd))
+                ipc_ready = true;
+        }
 
-            if (rc != 0)
+        /* Mark Test Agents which connections are readable */
+        if (ta_ready)
+        {
+            events_num = epoll_wait(ta_epfd, events, RCF_MAX_EVENTS, 0);
+            for (i = 0; i < events_num; i++)
             {
-                ERROR("Failed to receive user request: errno %r", rc);
-                free(req->message);
-                free(req);
-                continue;
+                agent = events[i].data.ptr;
+                agent->fd_ready = true;
             }
+        }
 
-            if (len != sizeof(rcf_msg) + req->message->data_len)
-            {
-                ERROR("Incorrect user request is received: "
-                      "data_len field does not match to IPC "
-                      "message size: %d != %d + %d",
-                      len, req->message->data_len, sizeof(rcf_msg));
-                free(req->message);
-                free(req);
+        if (ipc_ready)
+        {
+            if ((req = receive_user_request()) == NULL)
                 continue;
-            }
 
             INFO("Got request %u:%d:'%s' from user '%s'",
                  (unsigned)req->message->seqno, req->message->sid,
@@ -3134,13 +4088,17 @@ main(int argc, const char *argv[])
 
             /*
             * In all reboot states except @c TA_REBOOT_STATE_REBOOTING,
-            * messages may come from the agent
+            * messages may come from the agent. Only agents which
+            * connections are reported to be readable are checked,
+            * unless the connection cannot be watched.
             */
-            if ((agent->m.is_ready)(agent->handle) &&
+            if ((agent->fd_ready || !agent->fd_watched) &&
+                (agent->m.is_ready)(agent->handle) &&
                  agent->reboot_ctx.state != TA_REBOOT_STATE_REBOOTING)
             {
                 process_reply(agent);
             }
+            agent->fd_ready = false;
 
             rcf_ta_reboot_state_handler(agent);
 
@@ -3196,6 +4154,7 @@ main(int argc, const char *argv[])
 
 exit:
     rcf_shutdown();
+    rcf_events_fini();
 
     if (req != NULL && req->message->opcode == RCFOP_SHUTDOWN)
         rcf_answer_user_request(req);
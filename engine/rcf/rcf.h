@@ -20,6 +20,7 @@
 
 #include "te_errno.h"
 #include "te_defs.h"
+#include "te_string.h"
 #include "ipc_server.h"
 #include "rcf_methods.h"
 #include "rcf_api.h"
@@ -72,6 +73,7 @@ enum {
 
 typedef struct ta ta;
 typedef struct usrreq usrreq;
+typedef struct rcf_ta_stats rcf_ta_stats;
 
 /**
  * The prototype of the function that is called when receiving
@@ -93,6 +95,21 @@ struct usrreq {
     uint32_t                  timeout;  /**< Timeout in seconds */
     time_t                    sent;
     userreq_callback          cb;
+    bool                      packed;   /**< Request is received in
+                                             compact layout, answer
+                                             in the same layout */
+    uint64_t                  ts_received;  /**< Time of receiving the
+                                                 request (us, see
+                                                 rcf_stats_now()) */
+    uint64_t                  ts_transmit;  /**< Time of the start of
+                                                 transmission to TA */
+    uint64_t                  ts_sent;      /**< Time of the end of
+                                                 transmission to TA */
+    uint64_t                  ts_replied;   /**< Time of receiving
+                                                 the answer from TA */
+    bool                      in_flight;    /**< Request is counted in
+                                                 requests in flight of
+                                                 the TA */
 };
 
 /** A description for a task/thread to be executed at TA startup */
@@ -242,7 +259,25 @@ struct ta {
 
     struct rcf_talib_methods m; /**< TA-specific Methods */
 
+    int                 fd;                 /**< Connection file descriptor
+                                                 watched by RCF */
+    bool                fd_watched;         /**< @a fd is in the epoll set
+                                                 of Test Agents (otherwise
+                                                 is_ready() method is polled
+                                                 on every iteration) */
+    bool                fd_ready;           /**< @a fd is reported to be
+                                                 readable */
+
+    bool                proto_bin_supported; /**< Test Agent supports
+                                                  binary encoding of
+                                                  commands */
+    bool                proto_bin;          /**< Commands are sent in
+                                                 binary form when
+                                                 possible */
+
     ta_reboot_context reboot_ctx; /**< Reboot context */
+
+    rcf_ta_stats       *stats;              /**< Statistics of requests */
 };
 
 /**
@@ -254,7 +289,6 @@ typedef struct ta_check {
 } ta_check;
 
 extern ta_check ta_checker;
-extern fd_set set0;
 extern struct timeval tv0;
 
 /**
@@ -303,6 +337,33 @@ extern void rcf_set_ta_dead(ta *agent);
  */
 extern void rcf_set_ta_unrecoverable(ta *agent);
 
+/**
+ * Stop watching the Test Agent connection for incoming data.
+ * It should be called before the connection is closed in any way.
+ *
+ * @param agent     Test Agent
+ */
+extern void rcf_ta_unwatch(ta *agent);
+
+/**
+ * Close interactions with the Test Agent.
+ *
+ * @param agent     Test Agent
+ *
+ * @return Status code
+ */
+extern te_errno rcf_ta_close(ta *agent);
+
+/**
+ * Wait until data from the Test Agent are pending or RCF polling
+ * interval expires.
+ *
+ * @param agent     Test Agent
+ *
+ * @return @c true if data from the Test Agent are pending.
+ */
+extern bool rcf_ta_wait_ready(ta *agent);
+
 /**
  * Initialize Test Agent or recovery it after reboot.
  * Test Agent is marked as "unrecoverable dead" in the case of failure.
@@ -381,6 +442,45 @@ extern void rcf_ta_reboot_init_ctx(ta *agent);
  */
 extern void rcf_ta_reboot_get_next_reboot_type(ta *agent);
 
+/**
+ * Get current time used to measure latency of requests.
+ *
+ * @return Monotonic time in microseconds.
+ */
+extern uint64_t rcf_stats_now(void);
+
+/**
+ * Count the request accepted for the Test Agent in its requests
+ * in flight.
+ *
+ * @param agent Test Agent structure
+ * @param req   User request
+ */
+extern void rcf_stats_enqueue(ta *agent, usrreq *req);
+
+/**
+ * Account the request being answered in statistics of its Test Agent.
+ * Intermediate answers are ignored.
+ *
+ * @param req   User request
+ */
+extern void rcf_stats_answer(usrreq *req);
+
+/**
+ * Append statistics of requests of the Test Agent to the report.
+ *
+ * @param agent  Test Agent structure
+ * @param report Report
+ */
+extern void rcf_stats_report(ta *agent, te_string *report);
+
+/**
+ * Release statistics of requests of the Test Agent.
+ *
+ * @param agent Test Agent structure
+ */
+extern void rcf_stats_free(ta *agent);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -551,12 +551,7 @@ try_soft_shutdown(ta *agent)
     /* TODO: This should be moved to a separate function */
     while (!is_timed_out(t, RCF_SHUTDOWN_TIMEOUT))
     {
-        struct timeval tv  = tv0;
-        fd_set         set = set0;
-
-        select(FD_SETSIZE, &set, NULL, NULL, &tv);
-
-        if ((agent->m.is_ready)(agent->handle))
+        if (rcf_ta_wait_ready(agent))
         {
             char    answer[16];
             char   *ba;
@@ -575,7 +570,7 @@ try_soft_shutdown(ta *agent)
 
             INFO("Test Agent '%s' is down", agent->name);
             agent->flags |= TA_DOWN;
-            (agent->m.close)(agent->handle, &set0);
+            rcf_ta_close(agent);
             break;
         }
     }
@@ -603,6 +598,7 @@ rebooting_state_agent_reboot_handler(ta *agent)
 
     try_soft_shutdown(agent);
 
+    rcf_ta_unwatch(agent);
     rc = (agent->m.finish)(agent->handle, NULL);
     if (rc != 0)
     {
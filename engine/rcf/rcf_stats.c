@@ -0,0 +1,345 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF request statistics
+ *
+ * Per Test Agent and per operation counters and latency histograms of
+ * user requests. Each request is split into stages:
+ * - queue: from receiving the request to the start of its transmission
+ *   (time spent in waiting and pending queues);
+ * - transmit: transmission of the command and its attachment;
+ * - agent: from the end of transmission to the answer of the Test Agent;
+ * - answer: from the answer of the Test Agent to the answer to the user;
+ * - total: from receiving the request to the answer to the user.
+ *
+ * Histograms have log-linear buckets: each power of two range of
+ * microseconds is split into @ref RCF_STATS_SUB_BUCKETS equal buckets,
+ * so that percentiles are reported with bounded relative error.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+#include "rcf.h"
+#include "te_alloc.h"
+#include "te_string.h"
+
+/** Number of bits of the value below the most significant one used
+ *  to select a bucket */
+#define RCF_STATS_SUB_BITS      2
+
+/** Number of buckets per power of two */
+#define RCF_STATS_SUB_BUCKETS   (1 << RCF_STATS_SUB_BITS)
+
+/** Largest power of two of microseconds distinguished by histograms */
+#define RCF_STATS_MAX_EXP       40
+
+/** Number of histogram buckets */
+#define RCF_STATS_BUCKETS \
+    ((RCF_STATS_MAX_EXP - RCF_STATS_SUB_BITS + 2) * RCF_STATS_SUB_BUCKETS)
+
+/** Number of operation codes */
+#define RCF_STATS_OPS           (RCFOP_GET_STATS + 1)
+
+/** Request stages */
+typedef enum rcf_stats_stage {
+    RCF_STATS_QUEUE,        /**< Waiting for transmission */
+    RCF_STATS_TRANSMIT,     /**< Transmission */
+    RCF_STATS_AGENT,        /**< Processing by the Test Agent */
+    RCF_STATS_ANSWER,       /**< Processing of the answer */
+    RCF_STATS_TOTAL,        /**< The whole request */
+    RCF_STATS_STAGES,       /**< Number of stages */
+} rcf_stats_stage;
+
+/** Names of request stages */
+static const char * const rcf_stats_stage_names[RCF_STATS_STAGES] = {
+    "queue", "transmit", "agent", "answer", "total",
+};
+
+/** Latency histogram */
+typedef struct rcf_stats_hist {
+    uint64_t    count;                      /**< Number of samples */
+    uint64_t    sum;                        /**< Sum of samples (us) */
+    uint64_t    max;                        /**< Maximum sample (us) */
+    uint32_t    buckets[RCF_STATS_BUCKETS]; /**< Samples in buckets */
+} rcf_stats_hist;
+
+/** Statistics of one operation */
+typedef struct rcf_op_stats {
+    uint64_t        requests;               /**< Answered requests */
+    uint64_t        errors;                 /**< Requests answered with
+                                                 error */
+    rcf_stats_hist  hist[RCF_STATS_STAGES]; /**< Latency of stages */
+} rcf_op_stats;
+
+/** Statistics of the Test Agent */
+struct rcf_ta_stats {
+    unsigned int    in_flight;              /**< Requests accepted and not
+                                                 answered yet */
+    unsigned int    max_in_flight;          /**< Maximum of @a in_flight */
+    rcf_op_stats   *ops[RCF_STATS_OPS];     /**< Statistics of operations
+                                                 (allocated on demand) */
+};
+
+/* See description in rcf.h */
+uint64_t
+rcf_stats_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return TE_SEC2US((uint64_t)ts.tv_sec) + TE_NS2US(ts.tv_nsec);
+}
+
+/**
+ * Get histogram bucket of the value.
+ *
+ * @param value         Value (us)
+ *
+ * @return Bucket index.
+ */
+static unsigned int
+rcf_stats_bucket(uint64_t value)
+{
+    unsigned int exp;
+
+    if (value < RCF_STATS_SUB_BUCKETS)
+        return value;
+
+    exp = 63 - __builtin_clzll(value);
+    if (exp > RCF_STATS_MAX_EXP)
+        return RCF_STATS_BUCKETS - 1;
+
+    return (exp - RCF_STATS_SUB_BITS + 1) * RCF_STATS_SUB_BUCKETS +
+           ((value >> (exp - RCF_STATS_SUB_BITS)) &
+            (RCF_STATS_SUB_BUCKETS - 1));
+}
+
+/**
+ * Get the largest value of the histogram bucket.
+ *
+ * @param bucket        Bucket index
+ *
+ * @return Value (us).
+ */
+static uint64_t
+rcf_stats_bucket_max(unsigned int bucket)
+{
+    unsigned int exp;
+    uint64_t     sub;
+
+    if (bucket < RCF_STATS_SUB_BUCKETS)
+        return bucket;
+
+    exp = bucket / RCF_STATS_SUB_BUCKETS + RCF_STATS_SUB_BITS - 1;
+    sub = bucket % RCF_STATS_SUB_BUCKETS;
+
+    return ((RCF_STATS_SUB_BUCKETS + sub + 1) <<
+            (exp - RCF_STATS_SUB_BITS)) - 1;
+}
+
+/**
+ * Add a sample to the histogram.
+ *
+ * @param hist          Histogram
+ * @param start         Start of the interval (@c 0 if unknown)
+ * @param end           End of the interval (@c 0 if unknown)
+ */
+static void
+rcf_stats_hist_add(rcf_stats_hist *hist, uint64_t start, uint64_t end)
+{
+    uint64_t value;
+
+    if (start == 0 || end == 0 || end < start)
+        return;
+
+    value = end - start;
+    hist->count++;
+    hist->sum += value;
+    hist->max = MAX(hist->max, value);
+    hist->buckets[rcf_stats_bucket(value)]++;
+}
+
+/**
+ * Get percentile of the histogram.
+ *
+ * @param hist          Histogram
+ * @param percent       Percentile
+ *
+ * @return Upper bound of the percentile (us).
+ */
+static uint64_t
+rcf_stats_hist_percentile(const rcf_stats_hist *hist, unsigned int percent)
+{
+    uint64_t     rank = (hist->count * percent + 99) / 100;
+    uint64_t     seen = 0;
+    unsigned int i;
+
+    for (i = 0; i < RCF_STATS_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+            return MIN(rcf_stats_bucket_max(i), hist->max);
+    }
+
+    return hist->max;
+}
+
+/**
+ * Get statistics of the Test Agent allocating them if necessary.
+ *
+ * @param agent         Test Agent
+ *
+ * @return Statistics.
+ */
+static rcf_ta_stats *
+rcf_stats_get(ta *agent)
+{
+    if (agent->stats == NULL)
+        agent->stats = TE_ALLOC(sizeof(*agent->stats));
+
+    return agent->stats;
+}
+
+/* See description in rcf.h */
+void
+rcf_stats_enqueue(ta *agent, usrreq *req)
+{
+    rcf_ta_stats *stats = rcf_stats_get(agent);
+
+    req->in_flight = true;
+    stats->in_flight++;
+    stats->max_in_flight = MAX(stats->max_in_flight, stats->in_flight);
+}
+
+/* See description in rcf.h */
+void
+rcf_stats_answer(usrreq *req)
+{
+    rcf_msg        *msg = req->message;
+    ta             *agent;
+    rcf_ta_stats   *stats;
+    rcf_op_stats   *op;
+    uint64_t        now;
+
+    if (msg->flags & INTERMEDIATE_ANSWER)
+        return;
+
+    if (msg->opcode <= 0 || msg->opcode >= RCF_STATS_OPS ||
+        (agent = rcf_find_ta_by_name(msg->ta)) == NULL)
+        return;
+
+    stats = rcf_stats_get(agent);
+    if (req->in_flight)
+    {
+        req->in_flight = false;
+        if (stats->in_flight > 0)
+            stats->in_flight--;
+    }
+
+    if (stats->ops[msg->opcode] == NULL)
+        stats->ops[msg->opcode] = TE_ALLOC(sizeof(*op));
+    op = stats->ops[msg->opcode];
+
+    op->requests++;
+    if (msg->error != 0)
+        op->errors++;
+
+    now = rcf_stats_now();
+    rcf_stats_hist_add(&op->hist[RCF_STATS_QUEUE], req->ts_received,
+                       req->ts_transmit);
+    rcf_stats_hist_add(&op->hist[RCF_STATS_TRANSMIT], req->ts_transmit,
+                       req->ts_sent);
+    rcf_stats_hist_add(&op->hist[RCF_STATS_AGENT], req->ts_sent,
+                       req->ts_replied);
+    rcf_stats_hist_add(&op->hist[RCF_STATS_ANSWER], req->ts_replied, now);
+    rcf_stats_hist_add(&op->hist[RCF_STATS_TOTAL], req->ts_received, now);
+}
+
+/**
+ * Get number of requests in the queue.
+ *
+ * @param queue         Queue head
+ *
+ * @return Number of requests.
+ */
+static unsigned int
+rcf_stats_queue_len(const usrreq *queue)
+{
+    const usrreq *req;
+    unsigned int  len = 0;
+
+    for (req = queue->next; req != queue; req = req->next)
+        len++;
+
+    return len;
+}
+
+/* See description in rcf.h */
+void
+rcf_stats_report(ta *agent, te_string *report)
+{
+    rcf_ta_stats   *stats = rcf_stats_get(agent);
+    unsigned int    op;
+    unsigned int    stage;
+
+    te_string_append(report,
+                     "TA %s: %u in flight (max %u), %u sent, %u waiting, "
+                     "%u pending\n", agent->name, stats->in_flight,
+                     stats->max_in_flight, rcf_stats_queue_len(&agent->sent),
+                     rcf_stats_queue_len(&agent->waiting),
+                     rcf_stats_queue_len(&agent->pending));
+
+    for (op = 0; op < RCF_STATS_OPS; op++)
+    {
+        const rcf_op_stats *s = stats->ops[op];
+
+        if (s == NULL)
+            continue;
+
+        te_string_append(report,
+                         "  %s: %" TE_PRINTF_64 "u requests, "
+                         "%" TE_PRINTF_64 "u errors\n",
+                         rcf_op_to_string(op), s->requests, s->errors);
+
+        for (stage = 0; stage < RCF_STATS_STAGES; stage++)
+        {
+            const rcf_stats_hist *h = &s->hist[stage];
+
+            if (h->count == 0)
+                continue;
+
+            te_string_append(report,
+                             "    %-8s mean %" TE_PRINTF_64 "u "
+                             "p50 %" TE_PRINTF_64 "u "
+                             "p90 %" TE_PRINTF_64 "u "
+                             "p99 %" TE_PRINTF_64 "u "
+                             "max %" TE_PRINTF_64 "u us\n",
+                             rcf_stats_stage_names[stage],
+                             h->sum / h->count,
+                             rcf_stats_hist_percentile(h, 50),
+                             rcf_stats_hist_percentile(h, 90),
+                             rcf_stats_hist_percentile(h, 99), h->max);
+        }
+    }
+}
+
+/* See description in rcf.h */
+void
+rcf_stats_free(ta *agent)
+{
+    unsigned int op;
+
+    if (agent->stats == NULL)
+        return;
+
+    for (op = 0; op < RCF_STATS_OPS; op++)
+        free(agent->stats->ops[op]);
+
+    free(agent->stats);
+    agent->stats = NULL;
+}
@@ -11,6 +11,7 @@
 #ifndef __TE_COMM_AGENT_H__
 #define __TE_COMM_AGENT_H__
 
+#include "te_stdint.h"
 #include "te_errno.h"
 
 /** This structure is used to store some context for each connection. */
@@ -108,6 +109,24 @@ extern int rcf_comm_agent_wait(rcf_comm_connection *rcc,
 extern int rcf_comm_agent_reply(rcf_comm_connection *rcc,
                                 const void *p_buffer, size_t length);
 
+/**
+ * Send a part of the file as a part of reply to the Test Engine side of
+ * Network Communication library. The data are sent directly from
+ * the file to the connection if the system allows it.
+ *
+ * @param rcc           Handler received from rcf_comm_agent_init.
+ * @param fd            File descriptor of the file.
+ * @param offset        Offset of the part in the file.
+ * @param length        Length of the part.
+ *
+ * @return Status code.
+ * @retval 0            Success.
+ * @retval TE_EIO       The file is shorter than expected.
+ * @retval other value  errno.
+ */
+extern int rcf_comm_agent_reply_file(rcf_comm_connection *rcc, int fd,
+                                     uint64_t offset, uint64_t length);
+
 /**
  * Close connection.
  *
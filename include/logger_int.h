@@ -46,6 +46,14 @@ extern "C" {
 #define LGR_SRV_SNIFFER_MARK "LGR-SNIFFER_MARK"
 #define SNIFFER_MIN_MARK_SIZE 512
 
+/**
+ * Prefix of the message carrying several raw log messages to the Logger
+ * server. The prefix (preceded by its length as NFL) is followed by
+ * raw log messages, each of them preceded by its length as 32-bit
+ * integer in network byte order.
+ */
+#define LGR_SRV_BATCH "LGR-BATCH"
+
 /* ==== Test Agent Logger lib definitions */
 
 /*
@@ -17,6 +17,7 @@
 #endif
 
 #include "te_stdint.h"
+#include "te_defs.h"
 #include "te_errno.h"
 
 
@@ -98,6 +99,7 @@ typedef enum {
     RCFOP_TADEAD,           /**< Inform RCF that TA is dead */
     RCFOP_GET_SNIFFERS,     /**< Obtain the list of sniffers */
     RCFOP_GET_SNIF_DUMP,    /**< Pull out capture logs of the sniffer */
+    RCFOP_GET_STATS,        /**< Obtain statistics of requests */
 } rcf_op_t;
 
 
@@ -136,7 +138,10 @@ typedef struct rcf_msg {
 
     char  file[RCF_MAX_PATH];   /**< Local full file name */
     char  value[RCF_MAX_VAL];   /**< Value of the variable or object
-                                     instance */
+                                     instance;
+                                     file range "<offset> <length>"
+                                     (RCFOP_FPUT, RCFOP_FGET) or empty
+                                     string for the whole file */
 
     char  data[0];              /**< Start of additional for commands:
                                      RCFOP_TALIST (list of names);
@@ -144,7 +149,8 @@ typedef struct rcf_msg {
                                      RCFOP_CSAP_CREATE (parameters);
                                      RCFOP_EXECUTE (parameters);
                                      RCFOP_RPC (encoded data);
-                                     RCFOP_GET/PUT (remote file) */
+                                     RCFOP_GET/PUT (remote file);
+                                     RCFOP_GET_STATS (report) */
 } rcf_msg;
 
 /** Parameters generated by rcf_make_params function */
@@ -219,10 +225,82 @@ rcf_op_to_string(rcf_op_t op)
         case RCFOP_KILL:            return "kill";
         case RCFOP_GET_SNIFFERS:    return "get sniffers";
         case RCFOP_GET_SNIF_DUMP:   return "get snif dump";
+        case RCFOP_GET_STATS:       return "get stats";
         default:                    return "(unknown)";
     }
 }
 
+struct te_dbuf;
+
+/**
+ * Minimum length of the message payload passed via shared memory
+ * instead of IPC by rcf_msg_pack().
+ */
+#define RCF_MSG_SHM_MIN_LEN     (64 * 1024)
+
+/**
+ * Serialise RCF message in compact layout: only used parts of string
+ * fields and payload (data or encoded RPC) are put to the buffer.
+ *
+ * @param msg           Message to serialise
+ * @param buf           Buffer for the serialised message (reset before
+ *                      serialisation)
+ * @param shm_fd        If not @c NULL, large payload may be passed via
+ *                      shared memory file descriptor returned in this
+ *                      location (or @c -1 if it is not used). It must
+ *                      be sent with the message by
+ *                      ipc_send_message_with_fd() and closed then; if
+ *                      it cannot be sent, the message should be
+ *                      serialised again without shared memory.
+ *
+ * @return Status code.
+ */
+extern te_errno rcf_msg_pack(const rcf_msg *msg, struct te_dbuf *buf,
+                             int *shm_fd);
+
+/**
+ * Check whether the buffer contains a message in compact layout
+ * rather than legacy fixed-size @ref rcf_msg.
+ *
+ * @param buf           Received message
+ * @param len           Length of the received message
+ *
+ * @return @c true if the message is serialised with rcf_msg_pack().
+ */
+extern bool rcf_msg_is_packed(const void *buf, size_t len);
+
+/**
+ * Get length of the memory required for the message serialised with
+ * rcf_msg_pack().
+ *
+ * @param buf           Serialised message
+ * @param len           Length of the serialised message
+ *
+ * @return Length of the memory (at least sizeof(rcf_msg)) or @c 0 if
+ *         the message is malformed.
+ */
+extern size_t rcf_msg_unpacked_len(const void *buf, size_t len);
+
+/**
+ * Deserialise the message serialised with rcf_msg_pack().
+ *
+ * If the message is malformed but starts with a complete header, its
+ * identification (operation code, sequence number, session, etc.) is
+ * still filled in, so that the sender may be answered with an error.
+ *
+ * @param buf           Serialised message
+ * @param len           Length of the serialised message
+ * @param shm_fd        Shared memory file descriptor received with
+ *                      the message or @c -1 (it is not closed)
+ * @param msg           Location for the message of rcf_msg_unpacked_len()
+ *                      bytes (or at least sizeof(rcf_msg) bytes if
+ *                      the message is malformed)
+ *
+ * @return Status code.
+ */
+extern te_errno rcf_msg_unpack(const void *buf, size_t len, int shm_fd,
+                               rcf_msg *msg);
+
 /** Type of IPC used by RCF on Test Engine */
 #define RCF_IPC     (true)  /* Connection-oriented IPC */
 
@@ -98,7 +98,7 @@ typedef te_errno (* rcf_talib_finish)(rcf_talib_handle  handle,
  * @param handle        TA handle
  * @param select_set    FD_SET to be updated with the TA connection file
  *                      descriptor (for Test Agents supporting listening
- *                      mode) (IN/OUT)
+ *                      mode) (IN/OUT, may be @c NULL)
  *
  * @param select_tm     timeout value for the select to be updated with
  *                      TA polling interval (for Test Agents supporting
@@ -132,6 +132,18 @@ typedef te_errno (* rcf_talib_transmit)(rcf_talib_handle handle,
  */
 typedef bool (* rcf_talib_is_ready)(rcf_talib_handle handle);
 
+/**
+ * Get file descriptor of the Test Agent connection which becomes
+ * readable when data are pending. RCF watches it instead of calling
+ * is_ready method for all Test Agents on every iteration.
+ *
+ * @param handle        TA handle
+ *
+ * @return File descriptor or @c -1 if there is no connection or it
+ *         cannot be watched (is_ready method is polled in this case).
+ */
+typedef int (* rcf_talib_get_fd)(rcf_talib_handle handle);
+
 /**
  * Receive one command (possibly with attachment) from the Test Agent
  * or its part.
@@ -171,7 +183,7 @@ typedef te_errno (* rcf_talib_receive)(rcf_talib_handle handle,
  * @param handle        TA handle
  * @param select_set    FD_SET to be updated with the TA connection file
  *                      descriptor (for Test Agents supporting listening
- *                      mode) (IN/OUT)
+ *                      mode) (IN/OUT, may be @c NULL)
  *
  * @return Error code.
  */
@@ -191,6 +203,7 @@ struct rcf_talib_methods {
     rcf_talib_transmit  transmit; /**< Transmit to TA */
     rcf_talib_is_ready  is_ready; /**< Is data from TA pending */
     rcf_talib_receive   receive;  /**< Receive from TA */
+    rcf_talib_get_fd    get_fd;   /**< Get TA connection descriptor */
 };
 
 /**
@@ -211,7 +224,8 @@ struct rcf_talib_methods TE_CONCAT(TE_LIB_NAME, _methods) = {            \
     talib_prefix_ ## _connect,                                          \
     talib_prefix_ ## _transmit,                                         \
     talib_prefix_ ## _is_ready,                                         \
-    talib_prefix_ ## _receive                                           \
+    talib_prefix_ ## _receive,                                          \
+    talib_prefix_ ## _get_fd                                            \
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,202 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment
+ *
+ * Compact binary encoding of Test Protocol commands (used by RCF process
+ * and RCF PCH library).
+ *
+ * A command encoded in binary form is sent as
+ * "SID <sid> binary attach <length>" followed by the attachment:
+ * - version (1 byte, @ref RCF_PROTO_BIN_VERSION);
+ * - operation code (1 byte, @ref rcf_op_t);
+ * - variable type (1 byte, @ref rcf_var_type_t, zero if not applicable);
+ * - number of fields (1 byte);
+ * - fields, each one is a 4-byte big-endian length followed by
+ *   the field bytes and terminating zero byte (not counted in length).
+ *
+ * Fields are not quoted or escaped, so that they may be used in place
+ * without copying. Answers are sent in the usual text form.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_RCF_PROTO_BIN_H__
+#define __TE_RCF_PROTO_BIN_H__
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "te_stdint.h"
+#include "te_defs.h"
+#include "te_errno.h"
+#include "rcf_common.h"
+#include "rcf_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Test Protocol keyword of the command encoded in binary form */
+#define TE_PROTO_BINARY             "binary"
+
+/**
+ * Name of the Test Agent string variable used to negotiate encoding:
+ * reading it returns space-separated list of supported encodings and
+ * protocol extensions, writing it selects encoding used by RCF for the
+ * Test Agent.
+ */
+#define RCF_PROTO_VAR               "rcf_protocol"
+
+/** Name of the text encoding */
+#define RCF_PROTO_TEXT              "text"
+
+/**
+ * Name of the protocol extension: bulk configure get of a subtree.
+ *
+ * Configure get of an instance identifier followed by
+ * @ref RCF_PROTO_CFG_BULK_SUFFIX is answered with "0 attach <length>"
+ * and the attachment with identifiers of the instance and all its
+ * descendants followed by their values. Each identifier and value is
+ * a zero-terminated string, the list is terminated by an empty string.
+ */
+#define RCF_PROTO_CFG_BULK          "cfg_bulk"
+
+/** Suffix of the instance identifier in bulk configure get */
+#define RCF_PROTO_CFG_BULK_SUFFIX   "/...="
+
+/**
+ * Name of the protocol extension: generation of a subtree.
+ *
+ * Configure get of an instance identifier followed by
+ * @ref RCF_PROTO_CFG_GEN_SUFFIX is answered with a string which is
+ * changed on each change of the subtree of the instance object, or
+ * with @c TE_EOPNOTSUPP if the Test Agent does not track all changes
+ * of the subtree.
+ */
+#define RCF_PROTO_CFG_GEN           "cfg_gen"
+
+/** Suffix of the instance identifier in subtree generation get */
+#define RCF_PROTO_CFG_GEN_SUFFIX    "/...#"
+
+/** Encodings and extensions supported by this version of RCF PCH */
+#define RCF_PROTO_SUPPORTED \
+    RCF_PROTO_TEXT " " TE_PROTO_BINARY " " RCF_PROTO_CFG_BULK " " \
+    RCF_PROTO_CFG_GEN
+
+/** Version of the binary encoding */
+#define RCF_PROTO_BIN_VERSION       1
+
+/** Length of the binary command header */
+#define RCF_PROTO_BIN_HDR_LEN       4
+
+/** Maximum number of fields in the binary command */
+#define RCF_PROTO_BIN_MAX_FIELDS    2
+
+/**
+ * Encode the command in binary form.
+ *
+ * @param buf           Buffer for the encoded command
+ * @param size          Size of the buffer
+ * @param opcode        Operation code
+ * @param type          Variable type or @c 0
+ * @param n_fields      Number of fields
+ * @param fields        Fields (zero-terminated strings)
+ *
+ * @return Length of the encoded command or @c 0 if it does not fit
+ *         into the buffer.
+ */
+static inline size_t
+rcf_proto_bin_encode(uint8_t *buf, size_t size, rcf_op_t opcode,
+                     unsigned int type, unsigned int n_fields,
+                     const char * const *fields)
+{
+    size_t       off = RCF_PROTO_BIN_HDR_LEN;
+    unsigned int i;
+
+    if (size < RCF_PROTO_BIN_HDR_LEN || n_fields > RCF_PROTO_BIN_MAX_FIELDS)
+        return 0;
+
+    buf[0] = RCF_PROTO_BIN_VERSION;
+    buf[1] = (uint8_t)opcode;
+    buf[2] = (uint8_t)type;
+    buf[3] = (uint8_t)n_fields;
+
+    for (i = 0; i < n_fields; i++)
+    {
+        size_t len = strlen(fields[i]);
+
+        if (size - off < len + 5 || len > UINT32_MAX)
+            return 0;
+
+        buf[off++] = (uint8_t)(len >> 24);
+        buf[off++] = (uint8_t)(len >> 16);
+        buf[off++] = (uint8_t)(len >> 8);
+        buf[off++] = (uint8_t)len;
+        memcpy(buf + off, fields[i], len + 1);
+        off += len + 1;
+    }
+
+    return off;
+}
+
+/**
+ * Decode the command encoded in binary form. Fields are not copied,
+ * returned pointers refer to @p buf.
+ *
+ * @param buf           Encoded command
+ * @param len           Length of the encoded command
+ * @param opcode        Location for operation code
+ * @param type          Location for variable type
+ * @param n_fields      Location for number of fields
+ * @param fields        Location for @ref RCF_PROTO_BIN_MAX_FIELDS field
+ *                      pointers
+ *
+ * @return Status code
+ * @retval TE_EPROTONOSUPPORT   Unknown encoding version
+ * @retval TE_EFMT              Malformed command
+ */
+static inline te_errno
+rcf_proto_bin_decode(uint8_t *buf, size_t len, rcf_op_t *opcode,
+                     unsigned int *type, unsigned int *n_fields,
+                     char **fields)
+{
+    size_t       off = RCF_PROTO_BIN_HDR_LEN;
+    unsigned int i;
+
+    if (len < RCF_PROTO_BIN_HDR_LEN)
+        return TE_EFMT;
+    if (buf[0] != RCF_PROTO_BIN_VERSION)
+        return TE_EPROTONOSUPPORT;
+    if (buf[3] > RCF_PROTO_BIN_MAX_FIELDS)
+        return TE_EFMT;
+
+    *opcode = buf[1];
+    *type = buf[2];
+    *n_fields = buf[3];
+
+    for (i = 0; i < *n_fields; i++)
+    {
+        size_t flen;
+
+        if (len - off < 4)
+            return TE_EFMT;
+
+        flen = ((size_t)buf[off] << 24) | ((size_t)buf[off + 1] << 16) |
+               ((size_t)buf[off + 2] << 8) | buf[off + 3];
+        off += 4;
+
+        if (len - off < flen + 1 || buf[off + flen] != '\0')
+            return TE_EFMT;
+
+        fields[i] = (char *)buf + off;
+        off += flen + 1;
+    }
+
+    return off == len ? 0 : TE_EFMT;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* !__TE_RCF_PROTO_BIN_H__ */
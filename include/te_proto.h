@@ -50,6 +50,12 @@
 #define TE_PROTO_GET_SNIFFERS   "get_sniffers"
 #define TE_PROTO_GET_SNIF_DUMP  "get_snif_dump"
 
+/**
+ * Marker in the answer to @c get_log command telling that the Test Agent
+ * has more log messages to be passed right away.
+ */
+#define TE_PROTO_LOG_MORE       "more"
+
 #ifdef RCF_NEED_TYPES
 /**
  * Types recoding table.
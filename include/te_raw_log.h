@@ -85,6 +85,64 @@ typedef uint32_t te_log_seqno;
                                      sizeof(te_log_level))
 
 
+/**
+ * Suffix appended to the raw log file name to get the name of its
+ * index file created by the Logger.
+ */
+#define TE_RAW_LOG_INDEX_SUFFIX ".idx"
+
+/**
+ * Maximum amount of raw log data in bytes between two consecutive
+ * index entries (it may be exceeded by a single message).
+ */
+#define TE_RAW_LOG_INDEX_PERIOD (1 << 16)
+
+/**
+ * Raw log index entry. All fields are in network byte order.
+ *
+ * An entry is added for the first message of each run of consecutive
+ * messages with the same log ID, for each control message and at least
+ * every #TE_RAW_LOG_INDEX_PERIOD bytes of the raw log. So all the
+ * messages between two consecutive entries have the log ID of the
+ * first one and timestamps of the entries give approximate time of
+ * the raw log parts.
+ */
+typedef struct te_raw_log_index_entry {
+    uint32_t        offset_hi;  /**< High 32 bits of the message offset
+                                     in the raw log file */
+    uint32_t        offset_lo;  /**< Low 32 bits of the message offset */
+    te_log_ts_sec   ts_sec;     /**< Message timestamp seconds */
+    te_log_ts_usec  ts_usec;    /**< Message timestamp microseconds */
+    te_log_id       id;         /**< Message log ID */
+    te_log_level    level;      /**< Message log level */
+    uint16_t        reserved;   /**< Reserved, must be zero */
+} te_raw_log_index_entry;
+
+/**
+ * Suffix appended to the raw log file name to get the name of its
+ * segments file written by the Logger if the raw log is compressed.
+ *
+ * A compressed raw log is a sequence of gzip members (segments), each
+ * of them may be decompressed independently. The segments file is
+ * an array of te_raw_log_segment_entry records, one per segment, in
+ * the order of segments. Offsets in the raw log index refer to the
+ * decompressed data.
+ */
+#define TE_RAW_LOG_SEGMENTS_SUFFIX ".seg"
+
+/** Compressed raw log segment entry. All fields are in network byte order. */
+typedef struct te_raw_log_segment_entry {
+    uint32_t    raw_offset_hi;  /**< High 32 bits of the decompressed
+                                     data offset of the segment */
+    uint32_t    raw_offset_lo;  /**< Low 32 bits of the decompressed
+                                     data offset */
+    uint32_t    file_offset_hi; /**< High 32 bits of the segment offset
+                                     in the compressed file */
+    uint32_t    file_offset_lo; /**< Low 32 bits of the segment offset
+                                     in the compressed file */
+} te_raw_log_segment_entry;
+
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
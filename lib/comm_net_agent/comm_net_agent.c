@@ -51,12 +51,19 @@
 #if HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
+#if HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
 
+#include "te_defs.h"
 #include "te_alloc.h"
 #include "te_errno.h"
 #include "comm_agent.h"
 
 
+/** Length of the buffer used to send file if sendfile() cannot be used */
+#define REPLY_FILE_BUF_LEN  (1024 * 1024)
+
 /**
  * Error logging macro (TE logging facilities cannot be used here).
  *
@@ -459,6 +466,68 @@ rcf_comm_agent_reply(struct rcf_comm_connection *rcc, const void *buffer,
 }
 
 
+/* See description in comm_agent.h */
+int
+rcf_comm_agent_reply_file(struct rcf_comm_connection *rcc, int fd,
+                          uint64_t offset, uint64_t length)
+{
+    uint8_t *buf;
+    ssize_t  len;
+    int      rc = 0;
+
+#if HAVE_SYS_SENDFILE_H
+    off_t    off = offset;
+
+    while (length > 0)
+    {
+        len = sendfile(rcc->socket, fd, &off,
+                       MIN(length, REPLY_FILE_BUF_LEN));
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            /* Fall back to read()/send() if nothing is sent yet */
+            if ((errno == EINVAL || errno == ENOSYS) &&
+                (uint64_t)off == offset)
+                break;
+
+            ERROR("%s(): sendfile(%d) failed: errno=%d\n",
+                  __FUNCTION__, rcc->socket, errno);
+            return TE_OS_RC(TE_COMM, errno);
+        }
+        if (len == 0)
+        {
+            ERROR("%s(): unexpected end of file\n", __FUNCTION__);
+            return TE_RC(TE_COMM, TE_EIO);
+        }
+
+        length -= len;
+    }
+    if (length == 0)
+        return 0;
+#endif
+
+    buf = TE_ALLOC(MIN(length, REPLY_FILE_BUF_LEN));
+    while (rc == 0 && length > 0)
+    {
+        len = pread(fd, buf, MIN(length, REPLY_FILE_BUF_LEN), offset);
+        if (len <= 0)
+        {
+            ERROR("%s(): failed to read file: errno=%d\n",
+                  __FUNCTION__, len < 0 ? errno : 0);
+            rc = (len < 0) ? TE_OS_RC(TE_COMM, errno) :
+                             TE_RC(TE_COMM, TE_EIO);
+            break;
+        }
+
+        rc = rcf_comm_agent_reply(rcc, buf, len);
+        offset += len;
+        length -= len;
+    }
+    free(buf);
+
+    return rc;
+}
 
 /**
  * Close connection.
@@ -40,6 +40,9 @@
 #if HAVE_NETDB_H
 #include <netdb.h>
 #endif
+#if HAVE_POLL_H
+#include <poll.h>
+#endif
 
 #include "te_alloc.h"
 #include "te_errno.h"
@@ -86,6 +89,7 @@ static int read_socket(int socket, char *buffer, size_t len);
  * @param  p_rnc        pointer to to pointer to the rcf_net_connection
  *                      structure to be filled, used as handler
  * @param  p_select_set pointer to the fdset for reading to be modified
+ *                      (may be @c NULL)
  *
  * @return Status code.
  * @retval 0            Success.
@@ -227,7 +231,8 @@ rcf_net_engine_connect(const char *addr, const char *port,
     }
 #endif /* defined(TCP_NODELAY) || defined(SO_KEEPALIVE) */
 
-    FD_SET(s, p_select_set);
+    if (p_select_set != NULL)
+        FD_SET(s, p_select_set);
 
     /* Connection established. Let's allocate memory for rnc and fill it*/
     *p_rnc = TE_ALLOC(sizeof(**p_rnc));
@@ -302,8 +307,7 @@ rcf_net_engine_transmit(struct rcf_net_connection *rnc,
 bool
 rcf_net_engine_is_ready(struct rcf_net_connection *rnc)
 {
-    fd_set          rfds;
-    struct timeval  tv;
+    struct pollfd pfd;
 
     if (rnc == NULL)
         return false;
@@ -311,14 +315,19 @@ rcf_net_engine_is_ready(struct rcf_net_connection *rnc)
     if (rnc->bytes_to_read > 0)
         return true;
 
-    FD_ZERO(&rfds);
-    FD_SET(rnc->socket, &rfds);
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
+    /* poll() is used since the socket may be beyond FD_SETSIZE */
+    pfd.fd = rnc->socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
 
-    select(rnc->socket + 1, &rfds, NULL, NULL, &tv);
+    return poll(&pfd, 1, 0) > 0;
+}
 
-    return FD_ISSET(rnc->socket, &rfds) ? true : false;
+/* See description in comm_net_engine.h */
+int
+rcf_net_engine_get_fd(struct rcf_net_connection *rnc)
+{
+    return (rnc == NULL) ? -1 : rnc->socket;
 }
 
 /**
@@ -494,6 +503,7 @@ rcf_net_engine_receive(struct rcf_net_connection *rnc, char *buffer,
  * @param p_rnc         Pointer to variable with  handler received from
  *                      rcf_net_engine_connect
  * @param p_select_set  Pointer to the fdset for reading to be modified
+ *                      (may be @c NULL)
  *
  * @return Status code.
  * @retval 0            Success.
@@ -511,7 +521,8 @@ rcf_net_engine_close(struct rcf_net_connection **p_rnc,
     if (*p_rnc == NULL)
         return 0;
 
-    FD_CLR((*p_rnc)->socket, p_select_set);
+    if (p_select_set != NULL)
+        FD_CLR((*p_rnc)->socket, p_select_set);
 
     if (close((*p_rnc)->socket) < 0)
     {
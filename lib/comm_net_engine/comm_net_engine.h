@@ -35,6 +35,7 @@ struct rcf_net_connection;
  * @param  p_rnc        - pointer to to pointer to the rcf_net_connection
  *                        structure to be filled, used as handler
  * @param  p_select_set - pointer to the fdset for reading to be modified
+ *                        (may be @c NULL)
  *
  * @return Status code.
  * @retval 0            - success
@@ -72,6 +73,16 @@ extern int rcf_net_engine_transmit(struct rcf_net_connection *rnc,
  */
 extern bool rcf_net_engine_is_ready(struct rcf_net_connection *rnc);
 
+/**
+ * Get file descriptor of the test agent connection to watch it
+ * for incoming data.
+ *
+ * @param rnc       - Handler received from rcf_net_engine_connect.
+ *
+ * @return File descriptor or @c -1 if @p rnc is @c NULL.
+ */
+extern int rcf_net_engine_get_fd(struct rcf_net_connection *rnc);
+
 
 /**
  * Receive data from the Test Agent via Network Communication library.
@@ -129,6 +140,7 @@ extern int rcf_net_engine_receive(struct rcf_net_connection *rnc,
  * @param p_rnc         Pointer to variable with handler received from
  *                      rcf_net_engine_connect
  * @param p_select_set  Pointer to the fdset for reading to be modified
+ *                      (may be @c NULL)
  *
  * @return Status code.
  * @retval 0            - success
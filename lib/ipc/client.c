@@ -129,7 +129,11 @@ struct ipc_client_server {
                                      left to read from the socket and
                                      to return to user.
                                      This field MUST be 4-octets long. */
+            bool    in_shm;     /**< Is the current message in the
+                                     shared memory ring? */
 
+            struct ipc_shm *shm;    /**< Shared memory with the server
+                                         or @c NULL */
         } stream;
     };
 };
@@ -156,6 +160,7 @@ struct ipc_client {
         /* Connection-oriented client data */
         struct {
             char   *out_buffer; /**< Buffer for outgoing messages */
+            bool    use_shm;    /**< Create shared memory with servers */
         } stream;
     };
 };
@@ -299,6 +304,7 @@ ipc_free_client_server_pool(struct ipc_client *ipcc)
         {
             if (ipccs->stream.socket >= 0)
                 close(ipccs->stream.socket);
+            ipc_shm_destroy(ipccs->stream.shm);
         }
         else
         {
@@ -688,6 +694,8 @@ ipc_init_client(const char *name, bool conn,
             ipcc->stream.out_buffer = NULL;
         }
 
+        ipcc->stream.use_shm = ipc_shm_enabled();
+
         ipcc->send = ipc_stream_send_message;
         ipcc->recv = ipc_stream_receive_answer;
         ipcc->recv_rest = ipc_stream_receive_rest_answer;
@@ -1278,24 +1286,103 @@ ipc_dgram_receive_rest_answer(struct ipc_client *ipcc,
 }
 
 
-/* See description in ipc_client.h */
+/**
+ * Send a message header with a file descriptor attached.
+ *
+ * @param server        The server
+ * @param hdr           Message header
+ * @param fd            File descriptor to pass
+ *
+ * @return Status code.
+ */
 static int
-ipc_stream_send_message(struct ipc_client *ipcc, const char *server_name,
-                        const void *msg, size_t msg_len)
+ipc_stream_send_header_fd(struct ipc_client_server *server, size_t hdr,
+                          int fd)
 {
-    struct ipc_client_server *server;
+    struct iovec    iov = { .iov_base = &hdr, .iov_len = sizeof(hdr) };
+    union {
+        char            buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr  align;
+    } control;
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+
+    memset(&control, 0, sizeof(control));
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fd));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+
+    /* The header is short, so it is sent at once or not at all */
+    if (sendmsg(server->stream.socket, &msg, 0) != sizeof(hdr))
+    {
+        int rc = errno;
 
-    if ((ipcc == NULL) || (server_name == NULL) ||
-        (msg == NULL) != (msg_len == 0))
+        perror("ipc_stream_send_header_fd(): sendmsg() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+    return 0;
+}
+
+/**
+ * Create shared memory with the server and pass it in the first message
+ * header on the just established connection. The connection is used
+ * without shared memory if it cannot be created.
+ *
+ * @param server        The server
+ *
+ * @return Status code.
+ */
+static int
+ipc_stream_shm_connect(struct ipc_client_server *server)
+{
+    int fd;
+    int rc;
+
+    if (ipc_shm_create(&server->stream.shm, &fd) != 0)
+        return 0;
+
+    rc = ipc_stream_send_header_fd(server, IPC_SHM_HELLO, fd);
+    close(fd);
+    if (rc != 0)
     {
-        return TE_RC(TE_IPC, TE_EINVAL);
+        ipc_shm_destroy(server->stream.shm);
+        server->stream.shm = NULL;
     }
 
+    return rc;
+}
+
+/**
+ * Get the server from the pool and connect to it if the connection
+ * is not established yet.
+ *
+ * @param ipcc          Pointer to the ipc_client structure
+ * @param server_name   Name of the server
+ * @param p_server      Location for the server
+ *
+ * @return Status code.
+ */
+static int
+ipc_stream_connect(struct ipc_client *ipcc, const char *server_name,
+                   struct ipc_client_server **p_server)
+{
+    struct ipc_client_server *server;
+
     server = get_pool_item_by_name(ipcc, server_name);
     if (server == NULL)
     {
         return TE_OS_RC(TE_IPC, errno);
     }
+    *p_server = server;
 
     if (server->stream.socket == -1)
     {
@@ -1352,11 +1439,50 @@ ipc_stream_send_message(struct ipc_client *ipcc, const char *server_name,
                 sleep(IPC_SLEEP);
             }
         }
+
+        if (ipcc->stream.use_shm)
+        {
+            int rc = ipc_stream_shm_connect(server);
+
+            if (rc != 0)
+                return rc;
+        }
+    }
+
+    return 0;
+}
+
+/* See description in ipc_client.h */
+static int
+ipc_stream_send_message(struct ipc_client *ipcc, const char *server_name,
+                        const void *msg, size_t msg_len)
+{
+    struct ipc_client_server *server;
+    int                       rc;
+
+    if ((ipcc == NULL) || (server_name == NULL) ||
+        (msg == NULL) != (msg_len == 0))
+    {
+        return TE_RC(TE_IPC, TE_EINVAL);
     }
 
+    rc = ipc_stream_connect(ipcc, server_name, &server);
+    if (rc != 0)
+        return rc;
+
     /* At this point we have established connection. Send data */
 
-    if (msg_len + 8 > IPC_TCP_CLIENT_BUFFER_SIZE)
+    if (msg_len + 8 > IPC_TCP_CLIENT_BUFFER_SIZE &&
+        server->stream.shm != NULL &&
+        ipc_shm_put(server->stream.shm, IPC_SHM_TO_SERVER, msg, msg_len))
+    {
+        /* Only the header is sent, it wakes up the server */
+        size_t len = msg_len | IPC_SHM_MSG_FLAG;
+
+        return write_socket(server->stream.socket,
+                            (char *)&len, sizeof(len));
+    }
+    else if (msg_len + 8 > IPC_TCP_CLIENT_BUFFER_SIZE)
     {
         /* Message is too long to fit into the internal buffer */
         size_t len = msg_len;
@@ -1408,7 +1534,12 @@ ipc_client_int_receive(struct ipc_client_server *server,
     assert(buf != NULL || *p_buf_len == 0);
 
     octets_to_read = MIN(*p_buf_len, server->stream.pending);
-    if (octets_to_read > 0)
+    if (octets_to_read > 0 && server->stream.in_shm)
+    {
+        ipc_shm_get(server->stream.shm, IPC_SHM_TO_CLIENT, buf,
+                    octets_to_read);
+    }
+    else if (octets_to_read > 0)
     {
         int rc = read_socket(server->stream.socket, buf, octets_to_read);
 
@@ -1481,6 +1612,19 @@ ipc_stream_receive_answer(struct ipc_client *ipcc, const char *server_name,
         return TE_RC(TE_IPC, rc);
     }
 
+    server->stream.in_shm = (server->stream.pending & IPC_SHM_MSG_FLAG) != 0;
+    if (server->stream.in_shm)
+    {
+        server->stream.pending &= ~IPC_SHM_MSG_FLAG;
+        if (server->stream.shm == NULL ||
+            server->stream.pending >
+                ipc_shm_available(server->stream.shm, IPC_SHM_TO_CLIENT))
+        {
+            server->stream.pending = 0;
+            return TE_RC(TE_IPC, TE_ESYNCFAILED);
+        }
+    }
+
     return ipc_client_int_receive(server, buf, p_buf_len);
 }
 
@@ -1521,6 +1665,42 @@ ipc_send_message(struct ipc_client *ipcc, const char *server_name,
 }
 
 
+/* See description in ipc_client.h */
+int
+ipc_send_message_with_fd(struct ipc_client *ipcc, const char *server_name,
+                         const void *msg, size_t msg_len, int fd)
+{
+#ifdef TE_IPC_AF_UNIX
+    struct ipc_client_server *server;
+    int                       rc;
+
+    if (ipcc == NULL || server_name == NULL || fd < 0 ||
+        (msg == NULL) != (msg_len == 0))
+        return TE_RC(TE_IPC, TE_EINVAL);
+
+    /* Descriptors cannot be passed in datagrams of the pool */
+    if (!ipcc->conn)
+        return TE_RC(TE_IPC, TE_EOPNOTSUPP);
+
+    rc = ipc_stream_connect(ipcc, server_name, &server);
+    if (rc != 0)
+        return rc;
+
+    rc = ipc_stream_send_header_fd(server, IPC_FD_HEADER, fd);
+    if (rc != 0)
+        return rc;
+
+    return ipc_stream_send_message(ipcc, server_name, msg, msg_len);
+#else
+    UNUSED(ipcc);
+    UNUSED(server_name);
+    UNUSED(msg);
+    UNUSED(msg_len);
+    UNUSED(fd);
+    return TE_RC(TE_IPC, TE_EOPNOTSUPP);
+#endif
+}
+
 /* See description in ipc_client.h */
 int
 ipc_receive_answer(struct ipc_client *ipcc, const char *server_name,
@@ -0,0 +1,274 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Benchmark of IPC transports: round-trip latency and throughput of
+ * echoed messages of different sizes over connectionless IPC,
+ * connection-oriented IPC and connection-oriented IPC with shared
+ * memory.
+ *
+ * Usage: te_ipc_bench [iterations]
+ *
+ * It is built if @c benchmarks meson option is enabled.
+ *
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#if HAVE_TIME_H
+#include <time.h>
+#endif
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "ipc_client.h"
+#include "ipc_server.h"
+
+#include "ipc_internal.h"
+
+
+/** Default number of round trips for each message size */
+#define IPC_BENCH_ITERATIONS    1000
+
+/** Length of the message asking the server to stop */
+#define IPC_BENCH_STOP_LEN      1
+
+/** Sizes of echoed messages */
+static const size_t ipc_bench_sizes[] = {
+    64, 4096, 65536, 1 << 20,
+};
+
+/** Transport to benchmark */
+typedef struct ipc_bench_transport {
+    const char *name;   /**< Name of the transport */
+    bool        conn;   /**< Is connection-oriented? */
+    bool        shm;    /**< Use shared memory? */
+} ipc_bench_transport;
+
+/** Transports to benchmark */
+static const ipc_bench_transport ipc_bench_transports[] = {
+    { "dgram",  false,  false },
+    { "stream", true,   false },
+    { "shm",    true,   true },
+};
+
+/** Size of the largest message */
+#define IPC_BENCH_MAX_SIZE \
+    (ipc_bench_sizes[TE_ARRAY_LEN(ipc_bench_sizes) - 1])
+
+/**
+ * Get monotonic time.
+ *
+ * @return Time in seconds.
+ */
+static double
+ipc_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Echo messages of clients until the stop message is received.
+ *
+ * @param ipcs      IPC server
+ * @param buf       Buffer for messages
+ *
+ * @return Status code.
+ */
+static int
+ipc_bench_serve(struct ipc_server *ipcs, void *buf)
+{
+    struct ipc_server_client   *ipcsc;
+    size_t                      len;
+    int                         rc;
+
+    while (true)
+    {
+        ipcsc = NULL;
+        len = IPC_BENCH_MAX_SIZE;
+        rc = ipc_receive_message(ipcs, buf, &len, &ipcsc);
+        if (rc != 0)
+            return rc;
+
+        rc = ipc_send_answer(ipcs, ipcsc, buf, len);
+        if (rc != 0 || len == IPC_BENCH_STOP_LEN)
+            return rc;
+    }
+}
+
+/**
+ * Send messages of all sizes to the server and print the results.
+ *
+ * @param transport     Transport
+ * @param server_name   Name of the server
+ * @param iterations    Number of round trips for each message size
+ * @param buf           Buffer for messages
+ *
+ * @return Status code.
+ */
+static int
+ipc_bench_client(const ipc_bench_transport *transport,
+                 const char *server_name, unsigned int iterations,
+                 void *buf)
+{
+    struct ipc_client  *ipcc;
+    char                client_name[UNIX_PATH_MAX];
+    char                stop = 0;
+    size_t              len;
+    double              start;
+    double              elapsed;
+    unsigned int        i;
+    unsigned int        j;
+    int                 rc;
+
+    snprintf(client_name, sizeof(client_name), "te_ipc_bench_client_%d_%s",
+             (int)getpid(), transport->name);
+    rc = ipc_init_client(client_name, transport->conn, &ipcc);
+    if (rc != 0)
+        return rc;
+
+    for (i = 0; i < TE_ARRAY_LEN(ipc_bench_sizes); i++)
+    {
+        start = ipc_bench_now();
+        for (j = 0; j < iterations; j++)
+        {
+            len = ipc_bench_sizes[i];
+            rc = ipc_send_message_with_answer(ipcc, server_name,
+                                              buf, ipc_bench_sizes[i],
+                                              buf, &len);
+            if (rc != 0)
+                break;
+        }
+        if (rc != 0)
+            break;
+        elapsed = ipc_bench_now() - start;
+
+        printf("%-8s %8zu %14.1f %12.1f\n", transport->name,
+               ipc_bench_sizes[i], elapsed / iterations * 1e6,
+               2.0 * ipc_bench_sizes[i] * iterations / elapsed / 1e6);
+    }
+
+    len = sizeof(stop);
+    if (rc == 0)
+        rc = ipc_send_message_with_answer(ipcc, server_name, &stop,
+                                          sizeof(stop), &stop, &len);
+
+    ipc_close_client(ipcc);
+    return rc;
+}
+
+/**
+ * Benchmark the transport running the server in this process and
+ * the client in a child one.
+ *
+ * @param transport     Transport
+ * @param iterations    Number of round trips for each message size
+ * @param buf           Buffer for messages
+ *
+ * @return Status code.
+ */
+static int
+ipc_bench_run(const ipc_bench_transport *transport,
+              unsigned int iterations, void *buf)
+{
+    struct ipc_server  *ipcs;
+    char                server_name[UNIX_PATH_MAX];
+    pid_t               pid;
+    int                 status;
+    int                 rc;
+
+    snprintf(server_name, sizeof(server_name), "te_ipc_bench_%d_%s",
+             (int)getpid(), transport->name);
+    rc = ipc_register_server(server_name, transport->conn, &ipcs);
+    if (rc != 0)
+        return rc;
+
+    /* Clients read the environment variable on initialisation */
+    if (transport->shm)
+        setenv(IPC_SHM_ENV, "yes", 1);
+    else
+        unsetenv(IPC_SHM_ENV);
+
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0)
+    {
+        rc = TE_OS_RC(TE_IPC, errno);
+        ipc_close_server(ipcs);
+        return rc;
+    }
+    if (pid == 0)
+    {
+        rc = ipc_bench_client(transport, server_name, iterations, buf);
+        if (rc != 0)
+            fprintf(stderr, "%s client failed: %s\n", transport->name,
+                    te_rc_err2str(rc));
+        fflush(stdout);
+        _exit(rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    rc = ipc_bench_serve(ipcs, buf);
+    if (waitpid(pid, &status, 0) == pid && rc == 0 &&
+        !(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS))
+        rc = TE_RC(TE_IPC, TE_EFAIL);
+
+    ipc_close_server(ipcs);
+    return rc;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int    iterations = IPC_BENCH_ITERATIONS;
+    void           *buf;
+    unsigned int    i;
+    int             rc;
+    int             result = EXIT_SUCCESS;
+
+    if (argc > 2 || (argc == 2 && (iterations = atoi(argv[1])) == 0))
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    buf = calloc(1, IPC_BENCH_MAX_SIZE);
+    if (buf == NULL)
+    {
+        perror("calloc() failed");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-8s %8s %14s %12s\n", "IPC", "size", "round trip, us",
+           "MB/s");
+    for (i = 0; i < TE_ARRAY_LEN(ipc_bench_transports); i++)
+    {
+        rc = ipc_bench_run(&ipc_bench_transports[i], iterations, buf);
+        if (rc != 0)
+        {
+            fprintf(stderr, "%s benchmark failed: %s\n",
+                    ipc_bench_transports[i].name, te_rc_err2str(rc));
+            result = EXIT_FAILURE;
+        }
+    }
+
+    free(buf);
+    return result;
+}
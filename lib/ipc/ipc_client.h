@@ -32,6 +32,10 @@ typedef struct ipc_client ipc_client;
 /**
  * Initialize IPC library for the client.
  *
+ * If @c TE_IPC_SHM environment variable is set to @c yes, a
+ * connection-oriented client passes large messages to servers and
+ * gets large answers via shared memory instead of the socket.
+ *
  * @param client_name   Unique name of the client (must be less than
  *                      UNIX_PATH_MAX)
  * @param conn          @c false connectionless client,
@@ -78,6 +82,35 @@ extern int ipc_send_message(struct ipc_client *ipcc,
                             const void *msg, size_t msg_len);
 
 
+/**
+ * Send the message to the server with specified name together with
+ * a file descriptor. The server gets its own copy of the descriptor with
+ * ipc_server_client_take_fd(), so the caller may close the descriptor as
+ * soon as the function returns.
+ *
+ * @param ipcc          Pointer to the ipc_client structure returned
+ *                      by ipc_init_client()
+ * @param server_name   Name of the server, this name must be
+ *                      registered by ipc_register_server()
+ * @param msg           Pointer to message to send
+ * @param msg_len       Length of the message to send
+ * @param fd            File descriptor to pass
+ *
+ * @return Status code.
+ *
+ * @retval 0                Success
+ * @retval TE_EOPNOTSUPP    Descriptors cannot be passed by the client
+ *                          (it is not connection-oriented or IPC is
+ *                          not based on @c AF_UNIX sockets), nothing
+ *                          is sent
+ * @retval errno            Failure
+ */
+extern int ipc_send_message_with_fd(struct ipc_client *ipcc,
+                                    const char *server_name,
+                                    const void *msg, size_t msg_len,
+                                    int fd);
+
+
 /**
  * Send the message to the server with specified name and wait for the
  * answer.
@@ -30,6 +30,7 @@
 #endif
 
 #include "te_stdint.h"
+#include "te_defs.h"
 #include "te_queue.h"
 
 
@@ -130,6 +131,119 @@ extern int ipc_remember_datagram(struct ipc_datagrams *p_pool,
 /*@}*/
 
 
+/** @name Shared memory transport of connection-oriented IPC
+ *
+ * A connection-oriented client may create a shared memory area with two
+ * single-producer single-consumer rings (one per direction) and pass it
+ * to the server in the first message header with @c SCM_RIGHTS.
+ * Messages which do not fit into the internal buffers are copied to the
+ * ring of the sender, and only the header with @ref IPC_SHM_MSG_FLAG set
+ * is written to the socket. The header still wakes up the peer, so
+ * readiness of the server is tracked by the same descriptors. Messages
+ * which do not fit into the free space of the ring are sent via socket.
+ */
+
+/** Environment variable enabling shared memory transport in clients */
+#define IPC_SHM_ENV                 "TE_IPC_SHM"
+
+/** Size of the ring of each direction */
+#define IPC_SHM_RING_SIZE           (1 << 20)
+
+/** Flag of the message header: message payload is in the ring */
+#define IPC_SHM_MSG_FLAG            ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+/** Message header passing the shared memory descriptor */
+#define IPC_SHM_HELLO               (~(size_t)0)
+
+/**
+ * Message header passing a descriptor which belongs to the message
+ * following it (see ipc_send_message_with_fd())
+ */
+#define IPC_FD_HEADER               (~(size_t)1)
+
+/** Directions of the shared memory rings */
+typedef enum ipc_shm_dir {
+    IPC_SHM_TO_SERVER,      /**< From the client to the server */
+    IPC_SHM_TO_CLIENT,      /**< From the server to the client */
+} ipc_shm_dir;
+
+/** Shared memory area of the connection */
+struct ipc_shm;
+
+/**
+ * Check whether shared memory transport is enabled for new clients
+ * in the environment.
+ *
+ * @return @c true if enabled.
+ */
+extern bool ipc_shm_enabled(void);
+
+/**
+ * Create a shared memory area.
+ *
+ * @param p_shm     Location for the area
+ * @param p_fd      Location for the descriptor of the area to be passed
+ *                  to the server and closed by the caller
+ *
+ * @return Status code.
+ */
+extern int ipc_shm_create(struct ipc_shm **p_shm, int *p_fd);
+
+/**
+ * Map a shared memory area created by the peer.
+ *
+ * @param fd        Descriptor of the area
+ * @param p_shm     Location for the area
+ *
+ * @return Status code.
+ */
+extern int ipc_shm_attach(int fd, struct ipc_shm **p_shm);
+
+/**
+ * Unmap a shared memory area.
+ *
+ * @param shm       Area (may be @c NULL)
+ */
+extern void ipc_shm_destroy(struct ipc_shm *shm);
+
+/**
+ * Copy the message to the ring if it has enough free space.
+ *
+ * @param shm       Area
+ * @param dir       Direction of the ring
+ * @param msg       Message
+ * @param len       Length of the message
+ *
+ * @return @c true if the message is put to the ring.
+ */
+extern bool ipc_shm_put(struct ipc_shm *shm, ipc_shm_dir dir,
+                        const void *msg, size_t len);
+
+/**
+ * Get number of octets available for reading from the ring.
+ *
+ * @param shm       Area
+ * @param dir       Direction of the ring
+ *
+ * @return Number of octets.
+ */
+extern size_t ipc_shm_available(struct ipc_shm *shm, ipc_shm_dir dir);
+
+/**
+ * Copy data from the ring and release its space. The caller checks
+ * that the data are available.
+ *
+ * @param shm       Area
+ * @param dir       Direction of the ring
+ * @param buf       Buffer for data
+ * @param len       Number of octets to copy
+ */
+extern void ipc_shm_get(struct ipc_shm *shm, ipc_shm_dir dir,
+                        void *buf, size_t len);
+
+/*@}*/
+
+
 #ifndef TE_IPC_AF_UNIX
 
 /** RPC program name of Test Environment */
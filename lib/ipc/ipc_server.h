@@ -97,6 +97,47 @@ extern int ipc_get_server_fds(const struct ipc_server *ipcs,
 extern bool ipc_is_server_ready(struct ipc_server *ipcs,
                                    const fd_set *set, int max_fd);
 
+/**
+ * Prototype of the function to be called when a file descriptor
+ * of the IPC server is opened or is going to be closed.
+ *
+ * @param fd            File descriptor
+ * @param added         @c true if @p fd is opened, @c false if it
+ *                      is going to be closed
+ * @param opaque        Opaque data passed to ipc_server_set_fd_handler()
+ */
+typedef void (*ipc_server_fd_handler)(int fd, bool added, void *opaque);
+
+/**
+ * Set a handler to track file descriptors of the server incrementally
+ * (e.g. in an epoll set) instead of collecting them with
+ * ipc_get_server_fds() before every wait. The handler is called for all
+ * currently opened file descriptors immediately and then whenever
+ * a client connects or disconnects. It is not called when the server
+ * is closed.
+ *
+ * @param ipcs          Pointer to the ipc_server structure returned
+ *                      by ipc_register_server()
+ * @param handler       Handler or @c NULL to stop tracking
+ * @param opaque        Opaque data to be passed to the handler
+ */
+extern void ipc_server_set_fd_handler(struct ipc_server *ipcs,
+                                      ipc_server_fd_handler handler,
+                                      void *opaque);
+
+/**
+ * Notify the server that its file descriptor reported by the handler
+ * set with ipc_server_set_fd_handler() is readable. It is an analogue
+ * of ipc_is_server_ready() for a single file descriptor.
+ *
+ * @param ipcs          Pointer to the ipc_server structure returned
+ *                      by ipc_register_server()
+ * @param fd            Readable file descriptor
+ *
+ * @return @c true if a message may be received with ipc_receive_message().
+ */
+extern bool ipc_server_fd_ready(struct ipc_server *ipcs, int fd);
+
 /**
  * Get name of the IPC server client.
  *
@@ -108,6 +149,22 @@ extern bool ipc_is_server_ready(struct ipc_server *ipcs,
 extern const char *
     ipc_server_client_name(const struct ipc_server_client *ipcsc);
 
+/**
+ * Take the file descriptor passed by the client with the last received
+ * message (see ipc_send_message_with_fd()). The caller becomes the owner
+ * of the descriptor, otherwise it is closed when the next message of
+ * the client is received.
+ *
+ * @param ipcs          Pointer to the ipc_server structure returned
+ *                      by ipc_register_server()
+ * @param ipcsc         Pointer to the ipc_server_client structure
+ *                      returned by ipc_receive_message()
+ *
+ * @return File descriptor or @c -1 if it is not passed.
+ */
+extern int ipc_server_client_take_fd(const struct ipc_server *ipcs,
+                                     struct ipc_server_client *ipcsc);
+
 /**
  * Receive a message from IPC client.
  *
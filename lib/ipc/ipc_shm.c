@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief IPC library
+ *
+ * Shared memory rings of connection-oriented IPC.
+ *
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "te_errno.h"
+
+#include "ipc_internal.h"
+
+
+/** Magic number of the shared memory area */
+#define IPC_SHM_MAGIC       0x54454950
+
+/** Offset of the ring data from the start of the area */
+#define IPC_SHM_DATA_OFFSET 4096
+
+/** Size of the shared memory area */
+#define IPC_SHM_AREA_SIZE   (IPC_SHM_DATA_OFFSET + 2 * IPC_SHM_RING_SIZE)
+
+/** Position counters of the ring */
+struct ipc_shm_ring {
+    /** Number of octets ever put to the ring by the producer */
+    size_t  head __attribute__((aligned(64)));
+    /** Number of octets ever got from the ring by the consumer */
+    size_t  tail __attribute__((aligned(64)));
+};
+
+/** Header of the shared memory area */
+struct ipc_shm_header {
+    uint32_t            magic;      /**< @ref IPC_SHM_MAGIC */
+    uint32_t            ring_size;  /**< Size of each ring */
+    struct ipc_shm_ring rings[2];   /**< Rings of directions */
+};
+
+/** Shared memory area mapped by the process */
+struct ipc_shm {
+    struct ipc_shm_header  *hdr;    /**< Mapped area */
+};
+
+
+/**
+ * Get data of the ring.
+ *
+ * @param shm       Area
+ * @param dir       Direction of the ring
+ *
+ * @return Pointer to the first octet of the ring data.
+ */
+static uint8_t *
+ipc_shm_data(struct ipc_shm *shm, ipc_shm_dir dir)
+{
+    return (uint8_t *)shm->hdr + IPC_SHM_DATA_OFFSET +
+           (size_t)dir * IPC_SHM_RING_SIZE;
+}
+
+/* See description in ipc_internal.h */
+bool
+ipc_shm_enabled(void)
+{
+#if defined(TE_IPC_AF_UNIX) && defined(HAVE_MEMFD_CREATE)
+    const char *env = getenv(IPC_SHM_ENV);
+
+    return env != NULL && (strcmp(env, "yes") == 0 ||
+                           strcmp(env, "1") == 0);
+#else
+    return false;
+#endif
+}
+
+/**
+ * Map the shared memory area.
+ *
+ * @param fd        Descriptor of the area
+ * @param p_shm     Location for the area
+ *
+ * @return Status code.
+ */
+static int
+ipc_shm_map(int fd, struct ipc_shm **p_shm)
+{
+    struct ipc_shm *shm;
+    void           *addr;
+
+    addr = mmap(NULL, IPC_SHM_AREA_SIZE, PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        perror("ipc_shm_map(): mmap() error");
+        return TE_OS_RC(TE_IPC, errno);
+    }
+
+    shm = calloc(1, sizeof(*shm));
+    if (shm == NULL)
+    {
+        munmap(addr, IPC_SHM_AREA_SIZE);
+        return TE_RC(TE_IPC, TE_ENOMEM);
+    }
+    shm->hdr = addr;
+
+    *p_shm = shm;
+    return 0;
+}
+
+/* See description in ipc_internal.h */
+int
+ipc_shm_create(struct ipc_shm **p_shm, int *p_fd)
+{
+#ifdef HAVE_MEMFD_CREATE
+    int fd;
+    int rc;
+
+    fd = memfd_create("te_ipc", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        rc = errno;
+        perror("ipc_shm_create(): memfd_create() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+    if (ftruncate(fd, IPC_SHM_AREA_SIZE) != 0)
+    {
+        rc = errno;
+        perror("ipc_shm_create(): ftruncate() error");
+        close(fd);
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+    rc = ipc_shm_map(fd, p_shm);
+    if (rc != 0)
+    {
+        close(fd);
+        return rc;
+    }
+
+    (*p_shm)->hdr->magic = IPC_SHM_MAGIC;
+    (*p_shm)->hdr->ring_size = IPC_SHM_RING_SIZE;
+
+    *p_fd = fd;
+    return 0;
+#else
+    UNUSED(p_shm);
+    UNUSED(p_fd);
+    return TE_RC(TE_IPC, TE_EOPNOTSUPP);
+#endif
+}
+
+/* See description in ipc_internal.h */
+int
+ipc_shm_attach(int fd, struct ipc_shm **p_shm)
+{
+    struct stat st;
+    int         rc;
+
+    if (fstat(fd, &st) != 0)
+    {
+        rc = errno;
+        perror("ipc_shm_attach(): fstat() error");
+        return TE_OS_RC(TE_IPC, rc);
+    }
+    if (st.st_size != IPC_SHM_AREA_SIZE)
+        return TE_RC(TE_IPC, TE_EINVAL);
+
+    rc = ipc_shm_map(fd, p_shm);
+    if (rc != 0)
+        return rc;
+
+    if ((*p_shm)->hdr->magic != IPC_SHM_MAGIC ||
+        (*p_shm)->hdr->ring_size != IPC_SHM_RING_SIZE)
+    {
+        ipc_shm_destroy(*p_shm);
+        *p_shm = NULL;
+        return TE_RC(TE_IPC, TE_EINVAL);
+    }
+
+    return 0;
+}
+
+/* See description in ipc_internal.h */
+void
+ipc_shm_destroy(struct ipc_shm *shm)
+{
+    if (shm == NULL)
+        return;
+
+    munmap(shm->hdr, IPC_SHM_AREA_SIZE);
+    free(shm);
+}
+
+/* See description in ipc_internal.h */
+bool
+ipc_shm_put(struct ipc_shm *shm, ipc_shm_dir dir, const void *msg,
+            size_t len)
+{
+    struct ipc_shm_ring *ring = &shm->hdr->rings[dir];
+    uint8_t             *data = ipc_shm_data(shm, dir);
+    size_t               head = ring->head;
+    size_t               tail = __atomic_load_n(&ring->tail,
+                                                __ATOMIC_ACQUIRE);
+    size_t               off = head % IPC_SHM_RING_SIZE;
+    size_t               part;
+
+    if (head - tail > IPC_SHM_RING_SIZE ||
+        len > IPC_SHM_RING_SIZE - (head - tail))
+        return false;
+
+    part = MIN(len, IPC_SHM_RING_SIZE - off);
+    memcpy(data + off, msg, part);
+    memcpy(data, (const uint8_t *)msg + part, len - part);
+
+    __atomic_store_n(&ring->head, head + len, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* See description in ipc_internal.h */
+size_t
+ipc_shm_available(struct ipc_shm *shm, ipc_shm_dir dir)
+{
+    struct ipc_shm_ring *ring = &shm->hdr->rings[dir];
+    size_t               used;
+
+    /* Counters are writable by the peer, do not trust them */
+    used = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail;
+    return MIN(used, IPC_SHM_RING_SIZE);
+}
+
+/* See description in ipc_internal.h */
+void
+ipc_shm_get(struct ipc_shm *shm, ipc_shm_dir dir, void *buf, size_t len)
+{
+    struct ipc_shm_ring *ring = &shm->hdr->rings[dir];
+    const uint8_t       *data = ipc_shm_data(shm, dir);
+    size_t               tail = ring->tail;
+    size_t               off = tail % IPC_SHM_RING_SIZE;
+    size_t               part;
+
+    part = MIN(len, IPC_SHM_RING_SIZE - off);
+    memcpy(buf, data + off, part);
+    memcpy((uint8_t *)buf + part, data, len - part);
+
+    __atomic_store_n(&ring->tail, tail + len, __ATOMIC_RELEASE);
+}
@@ -109,6 +109,13 @@ struct ipc_server_client {
                                          socket and to return to user.
                                          This field MUST be 4-octets
                                          long. */
+            bool        in_shm;     /**< Is the current message in the
+                                         shared memory ring? */
+
+            struct ipc_shm *shm;    /**< Shared memory passed by the
+                                         client or @c NULL */
+            int         msg_fd;     /**< Descriptor passed with
+                                         the current message or @c -1 */
         } stream;
     };
 };
@@ -141,6 +148,11 @@ struct ipc_server {
 
     ipc_recv    recv;   /**< Function to receive requests */
     ipc_send    send;   /**< Function to send replies */
+
+    ipc_server_fd_handler   fd_handler; /**< Handler of opened/closed
+                                             file descriptors */
+    void                   *fd_opaque;  /**< Opaque data of
+                                             the handler */
 };
 
 
@@ -174,6 +186,7 @@ static int ipc_int_get_datagram(struct ipc_server *ipcs,
 
 
 static int read_socket(int socket, void *buffer, size_t len);
+static int read_header(int socket, size_t *len, int *fd);
 static int write_socket(int socket, const void *buffer, size_t len);
 
 static int ipc_dgram_receive_message(struct ipc_server *ipcs,
@@ -379,23 +392,89 @@ ipc_get_server_fds(const struct ipc_server *ipcs, fd_set *set)
     return max_fd;
 }
 
+/* See description in ipc_server.h */
+void
+ipc_server_set_fd_handler(struct ipc_server *ipcs,
+                          ipc_server_fd_handler handler, void *opaque)
+{
+    struct ipc_server_client *client;
+
+    if (ipcs == NULL)
+        return;
+
+    ipcs->fd_handler = handler;
+    ipcs->fd_opaque = opaque;
+    if (handler == NULL)
+        return;
+
+    handler(ipcs->socket, true, opaque);
+    if (ipcs->conn)
+    {
+        LIST_FOREACH(client, &ipcs->clients, links)
+            handler(client->stream.socket, true, opaque);
+    }
+}
+
 /**
  * Close IPC server association with client.
  *
+ * @param ipcs      IPC server
  * @param ipcsc     IPC server client
- * @param conn      Is connection-oriented server client or not?
  */
 static void
-ipc_server_close_client(struct ipc_server_client *ipcsc, bool conn)
+ipc_server_close_client(struct ipc_server *ipcs,
+                        struct ipc_server_client *ipcsc)
 {
     LIST_REMOVE(ipcsc, links);
-    if (conn)
+    if (ipcs->conn)
+    {
+        if (ipcs->fd_handler != NULL)
+            ipcs->fd_handler(ipcsc->stream.socket, false, ipcs->fd_opaque);
         close(ipcsc->stream.socket);
+        ipc_shm_destroy(ipcsc->stream.shm);
+        if (ipcsc->stream.msg_fd >= 0)
+            close(ipcsc->stream.msg_fd);
+    }
     else
+    {
         free(ipcsc->dgram.buffer);
+    }
     free(ipcsc);
 }
 
+/**
+ * Update state of the connection-oriented server client which socket
+ * is reported to be readable.
+ *
+ * @param ipcs      IPC server
+ * @param client    IPC server client
+ *
+ * @return @c true if data from the client are available, @c false
+ *         if the client has closed its socket (it is released then).
+ */
+static bool
+ipc_server_client_readable(struct ipc_server *ipcs,
+                           struct ipc_server_client *client)
+{
+    int available = 0;
+
+    /*
+     * Read event is reported when data are available and when
+     * client closes its socket.
+     */
+    if (ioctl(client->stream.socket, FIONREAD, &available) < 0)
+        perror("FIONREAD ioctl() failed");
+
+    if (available > 0)
+    {
+        client->stream.is_ready = true;
+        return true;
+    }
+
+    ipc_server_close_client(ipcs, client);
+    return false;
+}
+
 /* See description in ipc_server.h */
 bool
 ipc_is_server_ready(struct ipc_server *ipcs, const fd_set *set, int max_fd)
@@ -417,31 +496,42 @@ ipc_is_server_ready(struct ipc_server *ipcs, const fd_set *set, int max_fd)
         {
             if (client->stream.socket <= max_fd)
             {
-                client->stream.is_ready =
-                    FD_ISSET(client->stream.socket, set);
-                if (client->stream.is_ready)
-                {
-                    int available = 0;
+                client->stream.is_ready = false;
+                if (FD_ISSET(client->stream.socket, set) &&
+                    ipc_server_client_readable(ipcs, client))
+                    is_ready = true;
+            }
+        }
+    }
+
+    return is_ready;
+}
+
+/* See description in ipc_server.h */
+bool
+ipc_server_fd_ready(struct ipc_server *ipcs, int fd)
+{
+    struct ipc_server_client *client;
 
-                    /*
-                     * select() returns read event when data are
-                     * available and when client closes its socket.
-                     */
+    if (ipcs == NULL || fd < 0)
+        return false;
 
-                    if (ioctl(client->stream.socket, FIONREAD,
-                              &available) < 0)
-                        perror("FIONREAD ioctl() failed");
+    if (fd == ipcs->socket)
+    {
+        ipcs->is_ready = true;
+        return true;
+    }
 
-                    if (available > 0)
-                        is_ready = true;
-                    else
-                        ipc_server_close_client(client, ipcs->conn);
-                }
-            }
+    if (ipcs->conn)
+    {
+        LIST_FOREACH(client, &ipcs->clients, links)
+        {
+            if (client->stream.socket == fd)
+                return ipc_server_client_readable(ipcs, client);
         }
     }
 
-    return is_ready;
+    return false;
 }
 
 /* See description in ipc_server.h */
@@ -484,9 +574,10 @@ ipc_close_server(struct ipc_server *ipcs)
     }
 
     /* Free the pool */
+    ipcs->fd_handler = NULL;
     while ((ipcsc = LIST_FIRST(&ipcs->clients)) != NULL)
     {
-        ipc_server_close_client(ipcsc, ipcs->conn);
+        ipc_server_close_client(ipcs, ipcsc);
     }
 
     /* Free instance */
@@ -510,6 +601,21 @@ ipc_server_client_name(const struct ipc_server_client *ipcsc)
 #endif
 }
 
+/* See description in ipc_server.h */
+int
+ipc_server_client_take_fd(const struct ipc_server *ipcs,
+                          struct ipc_server_client *ipcsc)
+{
+    int fd;
+
+    if (ipcs == NULL || ipcsc == NULL || !ipcs->conn)
+        return -1;
+
+    fd = ipcsc->stream.msg_fd;
+    ipcsc->stream.msg_fd = -1;
+    return fd;
+}
+
 /* See description in ipc_server.h */
 int
 ipc_receive_message(struct ipc_server *ipcs,
@@ -777,12 +883,20 @@ ipc_stream_server_receive(struct ipc_server *ipcs,
     assert(ipcsc != NULL);
 
     octets_to_read = MIN(*p_buf_len, ipcsc->stream.pending);
-    rc = read_socket(ipcsc->stream.socket, buf, octets_to_read);
-    if (rc != 0)
+    if (ipcsc->stream.in_shm)
+    {
+        ipc_shm_get(ipcsc->stream.shm, IPC_SHM_TO_SERVER, buf,
+                    octets_to_read);
+    }
+    else
     {
-        fprintf(stderr, "ipc_stream_server_receive(): read_socket() "
-                        "failed in the middle of message\n");
-        return rc;
+        rc = read_socket(ipcsc->stream.socket, buf, octets_to_read);
+        if (rc != 0)
+        {
+            fprintf(stderr, "ipc_stream_server_receive(): read_socket() "
+                            "failed in the middle of message\n");
+            return rc;
+        }
     }
 
     ipcsc->stream.pending -= octets_to_read;
@@ -798,16 +912,154 @@ ipc_stream_server_receive(struct ipc_server *ipcs,
     }
 }
 
+/**
+ * Wait forever for a new connection or data from clients of
+ * the connection-oriented server and update their readiness.
+ *
+ * poll() is used since descriptors of the server may be beyond
+ * FD_SETSIZE in processes with many connections.
+ *
+ * @param ipcs      IPC server
+ *
+ * @return Status code.
+ */
+static int
+ipc_stream_wait(struct ipc_server *ipcs)
+{
+    struct ipc_server_client *client;
+    struct ipc_server_client *next_client;
+    struct pollfd            *fds;
+    unsigned int              n = 1;
+    unsigned int              i;
+    int                       rc;
+
+    LIST_FOREACH(client, &ipcs->clients, links)
+        n++;
+
+    fds = calloc(n, sizeof(*fds));
+    if (fds == NULL)
+        return TE_RC(TE_IPC, TE_ENOMEM);
+
+    fds[0].fd = ipcs->socket;
+    fds[0].events = POLLIN;
+    i = 1;
+    LIST_FOREACH(client, &ipcs->clients, links)
+    {
+        fds[i].fd = client->stream.socket;
+        fds[i].events = POLLIN;
+        i++;
+    }
+
+    rc = poll(fds, n, -1);
+    if (rc <= 0) /* Error? */
+    {
+        rc = errno;
+        perror("poll() error");
+        free(fds);
+        return TE_OS_RC(TE_IPC, rc);
+    }
+
+    ipcs->is_ready = (fds[0].revents != 0);
+    i = 1;
+    LIST_FOREACH_SAFE(client, &ipcs->clients, links, next_client)
+    {
+        client->stream.is_ready = false;
+        if (fds[i].revents != 0)
+            (void)ipc_server_client_readable(ipcs, client);
+        i++;
+    }
+
+    free(fds);
+    return 0;
+}
+
+/**
+ * Read the header of the next message from the client of
+ * the connection-oriented server. Shared memory passed by the client
+ * before the message is attached, a descriptor passed with the message
+ * is kept until the user takes it or the next message is read.
+ *
+ * @param client    IPC server client
+ *
+ * @return Status code.
+ */
+static int
+ipc_stream_read_header(struct ipc_server_client *client)
+{
+    size_t  len;
+    int     fd;
+    int     rc;
+
+    if (client->stream.msg_fd >= 0)
+    {
+        close(client->stream.msg_fd);
+        client->stream.msg_fd = -1;
+    }
+
+    while (true)
+    {
+        rc = read_header(client->stream.socket, &len, &fd);
+        if (rc != 0)
+            return rc;
+
+        if (len == IPC_FD_HEADER)
+        {
+            /* The message follows the descriptor */
+            if (fd < 0 || client->stream.msg_fd >= 0)
+            {
+                if (fd >= 0)
+                    close(fd);
+                return TE_RC(TE_IPC, TE_ESYNCFAILED);
+            }
+            client->stream.msg_fd = fd;
+            continue;
+        }
+
+        if (len != IPC_SHM_HELLO)
+            break;
+
+        /* The client sends its first message right after the hello */
+        if (fd < 0 || client->stream.shm != NULL)
+            rc = TE_RC(TE_IPC, TE_ESYNCFAILED);
+        else
+            rc = ipc_shm_attach(fd, &client->stream.shm);
+
+        if (fd >= 0)
+            close(fd);
+        if (rc != 0)
+        {
+            fprintf(stderr, "IPC(%d): Failed to attach shared memory "
+                    "of the client: %s\n", (int)getpid(),
+                    te_rc_err2str(rc));
+            return rc;
+        }
+    }
+
+    if (fd >= 0)
+        close(fd);
+
+    client->stream.in_shm = (len & IPC_SHM_MSG_FLAG) != 0;
+    client->stream.pending = len & ~IPC_SHM_MSG_FLAG;
+    if (client->stream.in_shm &&
+        (client->stream.shm == NULL ||
+         client->stream.pending >
+             ipc_shm_available(client->stream.shm, IPC_SHM_TO_SERVER)))
+    {
+        client->stream.pending = 0;
+        return TE_RC(TE_IPC, TE_ESYNCFAILED);
+    }
+
+    return 0;
+}
+
 /* See description of ipc_receive_message in ipc_server.h */
 static int
 ipc_stream_receive_message(struct ipc_server *ipcs,
                            void *buf, size_t *p_buf_len,
                            struct ipc_server_client **p_ipcsc)
 {
-    fd_set                    my_set;
     struct ipc_server_client *client;
     struct ipc_server_client *next_client;
-    int                       max_fd;
     int                       rc;
 
     if ((ipcs == NULL) || (buf == NULL) || (p_ipcsc == NULL) ||
@@ -822,9 +1074,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
 
         if (client->stream.pending == 0)
         {
-            rc = read_socket(client->stream.socket,
-                             &(client->stream.pending),
-                             sizeof(client->stream.pending));
+            rc = ipc_stream_read_header(client);
             if (rc != 0)
             {
                 if (rc != TE_RC(TE_IPC, TE_ECONNABORTED))
@@ -833,7 +1083,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
                 }
                 else
                 {
-                    ipc_server_close_client(client, ipcs->conn);
+                    ipc_server_close_client(ipcs, client);
                     return rc;
                 }
             }
@@ -868,9 +1118,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
                  * Let's read the length of the message and call
                  * ipc_receive_rest_message.
                  */
-                rc = read_socket(client->stream.socket,
-                                 &(client->stream.pending),
-                                 sizeof(client->stream.pending));
+                rc = ipc_stream_read_header(client);
                 if (rc != 0)
                 {
                     if (rc != TE_RC(TE_IPC, TE_ECONNABORTED))
@@ -879,7 +1127,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
                     }
                     else
                     {
-                        ipc_server_close_client(client, ipcs->conn);
+                        ipc_server_close_client(ipcs, client);
                         continue;
                     }
                 }
@@ -903,6 +1151,7 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
 #ifdef TE_IPC_AF_UNIX
             client->sa_len = sizeof(client->sa);
 #endif
+            client->stream.msg_fd = -1;
 
             client->stream.socket = accept(ipcs->socket,
 #ifdef TE_IPC_AF_UNIX
@@ -919,6 +1168,11 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
             else
             {
                 LIST_INSERT_HEAD(&ipcs->clients, client, links);
+                if (ipcs->fd_handler != NULL)
+                {
+                    ipcs->fd_handler(client->stream.socket, true,
+                                     ipcs->fd_opaque);
+                }
             }
 
             /*
@@ -932,18 +1186,9 @@ ipc_stream_receive_message(struct ipc_server *ipcs,
          *  - client tries to establish connection
          *  - client sends data via established connection
          */
-        FD_ZERO(&my_set);
-        max_fd = ipc_get_server_fds(ipcs, &my_set);
-
-        /* Waiting forever */
-        rc = select(max_fd + 1, &my_set, NULL, NULL, NULL);
-        if (rc <= 0) /* Error? */
-        {
-            perror("select() error");
-            return TE_OS_RC(TE_IPC, errno);
-        }
-
-        (void)ipc_is_server_ready(ipcs, &my_set, max_fd);
+        rc = ipc_stream_wait(ipcs);
+        if (rc != 0)
+            return rc;
     }
     /* Unreachable */
 }
@@ -962,7 +1207,16 @@ ipc_stream_send_answer(struct ipc_server *ipcs,
         return TE_RC(TE_IPC, TE_EINVAL);
     }
 
-    if ((msg_len + sizeof(len)) > IPC_TCP_SERVER_BUFFER_SIZE)
+    if ((msg_len + sizeof(len)) > IPC_TCP_SERVER_BUFFER_SIZE &&
+        ipcsc->stream.shm != NULL &&
+        ipc_shm_put(ipcsc->stream.shm, IPC_SHM_TO_CLIENT, msg, msg_len))
+    {
+        /* Only the header is sent, it wakes up the client */
+        len |= IPC_SHM_MSG_FLAG;
+
+        return write_socket(ipcsc->stream.socket, &len, sizeof(len));
+    }
+    else if ((msg_len + sizeof(len)) > IPC_TCP_SERVER_BUFFER_SIZE)
     {
         /* Message is too long to fit into the internal buffer */
 
@@ -1281,6 +1535,75 @@ read_socket(int socket, void *buffer, size_t len)
     return 0;
 }
 
+/**
+ * Read the message header from the connection together with
+ * the file descriptor passed along with it.
+ *
+ * @param socket    Connection socket.
+ * @param len       Location for the header.
+ * @param fd        Location for the passed descriptor or @c -1.
+ *
+ * @return Status code.
+ *
+ * @retval 0        success
+ * @retval errno    failure
+ */
+static int
+read_header(int socket, size_t *len, int *fd)
+{
+    struct iovec    iov = { .iov_base = len, .iov_len = sizeof(*len) };
+    union {
+        char            buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr  align;
+    } control;
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+    ssize_t         r;
+    int             rc;
+
+    *fd = -1;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    r = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+    if (r < 0)
+    {
+        perror("read_header(): recvmsg() error");
+        return TE_OS_RC(TE_IPC, errno);
+    }
+    else if (r == 0)
+    {
+        return TE_RC(TE_IPC, TE_ECONNABORTED);
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET &&
+            cmsg->cmsg_type == SCM_RIGHTS &&
+            cmsg->cmsg_len == CMSG_LEN(sizeof(*fd)))
+            memcpy(fd, CMSG_DATA(cmsg), sizeof(*fd));
+    }
+
+    if ((size_t)r < sizeof(*len))
+    {
+        rc = read_socket(socket, (uint8_t *)len + r, sizeof(*len) - r);
+        if (rc != 0)
+        {
+            if (*fd >= 0)
+                close(*fd);
+            *fd = -1;
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
 
 /**
  * Write specified number of octets (not less) to the connection.
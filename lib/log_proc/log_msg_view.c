@@ -15,6 +15,8 @@
 #include <assert.h>
 #include <arpa/inet.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "log_msg_view.h"
 #include "te_alloc.h"
@@ -148,6 +150,208 @@ extended_format(const char **fmt_orig, const char *fmt_end,
     return false;
 }
 
+/** Digits used in memory dumps */
+static const char hex_digits[16] = "0123456789ABCDEF";
+
+/**
+ * Function converting bytes to hexadecimal digits.
+ *
+ * @param dst       where to put 2 * @p len digits
+ * @param src       bytes to convert
+ * @param len       number of bytes
+ */
+typedef void (*hex_encode_func)(char *dst, const uint8_t *src, size_t len);
+
+/** Portable implementation of hex_encode_func */
+static void
+hex_encode_scalar(char *dst, const uint8_t *src, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        *dst++ = hex_digits[src[i] >> 4];
+        *dst++ = hex_digits[src[i] & 0xf];
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HEX_ENCODE_X86 1
+
+#include <immintrin.h>
+
+/**
+ * Implementation of hex_encode_func converting 16 bytes at once:
+ * nibbles are used as indexes in the table of digits by PSHUFB.
+ */
+__attribute__((target("ssse3")))
+static void
+hex_encode_ssse3(char *dst, const uint8_t *src, size_t len)
+{
+    const __m128i digits = _mm_loadu_si128((const __m128i *)hex_digits);
+    const __m128i mask = _mm_set1_epi8(0xf);
+    size_t        i;
+
+    for (i = 0; i + 16 <= len; i += 16)
+    {
+        __m128i val = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(val, 4), mask);
+        __m128i lo = _mm_and_si128(val, mask);
+
+        hi = _mm_shuffle_epi8(digits, hi);
+        lo = _mm_shuffle_epi8(digits, lo);
+        _mm_storeu_si128((__m128i *)(dst + 2 * i),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+    hex_encode_scalar(dst + 2 * i, src + i, len - i);
+}
+
+/** Implementation of hex_encode_func converting 32 bytes at once */
+__attribute__((target("avx2")))
+static void
+hex_encode_avx2(char *dst, const uint8_t *src, size_t len)
+{
+    const __m256i digits = _mm256_broadcastsi128_si256(
+                               _mm_loadu_si128((const __m128i *)hex_digits));
+    const __m256i mask = _mm256_set1_epi8(0xf);
+    size_t        i;
+
+    for (i = 0; i + 32 <= len; i += 32)
+    {
+        __m256i val = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(val, 4), mask);
+        __m256i lo = _mm256_and_si256(val, mask);
+        __m256i even;
+        __m256i odd;
+
+        hi = _mm256_shuffle_epi8(digits, hi);
+        lo = _mm256_shuffle_epi8(digits, lo);
+        /* Unpacking works within 128-bit lanes, so reorder the halves */
+        even = _mm256_unpacklo_epi8(hi, lo);
+        odd = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i),
+                            _mm256_permute2x128_si256(even, odd, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 2 * i + 32),
+                            _mm256_permute2x128_si256(even, odd, 0x31));
+    }
+    hex_encode_scalar(dst + 2 * i, src + i, len - i);
+}
+#endif /* x86 */
+
+/** Choose the fastest hex_encode_func supported by the CPU */
+static hex_encode_func
+hex_encode_select(void)
+{
+#ifdef HEX_ENCODE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return hex_encode_avx2;
+    if (__builtin_cpu_supports("ssse3"))
+        return hex_encode_ssse3;
+#endif
+    return hex_encode_scalar;
+}
+
+/** Get hex_encode_func to be used, it is chosen on the first call */
+static hex_encode_func
+hex_encode_get(void)
+{
+    static hex_encode_func encode = NULL;
+    hex_encode_func        result;
+
+    result = __atomic_load_n(&encode, __ATOMIC_RELAXED);
+    if (result == NULL)
+    {
+        result = hex_encode_select();
+        __atomic_store_n(&encode, result, __ATOMIC_RELAXED);
+    }
+
+    return result;
+}
+
+/* See description in log_msg_view.h */
+void
+te_raw_log_hex_encode(char *dst, const void *src, size_t len)
+{
+    hex_encode_get()(dst, src, len);
+}
+
+/**
+ * Append a memory dump as requested by %Tm[[n].[w]] conversion:
+ * each line starts with two spaces, tuples are separated by a space,
+ * and the dump is terminated by an empty line.
+ *
+ * @param target        where the result should be placed
+ * @param data          memory to dump
+ * @param len           length of @p data
+ * @param tuple_width   width (in bytes) of a tuple, @c 0 means no tuples
+ * @param n_tuples      number of tuples in a line, @c 0 means that
+ *                      the dump is not split into lines
+ *
+ * @returns Status code
+ */
+static te_errno
+append_mem_dump(te_string *target, const uint8_t *data, size_t len,
+                int tuple_width, int n_tuples)
+{
+    hex_encode_func encode = hex_encode_get();
+    size_t          tuple_len;
+    size_t          line_len;
+    size_t          pos;
+    char           *out;
+    te_errno        rc;
+
+    tuple_len = tuple_width > 0 ? (size_t)tuple_width : SIZE_MAX;
+    line_len = tuple_width > 0 && n_tuples > 0 ?
+               (size_t)tuple_width * n_tuples : SIZE_MAX;
+
+    /* The worst case is a tuple per line: 5 characters per byte */
+    rc = te_string_reserve(target, target->len + 5 * len + 3);
+    if (rc != 0)
+        return rc;
+
+    out = target->ptr + target->len;
+    for (pos = 0; pos < len; pos += line_len)
+    {
+        size_t  line_bytes = MIN(line_len, len - pos);
+        size_t  n_seps = (line_bytes - 1) / tuple_len;
+        char   *hex;
+        size_t  i;
+
+        memcpy(out, "\n  ", 3);
+        out += 3;
+
+        /*
+         * Convert the line at the end of the room reserved for it and
+         * move tuples to their places, no tuple may be overwritten
+         * before it is moved since separators are inserted before it.
+         */
+        hex = out + n_seps;
+        encode(hex, data + pos, line_bytes);
+        if (n_seps == 0)
+        {
+            out += 2 * line_bytes;
+            continue;
+        }
+
+        for (i = 0; i < line_bytes; i += tuple_len)
+        {
+            size_t n = MIN(tuple_len, line_bytes - i);
+
+            if (i > 0)
+                *out++ = ' ';
+            memmove(out, hex + 2 * i, 2 * n);
+            out += 2 * n;
+        }
+    }
+    memcpy(out, "\n\n", 3);
+    target->len = out + 2 - target->ptr;
+
+    return 0;
+}
+
 /* See description in raw_log_filter.h */
 te_errno
 te_raw_log_expand(const log_msg_view *view, te_string *target)
@@ -265,11 +469,8 @@ te_raw_log_expand(const log_msg_view *view, te_string *target)
                         }
                         case 'm':
                         {
-                            int i;
                             int tuple_width;
                             int n_tuples;
-                            int line_cnt = 1;
-                            int tuple_cnt = 1;
 
 /*
  *  %Tm[[n].[w]] - memory dump, n - the number of elements after
@@ -284,24 +485,10 @@ te_raw_log_expand(const log_msg_view *view, te_string *target)
                                 n_tuples = 16;
                             }
 
-                            for (i = 0; i < arg_len; i++)
-                            {
-                                line_cnt--;
-                                tuple_cnt--;
-                                if (line_cnt == 0)
-                                {
-                                    te_string_append(target, "\n  ");
-                                    line_cnt = tuple_width * n_tuples;
-                                    tuple_cnt = tuple_width;
-                                }
-                                else if (tuple_cnt == 0)
-                                {
-                                    te_string_append(target, " ");
-                                    tuple_cnt = tuple_width;
-                                }
-                                te_string_append(target, "%02X", ((const char *)arg)[i]);
-                            }
-                            te_string_append(target, "\n\n");
+                            rc = append_mem_dump(target, arg, arg_len,
+                                                 tuple_width, n_tuples);
+                            if (rc != 0)
+                                return rc;
                         }
                     }
                     break;
@@ -311,7 +498,18 @@ te_raw_log_expand(const log_msg_view *view, te_string *target)
         }
         else
         {
-            te_string_append(target, "%c", *fmt);
+            const char *run_end;
+
+            /*
+             * Copy the whole literal run up to the next conversion
+             * at once, memchr() is vectorised by the C library.
+             */
+            run_end = memchr(fmt + 1, '%', fmt_end - fmt - 1);
+            if (run_end == NULL)
+                run_end = fmt_end;
+            te_string_append_buf(target, fmt, run_end - fmt);
+            fmt = run_end;
+            continue;
         }
         fmt++;
     }
@@ -64,6 +64,17 @@ extern te_errno te_raw_log_parse(const void *buf, size_t buf_len,
 extern te_errno te_raw_log_expand(const log_msg_view *view,
                                   te_string *target);
 
+/**
+ * Convert bytes to uppercase hexadecimal digits as they are shown in
+ * memory dumps (%Tm). The fastest implementation supported by the CPU
+ * is chosen on the first call.
+ *
+ * @param dst       where to put 2 * @p len digits (no null terminator)
+ * @param src       bytes to convert
+ * @param len       number of bytes
+ */
+extern void te_raw_log_hex_encode(char *dst, const void *src, size_t len);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -71,12 +71,18 @@ typedef struct md_list {
 struct lgr_rb log_buffer;
 
 /**
- * Each message to be registered in the local log buffer
- * increases this variable by 1.
+ * Each message passed to the Logger increases this variable by 1
+ * and each message dropped due to overfilled local log buffer
+ * increases it by 1 as well, so the Logger is able to detect
+ * lost messages.
  */
 uint32_t log_sequence = 0;
 
 
+/*
+ * The lock is not used by messages producers, it only serializes
+ * consumers of the local log buffer.
+ */
 #if HAVE_PTHREAD_H
 pthread_mutex_t ta_log_mutex;
 #elif HAVE_SEMAPHORE_H
@@ -86,29 +92,19 @@ sem_t           ta_log_sem;
 static const char  *skip_flags = "#-+ 0";
 static const char  *skip_width = "*0123456789";
 
-static te_errno
-ta_log_add_ptr_argument(struct lgr_rb *ring_buffer, uint32_t position,
+static void
+ta_log_add_ptr_argument(struct lgr_rb *ring_buffer, uint32_t *position,
                         const void *start, uint32_t length,
                         ta_log_arg *arg_location, bool add_zero)
 {
-    uint32_t val;
     uint8_t *arg_addr;
-    int res;
+    uint32_t used;
 
-    res = lgr_rb_allocate_and_copy(ring_buffer, start, length, &arg_addr,
-                                   add_zero);
-
-    if (res == 0)
-    {
-        return TE_ENOBUFS;
-    }
+    used = lgr_rb_copy(ring_buffer, *position, start, length, &arg_addr,
+                       add_zero);
 
     *arg_location = (ta_log_arg)arg_addr;
-    val = LGR_GET_ELEMENTS_FIELD(ring_buffer, position);
-    val += res;
-    LGR_SET_ELEMENTS_FIELD(ring_buffer, position, val);
-
-    return 0;
+    LGR_RB_CORRECTION(*position + used, *position);
 }
 
 extern void
@@ -116,48 +112,33 @@ ta_log_dynamic_user_ts(te_log_ts_sec sec, te_log_ts_usec usec,
                        unsigned int level, const char *user, const char *msg)
 {
     const char *args[] = { user, msg };
-    struct lgr_rb lgr_rb_old;
     lgr_mess_header *hdr_addr = NULL;
     lgr_mess_header header;
-    ta_log_lock_key key;
     uint32_t position;
+    uint32_t arg_pos;
+    uint32_t elements = 1;
     unsigned int i;
-    int res;
 
     lgr_rb_init_header(&header, level, NULL, "%s", true, sec, usec);
 
-    if (ta_log_lock(&key) != 0)
-        return;
-
-    lgr_rb_old = log_buffer;
+    for (i = 0; i < TE_ARRAY_LEN(args); i++)
+        elements += lgr_rb_arg_elements(strlen(args[i]) + 1);
 
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
-    if (res == 0)
-    {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
-        goto resume;
-    }
+    if (!lgr_rb_reserve(&log_buffer, elements, &position))
+        return;
 
-    hdr_addr = (struct lgr_mess_header *)(log_buffer.rb) + position;
+    hdr_addr = LGR_GET_MESSAGE_ADDR(&log_buffer, position);
     lgr_rb_fill_allocated_header(hdr_addr, &header);
 
+    LGR_RB_CORRECTION(position + 1, arg_pos);
     for (i = 0; i < TE_ARRAY_LEN(args); i++)
     {
-        if (ta_log_add_ptr_argument(&log_buffer, position,
-                                    args[i], strlen(args[i]) + 1,
-                                    hdr_addr->args + i, false) != 0)
-        {
-            log_buffer = lgr_rb_old;
-            (void)ta_log_unlock(&key);
-            goto resume;
-        }
+        ta_log_add_ptr_argument(&log_buffer, &arg_pos,
+                                args[i], strlen(args[i]) + 1,
+                                hdr_addr->args + i, false);
     }
 
-    (void)ta_log_unlock(&key);
-
-resume:
-    ;
+    lgr_rb_commit(&log_buffer, position, elements);
 }
 
 /**
@@ -172,14 +153,13 @@ ta_log_message(const char *file, unsigned int line,
                unsigned int level, const char *entity, const char *user,
                const char *fmt, va_list ap)
 {
-    ta_log_lock_key     key;
     uint32_t            position;
-    int                 res;
+    uint32_t            arg_pos;
+    uint32_t            elements = 1;
     const char         *p_str;
     md_list             cp_list = {&cp_list, &cp_list, 0, NULL, 0};
     md_list            *tmp_list = NULL;
     uint32_t            narg = 0;
-    struct lgr_rb       lgr_rb_old;
     int                 precision;
 
     lgr_mess_header header;
@@ -265,7 +245,7 @@ ta_log_message(const char *file, unsigned int line,
 
                 if (precision >= 0)
                 {
-                    length = precision + 1;
+                    length = strnlen(addr, precision) + 1;
                     cp_list.length += length;
                     LGR_PUT_MD_LIST(cp_list, narg, addr, length, true);
                 }
@@ -305,38 +285,29 @@ ta_log_message(const char *file, unsigned int line,
 
     UNUSED(precision);
 
-    if (ta_log_lock(&key) != 0)
-        return;
-
-    lgr_rb_old = log_buffer;
-
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
-    if (res == 0)
+    for (tmp_list = cp_list.next; tmp_list != &cp_list;
+         tmp_list = tmp_list->next)
     {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
-        goto resume;
+        elements += lgr_rb_arg_elements(tmp_list->length);
     }
 
-    hdr_addr = (struct lgr_mess_header *)(log_buffer.rb) + position;
+    if (!lgr_rb_reserve(&log_buffer, elements, &position))
+        goto resume;
+
+    hdr_addr = LGR_GET_MESSAGE_ADDR(&log_buffer, position);
     lgr_rb_fill_allocated_header(hdr_addr, &header);
 
-    tmp_list = cp_list.next;
-    while (tmp_list != &cp_list)
+    LGR_RB_CORRECTION(position + 1, arg_pos);
+    for (tmp_list = cp_list.next; tmp_list != &cp_list;
+         tmp_list = tmp_list->next)
     {
-        if (ta_log_add_ptr_argument(&log_buffer, position,
-                                    tmp_list->addr, tmp_list->length,
-                                    hdr_addr->args + tmp_list->narg,
-                                    tmp_list->add_zero) != 0)
-        {
-            log_buffer = lgr_rb_old;
-            (void)ta_log_unlock(&key);
-            goto resume;
-        }
-
-        tmp_list = tmp_list->next;
+        ta_log_add_ptr_argument(&log_buffer, &arg_pos,
+                                tmp_list->addr, tmp_list->length,
+                                hdr_addr->args + tmp_list->narg,
+                                tmp_list->add_zero);
     }
-    (void)ta_log_unlock(&key);
+
+    lgr_rb_commit(&log_buffer, position, elements);
 
 resume:
     LGR_FREE_MD_LIST(cp_list);
@@ -406,6 +377,7 @@ clear_fmt(const char *fmt, uint8_t *clean_fmt)
 /**
  * Get message from log buffer.
  * On success the processed message will be removed from log buffer.
+ * It must be called with the consumer lock held.
  *
  * @return  Length of processed message.
  */
@@ -416,7 +388,8 @@ log_get_message(uint32_t length, uint8_t *buffer)
     const char         *fs;
     uint32_t            mess_length = 0;
     uint32_t            tmp_length;
-    ta_log_lock_key     key;
+    uint32_t            dropped;
+    uint32_t            sequence;
     uint8_t            *tmp_buf;
     lgr_mess_header     header;
     uint8_t            *ring_last = log_buffer.rb + LGR_TOTAL_RB_BYTES;
@@ -424,42 +397,30 @@ log_get_message(uint32_t length, uint8_t *buffer)
     if (length < LGR_RB_ELEMENT_LEN)
         return 0;
 
-    if (ta_log_lock(&key) != 0)
+    if (!lgr_rb_head_ready(&log_buffer))
         return 0;
 
-    if (LGR_RB_UNUSED(&log_buffer) == LGR_TOTAL_RB_EL)
-    {
-        (void)ta_log_unlock(&key);
-        return 0;
-    }
-
-    LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 1);
-    if (ta_log_unlock(&key) != 0)
-    {
-        LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
-        return 0;
-    }
-
     tmp_buf = buffer;
 
     lgr_rb_get_elements(&log_buffer, LGR_RB_HEAD(&log_buffer),
                         1, (uint8_t *)&header);
 
+    /* Messages dropped before this one are accounted as lost */
+    dropped = __atomic_load_n(&log_buffer.dropped, __ATOMIC_RELAXED);
+    sequence = log_sequence + dropped + 1;
+
 
 #define LGR_CHECK_LENGTH(_field_length) \
     do {                                                            \
         if (mess_length + (_field_length) > length)                 \
-        {                                                           \
-            LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);    \
             return 0;                                               \
-        }                                                           \
         mess_length += (_field_length);                             \
     } while (0)
 
     LGR_CHECK_LENGTH(sizeof(te_log_seqno) + TE_LOG_MSG_COMMON_HDR_SZ);
 
     /* Write message sequence number FIXME */
-    *((uint32_t *)tmp_buf) = htonl(header.sequence);
+    *((uint32_t *)tmp_buf) = htonl(sequence);
     tmp_buf += sizeof(uint32_t);
 
     /* Write current log version */
@@ -663,15 +624,9 @@ log_get_message(uint32_t length, uint8_t *buffer)
 
 #undef LGR_CHECK_LENGTH
 
-    if (ta_log_lock(&key) != 0)
-    {
-        /* TODO: Is it safe to do it without lock? */
-        LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
-        return 0;
-    }
-    LGR_SET_MARK_FIELD(&log_buffer, log_buffer.head, 0);
     lgr_rb_remove_oldest(&log_buffer);
-    (void)ta_log_unlock(&key);
+    __atomic_sub_fetch(&log_buffer.dropped, dropped, __ATOMIC_RELAXED);
+    log_sequence = sequence;
 
     return mess_length;
 }
@@ -735,31 +690,55 @@ ta_log_shutdown(void)
 uint32_t
 ta_log_get(uint32_t buf_length, uint8_t *transfer_buf)
 {
+    ta_log_lock_key key;
     uint32_t log_length = 0;
     uint32_t mess_length, rest_length;
     uint8_t *tmp_buf = transfer_buf;
 
 
     if ((buf_length <= 0) || (transfer_buf == NULL))
-        goto ret;
+        return 0;
+
+    if (ta_log_lock(&key) != 0)
+        return 0;
 
     do {
-        if (LGR_RB_UNUSED(&log_buffer) == LGR_TOTAL_RB_EL)
-            goto ret;
+        if (!lgr_rb_head_ready(&log_buffer))
+            break;
 
         rest_length = buf_length - log_length;
         if (rest_length == 0)
-            goto ret;
+            break;
 
         mess_length = log_get_message(rest_length, tmp_buf);
         if (mess_length == 0)
-            goto ret;
+        {
+            if (log_length != 0)
+                break;
+
+            /*
+             * The message does not fit even in the empty transfer
+             * buffer, it would block the log forever. Drop it and
+             * let the Logger know that it is lost.
+             */
+            lgr_rb_remove_oldest(&log_buffer);
+            __atomic_add_fetch(&log_buffer.dropped, 1, __ATOMIC_RELAXED);
+            continue;
+        }
 
         tmp_buf += mess_length;
         log_length += mess_length;
 
     } while (1);
 
-ret:
+    (void)ta_log_unlock(&key);
+
     return log_length;
 }
+
+/* See the description in logger_ta.h */
+bool
+ta_log_pending(void)
+{
+    return lgr_rb_head_ready(&log_buffer);
+}
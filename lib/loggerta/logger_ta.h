@@ -83,6 +83,17 @@ extern void ta_log_dynamic_user_ts(te_log_ts_sec sec, te_log_ts_usec usec,
  */
 extern uint32_t ta_log_get(uint32_t buf_length, uint8_t *transfer_buf);
 
+/**
+ * Check whether the Test Agent local log buffer still keeps messages
+ * which have not been passed to the Logger yet.
+ *
+ * It is used to let the Logger know that it should get the next bulk
+ * of messages immediately rather than wait for the next polling period.
+ *
+ * @return @c true if the local log buffer is not empty.
+ */
+extern bool ta_log_pending(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
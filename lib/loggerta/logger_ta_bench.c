@@ -0,0 +1,278 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Logger library to be used by Test Agents
+ *
+ * Benchmark of the local log buffer: rate of messages logged by several
+ * threads at once while a consumer thread drains the buffer the same
+ * way as the Test Agent does for the Logger.
+ *
+ * Usage: te_ta_log_bench [messages]
+ *
+ * It is built if @c benchmarks meson option is enabled.
+ *
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "Bench"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#if HAVE_TIME_H
+#include <time.h>
+#endif
+#include <netinet/in.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_raw_log.h"
+#include "logger_api.h"
+#include "logger_ta.h"
+
+
+/** Default number of messages logged by all threads in each run */
+#define TA_LOG_BENCH_MESSAGES   1000000
+
+/** Size of the transfer buffer of the consumer */
+#define TA_LOG_BENCH_BUF_SIZE   16384
+
+/** Numbers of producer threads */
+static const unsigned int ta_log_bench_threads[] = { 1, 4, 16 };
+
+/** Number of messages logged by each producer thread */
+static unsigned int ta_log_bench_per_thread;
+
+/** Set when all producers of the run are finished */
+static volatile bool ta_log_bench_stop;
+
+/** Number of messages got by the consumer */
+static unsigned long ta_log_bench_got;
+
+/** Sequence number of the last message got by the consumer */
+static uint32_t ta_log_bench_last_seqno;
+
+
+/*
+ * The benchmark does not fork, but logger_ta.c refers to the logging
+ * function of forked processes.
+ */
+void
+logfork_log_message(const char *file, unsigned int line,
+                    te_log_ts_sec sec, te_log_ts_usec usec,
+                    unsigned int level, const char *entity,
+                    const char *user, const char *fmt, va_list ap)
+{
+    UNUSED(file);
+    UNUSED(line);
+    UNUSED(sec);
+    UNUSED(usec);
+    UNUSED(level);
+    UNUSED(entity);
+    UNUSED(user);
+    UNUSED(fmt);
+    UNUSED(ap);
+}
+
+/**
+ * Get monotonic time.
+ *
+ * @return Time in seconds.
+ */
+static double
+ta_log_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Log messages with a typical set of arguments.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL.
+ */
+static void *
+ta_log_bench_producer(void *arg)
+{
+    static const uint8_t    dump[] = "0123456789abcdef";
+    unsigned int            i;
+
+    UNUSED(arg);
+
+    for (i = 0; i < ta_log_bench_per_thread; i++)
+    {
+        RING("Message %u from %s: %Tm", i, "producer",
+             dump, sizeof(dump) - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * Count messages in the transfer buffer filled in by ta_log_get().
+ *
+ * @param buf       Transfer buffer
+ * @param len       Length of data in the buffer
+ */
+static void
+ta_log_bench_count(const uint8_t *buf, uint32_t len)
+{
+    const uint8_t  *p = buf;
+    uint32_t        seqno;
+    te_log_nfl      nfl;
+
+    while (p < buf + len)
+    {
+        memcpy(&seqno, p, sizeof(seqno));
+        ta_log_bench_last_seqno = ntohl(seqno);
+        ta_log_bench_got++;
+        p += sizeof(seqno) + TE_LOG_MSG_COMMON_HDR_SZ;
+
+        do {
+            memcpy(&nfl, p, sizeof(nfl));
+            nfl = ntohs(nfl);
+            p += sizeof(nfl);
+            if (nfl != TE_LOG_RAW_EOR_LEN)
+                p += nfl;
+        } while (nfl != TE_LOG_RAW_EOR_LEN);
+    }
+}
+
+/**
+ * Drain the local log buffer until producers are finished and the
+ * buffer is empty.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL.
+ */
+static void *
+ta_log_bench_consumer(void *arg)
+{
+    static uint8_t  buf[TA_LOG_BENCH_BUF_SIZE];
+    uint32_t        len;
+    bool            stop;
+
+    UNUSED(arg);
+
+    do {
+        stop = ta_log_bench_stop;
+        len = ta_log_get(sizeof(buf), buf);
+        ta_log_bench_count(buf, len);
+    } while (len != 0 || !stop);
+
+    return NULL;
+}
+
+/**
+ * Log messages by the specified number of threads and print the rate.
+ *
+ * @param threads       Number of producer threads
+ * @param messages      Number of messages logged by all threads
+ *
+ * @return Status code.
+ */
+static te_errno
+ta_log_bench_run(unsigned int threads, unsigned int messages)
+{
+    pthread_t       consumer;
+    pthread_t      *producers;
+    unsigned long   got_start = ta_log_bench_got;
+    uint32_t        seqno_start = ta_log_bench_last_seqno;
+    unsigned long   got;
+    unsigned long   lost;
+    double          start;
+    double          elapsed;
+    unsigned int    i;
+    int             rc;
+
+    producers = calloc(threads, sizeof(*producers));
+    if (producers == NULL)
+        return TE_ENOMEM;
+
+    ta_log_bench_per_thread = messages / threads;
+    ta_log_bench_stop = false;
+
+    rc = pthread_create(&consumer, NULL, ta_log_bench_consumer, NULL);
+    if (rc != 0)
+    {
+        free(producers);
+        return te_rc_os2te(rc);
+    }
+
+    start = ta_log_bench_now();
+    for (i = 0; i < threads; i++)
+    {
+        rc = pthread_create(&producers[i], NULL, ta_log_bench_producer,
+                            NULL);
+        if (rc != 0)
+            break;
+    }
+    threads = i;
+    for (i = 0; i < threads; i++)
+        pthread_join(producers[i], NULL);
+    elapsed = ta_log_bench_now() - start;
+
+    ta_log_bench_stop = true;
+    pthread_join(consumer, NULL);
+    free(producers);
+    if (rc != 0)
+        return te_rc_os2te(rc);
+
+    got = ta_log_bench_got - got_start;
+    lost = (uint32_t)(ta_log_bench_last_seqno - seqno_start) - got;
+    printf("%7u %14.0f %10lu %10lu\n", threads,
+           ta_log_bench_per_thread * threads / elapsed, got, lost);
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int    messages = TA_LOG_BENCH_MESSAGES;
+    unsigned int    i;
+    te_errno        rc;
+    int             result = EXIT_SUCCESS;
+
+    if (argc > 2 || (argc == 2 && (messages = atoi(argv[1])) == 0))
+    {
+        fprintf(stderr, "Usage: %s [messages]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    rc = ta_log_init("Bench");
+    if (rc != 0)
+    {
+        fprintf(stderr, "ta_log_init() failed: %s\n", te_rc_err2str(rc));
+        return EXIT_FAILURE;
+    }
+
+    printf("%7s %14s %10s %10s\n", "threads", "messages/s", "got", "lost");
+    for (i = 0; i < TE_ARRAY_LEN(ta_log_bench_threads); i++)
+    {
+        rc = ta_log_bench_run(ta_log_bench_threads[i], messages);
+        if (rc != 0)
+        {
+            fprintf(stderr, "%u threads benchmark failed: %s\n",
+                    ta_log_bench_threads[i], te_rc_err2str(rc));
+            result = EXIT_FAILURE;
+        }
+    }
+
+    ta_log_shutdown();
+    return result;
+}
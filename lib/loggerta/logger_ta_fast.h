@@ -183,26 +183,13 @@ ta_log_message_fast(unsigned int level, const char *user, const char *fmt,
                     int argl12, ta_log_arg arg12,
                     int argl13)
 {
-    ta_log_lock_key     key;
     uint32_t            position;
-    int                 res;
 
     struct lgr_mess_header *msg;
-    struct lgr_rb lgr_rb_old;
 
-    if (ta_log_lock(&key) != 0)
+    if (!lgr_rb_reserve(&log_buffer, 1, &position))
         return;
 
-    lgr_rb_old = log_buffer;
-
-    res = lgr_rb_allocate_head(&log_buffer, TA_LOG_FORCE_NEW, &position);
-    if (res == 0)
-    {
-        log_buffer = lgr_rb_old;
-        (void)ta_log_unlock(&key);
-        return;
-    }
-
     msg = (struct lgr_mess_header *)LGR_GET_MESSAGE_ARRAY(&log_buffer,
                                                           position);
 
@@ -264,7 +251,7 @@ ta_log_message_fast(unsigned int level, const char *user, const char *fmt,
         }
     }
 
-    (void)ta_log_unlock(&key);
+    lgr_rb_commit(&log_buffer, position, 1);
 }
 
 #ifdef __cplusplus
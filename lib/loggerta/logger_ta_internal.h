@@ -48,15 +48,6 @@ extern "C" {
  */
 #define TA_LOG_ARGS_MAX     12
 
-#ifndef TA_LOG_FORCE_NEW
-/*
- * Drop a new or the oldest message, if no enough space:
- * 0 - drop a new message, !0 - drop the oldest message.
- */
-#define TA_LOG_FORCE_NEW    0
-#endif
-
-
 /*
  * Following macros provide the means for ring buffer processing.
  */
@@ -92,13 +83,13 @@ extern "C" {
     } while (0)
 
 /** Get ring buffer unused elements */
-#define LGR_RB_UNUSED(_rb)  ((_rb)->unused)
+#define LGR_RB_UNUSED(_rb)  lgr_rb_unused(_rb)
 
 /** Get ring buffer head element */
 #define LGR_RB_HEAD(_rb)    ((_rb)->head)
 
 /** Get ring buffer tail element */
-#define LGR_RB_TAIL(_rb)    ((_rb)->tail)
+#define LGR_RB_TAIL(_rb)    lgr_rb_tail(_rb)
 
 /** Get/Set header argument */
 #define LGR_GET_ARG(_hdr, _narg)        ((_hdr).args[_narg])
@@ -118,15 +109,13 @@ extern "C" {
 #define LGR_SET_ELEMENTS_FIELD(_rb, _pos, _val) \
     LGR_GET_MESSAGE_ADDR((_rb), (_pos))->elements = (_val)
 
-#define LGR_GET_MARK_FIELD(_rb, _pos) \
-    LGR_GET_MESSAGE_ADDR((_rb), (_pos))->mark
-#define LGR_SET_MARK_FIELD(_rb, _pos, _val) \
-    LGR_GET_MESSAGE_ADDR((_rb), (_pos))->mark = (_val)
-
-#define LGR_GET_SEQUENCE_FIELD(_rb, _pos) \
-    LGR_GET_MESSAGE_ADDR((_rb), (_pos))->sequence
-#define LGR_SET_SEQUENCE_FIELD(_rb, _pos, _val) \
-    LGR_GET_MESSAGE_ADDR((_rb), (_pos))->sequence = (_val)
+/** Get/Set flag telling that the message is completely written */
+#define LGR_GET_READY_FIELD(_rb, _pos) \
+    __atomic_load_n(&LGR_GET_MESSAGE_ADDR((_rb), (_pos))->ready, \
+                    __ATOMIC_ACQUIRE)
+#define LGR_SET_READY_FIELD(_rb, _pos, _val) \
+    __atomic_store_n(&LGR_GET_MESSAGE_ADDR((_rb), (_pos))->ready, (_val), \
+                     __ATOMIC_RELEASE)
 
 
 /** Type of argument native for a stack */
@@ -145,9 +134,9 @@ typedef struct lgr_mess_header {
                                              argument */
     uint32_t        elements;       /**< Number of consequent ring buffer
                                          elements in message */
-    uint32_t        sequence;       /**< Sequence number for this message */
-    uint32_t        mark;           /**< Flag: message is marked as
-                                         processed at this time */
+    uint32_t        ready;          /**< Flag: message is completely
+                                         written and may be passed
+                                         to the Logger */
 
     te_log_ts_sec   sec;            /**< Seconds of the timestamp */
     te_log_ts_usec  usec;           /**< Microseconds of the timestamp */
@@ -187,11 +176,23 @@ ta_log_timestamp(te_log_ts_sec *sec, te_log_ts_usec *usec)
 /**
  * The main ring buffer structure.
  * Element of the ring buffer is multiple to the struct lgr_mess_header
+ *
+ * The ring buffer has many producers (threads logging messages) and
+ * a single consumer (the thread passing the log to the Logger).
+ * Producers do not take any lock: space for a whole message is
+ * reserved by atomic update of the control word, filled in and then
+ * published by setting the ready flag of the message header.
+ * The consumer passes messages in the order of reservation and
+ * returns their space by atomic update of the control word.
  */
 struct lgr_rb {
-    uint32_t head;    /**< Head ring buffer element number */
-    uint32_t tail;    /**< Tail ring buffer element number */
-    uint32_t unused;  /**< Number of unused ring buffer elements */
+    uint64_t ctl;     /**< Tail ring buffer element number in upper
+                           32 bits and number of unused ring buffer
+                           elements in lower 32 bits (atomic) */
+    uint32_t head;    /**< Head ring buffer element number
+                           (consumer only) */
+    uint32_t dropped; /**< Number of messages dropped since the last
+                           one passed to the Logger (atomic) */
     uint8_t *rb;      /**< Pointer to the ring buffer location */
 };
 
@@ -199,6 +200,33 @@ extern struct lgr_rb log_buffer;
 extern uint32_t      log_sequence;
 
 
+/**
+ * Get number of unused ring buffer elements.
+ *
+ * @param ring_buffer Ring buffer location.
+ *
+ * @return Number of unused elements.
+ */
+static inline uint32_t
+lgr_rb_unused(struct lgr_rb *ring_buffer)
+{
+    return (uint32_t)__atomic_load_n(&ring_buffer->ctl, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Get ring buffer tail element number.
+ *
+ * @param ring_buffer Ring buffer location.
+ *
+ * @return Tail element number.
+ */
+static inline uint32_t
+lgr_rb_tail(struct lgr_rb *ring_buffer)
+{
+    return (uint32_t)(__atomic_load_n(&ring_buffer->ctl,
+                                      __ATOMIC_ACQUIRE) >> 32);
+}
+
 /**
  * Initialize ring buffer.
  *
@@ -209,10 +237,11 @@ lgr_rb_init(struct lgr_rb *ring_buffer)
 {
     memset(ring_buffer, 0, sizeof(struct lgr_rb));
 
+    /* Zeroed memory means that no message is ready */
     ring_buffer->rb = TE_ALLOC(LGR_TOTAL_RB_BYTES * sizeof(uint8_t));
 
-    ring_buffer->unused = LGR_TOTAL_RB_EL;
-    ring_buffer->head = ring_buffer->tail = 0;
+    ring_buffer->ctl = LGR_TOTAL_RB_EL;
+    ring_buffer->head = 0;
 }
 
 /**
@@ -237,18 +266,31 @@ lgr_rb_destroy(struct lgr_rb *ring_buffer)
 static inline void
 lgr_rb_view_head(struct lgr_rb *ring_buffer, uint32_t position)
 {
-    printf("unused:%d, head:%d, tail:%d elements:%d, mark:%d, "
-           "sequence:%d\n",
+    printf("unused:%d, head:%d, tail:%d elements:%d, ready:%d\n",
            (int)LGR_RB_UNUSED(ring_buffer),
            (int)LGR_RB_HEAD(ring_buffer),
            (int)LGR_RB_TAIL(ring_buffer),
            (int)LGR_GET_ELEMENTS_FIELD(ring_buffer, position),
-           (int)LGR_GET_MARK_FIELD(ring_buffer, position),
-           (int)LGR_GET_SEQUENCE_FIELD(ring_buffer, position));
+           (int)LGR_GET_READY_FIELD(ring_buffer, position));
 }
 
 /**
- * Remove oldest message.
+ * Check whether the oldest message is ready to be passed.
+ * It may be called by the consumer only.
+ *
+ * @param ring_buffer Ring buffer location.
+ *
+ * @return @c true if the message is ready.
+ */
+static inline bool
+lgr_rb_head_ready(struct lgr_rb *ring_buffer)
+{
+    return LGR_GET_READY_FIELD(ring_buffer, ring_buffer->head) != 0;
+}
+
+/**
+ * Remove oldest message. It may be called by the consumer only
+ * and only if the oldest message is ready.
  *
  * @param ring_buffer Ring buffer location.
  *
@@ -258,85 +300,99 @@ static inline uint32_t
 lgr_rb_remove_oldest(struct lgr_rb *ring_buffer)
 {
     uint32_t mess_len;
-    uint32_t head;
-
-    if (ring_buffer->unused == LGR_TOTAL_RB_EL)
-        return LGR_TOTAL_RB_EL;
+    uint32_t pos;
+    uint32_t i;
 
-    head = LGR_RB_HEAD(ring_buffer);
-    mess_len = LGR_GET_ELEMENTS_FIELD(ring_buffer, head);
-    head += mess_len;
+    pos = LGR_RB_HEAD(ring_buffer);
+    mess_len = LGR_GET_ELEMENTS_FIELD(ring_buffer, pos);
 
-    LGR_RB_CORRECTION(head, LGR_RB_HEAD(ring_buffer));
+    /*
+     * Clear ready flag in all the elements of the message since
+     * any of them may become a header of a new message.
+     */
+    for (i = 0; i < mess_len; i++)
+    {
+        LGR_GET_MESSAGE_ADDR(ring_buffer, pos)->ready = 0;
+        LGR_RB_CORRECTION(pos + 1, pos);
+    }
+    LGR_RB_HEAD(ring_buffer) = pos;
 
-    ring_buffer->unused += mess_len;
-    return ring_buffer->unused;
+    return (uint32_t)__atomic_add_fetch(&ring_buffer->ctl, mess_len,
+                                        __ATOMIC_RELEASE);
 }
 
-
 /**
- * Allocate ring buffer space for number elements.
+ * Get number of ring buffer elements required to store an argument.
  *
- * @param ring_buffer Ring buffer location.
- * @param nmbr        Number of elements need to be allocated.
- * @param position    Allocated space first element number.
+ * @param length        Argument length in bytes.
  *
- * @retval Number of allocated elements.
+ * @return Number of elements.
  */
 static inline uint32_t
-lgr_rb_allocate_space(struct lgr_rb *ring_buffer,
-                      uint32_t nmbr, uint32_t *position)
+lgr_rb_arg_elements(uint32_t length)
 {
-    uint32_t tail;
-
-    if (ring_buffer->unused < nmbr)
-    {
-        return 0;
-    }
-
-    tail = *position = ring_buffer->tail;
-    tail += nmbr;
-
-    LGR_RB_CORRECTION(tail, ring_buffer->tail);
-    ring_buffer->unused -= nmbr;
+    if (length > TE_LOG_FIELD_MAX)
+        length = TE_LOG_FIELD_MAX;
 
-    return nmbr;
+    return (length + LGR_RB_ELEMENT_LEN - 1) / LGR_RB_ELEMENT_LEN;
 }
 
 /**
- * Allocate ring buffer space for head element of message.
- * If force flag is turn on and ring buffer does not have an unused space
- * the oldest message will be removed to allocate new one.
+ * Reserve ring buffer space for a message. It may be called by
+ * any number of producers concurrently. If there is not enough
+ * unused space, the message is dropped and it is accounted to be
+ * reported to the Logger.
  *
  * @param ring_buffer Ring buffer location.
- * @param force       Remove oldest message if unused space is absent.
- * @param position    Number of the first element of allocated space.
+ * @param nmbr        Number of elements required for the message
+ *                    (including its header).
+ * @param position    Location for the number of the first element of
+ *                    the reserved space.
  *
- * @retval  Number of allocated elements.
+ * @return @c true if the space is reserved.
  */
-static inline uint32_t
-lgr_rb_allocate_head(struct lgr_rb *ring_buffer,
-                     uint32_t force, uint32_t *position)
+static inline bool
+lgr_rb_reserve(struct lgr_rb *ring_buffer, uint32_t nmbr,
+               uint32_t *position)
 {
-    log_sequence++;
+    uint64_t ctl;
+    uint64_t new_ctl;
+    uint32_t tail;
+    uint32_t unused;
 
-    if ((ring_buffer->unused == 0) &&
-        ((force == 0) ||
-         (LGR_GET_MARK_FIELD(ring_buffer, ring_buffer->head) == 1)))
-    {
-        return 0;
-    }
+    ctl = __atomic_load_n(&ring_buffer->ctl, __ATOMIC_ACQUIRE);
+    do {
+        tail = (uint32_t)(ctl >> 32);
+        unused = (uint32_t)ctl;
 
-    if (ring_buffer->unused == 0)
-        lgr_rb_remove_oldest(ring_buffer);
+        if (unused < nmbr)
+        {
+            __atomic_add_fetch(&ring_buffer->dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
 
-    lgr_rb_allocate_space(ring_buffer, 1, position);
+        LGR_RB_CORRECTION(tail + nmbr, new_ctl);
+        new_ctl = (new_ctl << 32) | (unused - nmbr);
+    } while (!__atomic_compare_exchange_n(&ring_buffer->ctl, &ctl, new_ctl,
+                                          false, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE));
 
-    LGR_SET_ELEMENTS_FIELD(ring_buffer, *position, 1);
-    LGR_SET_MARK_FIELD(ring_buffer, *position, 0);
-    LGR_SET_SEQUENCE_FIELD(ring_buffer, *position, log_sequence);
+    *position = tail;
+    return true;
+}
 
-    return 1;
+/**
+ * Publish the message written to the reserved space.
+ *
+ * @param ring_buffer Ring buffer location.
+ * @param position    Number of the first element of the reserved space.
+ * @param nmbr        Number of reserved elements.
+ */
+static inline void
+lgr_rb_commit(struct lgr_rb *ring_buffer, uint32_t position, uint32_t nmbr)
+{
+    LGR_SET_ELEMENTS_FIELD(ring_buffer, position, nmbr);
+    LGR_SET_READY_FIELD(ring_buffer, position, 1);
 }
 
 static inline void
@@ -357,22 +413,18 @@ static inline void
 lgr_rb_fill_allocated_header(lgr_mess_header *allocated,
                              const lgr_mess_header *from)
 {
-    lgr_mess_header header;
-
-    header = *from;
-    header.elements = allocated->elements;
-    header.sequence = allocated->sequence;
-    header.mark = allocated->mark;
-
-    *allocated = header;
+    *allocated = *from;
+    allocated->elements = 0;
+    allocated->ready = 0;
 }
 
 
 /**
- * Allocate ring buffer space and copy length bytes from start address.
- * Only 256 bytes can be copied if ring buffer unused space is enough.
+ * Copy length bytes from start address to the reserved ring buffer
+ * space. Only TE_LOG_FIELD_MAX bytes are copied at most.
  *
  * @param ring_buffer    Ring buffer location.
+ * @param position       Number of the first element to copy to.
  * @param start          Byte array start address.
  * @param length         The length of the output
  *                       (may be one byte longer than
@@ -383,58 +435,44 @@ lgr_rb_fill_allocated_header(lgr_mess_header *allocated,
  *                       byte is appended to the output
  *                       buffer.
  *
- * @retval  Number of allocated elements.
+ * @retval  Number of used elements.
  */
 static inline uint32_t
-lgr_rb_allocate_and_copy(struct lgr_rb *ring_buffer,
-                         const void *start, uint32_t length,
-                         uint8_t **arg_addr, bool add_zero)
+lgr_rb_copy(struct lgr_rb *ring_buffer, uint32_t position,
+            const void *start, uint32_t length,
+            uint8_t **arg_addr, bool add_zero)
 {
-    uint32_t start_pos = 0;
-    uint32_t need_elements;
+    uint32_t        room;
+    uint32_t        copy_len;
+    const uint8_t  *start_aux = start;
 
     if (length > TE_LOG_FIELD_MAX)
         length = TE_LOG_FIELD_MAX;
 
-    need_elements = (length % LGR_RB_ELEMENT_LEN) ?
-                     (uint32_t)(length / LGR_RB_ELEMENT_LEN) + 1 :
-                     (uint32_t)(length / LGR_RB_ELEMENT_LEN);
+    *arg_addr = LGR_GET_MESSAGE_ARRAY(ring_buffer, position);
+    room = (LGR_TOTAL_RB_EL - position) * LGR_RB_ELEMENT_LEN;
+    copy_len = (add_zero && length > 0) ? length - 1 : length;
 
-    if (lgr_rb_allocate_space(ring_buffer, need_elements, &start_pos) !=
-            need_elements)
+    if (copy_len <= room)
     {
-        return 0;
-    }
-
-    *arg_addr = LGR_GET_MESSAGE_ARRAY(ring_buffer, start_pos);
-
-    if ((start_pos + need_elements) <= LGR_TOTAL_RB_EL)
-    {
-        if (add_zero)
-        {
-            memcpy(*arg_addr, start, length - 1);
-            *(*arg_addr + length - 1) = '\0';
-        }
-        else
-        {
-            memcpy(*arg_addr, start, length);
-        }
+        memcpy(*arg_addr, start_aux, copy_len);
     }
     else
     {
-        uint32_t  length_aux;
-        const uint8_t *start_aux = start;
-
-        length_aux = (LGR_TOTAL_RB_EL - start_pos) * LGR_RB_ELEMENT_LEN;
-        memcpy(*arg_addr, start_aux, length_aux);
-
-        start_aux += length_aux;
-        length_aux = length - length_aux;
+        memcpy(*arg_addr, start_aux, room);
         memcpy(LGR_GET_MESSAGE_ARRAY(ring_buffer, 0),
-               start_aux, length_aux);
+               start_aux + room, copy_len - room);
+    }
+
+    if (add_zero && length > 0)
+    {
+        if (copy_len < room)
+            (*arg_addr)[copy_len] = '\0';
+        else
+            (LGR_GET_MESSAGE_ARRAY(ring_buffer, 0))[copy_len - room] = '\0';
     }
 
-    return need_elements;
+    return lgr_rb_arg_elements(length);
 }
 
 /**
@@ -28,6 +28,12 @@
 #if HAVE_SYS_TYPES_H
 #include <sys/types.h>
 #endif
+#if HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+#if HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
 #if HAVE_PTHREAD_H
 #include <pthread.h>
 #else
@@ -51,6 +57,29 @@
 /** Maximum logger message length */
 #define LGR_TEN_MSG_BUF_INIT    0x1000
 
+/** Size of the buffer to collect a batch of log messages */
+#define LGR_TEN_BATCH_MAX       0x4000
+
+/** Maximum time in milliseconds a message may stay in a batch */
+#define LGR_TEN_BATCH_LATENCY_MS    50
+
+/**
+ * Levels of messages which are delivered without delay together with
+ * the batch, since they are the most important ones if the process is
+ * killed or crashes.
+ */
+#define LGR_TEN_BATCH_FLUSH_LEVELS \
+    (TE_LL_ERROR | TE_LL_WARN | TE_LL_RING | TE_LL_CONTROL)
+
+/**
+ * Maximum time in milliseconds to wait for the lock to send the last
+ * batch when the client is closed
+ */
+#define LGR_TEN_CLOSE_TIMEOUT_MS    1000
+
+/** Length of the batch header */
+#define LGR_TEN_BATCH_HDR_LEN   (sizeof(te_log_nfl) + strlen(LGR_SRV_BATCH))
+
 
 #ifdef HAVE_PTHREAD_H
 /** Mutual exclusion execution lock */
@@ -71,6 +100,60 @@ static struct ipc_client *lgr_client = NULL;
  */
 static te_log_msg_raw_data lgr_out;
 
+/**
+ * Batch of log messages to be sent to the Logger.
+ *
+ * @note It should be used under lgr_lock only.
+ */
+static uint8_t *lgr_batch = NULL;
+/** Length of the batch including the header */
+static size_t lgr_batch_len = 0;
+/** Number of messages in the batch */
+static unsigned int lgr_batch_num = 0;
+/** Are log messages sent in batches? */
+static bool lgr_batch_enabled = false;
+/** Signalled when a message is added to the empty batch */
+static pthread_cond_t lgr_batch_cond = PTHREAD_COND_INITIALIZER;
+
+
+/**
+ * Send message to the Logger server via IPC.
+ *
+ * @param msg       Message to be sent
+ * @param len       Length of the message
+ */
+static void
+log_message_send(const void *msg, size_t len)
+{
+    if (ipc_send_message(lgr_client, LGR_SRV_NAME, msg, len) != 0)
+    {
+        fprintf(stderr, "Failed to send message to IPC server '%s': %s\n",
+                LGR_SRV_NAME, strerror(errno));
+    }
+}
+
+/**
+ * Send collected batch of log messages to the Logger server.
+ * A single message is sent as is.
+ *
+ * @note It should be called under lgr_lock only.
+ */
+static void
+lgr_batch_send(void)
+{
+    size_t hdr_len = LGR_TEN_BATCH_HDR_LEN + sizeof(uint32_t);
+
+    if (lgr_batch_num == 0)
+        return;
+
+    if (lgr_batch_num == 1)
+        log_message_send(lgr_batch + hdr_len, lgr_batch_len - hdr_len);
+    else
+        log_message_send(lgr_batch, lgr_batch_len);
+
+    lgr_batch_len = LGR_TEN_BATCH_HDR_LEN;
+    lgr_batch_num = 0;
+}
 
 /**
  * Log message via IPC.
@@ -81,11 +164,150 @@ static te_log_msg_raw_data lgr_out;
 static void
 log_message_ipc(const void *msg, size_t len)
 {
-    if (ipc_send_message(lgr_client, LGR_SRV_NAME, msg, len) != 0)
+    uint32_t nlen = htonl(len);
+
+    if (!lgr_batch_enabled ||
+        LGR_TEN_BATCH_HDR_LEN + sizeof(nlen) + len > LGR_TEN_BATCH_MAX)
     {
-        fprintf(stderr, "Failed to send message to IPC server '%s': %s\n",
-                LGR_SRV_NAME, strerror(errno));
+        lgr_batch_send();
+        log_message_send(msg, len);
+        return;
     }
+
+    if (lgr_batch_len + sizeof(nlen) + len > LGR_TEN_BATCH_MAX)
+        lgr_batch_send();
+
+    if (lgr_batch_num == 0)
+        pthread_cond_signal(&lgr_batch_cond);
+
+    memcpy(lgr_batch + lgr_batch_len, &nlen, sizeof(nlen));
+    memcpy(lgr_batch + lgr_batch_len + sizeof(nlen), msg, len);
+    lgr_batch_len += sizeof(nlen) + len;
+    lgr_batch_num++;
+}
+
+/**
+ * Entry point of the thread sending log messages which have stayed
+ * in the batch for #LGR_TEN_BATCH_LATENCY_MS.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL
+ */
+static void *
+lgr_batch_flusher(void *arg)
+{
+    struct timespec deadline;
+
+    UNUSED(arg);
+
+    pthread_mutex_lock(&lgr_lock);
+    while (true)
+    {
+        while (lgr_batch_num == 0)
+            pthread_cond_wait(&lgr_batch_cond, &lgr_lock);
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += TE_MS2NS(LGR_TEN_BATCH_LATENCY_MS);
+        if (deadline.tv_nsec >= TE_SEC2NS(1))
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= TE_SEC2NS(1);
+        }
+        while (lgr_batch_num != 0 &&
+               pthread_cond_timedwait(&lgr_batch_cond, &lgr_lock,
+                                      &deadline) != ETIMEDOUT)
+            ;
+
+        lgr_batch_send();
+    }
+
+    return NULL;
+}
+
+/** Send the batch before fork() to avoid its duplication */
+static void
+lgr_batch_atfork_prepare(void)
+{
+    pthread_mutex_lock(&lgr_lock);
+    lgr_batch_send();
+}
+
+/** Release the lock taken before fork() in the parent process */
+static void
+lgr_batch_atfork_parent(void)
+{
+    pthread_mutex_unlock(&lgr_lock);
+}
+
+/**
+ * The flusher thread does not exist in the child process, so log
+ * messages are not batched there.
+ */
+static void
+lgr_batch_atfork_child(void)
+{
+    lgr_batch_enabled = false;
+    pthread_mutex_unlock(&lgr_lock);
+}
+
+/**
+ * Start sending log messages in batches. If it fails, messages are
+ * sent one by one.
+ *
+ * @note It should be called under lgr_lock only.
+ */
+static void
+lgr_batch_start(void)
+{
+    static bool started = false;
+
+    pthread_attr_t  attr;
+    pthread_t       thread;
+    sigset_t        mask;
+    sigset_t        old_mask;
+    uint8_t        *ptr;
+    int             rc;
+
+    /* The client may be re-created after log_client_close() */
+    if (started)
+        return;
+    started = true;
+
+    lgr_batch = malloc(LGR_TEN_BATCH_MAX);
+    if (lgr_batch == NULL)
+        return;
+
+    ptr = lgr_batch;
+    LGR_NFL_PUT(strlen(LGR_SRV_BATCH), ptr);
+    memcpy(ptr, LGR_SRV_BATCH, strlen(LGR_SRV_BATCH));
+    lgr_batch_len = LGR_TEN_BATCH_HDR_LEN;
+
+    /* The flusher thread must not get signals destined to the process */
+    sigfillset(&mask);
+    pthread_sigmask(SIG_SETMASK, &mask, &old_mask);
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&thread, &attr, lgr_batch_flusher, NULL);
+    pthread_attr_destroy(&attr);
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    if (rc != 0)
+    {
+        fprintf(stderr, "%s(): failed to create log flusher thread: %s\n",
+                __FUNCTION__, strerror(rc));
+        return;
+    }
+
+    rc = pthread_atfork(lgr_batch_atfork_prepare, lgr_batch_atfork_parent,
+                        lgr_batch_atfork_child);
+    if (rc != 0)
+    {
+        fprintf(stderr, "%s(): pthread_atfork() failed: %s\n",
+                __FUNCTION__, strerror(rc));
+        return;
+    }
+
+    lgr_batch_enabled = true;
 }
 
 
@@ -133,11 +355,16 @@ ten_log_message(const char *file, unsigned int line,
         lgr_out.buf = lgr_out.end = NULL;
         lgr_out.args_max = 0;
         lgr_out.args = NULL;
+
+        lgr_batch_start();
     }
 
     log_message_va(&lgr_out, file, line, sec, usec, level, entity, user,
                    fmt, ap);
 
+    if ((level & LGR_TEN_BATCH_FLUSH_LEVELS) != 0)
+        lgr_batch_send();
+
 #ifdef HAVE_PTHREAD_H
     pthread_mutex_unlock(&lgr_lock);
 #endif
@@ -151,13 +378,31 @@ log_client_close(void)
     int res;
 
 #ifdef HAVE_PTHREAD_H
-    if ((res = pthread_mutex_trylock(&lgr_lock)) != 0)
+    struct timespec deadline;
+
+    /*
+     * The lock may be held by the flusher thread sending a batch or
+     * by a thread which never releases it, e.g. when exit() is called
+     * while logging.
+     */
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += LGR_TEN_CLOSE_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += TE_MS2NS(LGR_TEN_CLOSE_TIMEOUT_MS % 1000);
+    if (deadline.tv_nsec >= TE_SEC2NS(1))
     {
-        fprintf(stderr, "%s(): pthread_mutex_trylock() failed: %s\n",
+        deadline.tv_sec++;
+        deadline.tv_nsec -= TE_SEC2NS(1);
+    }
+    if ((res = pthread_mutex_timedlock(&lgr_lock, &deadline)) != 0)
+    {
+        fprintf(stderr, "%s(): pthread_mutex_timedlock() failed: %s\n",
                 __FUNCTION__, strerror(res));
         return;
     }
 #endif
+    if (lgr_client != NULL)
+        lgr_batch_send();
+
     res = ipc_close_client(lgr_client);
     if (res != 0)
     {
@@ -204,6 +449,16 @@ log_flush_ten(const char *ta_name)
         return TE_EINVAL;
     }
 
+    /* Deliver own log messages collected so far */
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&lgr_lock);
+#endif
+    if (lgr_client != NULL)
+        lgr_batch_send();
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&lgr_lock);
+#endif
+
     snprintf(clnt_name, sizeof(clnt_name), "LOGGER_FLUSH_%s", ta_name);
 
     rc = ipc_init_client(clnt_name, LOGGER_IPC, &log_client);
@@ -43,6 +43,7 @@
 #endif
 
 #include "te_alloc.h"
+#include "te_dbuf.h"
 #include "te_defs.h"
 #include "te_stdint.h"
 #include "te_errno.h"
@@ -69,20 +70,47 @@
 #define RCF_MAX_INT     12
 
 
+/** Number of buckets in the table of buffered answers */
+#define MSG_BUF_BUCKETS 64
+
 typedef struct msg_buf_entry {
-    CIRCLEQ_ENTRY(msg_buf_entry) link;
-    rcf_msg                     *message;
+    TAILQ_ENTRY(msg_buf_entry)  link;       /**< Links in order of
+                                                 receiving */
+    TAILQ_ENTRY(msg_buf_entry)  seqno_link; /**< Links in the bucket of
+                                                 the sequence number */
+    rcf_msg                    *message;
 } msg_buf_entry_t;
 
-typedef CIRCLEQ_HEAD(msg_buf_head, msg_buf_entry) msg_buf_head_t;
+/** List of buffered answers */
+typedef TAILQ_HEAD(msg_buf_list, msg_buf_entry) msg_buf_list_t;
+
+/**
+ * Answers received by the thread while it waits for other ones.
+ * They are kept in order of receiving for arbitrary matching and
+ * indexed by sequence number for matching to requests.
+ */
+typedef struct msg_buf_head {
+    msg_buf_list_t  all;                        /**< All answers */
+    msg_buf_list_t  by_seqno[MSG_BUF_BUCKETS];  /**< Answers hashed by
+                                                     sequence number */
+} msg_buf_head_t;
 
 typedef struct thread_ctx {
     struct ipc_client *ipc_handle;
     msg_buf_head_t     msg_buf_head;
     uint32_t           seqno;
     bool log_cfg_changes;
+    te_dbuf            send_buf;    /**< Buffer for serialised request */
 } thread_ctx_t;
 
+/** RCF request sent without waiting for the answer */
+struct rcf_async {
+    thread_ctx_t   *ctx;        /**< Context of the thread sending it */
+    uint32_t        seqno;      /**< Sequence number of the request */
+    rcf_msg        *answer;     /**< Answer or @c NULL if it is not
+                                     received yet */
+};
+
 
 /* Forward declaration */
 static int csap_tr_recv_get(const char *ta_name, int session,
@@ -179,6 +207,7 @@ rcf_message_match(rcf_msg *msg, void *opaque)
     {
         case RCFOP_TALIST:
         case RCFOP_TACHECK:
+        case RCFOP_GET_STATS:
             /* These requests do not have TA name and SID */
             return 0;
 
@@ -196,6 +225,70 @@ rcf_message_match(rcf_msg *msg, void *opaque)
     }
 }
 
+/**
+ * Match RCF IPC message with the sequence number of the request.
+ * RCF answers with the message of the request, so the sequence number
+ * identifies the answer. Messages matched by this callback are looked up
+ * by msg_buffer_find() in constant time.
+ *
+ * The function complies with rcf_message_match_cb prototype.
+ */
+static int
+rcf_message_match_seqno(rcf_msg *msg, void *opaque)
+{
+    return (msg != NULL && msg->seqno == *(uint32_t *)opaque) ? 0 : 1;
+}
+
+/**
+ * Get the bucket of answers with the sequence number.
+ *
+ * @param buf_head      head of buffer list
+ * @param seqno         sequence number
+ *
+ * @return Bucket list.
+ */
+static inline msg_buf_list_t *
+msg_buffer_bucket(msg_buf_head_t *buf_head, uint32_t seqno)
+{
+    return &buf_head->by_seqno[seqno % MSG_BUF_BUCKETS];
+}
+
+/**
+ * Initialize RCF message buffer
+ *
+ * @param buf_head      head of buffer list
+ */
+static void
+msg_buffer_init(msg_buf_head_t *buf_head)
+{
+    unsigned int i;
+
+    TAILQ_INIT(&buf_head->all);
+    for (i = 0; i < MSG_BUF_BUCKETS; i++)
+        TAILQ_INIT(&buf_head->by_seqno[i]);
+}
+
+/**
+ * Remove the entry from RCF message buffer and free it.
+ *
+ * @param buf_head      head of buffer list
+ * @param entry         entry to be removed
+ *
+ * @return Message of the entry.
+ */
+static rcf_msg *
+msg_buffer_remove(msg_buf_head_t *buf_head, msg_buf_entry_t *entry)
+{
+    rcf_msg *msg = entry->message;
+
+    TAILQ_REMOVE(&buf_head->all, entry, link);
+    TAILQ_REMOVE(msg_buffer_bucket(buf_head, msg->seqno), entry,
+                 seqno_link);
+    free(entry);
+
+    return msg;
+}
+
 /**
  * Clear RCF message buffer
  *
@@ -211,12 +304,9 @@ msg_buffer_clear(msg_buf_head_t *buf_head)
     if (buf_head == NULL)
         return 0;
 
-    while ((entry = buf_head->cqh_first) != (void *)buf_head)
-    {
-        CIRCLEQ_REMOVE(buf_head, entry, link);
-        free(entry->message);
-        free(entry);
-    }
+    while ((entry = TAILQ_FIRST(&buf_head->all)) != NULL)
+        free(msg_buffer_remove(buf_head, entry));
+
     return 0;
 }
 
@@ -247,7 +337,9 @@ msg_buffer_insert(msg_buf_head_t *buf_head, rcf_msg *message)
 
     memcpy(buf_entry->message, message, msg_len);
 
-    CIRCLEQ_INSERT_TAIL(buf_head, buf_entry, link);
+    TAILQ_INSERT_TAIL(&buf_head->all, buf_entry, link);
+    TAILQ_INSERT_TAIL(msg_buffer_bucket(buf_head, message->seqno),
+                      buf_entry, seqno_link);
 
     return 0;
 }
@@ -272,18 +364,23 @@ msg_buffer_find(msg_buf_head_t *msg_buf, rcf_message_match_cb match_cb,
     if (msg_buf == NULL)
         return NULL;
 
-    for (buf_entry = msg_buf->cqh_first;
-         buf_entry != (void *)msg_buf;
-         buf_entry = buf_entry->link.cqe_next)
+    if (match_cb == rcf_message_match_seqno)
     {
-        if (match_cb(buf_entry->message, opaque) == 0)
-        {
-            rcf_msg *msg = buf_entry->message;
+        uint32_t seqno = *(uint32_t *)opaque;
 
-            CIRCLEQ_REMOVE(msg_buf, buf_entry, link);
-            free(buf_entry);
-            return msg;
+        TAILQ_FOREACH(buf_entry, msg_buffer_bucket(msg_buf, seqno),
+                      seqno_link)
+        {
+            if (buf_entry->message->seqno == seqno)
+                return msg_buffer_remove(msg_buf, buf_entry);
         }
+        return NULL;
+    }
+
+    TAILQ_FOREACH(buf_entry, &msg_buf->all, link)
+    {
+        if (match_cb(buf_entry->message, opaque) == 0)
+            return msg_buffer_remove(msg_buf, buf_entry);
     }
 
     return NULL;
@@ -294,10 +391,15 @@ msg_buffer_find(msg_buf_head_t *msg_buf, rcf_message_match_cb match_cb,
  * If message is too long, the memory is allocated and its address
  * is placed to p_answer.
  *
+ * Messages in compact layout are deserialised, so that the caller
+ * always gets complete rcf_msg structure.
+ *
  * @param ipcc            pointer to the ipc_client structure returned
  *                        by ipc_init_client()
  * @param recv_msg        pointer to the buffer for answer
  * @param recv_size       pointer to the variable to store:
+ *                          on entry - length of the available buffer;
+ *                          on exit - length of the message received
  * @param p_answer        location for address of the memory
  *                        allocated for the answer or NULL
  *
@@ -307,48 +409,82 @@ static int
 rcf_ipc_receive_answer(struct ipc_client *ipcc, rcf_msg *recv_msg,
                        size_t *recv_size, rcf_msg **p_answer)
 {
-    te_errno    rc;
-    size_t      buflen = *recv_size;
+    uint8_t     buf[sizeof(rcf_msg)];
+    uint8_t    *raw = buf;
+    size_t      raw_len = sizeof(buf);
     size_t      len;
+    bool        packed;
+    rcf_msg    *message;
+    te_errno    rc;
 
-    if ((rc = ipc_receive_answer(ipcc, RCF_SERVER,
-                                 recv_msg, recv_size)) == 0)
-    {
-        INFO("%s: got reply for %u:%d:'%s'", ipc_client_name(ipcc),
-            (unsigned)recv_msg->seqno, recv_msg->sid,
-            rcf_op_to_string(recv_msg->opcode));
+    if (p_answer != NULL)
+        *p_answer = NULL;
 
-        if (p_answer != NULL)
-            *p_answer = NULL;
-        return 0;
+    rc = ipc_receive_answer(ipcc, RCF_SERVER, raw, &raw_len);
+    if (TE_RC_GET_ERROR(rc) == TE_ESMALLBUF)
+    {
+        len = raw_len - sizeof(buf);
+        raw = TE_ALLOC(raw_len);
+        memcpy(raw, buf, sizeof(buf));
+        rc = ipc_receive_rest_answer(ipcc, RCF_SERVER, raw + sizeof(buf),
+                                     &len);
     }
-    else if (TE_RC_GET_ERROR(rc) != TE_ESMALLBUF)
+    if (rc != 0)
     {
-        return TE_RC(TE_RCF_API, TE_EIPC);
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+        goto exit;
     }
 
-    INFO("%s: got reply for %u:%d:'%s'", ipc_client_name(ipcc),
-        (unsigned)recv_msg->seqno, recv_msg->sid,
-        rcf_op_to_string(recv_msg->opcode));
+    packed = rcf_msg_is_packed(raw, raw_len);
+    len = packed ? rcf_msg_unpacked_len(raw, raw_len) : raw_len;
+    if (len == 0 || (!packed && len < sizeof(rcf_msg)))
+    {
+        ERROR("Malformed message is received");
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+        goto exit;
+    }
 
-    if (p_answer == NULL)
+    if (len <= *recv_size)
+    {
+        message = recv_msg;
+    }
+    else if (p_answer == NULL)
     {
         ERROR("Unexpected large message is received");
-        return TE_RC(TE_RCF_API, TE_EIPC);
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+        goto exit;
+    }
+    else
+    {
+        message = *p_answer = TE_ALLOC(len);
     }
 
-    *p_answer = TE_ALLOC(*recv_size);
+    if (packed)
+        rc = rcf_msg_unpack(raw, raw_len, -1, message);
+    else
+        memcpy(message, raw, len);
 
-    memcpy(*p_answer, recv_msg, buflen);
-    len = *recv_size - buflen;
-    if ((rc = ipc_receive_rest_answer(ipcc, RCF_SERVER,
-                                      ((uint8_t *)*p_answer) + buflen,
-                                      &len)) != 0)
+    if (rc != 0)
     {
-        return TE_RC(TE_RCF_API, TE_EIPC);
+        if (p_answer != NULL)
+        {
+            free(*p_answer);
+            *p_answer = NULL;
+        }
+        rc = TE_RC(TE_RCF_API, TE_EIPC);
+        goto exit;
     }
+    *recv_size = len;
 
-    return 0;
+    INFO("%s: got reply for %u:%d:'%s'", ipc_client_name(ipcc),
+        (unsigned)message->seqno, message->sid,
+        rcf_op_to_string(message->opcode));
+
+exit:
+    if (raw != buf)
+        free(raw);
+
+    return rc;
 }
 
 /**
@@ -439,43 +575,20 @@ wait_rcf_ipc_message(struct ipc_client *ipcc,
 
 
 /**
- * Send IPC RCF message and receive appropriate answer.
- * If message is too long, the memory is allocated and its address
- * is placed to p_answer.
+ * Send IPC RCF message without waiting for the answer. The message is
+ * assigned the next sequence number of the thread, its answer is
+ * matched with rcf_message_match_seqno().
  *
  * @param ctx             RCF client context
  * @param send_msg        pointer to the message to be sent
- * @param send_size       size of message to be sent
- * @param recv_msg        pointer to the buffer for answer
- * @param recv_size       pointer to the variable to store:
- *                          on entry - length of the available buffer;
- *                          on exit - length of the message received
- * @param p_answer        location for address of the memory
- *                        allocated for the answer or NULL
  *
  * @return zero on success or error code
  */
 static te_errno
-send_recv_rcf_ipc_message(thread_ctx_t *ctx,
-                          rcf_msg *send_buf, size_t send_size,
-                          rcf_msg *recv_buf, size_t *recv_size,
-                          rcf_msg **p_answer)
+send_rcf_ipc_message(thread_ctx_t *ctx, rcf_msg *send_buf)
 {
-    te_errno                    rc;
-    char                        ta[RCF_MAX_NAME];
-    rcf_msg                    *message;
-    rcf_message_match_simple    match_data;
-
-
-    if (ctx == NULL || ctx->ipc_handle == NULL ||
-        send_buf == NULL || recv_buf == NULL || recv_size == NULL)
-        return TE_RC(TE_RCF_API, TE_EWRONGPTR);
-
-    /* The same memory may be used for send_buf and recv_buf */
-    te_strlcpy(ta, send_buf->ta, sizeof(ta));
-    match_data.ta_name = ta;
-    match_data.sid = send_buf->sid;
-    match_data.opcode = send_buf->opcode;
+    te_errno rc;
+    int      shm_fd;
 
     send_buf->seqno = ctx->seqno++;
 
@@ -483,8 +596,29 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
          (unsigned)send_buf->seqno, send_buf->sid,
          rcf_op_to_string(send_buf->opcode));
 
-    if ((rc = ipc_send_message(ctx->ipc_handle, RCF_SERVER,
-                               send_buf, send_size)) != 0)
+    rcf_msg_pack(send_buf, &ctx->send_buf, &shm_fd);
+
+    if (shm_fd >= 0)
+    {
+        /* RCF gets its own descriptor, so this one is not needed then */
+        rc = ipc_send_message_with_fd(ctx->ipc_handle, RCF_SERVER,
+                                      ctx->send_buf.ptr, ctx->send_buf.len,
+                                      shm_fd);
+        close(shm_fd);
+        if (TE_RC_GET_ERROR(rc) == TE_EOPNOTSUPP)
+        {
+            rcf_msg_pack(send_buf, &ctx->send_buf, NULL);
+            rc = ipc_send_message(ctx->ipc_handle, RCF_SERVER,
+                                  ctx->send_buf.ptr, ctx->send_buf.len);
+        }
+    }
+    else
+    {
+        rc = ipc_send_message(ctx->ipc_handle, RCF_SERVER,
+                              ctx->send_buf.ptr, ctx->send_buf.len);
+    }
+
+    if (rc != 0)
     {
         /*
          * Encountering EPIPE is the only way to know that RCF is down,
@@ -495,27 +629,56 @@ send_recv_rcf_ipc_message(thread_ctx_t *ctx,
             INFO("%s() failed with rc %r", __FUNCTION__, rc);
         else
             ERROR("%s() failed with rc %r", __FUNCTION__, rc);
+
         return TE_RC(TE_RCF_API, TE_EIPC);
     }
 
-    if ((rc = rcf_ipc_receive_answer(ctx->ipc_handle, recv_buf,
-                                     recv_size, p_answer)) != 0)
-        return rc;
+    return 0;
+}
 
-    message = (p_answer != NULL && *p_answer != NULL) ? *p_answer
-                                                      : recv_buf;
-    if (rcf_message_match(recv_buf, &match_data) == 0)
-        return 0;
+/**
+ * Send IPC RCF message and receive appropriate answer.
+ * If message is too long, the memory is allocated and its address
+ * is placed to p_answer.
+ *
+ * @param ctx             RCF client context
+ * @param send_msg        pointer to the message to be sent
+ * @param send_size       size of message to be sent
+ * @param recv_msg        pointer to the buffer for answer
+ * @param recv_size       pointer to the variable to store:
+ *                          on entry - length of the available buffer;
+ *                          on exit - length of the message received
+ * @param p_answer        location for address of the memory
+ *                        allocated for the answer or NULL
+ *
+ * @return zero on success or error code
+ */
+static te_errno
+send_recv_rcf_ipc_message(thread_ctx_t *ctx,
+                          rcf_msg *send_buf, size_t send_size,
+                          rcf_msg *recv_buf, size_t *recv_size,
+                          rcf_msg **p_answer)
+{
+    te_errno    rc;
+    uint32_t    seqno;
 
-    if (msg_buffer_insert(&ctx->msg_buf_head, message) != 0)
-        ERROR("RCF message is lost");
+    UNUSED(send_size);
 
-    if (message != recv_buf)
-        free(message);
+    if (ctx == NULL || ctx->ipc_handle == NULL ||
+        send_buf == NULL || recv_buf == NULL || recv_size == NULL)
+        return TE_RC(TE_RCF_API, TE_EWRONGPTR);
+
+    rc = send_rcf_ipc_message(ctx, send_buf);
+    if (rc != 0)
+        return rc;
+
+    /* The same memory may be used for send_buf and recv_buf */
+    seqno = send_buf->seqno;
+    rc = wait_rcf_ipc_message(ctx->ipc_handle, &ctx->msg_buf_head,
+                              rcf_message_match_seqno, &seqno,
+                              recv_buf, recv_size, p_answer);
 
-    return wait_rcf_ipc_message(ctx->ipc_handle, &ctx->msg_buf_head,
-                                rcf_message_match, &match_data,
-                                recv_buf, recv_size, p_answer);
+    return rc;
 }
 
 #ifdef HAVE_PTHREAD_H
@@ -539,6 +702,7 @@ rcf_api_thread_ctx_destroy(void *handle)
     }
 
     msg_buffer_clear(&(rcf_ctx_handle->msg_buf_head));
+    te_dbuf_free(&rcf_ctx_handle->send_buf);
     free(rcf_ctx_handle);
 }
 
@@ -587,6 +751,8 @@ get_ctx_handle(bool create)
         char        name[RCF_MAX_NAME];
 
         handle = TE_ALLOC(sizeof(*handle));
+        handle->send_buf =
+            (te_dbuf)TE_DBUF_INIT(TE_DBUF_DEFAULT_GROW_FACTOR);
 
         sprintf(name, "rcf_client_%u_%u", (unsigned int)getpid(),
                 (unsigned int)pthread_self());
@@ -601,7 +767,7 @@ get_ctx_handle(bool create)
         }
         assert(handle->ipc_handle != NULL);
 
-        CIRCLEQ_INIT(&handle->msg_buf_head);
+        msg_buffer_init(&handle->msg_buf_head);
 #ifdef HAVE_PTHREAD_H
         if (pthread_setspecific(key, (void *)handle) != 0)
         {
@@ -1156,6 +1322,89 @@ rcf_log_cfg_changes(bool enable)
         ctx_handle->log_cfg_changes = enable;
 }
 
+/**
+ * Get object instance value from the answer to RCFOP_CONFGET request.
+ * The file with the value saved by RCF process is removed.
+ *
+ * @param msg           answer
+ * @param val_buf       location for the object instance value
+ * @param len           location length
+ *
+ * @return error code
+ */
+static te_errno
+cfg_get_answer_value(rcf_msg *msg, char *val_buf, size_t len)
+{
+    if (msg->flags & BINARY_ATTACHMENT)
+    {
+        te_errno    rc = 0;
+        ssize_t     n;
+        int         fd;
+
+        if ((fd = open(msg->file, O_RDONLY)) < 0)
+        {
+            ERROR("Cannot open file %s saved by RCF process", msg->file);
+            return TE_RC(TE_RCF_API, TE_ENOENT);
+        }
+        if ((n = read(fd, val_buf, len)) < 0)
+        {
+            ERROR("Cannot read from file %s saved by RCF process",
+                  msg->file);
+            close(fd);
+            return TE_RC(TE_RCF_API, TE_EIPC);
+        }
+        if (len == (size_t)n)
+        {
+            char tmp;
+
+            if (read(fd, &tmp, 1) != 0)
+                rc = TE_RC(TE_RCF_API, TE_ESMALLBUF);
+        }
+        close(fd);
+        if (unlink(msg->file) != 0)
+            ERROR("Cannot unlink file %s saved by RCF process", msg->file);
+        msg->flags &= ~BINARY_ATTACHMENT;
+
+        return rc;
+    }
+
+    if (len <= strlen(msg->value))
+        return TE_RC(TE_RCF_API, TE_ESMALLBUF);
+    te_strlcpy(val_buf, msg->value, len);
+
+    return 0;
+}
+
+/**
+ * Log configuration change if it is enabled by rcf_log_cfg_changes().
+ *
+ * @param ctx           RCF client context
+ * @param opcode        RCFOP_CONFSET, RCFOP_CONFADD or RCFOP_CONFDEL
+ * @param oid           object instance identifier
+ * @param val           object instance value
+ * @param rc            status of the change
+ */
+static void
+cfg_log_change(thread_ctx_t *ctx, rcf_op_t opcode, const char *oid,
+               const char *val, te_errno rc)
+{
+    if (!ctx->log_cfg_changes)
+        return;
+
+    if (opcode == RCFOP_CONFSET)
+        LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
+                "Set %s to %s: %r", oid, val, rc);
+    else if (opcode == RCFOP_CONFDEL)
+        LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
+                "Delete %s: %r", oid, rc);
+    else if (strlen(val) == 0)
+        LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
+                "Add %s: %r", oid, rc);
+    else
+        LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
+                "Add %s with value %s: %r", oid, val, rc);
+}
+
 /* See description in rcf_api.h */
 te_errno
 rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
@@ -1185,47 +1434,7 @@ rcf_ta_cfg_get(const char *ta_name, int session, const char *oid,
     if (rc != 0 || (rc = msg.error) != 0)
         return rc;
 
-    if (msg.flags & BINARY_ATTACHMENT)
-    {
-        ssize_t n;
-        int     fd;
-
-        if ((fd = open(msg.file, O_RDONLY)) < 0)
-        {
-            ERROR("Cannot open file %s saved by RCF process", msg.file);
-            return TE_RC(TE_RCF_API, TE_ENOENT);
-        }
-        if ((n = read(fd, val_buf, len)) < 0)
-        {
-            ERROR("Cannot read from file %s saved by RCF process",
-                  msg.file);
-            close(fd);
-            return TE_RC(TE_RCF_API, TE_EIPC);
-        }
-        if (len == (size_t)n)
-        {
-            char tmp;
-
-            if (read(fd, &tmp, 1) != 0)
-            {
-                close(fd);
-                if (unlink(msg.file) != 0)
-                    ERROR("Cannot unlink file %s saved by RCF process", msg.file);
-                return TE_RC(TE_RCF_API, TE_ESMALLBUF);
-            }
-        }
-        close(fd);
-        if (unlink(msg.file) != 0)
-            ERROR("Cannot unlink file %s saved by RCF process", msg.file);
-    }
-    else
-    {
-        if (len <= strlen(msg.value))
-            return TE_RC(TE_RCF_API, TE_ESMALLBUF);
-        te_strlcpy(val_buf, msg.value, len);
-    }
-
-    return 0;
+    return cfg_get_answer_value(&msg, val_buf, len);
 }
 
 /**
@@ -1269,19 +1478,7 @@ conf_add_set(const char *ta_name, int session, const char *oid,
     if (rc == 0)
         rc = msg.error;
 
-    if (ctx_handle->log_cfg_changes)
-    {
-        if (opcode == RCFOP_CONFSET)
-            LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
-                    "Set %s to %s: %r", oid, val, rc);
-        else if (strlen(val) == 0)
-            LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
-                    "Add %s: %r", oid, rc);
-        else
-            LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
-                    "Add %s with value %s: %r", oid, val, rc);
-
-    }
+    cfg_log_change(ctx_handle, opcode, oid, val, rc);
 
     return rc;
 }
@@ -1335,13 +1532,281 @@ rcf_ta_cfg_del(const char *ta_name, int session, const char *oid)
     if (rc == 0)
         rc = msg.error;
 
-    if (ctx_handle->log_cfg_changes)
-        LOG_MSG(rc == 0 ? TE_LL_RING : TE_LL_ERROR,
-                "Delete %s: %r", oid, rc);
+    cfg_log_change(ctx_handle, RCFOP_CONFDEL, oid, "", rc);
 
     return rc;
 }
 
+/**
+ * Send configuration request without waiting for the answer.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param opcode        RCFOP_CONFGET, RCFOP_CONFSET, RCFOP_CONFADD or
+ *                      RCFOP_CONFDEL
+ * @param oid           object instance identifier
+ * @param val           object instance value or @c NULL
+ * @param req           location for the request handle
+ *
+ * @return error code
+ */
+static te_errno
+cfg_async_send(const char *ta_name, int session, rcf_op_t opcode,
+               const char *oid, const char *val, rcf_async **req)
+{
+    rcf_msg     msg;
+    rcf_async  *async;
+    te_errno    rc;
+
+    RCF_API_INIT;
+
+    if (req == NULL || oid == NULL || strlen(oid) >= RCF_MAX_ID ||
+        (val != NULL && strlen(val) >= RCF_MAX_VAL) || BAD_TA)
+    {
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    te_strlcpy(msg.id, oid, sizeof(msg.id));
+    if (val != NULL)
+        te_strlcpy(msg.value, val, sizeof(msg.value));
+    te_strlcpy(msg.ta, ta_name, sizeof(msg.ta));
+    msg.opcode = opcode;
+    msg.sid = session;
+
+    async = TE_ALLOC(sizeof(*async));
+    async->ctx = ctx_handle;
+
+    rc = send_rcf_ipc_message(ctx_handle, &msg);
+    if (rc != 0)
+    {
+        free(async);
+        return rc;
+    }
+    async->seqno = msg.seqno;
+
+    *req = async;
+    return 0;
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_get_async(const char *ta_name, int session, const char *oid,
+                     rcf_async **req)
+{
+    return cfg_async_send(ta_name, session, RCFOP_CONFGET, oid, NULL, req);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_set_async(const char *ta_name, int session, const char *oid,
+                     const char *val, rcf_async **req)
+{
+    if (val == NULL)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    return cfg_async_send(ta_name, session, RCFOP_CONFSET, oid, val, req);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_add_async(const char *ta_name, int session, const char *oid,
+                     const char *val, rcf_async **req)
+{
+    return cfg_async_send(ta_name, session, RCFOP_CONFADD, oid,
+                          val == NULL ? "" : val, req);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_cfg_del_async(const char *ta_name, int session, const char *oid,
+                     rcf_async **req)
+{
+    return cfg_async_send(ta_name, session, RCFOP_CONFDEL, oid, NULL, req);
+}
+
+/**
+ * Check whether the answer to the request is received and take it
+ * from the buffer of answers.
+ *
+ * @param req           request handle
+ *
+ * @return @c true if the answer is received.
+ */
+static bool
+rcf_async_check(rcf_async *req)
+{
+    rcf_msg *answer;
+
+    if (req->answer != NULL)
+        return true;
+
+    answer = msg_buffer_find(&req->ctx->msg_buf_head,
+                             rcf_message_match_seqno, &req->seqno);
+    if (answer == NULL)
+        return false;
+
+    if (answer->opcode != RCFOP_CONFGET)
+    {
+        cfg_log_change(req->ctx, answer->opcode, answer->id,
+                       answer->value, answer->error);
+    }
+
+    req->answer = answer;
+    return true;
+}
+
+/**
+ * Receive an answer from RCF and put it to the buffer of answers.
+ *
+ * @param ctx           RCF client context
+ *
+ * @return error code
+ */
+static te_errno
+rcf_async_receive(thread_ctx_t *ctx)
+{
+    rcf_msg     msg;
+    rcf_msg    *answer = NULL;
+    size_t      anslen = sizeof(msg);
+    te_errno    rc;
+
+    rc = rcf_ipc_receive_answer(ctx->ipc_handle, &msg, &anslen, &answer);
+    if (rc != 0)
+        return rc;
+
+    if (msg_buffer_insert(&ctx->msg_buf_head,
+                          answer != NULL ? answer : &msg) != 0)
+        ERROR("RCF message is lost");
+
+    free(answer);
+    return 0;
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_async_wait_any(rcf_async * const *reqs, unsigned int n,
+                   unsigned int *index)
+{
+    thread_ctx_t   *ctx = get_ctx_handle(false);
+    bool            waiting;
+    unsigned int    i;
+    te_errno        rc;
+
+    if (reqs == NULL || index == NULL)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    while (true)
+    {
+        waiting = false;
+        for (i = 0; i < n; i++)
+        {
+            if (reqs[i] == NULL)
+                continue;
+
+            if (reqs[i]->ctx != ctx)
+            {
+                ERROR("%s(): request is sent by another thread",
+                      __FUNCTION__);
+                return TE_RC(TE_RCF_API, TE_EINVAL);
+            }
+
+            if (rcf_async_check(reqs[i]))
+            {
+                *index = i;
+                return reqs[i]->answer->error;
+            }
+            waiting = true;
+        }
+
+        if (!waiting)
+            return TE_RC(TE_RCF_API, TE_ENOENT);
+
+        rc = rcf_async_receive(ctx);
+        if (rc != 0)
+            return rc;
+    }
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_async_wait(rcf_async *req)
+{
+    unsigned int index;
+
+    if (req == NULL)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    return rcf_async_wait_any(&req, 1, &index);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_async_wait_all(rcf_async * const *reqs, unsigned int n)
+{
+    te_errno        result = 0;
+    te_errno        rc;
+    unsigned int    i;
+
+    if (reqs == NULL)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    for (i = 0; i < n; i++)
+    {
+        if (reqs[i] == NULL)
+            continue;
+
+        rc = rcf_async_wait(reqs[i]);
+        if (TE_RC_GET_ERROR(rc) == TE_EIPC)
+            return rc;
+        if (result == 0)
+            result = rc;
+    }
+
+    return result;
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_async_cfg_get_value(rcf_async *req, char *val_buf, size_t len)
+{
+    te_errno rc;
+
+    if (val_buf == NULL)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    rc = rcf_async_wait(req);
+    if (rc != 0)
+        return rc;
+
+    if (req->answer->opcode != RCFOP_CONFGET)
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    return cfg_get_answer_value(req->answer, val_buf, len);
+}
+
+/* See description in rcf_api.h */
+void
+rcf_async_free(rcf_async *req)
+{
+    if (req == NULL)
+        return;
+
+    /* Do not leave the answer in the buffer of the thread */
+    if (req->answer == NULL && req->ctx == get_ctx_handle(false))
+        (void)rcf_async_wait(req);
+
+    if (req->answer != NULL && (req->answer->flags & BINARY_ATTACHMENT) &&
+        unlink(req->answer->file) != 0)
+    {
+        ERROR("Cannot unlink file %s saved by RCF process",
+              req->answer->file);
+    }
+
+    free(req->answer);
+    free(req);
+}
+
 /* See description in rcf_api.h */
 te_errno
 rcf_ta_cfg_group(const char *ta_name, int session, bool is_start)
@@ -1458,6 +1923,13 @@ rcf_ta_get_sniffers(const char *ta_name, const char *snif_id, char **buf,
 /* See description in rcf_api.h */
 te_errno
 rcf_ta_get_log(const char *ta_name, char *log_file)
+{
+    return rcf_ta_get_log_ext(ta_name, log_file, NULL);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_get_log_ext(const char *ta_name, char *log_file, bool *more)
 {
     rcf_msg     msg;
     size_t      anslen = sizeof(msg);
@@ -1465,6 +1937,9 @@ rcf_ta_get_log(const char *ta_name, char *log_file)
 
     RCF_API_INIT;
 
+    if (more != NULL)
+        *more = false;
+
     if (log_file == NULL || strlen(log_file) >= RCF_MAX_PATH || BAD_TA)
         return TE_RC(TE_RCF_API, TE_EINVAL);
 
@@ -1478,7 +1953,11 @@ rcf_ta_get_log(const char *ta_name, char *log_file)
                                    &msg, &anslen, NULL);
 
     if (rc == 0 && (rc = msg.error) == 0)
+    {
         te_strlcpy(log_file, msg.file, RCF_MAX_PATH);
+        if (more != NULL)
+            *more = (msg.intparm != 0);
+    }
 
     return rc;
 }
@@ -1652,12 +2131,16 @@ rcf_ta_set_var(const char *ta_name, int session, const char *var_name,
  * @param rfile         full name of the file in the TA/NUT file system
  * @param lfile         full name of the file in the TN file system
  * @param opcode        RCFOP_FPUT, RCFOP_FGET or RCFOP_DEL
+ * @param offset        offset of the part of the file
+ * @param length        maximum length of the part of the file
+ *                      (@c UINT64_MAX for the whole file)
  *
  * @return error code
  */
 static te_errno
 handle_file(const char *ta_name, int session,
-            const char *rfile, const char *lfile, int opcode)
+            const char *rfile, const char *lfile, int opcode,
+            uint64_t offset, uint64_t length)
 {
     rcf_msg    *msg;
     size_t      anslen = sizeof(*msg);
@@ -1711,6 +2194,11 @@ handle_file(const char *ta_name, int session,
     msg->sid = session;
     if (opcode == RCFOP_FPUT)
         msg->flags |= BINARY_ATTACHMENT;
+    if (length != UINT64_MAX)
+    {
+        TE_SPRINTF(msg->value, "%" TE_PRINTF_64 "u %" TE_PRINTF_64 "u",
+                   offset, length);
+    }
 
     rc = send_recv_rcf_ipc_message(ctx_handle,
                                    msg, sizeof(*msg) + msg->data_len,
@@ -1732,7 +2220,8 @@ te_errno
 rcf_ta_get_file(const char *ta_name, int session,
                 const char *rfile, const char *lfile)
 {
-    return handle_file(ta_name, session, rfile, lfile, RCFOP_FGET);
+    return handle_file(ta_name, session, rfile, lfile, RCFOP_FGET,
+                       0, UINT64_MAX);
 }
 
 /* See description in rcf_api.h */
@@ -1740,14 +2229,82 @@ te_errno
 rcf_ta_put_file(const char *ta_name, int session,
                 const char *lfile, const char *rfile)
 {
-    return handle_file(ta_name, session, rfile, lfile, RCFOP_FPUT);
+    return handle_file(ta_name, session, rfile, lfile, RCFOP_FPUT,
+                       0, UINT64_MAX);
 }
 
 /* See description in rcf_api.h */
 te_errno
 rcf_ta_del_file(const char *ta_name, int session, const char *rfile)
 {
-    return handle_file(ta_name, session, rfile, "", RCFOP_FDEL);
+    return handle_file(ta_name, session, rfile, "", RCFOP_FDEL,
+                       0, UINT64_MAX);
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_get_file_stream(const char *ta_name, int session,
+                       const char *rfile, const char *lfile,
+                       uint64_t offset)
+{
+    struct stat st;
+    uint64_t    received;
+    te_errno    rc;
+
+    do {
+        rc = handle_file(ta_name, session, rfile, lfile, RCFOP_FGET,
+                         offset, RCF_FILE_CHUNK_LEN);
+        if (rc != 0)
+            return rc;
+
+        if (stat(lfile, &st) != 0 || (uint64_t)st.st_size < offset)
+        {
+            ERROR("%s: file %s is not received", __FUNCTION__, lfile);
+            return TE_RC(TE_RCF_API, TE_EIO);
+        }
+
+        received = st.st_size - offset;
+        offset += received;
+    } while (received == RCF_FILE_CHUNK_LEN);
+
+    return 0;
+}
+
+/* See description in rcf_api.h */
+te_errno
+rcf_ta_put_file_stream(const char *ta_name, int session,
+                       const char *lfile, const char *rfile,
+                       uint64_t offset)
+{
+    struct stat st;
+    uint64_t    length;
+    te_errno    rc;
+
+    if (lfile == NULL || stat(lfile, &st) != 0)
+    {
+        ERROR("%s: cannot get size of file %s", __FUNCTION__,
+              lfile == NULL ? "(null)" : lfile);
+        return TE_RC(TE_RCF_API, TE_ENOENT);
+    }
+
+    if (offset > (uint64_t)st.st_size)
+    {
+        ERROR("%s: offset %" TE_PRINTF_64 "u is beyond the end of file %s",
+              __FUNCTION__, offset, lfile);
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+    }
+
+    do {
+        length = MIN((uint64_t)st.st_size - offset, RCF_FILE_CHUNK_LEN);
+        rc = handle_file(ta_name, session, rfile, lfile, RCFOP_FPUT,
+                         offset, length);
+        if (rc != 0)
+            return rc;
+
+        offset += length;
+    } while (offset < (uint64_t)st.st_size);
+
+    return 0;
 }
 
 
@@ -2935,6 +3492,47 @@ rcf_check_agents(void)
     return rc == 0 ? msg.error : rc;
 }
 
+/* See description in rcf_api.h */
+te_errno
+rcf_get_stats(const char *ta_name, char **report)
+{
+    rcf_msg     msg;
+    rcf_msg    *ans = NULL;
+    size_t      anslen = sizeof(msg);
+    te_errno    rc;
+
+    RCF_API_INIT;
+
+    if (report == NULL ||
+        (ta_name != NULL && strlen(ta_name) >= RCF_MAX_NAME))
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.opcode = RCFOP_GET_STATS;
+    if (ta_name != NULL)
+        te_strlcpy(msg.ta, ta_name, sizeof(msg.ta));
+
+    rc = send_recv_rcf_ipc_message(ctx_handle, &msg, sizeof(msg),
+                                   &msg, &anslen, &ans);
+    if (rc != 0)
+        return rc;
+
+    if (ans == NULL)
+    {
+        /* Answer without report fits into the message */
+        if (msg.error != 0)
+            return msg.error;
+        *report = TE_STRDUP("");
+        return 0;
+    }
+
+    if ((rc = ans->error) == 0)
+        *report = TE_STRNDUP(ans->data, ans->data_len);
+
+    free(ans);
+    return rc;
+}
+
 /* See description in rcf_api.h */
 te_errno
 rcf_shutdown_call(void)
@@ -386,6 +386,146 @@ extern te_errno rcf_ta_cfg_add(const char *ta_name, int session,
 extern te_errno rcf_ta_cfg_del(const char *ta_name, int session,
                                const char *oid);
 
+/**
+ * Handle of the request sent to RCF without waiting for the answer.
+ *
+ * Answers are received by the thread which sent the request, so the
+ * handle may be waited for and freed in this thread only, before it
+ * exits. Answers are matched to requests by sequence number in constant
+ * time, so that requests to many Test Agents may be issued at once and
+ * then waited for.
+ */
+typedef struct rcf_async rcf_async;
+
+/**
+ * Send the request to get object instance value without waiting for
+ * the answer. The value is obtained by rcf_async_cfg_get_value().
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           object instance identifier
+ * @param req           location for the request handle to be freed
+ *                      by rcf_async_free()
+ *
+ * @return error code
+ *
+ * @retval 0            success
+ * @retval TE_EINVAL    invalid parameter
+ * @retval TE_EIPC      cannot interact with RCF
+ */
+extern te_errno rcf_ta_cfg_get_async(const char *ta_name, int session,
+                                     const char *oid, rcf_async **req);
+
+/**
+ * Send the request to change object instance value without waiting for
+ * the answer (see rcf_ta_cfg_set()).
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           object instance identifier
+ * @param val           object instance value
+ * @param req           location for the request handle to be freed
+ *                      by rcf_async_free()
+ *
+ * @return error code (see rcf_ta_cfg_get_async())
+ */
+extern te_errno rcf_ta_cfg_set_async(const char *ta_name, int session,
+                                     const char *oid, const char *val,
+                                     rcf_async **req);
+
+/**
+ * Send the request to create object instance without waiting for
+ * the answer (see rcf_ta_cfg_add()).
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           object instance identifier
+ * @param val           object instance value or @c NULL
+ * @param req           location for the request handle to be freed
+ *                      by rcf_async_free()
+ *
+ * @return error code (see rcf_ta_cfg_get_async())
+ */
+extern te_errno rcf_ta_cfg_add_async(const char *ta_name, int session,
+                                     const char *oid, const char *val,
+                                     rcf_async **req);
+
+/**
+ * Send the request to remove object instance without waiting for
+ * the answer (see rcf_ta_cfg_del()).
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param oid           object instance identifier
+ * @param req           location for the request handle to be freed
+ *                      by rcf_async_free()
+ *
+ * @return error code (see rcf_ta_cfg_get_async())
+ */
+extern te_errno rcf_ta_cfg_del_async(const char *ta_name, int session,
+                                     const char *oid, rcf_async **req);
+
+/**
+ * Wait for the answer to any of the requests. Requests which are
+ * already answered are reported immediately, so the caller should
+ * free reported requests and replace them with @c NULL in the array.
+ *
+ * @param reqs          requests (@c NULL entries are skipped)
+ * @param n             number of entries in @p reqs
+ * @param index         location for the index of the answered request
+ *
+ * @return Status of the answered request or error code
+ *
+ * @retval TE_ENOENT    there are no requests to wait for
+ * @retval TE_EIPC      cannot interact with RCF
+ */
+extern te_errno rcf_async_wait_any(rcf_async * const *reqs, unsigned int n,
+                                   unsigned int *index);
+
+/**
+ * Wait for the answer to the request.
+ *
+ * @param req           request handle
+ *
+ * @return Status of the request or @c TE_EIPC if RCF cannot be
+ *         interacted with.
+ */
+extern te_errno rcf_async_wait(rcf_async *req);
+
+/**
+ * Wait for the answers to all the requests.
+ *
+ * @param reqs          requests (@c NULL entries are skipped)
+ * @param n             number of entries in @p reqs
+ *
+ * @return @c 0 if all requests succeeded, status of the first failed
+ *         request or @c TE_EIPC.
+ */
+extern te_errno rcf_async_wait_all(rcf_async * const *reqs,
+                                   unsigned int n);
+
+/**
+ * Get object instance value requested by rcf_ta_cfg_get_async(),
+ * waiting for the answer if necessary. The value may be obtained
+ * only once.
+ *
+ * @param req           request handle
+ * @param val_buf       location for the object instance value
+ * @param len           location length
+ *
+ * @return error code (see rcf_ta_cfg_get())
+ */
+extern te_errno rcf_async_cfg_get_value(rcf_async *req, char *val_buf,
+                                        size_t len);
+
+/**
+ * Free the request handle. If the answer is not received yet, it is
+ * waited for, so that it is not left in the buffer of the thread.
+ *
+ * @param req           request handle or @c NULL
+ */
+extern void rcf_async_free(rcf_async *req);
+
 /**
  * This function is used to begin/finish group of configuration commands.
  * The function may be called by Configurator only.
@@ -478,6 +618,25 @@ extern te_errno rcf_ta_get_sniffers(const char *ta_name,
  */
 extern te_errno rcf_ta_get_log(const char *ta_name, char *log_file);
 
+/**
+ * Same as rcf_ta_get_log(), but also reports whether the Test Agent
+ * has more log messages which did not fit into the bulk.
+ * The function may be called by Logger only.
+ *
+ * @param ta_name       Test Agent name
+ * @param log_file      name of the local file where log should be put
+ *                      (the file is truncated to zero length before
+ *                      updating)
+ * @param more          location for the flag which is set to @c true
+ *                      if the next bulk should be requested right
+ *                      away (may be @c NULL); it is always @c false
+ *                      for Test Agents which do not report it
+ *
+ * @return error code (see rcf_ta_get_log())
+ */
+extern te_errno rcf_ta_get_log_ext(const char *ta_name, char *log_file,
+                                   bool *more);
+
 /**
  * This function is used to obtain value of the variable from the Test Agent
  * or NUT served by it.
@@ -580,6 +739,53 @@ extern te_errno rcf_ta_get_file(const char *ta_name, int session,
 extern te_errno rcf_ta_put_file(const char *ta_name, int session,
                                 const char *lfile, const char *rfile);
 
+/**
+ * Maximum length of the file part transferred by one command of
+ * rcf_ta_get_file_stream() and rcf_ta_put_file_stream().
+ */
+#define RCF_FILE_CHUNK_LEN  (16 * 1024 * 1024)
+
+/**
+ * This function loads file from Test Agent or NUT served by it to the
+ * testing node by parts of @ref RCF_FILE_CHUNK_LEN bytes, so that
+ * files of any size may be loaded and other commands of the session
+ * are not blocked for long time. The part of the local file before
+ * @p offset is kept and the rest of it is replaced, so that interrupted
+ * loading may be resumed from the current size of the local file.
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param rfile         full name of the file in the TA/NUT file system
+ * @param lfile         full name of the file in the TN file system
+ * @param offset        offset in the file to start loading from
+ *
+ * @return error code (see rcf_ta_get_file())
+ *
+ * @retval TE_EIO           the file is not saved in the TN file system
+ */
+extern te_errno rcf_ta_get_file_stream(const char *ta_name, int session,
+                                       const char *rfile,
+                                       const char *lfile,
+                                       uint64_t offset);
+
+/**
+ * This function loads file from the testing node to Test Agent or NUT
+ * served by it by parts of @ref RCF_FILE_CHUNK_LEN bytes, see
+ * rcf_ta_get_file_stream().
+ *
+ * @param ta_name       Test Agent name
+ * @param session       TA session or 0
+ * @param lfile         full name of the file in the TN file system
+ * @param rfile         full name of the file in the TA/NUT file system
+ * @param offset        offset in the file to start loading from
+ *
+ * @return error code (see rcf_ta_put_file())
+ */
+extern te_errno rcf_ta_put_file_stream(const char *ta_name, int session,
+                                       const char *lfile,
+                                       const char *rfile,
+                                       uint64_t offset);
+
 /**
  * This function deletes file from the Test Agent or NUT served by it.
  *
@@ -1151,6 +1357,23 @@ extern te_errno rcf_check_agent(const char *ta_name);
  */
 extern te_errno rcf_check_agents(void);
 
+/**
+ * Get statistics of requests processed by RCF: per Test Agent and per
+ * operation numbers of requests and errors, latency percentiles of
+ * request stages and current numbers of queued requests.
+ *
+ * @param ta_name       Test Agent name or @c NULL for all Test Agents
+ * @param report        Location for the report in text form (should be
+ *                      freed by the caller)
+ *
+ * @return error code
+ *
+ * @retval 0            success
+ * @retval TE_ENOENT    Test Agent is not found
+ * @retval TE_EIPC      cannot interact with RCF
+ */
+extern te_errno rcf_get_stats(const char *ta_name, char **report);
+
 /**
  * This function is used to shutdown the RCF.
  *
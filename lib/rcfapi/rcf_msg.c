@@ -0,0 +1,364 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF API library
+ *
+ * Compact layout of RCF messages passed between RCF clients and RCF.
+ *
+ * Legacy layout is a complete @ref rcf_msg structure with all fixed-size
+ * arrays followed by data. Compact layout starts from
+ * @ref RCF_MSG_PACKED_MAGIC (which never matches an operation code
+ * in the legacy layout), has integer fields, used parts of string fields
+ * and payload. The payload is the data or, for @c RCFOP_RPC, encoded RPC
+ * starting from @a file field. Large payload may be passed in shared
+ * memory file descriptor sent along with the message over IPC.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#define TE_LGR_USER     "RCF API"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#include <stddef.h>
+#include <errno.h>
+
+#include "te_defs.h"
+#include "te_errno.h"
+#include "te_dbuf.h"
+#include "te_str.h"
+#include "rcf_common.h"
+#include "rcf_internal.h"
+#include "logger_api.h"
+
+/** Marker of the message in compact layout ("RCFP") */
+#define RCF_MSG_PACKED_MAGIC    0x52434650
+
+/** Header of the message in compact layout */
+typedef struct rcf_msg_packed {
+    uint32_t magic;         /**< @ref RCF_MSG_PACKED_MAGIC */
+    uint32_t opcode;        /**< Operation code */
+    uint32_t seqno;         /**< Sequence number */
+    int32_t  flags;         /**< Auxiliary flags */
+    int32_t  sid;           /**< Session identifier */
+    uint32_t error;         /**< Error code */
+    int32_t  handle;        /**< CSAP handle or PID */
+    int32_t  num;           /**< Number of packets or priority */
+    uint32_t timeout;       /**< Timeout value */
+    int32_t  intparm;       /**< Integer parameter */
+    uint64_t data_len;      /**< @a data_len field of the message */
+    uint16_t ta_len;        /**< Length of @a ta field */
+    uint16_t id_len;        /**< Length of @a id field */
+    uint16_t file_len;      /**< Length of @a file field */
+    uint16_t value_len;     /**< Length of @a value field */
+    uint64_t payload_len;   /**< Length of the payload */
+    uint32_t shm;           /**< Non-zero if the payload is in shared
+                                 memory passed with the message rather
+                                 than follows string fields */
+    uint32_t reserved;      /**< Padding, always zero */
+} rcf_msg_packed;
+
+/** Length of encoded RPC placed inside rcf_msg before @a data */
+#define RCF_MSG_RPC_INSIDE_LEN \
+    (sizeof(((rcf_msg *)0)->file) + sizeof(((rcf_msg *)0)->value))
+
+/**
+ * Get payload location and length of the message.
+ *
+ * @param msg           Message
+ * @param len           Location for payload length
+ *
+ * @return Payload pointer.
+ */
+static const uint8_t *
+rcf_msg_payload(const rcf_msg *msg, size_t *len)
+{
+    if (msg->opcode == RCFOP_RPC)
+    {
+        /*
+         * Data length of RPC message is computed modulo size_t and may
+         * be "negative" if the encoded RPC fits into file and value.
+         */
+        size_t room = RCF_MSG_RPC_INSIDE_LEN + msg->data_len;
+
+        *len = msg->intparm <= 0 ? 0 : MIN((size_t)msg->intparm, room);
+        return (const uint8_t *)msg->file;
+    }
+
+    *len = msg->data_len;
+    return (const uint8_t *)msg->data;
+}
+
+/**
+ * Put payload to shared memory.
+ *
+ * @param payload       Payload
+ * @param len           Payload length
+ *
+ * @return Shared memory file descriptor or @c -1.
+ */
+static int
+rcf_msg_shm_create(const uint8_t *payload, size_t len)
+{
+#ifdef HAVE_MEMFD_CREATE
+    int     fd;
+    ssize_t rc;
+
+    fd = memfd_create("rcf_msg", MFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    while (len > 0)
+    {
+        rc = write(fd, payload, len);
+        if (rc <= 0)
+        {
+            close(fd);
+            return -1;
+        }
+        payload += rc;
+        len -= rc;
+    }
+
+    return fd;
+#else
+    UNUSED(payload);
+    UNUSED(len);
+    return -1;
+#endif
+}
+
+/* See description in rcf_internal.h */
+te_errno
+rcf_msg_pack(const rcf_msg *msg, te_dbuf *buf, int *shm_fd)
+{
+    rcf_msg_packed  hdr;
+    const uint8_t  *payload;
+    size_t          payload_len;
+    bool            rpc = (msg->opcode == RCFOP_RPC);
+
+    payload = rcf_msg_payload(msg, &payload_len);
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = RCF_MSG_PACKED_MAGIC;
+    hdr.opcode = msg->opcode;
+    hdr.seqno = msg->seqno;
+    hdr.flags = msg->flags;
+    hdr.sid = msg->sid;
+    hdr.error = msg->error;
+    hdr.handle = msg->handle;
+    hdr.num = msg->num;
+    hdr.timeout = msg->timeout;
+    hdr.intparm = msg->intparm;
+    hdr.data_len = msg->data_len;
+    hdr.ta_len = strnlen(msg->ta, sizeof(msg->ta));
+    hdr.id_len = strnlen(msg->id, sizeof(msg->id));
+    /* Encoded RPC overlaps file and value fields */
+    hdr.file_len = rpc ? 0 : strnlen(msg->file, sizeof(msg->file));
+    hdr.value_len = rpc ? 0 : strnlen(msg->value, sizeof(msg->value));
+    hdr.payload_len = payload_len;
+
+    if (shm_fd != NULL)
+    {
+        *shm_fd = -1;
+        if (payload_len >= RCF_MSG_SHM_MIN_LEN)
+        {
+            *shm_fd = rcf_msg_shm_create(payload, payload_len);
+            hdr.shm = (*shm_fd >= 0);
+        }
+    }
+
+    te_dbuf_reset(buf);
+    te_dbuf_append(buf, &hdr, sizeof(hdr));
+    te_dbuf_append(buf, msg->ta, hdr.ta_len);
+    te_dbuf_append(buf, msg->id, hdr.id_len);
+    te_dbuf_append(buf, msg->file, hdr.file_len);
+    te_dbuf_append(buf, msg->value, hdr.value_len);
+    if (!hdr.shm)
+        te_dbuf_append(buf, payload, payload_len);
+
+    return 0;
+}
+
+/* See description in rcf_internal.h */
+bool
+rcf_msg_is_packed(const void *buf, size_t len)
+{
+    uint32_t magic;
+
+    if (len < sizeof(rcf_msg_packed))
+        return false;
+
+    memcpy(&magic, buf, sizeof(magic));
+    return magic == RCF_MSG_PACKED_MAGIC;
+}
+
+/**
+ * Get header of the message in compact layout and check its
+ * consistency.
+ *
+ * @param buf           Serialised message
+ * @param len           Length of the serialised message
+ * @param hdr           Location for the header
+ * @param msg_len       Location for the length of deserialised message
+ *
+ * @return @c true if the message is consistent.
+ */
+static bool
+rcf_msg_packed_hdr(const void *buf, size_t len, rcf_msg_packed *hdr,
+                   size_t *msg_len)
+{
+    size_t strings_len;
+    size_t payload_off;
+
+    if (!rcf_msg_is_packed(buf, len))
+        return false;
+
+    memcpy(hdr, buf, sizeof(*hdr));
+
+    if (hdr->ta_len > RCF_MAX_NAME || hdr->id_len > RCF_MAX_ID ||
+        hdr->file_len > RCF_MAX_PATH || hdr->value_len > RCF_MAX_VAL)
+        return false;
+
+    strings_len = (size_t)hdr->ta_len + hdr->id_len + hdr->file_len +
+                  hdr->value_len;
+    if (len - sizeof(*hdr) < strings_len ||
+        len - sizeof(*hdr) - strings_len !=
+            (hdr->shm ? 0 : hdr->payload_len))
+        return false;
+
+    /* Data length of RPC message may be "negative", see above */
+    if ((ssize_t)hdr->data_len > 0)
+        *msg_len = sizeof(rcf_msg) + hdr->data_len;
+    else
+        *msg_len = sizeof(rcf_msg);
+
+    payload_off = (hdr->opcode == RCFOP_RPC) ? offsetof(rcf_msg, file) :
+                                               offsetof(rcf_msg, data);
+
+    return hdr->payload_len <= *msg_len - payload_off;
+}
+
+/* See description in rcf_internal.h */
+size_t
+rcf_msg_unpacked_len(const void *buf, size_t len)
+{
+    rcf_msg_packed  hdr;
+    size_t          msg_len;
+
+    if (!rcf_msg_packed_hdr(buf, len, &hdr, &msg_len))
+        return 0;
+
+    return msg_len;
+}
+
+/**
+ * Read payload from shared memory passed with the message.
+ *
+ * @param fd            Shared memory file descriptor
+ * @param len           Payload length
+ * @param payload       Location for the payload
+ *
+ * @return Status code.
+ */
+static te_errno
+rcf_msg_shm_read(int fd, size_t len, uint8_t *payload)
+{
+    size_t   off = 0;
+    ssize_t  rc;
+
+    if (fd < 0)
+    {
+        ERROR("Shared memory with message payload is not passed");
+        return TE_RC(TE_RCF_API, TE_EBADF);
+    }
+
+    while (off < len)
+    {
+        rc = pread(fd, payload + off, len - off, off);
+        if (rc <= 0)
+        {
+            te_errno err = rc < 0 ? TE_OS_RC(TE_RCF_API, errno) :
+                                    TE_RC(TE_RCF_API, TE_EIO);
+
+            ERROR("Cannot read message payload: %r", err);
+            return err;
+        }
+        off += rc;
+    }
+
+    return 0;
+}
+
+/* See description in rcf_internal.h */
+te_errno
+rcf_msg_unpack(const void *buf, size_t len, int shm_fd, rcf_msg *msg)
+{
+    rcf_msg_packed  hdr;
+    size_t          msg_len;
+    const uint8_t  *ptr = (const uint8_t *)buf + sizeof(hdr);
+    uint8_t        *payload;
+    bool            valid;
+
+    if (!rcf_msg_is_packed(buf, len))
+    {
+        ERROR("Malformed RCF message is received");
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+    }
+
+    valid = rcf_msg_packed_hdr(buf, len, &hdr, &msg_len);
+
+    memset(msg, 0, sizeof(*msg));
+    msg->opcode = hdr.opcode;
+    msg->seqno = hdr.seqno;
+    msg->flags = hdr.flags;
+    msg->sid = hdr.sid;
+    msg->error = hdr.error;
+    msg->handle = hdr.handle;
+    msg->num = hdr.num;
+    msg->timeout = hdr.timeout;
+    msg->intparm = hdr.intparm;
+
+    /* Identification is enough to answer a malformed message */
+    if (!valid)
+    {
+        ERROR("Malformed RCF message is received");
+        return TE_RC(TE_RCF_API, TE_EINVAL);
+    }
+    msg->data_len = hdr.data_len;
+
+#define GET_STRING(_field) \
+    do {                                                    \
+        size_t _len = MIN(hdr._field##_len,                 \
+                          sizeof(msg->_field) - 1);         \
+                                                            \
+        memcpy(msg->_field, ptr, _len);                     \
+        ptr += hdr._field##_len;                            \
+    } while (0)
+
+    GET_STRING(ta);
+    GET_STRING(id);
+    GET_STRING(file);
+    GET_STRING(value);
+#undef GET_STRING
+
+    payload = (hdr.opcode == RCFOP_RPC) ? (uint8_t *)msg->file :
+                                          (uint8_t *)msg->data;
+    if (hdr.shm)
+        return rcf_msg_shm_read(shm_fd, hdr.payload_len, payload);
+
+    memcpy(payload, ptr, hdr.payload_len);
+    return 0;
+}
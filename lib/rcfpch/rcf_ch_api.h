@@ -292,7 +292,9 @@ extern int rcf_ch_vwrite(struct rcf_comm_connection *handle,
 /**
  * Put/get file to/from the Test Agent or NUT served by it.  If the
  * function returns -1, default command processing (using stdio
- * library) is  performed by caller.
+ * library) is  performed by caller.  The function is called from
+ * the thread receiving commands only, while default processing may be
+ * passed to a worker thread.
  *
  * @param handle        connection handle
  * @param cbuf          command buffer
@@ -941,6 +943,21 @@ typedef struct rcf_pch_cfg_object {
     /** Pointer to a linear array of substitutions */
     const rcf_pch_cfg_substitution *subst;
 
+    /** @name Change tracking */
+    /**
+     * Generation of the subtree incremented on each change of the
+     * subtree requested by Configurator or reported by
+     * rcf_pch_cfg_changed()
+     */
+    uint64_t        generation;
+    /**
+     * All other changes of the subtree are reported by
+     * rcf_pch_cfg_changed(), so the generation may be used to skip
+     * synchronisation of the subtree
+     */
+    bool            changes_tracked;
+    /*@}*/
+
 } rcf_pch_cfg_object;
 
 /**
@@ -59,6 +59,7 @@
 #define RCF_NEED_TYPES
 #include "te_proto.h"
 #undef RCF_NEED_TYPES
+#include "rcf_proto_bin.h"
 
 
 extern te_errno rcf_ch_get_sniffers(struct rcf_comm_connection *handle,
@@ -400,10 +401,23 @@ transmit_log(struct rcf_comm_connection *conn, char *cbuf,
 
     len = ta_log_get(sizeof(log_data), log_data);
 
-    ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
-                   (len == 0) ? "%u" : "0 attach %u",
-                   (len == 0) ? (unsigned)TE_RC(TE_RCF_PCH, TE_ENOENT) :
-                                (unsigned)len);
+    if (len == 0)
+    {
+        ret = snprintf(cbuf + answer_plen, buflen - answer_plen, "%u",
+                       (unsigned)TE_RC(TE_RCF_PCH, TE_ENOENT));
+    }
+    else
+    {
+        /*
+         * If the bulk has not drained the local log buffer, ask
+         * the Logger to come back without waiting for the next
+         * polling period, otherwise the buffer may be overfilled.
+         */
+        ret = snprintf(cbuf + answer_plen, buflen - answer_plen,
+                       ta_log_pending() ? "0 " TE_PROTO_LOG_MORE " attach %u" :
+                                          "0 attach %u",
+                       (unsigned)len);
+    }
     if ((size_t)ret >= (buflen - answer_plen))
     {
         ERROR("Command buffer too small");
@@ -422,6 +436,91 @@ transmit_log(struct rcf_comm_connection *conn, char *cbuf,
     return rc;
 }
 
+/**
+ * Process configuration command using CH handler and falling back to
+ * the default one.
+ *
+ * @param opcode        operation code
+ * @param cbuf          command buffer
+ * @param buflen        length of the command buffer
+ * @param answer_plen   number of bytes to be copied from the command
+ *                      to answer
+ * @param ba            binary attachment pointer or @c NULL
+ * @param cmdlen        full length of the command
+ * @param oid           object identifier
+ * @param val           object value or @c NULL
+ *
+ * @return Status code returned by the handler
+ */
+static int
+process_configure(rcf_op_t opcode, char *cbuf, size_t buflen,
+                  size_t answer_plen, void *ba, size_t cmdlen,
+                  char *oid, char *val)
+{
+    int op = opcode == RCFOP_CONFGET ? RCF_CH_CFG_GET :
+             opcode == RCFOP_CONFSET ? RCF_CH_CFG_SET :
+             opcode == RCFOP_CONFADD ? RCF_CH_CFG_ADD :
+             RCF_CH_CFG_DEL;
+    int rc;
+
+    rc = rcf_ch_configure(conn, cbuf, buflen, answer_plen,
+                          ba, cmdlen, op, oid, val);
+    if (rc < 0)
+        rc = rcf_pch_configure(conn, cbuf, buflen, answer_plen,
+                               ba, cmdlen, op, oid, val);
+
+    return rc;
+}
+
+/**
+ * Process variable read or write command using CH handler and falling
+ * back to the default one.
+ *
+ * @param opcode        operation code
+ * @param cbuf          command buffer
+ * @param buflen        length of the command buffer
+ * @param answer_plen   number of bytes to be copied from the command
+ *                      to answer
+ * @param type          variable type
+ * @param var           variable name
+ * @param val_string    value of the string variable to be written
+ * @param val_int       value of the integer variable to be written
+ *
+ * @return Status code returned by the handler
+ */
+static int
+process_var(rcf_op_t opcode, char *cbuf, size_t buflen,
+            size_t answer_plen, rcf_var_type_t type, char *var,
+            char *val_string, uint64_t val_int)
+{
+    int rc;
+
+    if (opcode == RCFOP_VREAD)
+    {
+        rc = rcf_ch_vread(conn, cbuf, buflen, answer_plen, type, var);
+        if (rc < 0)
+            rc = rcf_pch_vread(conn, cbuf, buflen, answer_plen, type, var);
+    }
+    else if (type == RCF_STRING)
+    {
+        rc = rcf_ch_vwrite(conn, cbuf, buflen, answer_plen, type, var,
+                           val_string);
+        if (rc < 0)
+            rc = rcf_pch_vwrite(conn, cbuf, buflen, answer_plen, type, var,
+                                val_string);
+    }
+    else
+    {
+        rc = rcf_ch_vwrite(conn, cbuf, buflen, answer_plen, type, var,
+                           val_int);
+        if (rc < 0)
+            rc = rcf_pch_vwrite(conn, cbuf, buflen, answer_plen, type, var,
+                                val_int);
+    }
+
+    return rc;
+}
+
 /** Detach from the Test Engine after fork() */
 static void
 rcf_pch_detach(void)
@@ -520,6 +619,7 @@ rcf_pch_run(const char *confstr, const char *info)
         goto exit;
     }
     rcf_pch_cfg_init();
+    rcf_pch_workers_init();
 
     rc = rcf_ch_tad_init();
     if (TE_RC_GET_ERROR(rc) == TE_ENOSYS)
@@ -605,6 +705,70 @@ rcf_pch_run(const char *confstr, const char *info)
             answer_plen = ptr - cmd;
         }
 
+        if (strcmp_start(TE_PROTO_BINARY, ptr) == 0)
+        {
+            char         *fields[RCF_PROTO_BIN_MAX_FIELDS];
+            unsigned int  n_fields;
+            unsigned int  type;
+            rcf_op_t      bin_opcode;
+            uint64_t      val_int = 0;
+
+            ptr += strlen(TE_PROTO_BINARY);
+            SKIP_SPACES(ptr);
+            if (*ptr != 0 || ba == NULL ||
+                rcf_proto_bin_decode(ba, len - ((uint8_t *)ba -
+                                                (uint8_t *)cmd),
+                                     &bin_opcode, &type, &n_fields,
+                                     fields) != 0)
+                goto bad_protocol;
+
+            switch (bin_opcode)
+            {
+                case RCFOP_CONFGET:
+                case RCFOP_CONFDEL:
+                case RCFOP_CONFSET:
+                case RCFOP_CONFADD:
+                    if (n_fields != ((bin_opcode == RCFOP_CONFGET ||
+                                      bin_opcode == RCFOP_CONFDEL) ? 1 : 2))
+                        goto bad_protocol;
+
+                    opcode = bin_opcode;
+                    rc = process_configure(opcode, cmd, cmd_buf_len,
+                                           answer_plen, NULL, len,
+                                           fields[0], n_fields > 1 ?
+                                                      fields[1] : NULL);
+                    break;
+
+                case RCFOP_VREAD:
+                case RCFOP_VWRITE:
+                    if (n_fields != (bin_opcode == RCFOP_VREAD ? 1 : 2) ||
+                        type >= RCF_TYPE_TOTAL)
+                        goto bad_protocol;
+
+                    if (bin_opcode == RCFOP_VWRITE && type != RCF_STRING)
+                    {
+                        char *tmp;
+
+                        val_int = strtoll(fields[1], &tmp, 10);
+                        if (tmp == fields[1] || *tmp != 0)
+                            goto bad_protocol;
+                    }
+
+                    opcode = bin_opcode;
+                    rc = process_var(opcode, cmd, cmd_buf_len, answer_plen,
+                                     type, fields[0], n_fields > 1 ?
+                                                      fields[1] : NULL,
+                                     val_int);
+                    break;
+
+                default:
+                    goto bad_protocol;
+            }
+            if (rc != 0)
+                goto communication_problem;
+            continue;
+        }
+
         if (get_opcode(&ptr, &opcode) != 0)
             goto bad_protocol;
 
@@ -661,10 +825,6 @@ rcf_pch_run(const char *confstr, const char *info)
             case RCFOP_CONFADD:
             case RCFOP_CONFDEL:
             {
-                int op = opcode == RCFOP_CONFGET ? RCF_CH_CFG_GET :
-                         opcode == RCFOP_CONFSET ? RCF_CH_CFG_SET :
-                         opcode == RCFOP_CONFADD ? RCF_CH_CFG_ADD :
-                         RCF_CH_CFG_DEL;
                 char *oid,
                      *val = NULL;
 
@@ -690,14 +850,8 @@ rcf_pch_run(const char *confstr, const char *info)
                         goto bad_protocol;
                 }
 
-                rc = rcf_ch_configure(conn, cmd, cmd_buf_len, answer_plen,
-                                      ba, len, op, oid, val);
-
-                if (rc < 0)
-                    rc = rcf_pch_configure(conn, cmd, cmd_buf_len,
-                                           answer_plen, ba, len,
-                                           op, oid, val);
-
+                rc = process_configure(opcode, cmd, cmd_buf_len,
+                                       answer_plen, ba, len, oid, val);
                 if (rc != 0)
                     goto communication_problem;
                 break;
@@ -806,42 +960,19 @@ rcf_pch_run(const char *confstr, const char *info)
                     if (*ptr != 0)
                         goto bad_protocol;
 
-                    if (type == RCF_STRING)
-                    {
-                        rc = rcf_ch_vwrite(conn, cmd, cmd_buf_len,
-                                           answer_plen, type, var,
-                                           val_string);
-                        if (rc < 0)
-                            rc = rcf_pch_vwrite(conn, cmd, cmd_buf_len,
-                                                answer_plen, type, var,
-                                                val_string);
-                    }
-                    else
-                    {
-                        rc = rcf_ch_vwrite(conn, cmd, cmd_buf_len,
-                                           answer_plen, type, var,
-                                           val_int);
-                        if (rc < 0)
-                            rc = rcf_pch_vwrite(conn, cmd, cmd_buf_len,
-                                                answer_plen, type, var,
-                                                val_int);
-                    }
-                    if (rc != 0)
-                        goto communication_problem;
+                    rc = process_var(opcode, cmd, cmd_buf_len, answer_plen,
+                                     type, var, val_string, val_int);
                 }
                 else
                 {
                     if (*ptr != 0)
                         goto bad_protocol;
 
-                    rc = rcf_ch_vread(conn, cmd, cmd_buf_len,
-                                      answer_plen, type, var);
-                    if (rc < 0)
-                        rc = rcf_pch_vread(conn, cmd, cmd_buf_len,
-                                           answer_plen, type, var);
-                    if (rc != 0)
-                        goto communication_problem;
+                    rc = process_var(opcode, cmd, cmd_buf_len, answer_plen,
+                                     type, var, NULL, 0);
                 }
+                if (rc != 0)
+                    goto communication_problem;
                 break;
             }
 
@@ -849,20 +980,50 @@ rcf_pch_run(const char *confstr, const char *info)
             case RCFOP_FGET:
             case RCFOP_FDEL:
             {
-                char *filename;
-                int   put = opcode == RCFOP_FPUT;
+                char     *filename;
+                int       put = opcode == RCFOP_FPUT;
+                uint64_t  offset = 0;
+                uint64_t  length = UINT64_MAX;
 
                 if (*ptr == '\0' ||
-                    transform_str(&ptr, &filename) != 0 ||
-                    *ptr != '\0' ||
-                    (put != (ba != NULL)))
+                    transform_str(&ptr, &filename) != 0)
+                    goto bad_protocol;
+
+                /* Optional range of the file: <offset> <length> */
+                if (*ptr != '\0' && opcode != RCFOP_FDEL)
+                {
+                    READ_INT(offset);
+                    READ_INT(length);
+                }
+
+                if (*ptr != '\0' || (put != (ba != NULL)))
                     goto bad_protocol;
 
-                rc = rcf_ch_file(conn, cmd, cmd_buf_len, answer_plen,
-                                 ba, len, opcode, filename);
+                /*
+                 * The Test Agent specific handler is called from this
+                 * thread only, so it need not be thread-safe. Only the
+                 * default processing is passed to the worker pool.
+                 */
+                rc = -1;
+                if (offset == 0 && length == UINT64_MAX)
+                {
+                    rc = rcf_ch_file(conn, cmd, cmd_buf_len, answer_plen,
+                                     ba, len, opcode, filename);
+                }
                 if (rc < 0)
-                    rc = rcf_pch_file(conn, cmd, cmd_buf_len, answer_plen,
-                                      ba, len, opcode, filename);
+                {
+                    if (rcf_pch_workers_submit(conn, cmd, cmd_buf_len,
+                                               answer_plen, ba, len, opcode,
+                                               filename, offset, length))
+                    {
+                        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EACK));
+                        break;
+                    }
+
+                    rc = rcf_pch_file_range(conn, cmd, cmd_buf_len,
+                                            answer_plen, ba, len, opcode,
+                                            filename, offset, length);
+                }
 
                 if (rc != 0)
                     goto communication_problem;
@@ -1323,6 +1484,7 @@ communication_problem:
     LOG_PRINT("Fatal communication error %s", te_rc_err2str(rc));
 
 exit:
+    rcf_pch_workers_fini();
     rc2 = rcf_ch_tad_shutdown();
     if (rc2 != 0)
     {
@@ -176,6 +176,38 @@ extern int rcf_pch_file(struct rcf_comm_connection *conn,
                         const uint8_t *ba, size_t cmdlen,
                         rcf_op_t op, const char *filename);
 
+/**
+ * Default file processing handler for a part of the file.
+ *
+ * The part of the file before @p offset is kept by fput, the rest of
+ * the file is replaced with the attachment. fget replies with at most
+ * @p length bytes of the file starting from @p offset.
+ *
+ * @param conn          connection handle
+ * @param cbuf          command buffer
+ * @param buflen        length of the command buffer
+ * @param answer_plen   number of bytes in the command buffer to be
+ *                      copied to the answer
+ * @param ba            pointer to location of binary attachment
+ *                      in the command buffer or NULL if no binary
+ *                      attachment is provided
+ * @param cmdlen        full length of the command including binary
+ *                      attachment
+ * @param op            RCFOP_FGET, RCFOP_FPUT or RCFOP_FDEL
+ * @param filename      full name of the file in TA or NUT file system
+ * @param offset        offset of the part in the file
+ * @param length        maximum length of the part (@c UINT64_MAX for
+ *                      the rest of the file)
+ *
+ * @return 0 or error returned by communication library
+ */
+extern int rcf_pch_file_range(struct rcf_comm_connection *conn,
+                              char *cbuf, size_t buflen,
+                              size_t answer_plen, const uint8_t *ba,
+                              size_t cmdlen, rcf_op_t op,
+                              const char *filename, uint64_t offset,
+                              uint64_t length);
+
 /**
  * Default routine call handler.
  *
@@ -314,6 +346,27 @@ extern te_errno rcf_pch_add_node(const char *father,
  * @return Status code
  */
 extern te_errno rcf_pch_del_node(rcf_pch_cfg_object *node);
+
+/**
+ * Declare that changes of the subtree which are not requested by
+ * Configurator (e.g. made by RPC servers or by the system itself) are
+ * reported by rcf_pch_cfg_changed(). Configurator skips
+ * synchronisation of such subtree if it is not changed since the
+ * previous synchronisation.
+ *
+ * @param oid           OID of the subtree root object
+ *
+ * @return Status code
+ */
+extern te_errno rcf_pch_cfg_track_changes(const char *oid);
+
+/**
+ * Report a change of the configuration tree which is not requested by
+ * Configurator, e.g. from commit hooks or netlink listeners.
+ *
+ * @param oid           OID of the changed object or instance
+ */
+extern void rcf_pch_cfg_changed(const char *oid);
 /**@} */
 
 /*--------------- Dynamically grabbed TA resources -------------------*/
@@ -39,6 +39,12 @@
 #if HAVE_GLOB_H
 #include <glob.h>
 #endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if HAVE_TIME_H
+#include <time.h>
+#endif
 
 #include "rcf_pch_internal.h"
 
@@ -51,6 +57,7 @@
 #include "rcf_common.h"
 #include "rcf_pch.h"
 #include "rcf_ch_api.h"
+#include "rcf_proto_bin.h"
 #include "te_str.h"
 #include "te_vector.h"
 #include "te_alloc.h"
@@ -90,6 +97,7 @@ static TAILQ_HEAD(rcf_pch_commit_head_t, rcf_pch_commit_op_t)   commits;
 
 static bool is_group = false;       /**< Is group started? */
 static unsigned int gid;                    /**< Group identifier */
+static time_t start_time;           /**< Time of configuration init */
 
 
 /** Test Agent root node */
@@ -536,6 +544,47 @@ convert_to_answer(olist *list, char **answer)
     return 0;
 }
 
+/**
+ * Send successful answer with binary attachment.
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param data            attachment
+ * @param len             length of the attachment
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+send_attachment(struct rcf_comm_connection *conn, char *cbuf,
+                size_t buflen, size_t answer_plen, const char *data,
+                size_t len)
+{
+    int rc;
+
+    if ((size_t)snprintf(cbuf + answer_plen, buflen - answer_plen,
+                         "0 attach %u", (unsigned int)len) >=
+            (buflen - answer_plen))
+    {
+        ERROR("Command buffer too small for reply");
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_E2BIG));
+    }
+
+    RCF_CH_LOCK;
+    rc = rcf_comm_agent_reply(conn, cbuf, strlen(cbuf) + 1);
+    VERB("Sent answer '%s' len=%u rc=%d", cbuf,  strlen(cbuf) + 1, rc);
+    if (rc == 0)
+    {
+        rc = rcf_comm_agent_reply(conn, data, len);
+        VERB("Sent binary attachment len=%u rc=%d", len, rc);
+    }
+    RCF_CH_UNLOCK;
+
+    return rc;
+}
+
 /**
  * Process wildcard configure get request.
  *
@@ -582,27 +631,8 @@ process_wildcard(struct rcf_comm_connection *conn, char *cbuf,
     if ((rc != 0 )|| ((rc = convert_to_answer(list, &tmp)) != 0))
         SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
 
-    if ((size_t)snprintf(cbuf + answer_plen, buflen - answer_plen,
-                         "0 attach %u",
-                         (unsigned int)(strlen(tmp) + 1)) >=
-            (buflen - answer_plen))
-    {
-        free(tmp);
-        ERROR("Command buffer too small for reply");
-        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_E2BIG));
-    }
-
-    RCF_CH_LOCK;
-    rc = rcf_comm_agent_reply(conn, cbuf, strlen(cbuf) + 1);
-    VERB("Sent answer to wildcard request '%s' len=%u rc=%d",
-         cbuf,  strlen(cbuf) + 1, rc);
-    if (rc == 0)
-    {
-        rc = rcf_comm_agent_reply(conn, tmp, strlen(tmp) + 1);
-        VERB("Sent binary attachment len=%u rc=%d", strlen(tmp) + 1, rc);
-    }
-    RCF_CH_UNLOCK;
-
+    rc = send_attachment(conn, cbuf, buflen, answer_plen, tmp,
+                         strlen(tmp) + 1);
     free(tmp);
 
     return rc;
@@ -729,6 +759,7 @@ void
 rcf_pch_cfg_init(void)
 {
     TAILQ_INIT(&commits);
+    start_time = time(NULL);
 
     if (rcf_ch_conf_init() != 0)
     {
@@ -943,6 +974,324 @@ out:
     return rc;
 }
 
+/**
+ * Find the object of the instance.
+ *
+ * @param p_oid         instance identifier
+ * @param p_obj         location for the object
+ * @param inst_names    array of @c RCF_MAX_PARAMS instance names to be
+ *                      filled in (names point to @p p_oid)
+ *
+ * @return Status code
+ * @retval TE_ENOENT    the object is not found
+ */
+static te_errno
+find_object(const cfg_oid *p_oid, rcf_pch_cfg_object **p_obj,
+            char **inst_names)
+{
+    cfg_inst_subid     *p_ids = (cfg_inst_subid *)(p_oid->ids);
+    rcf_pch_cfg_object *obj = NULL;
+    rcf_pch_cfg_object *next;
+    unsigned int        i;
+
+    memset(inst_names, 0, RCF_MAX_PARAMS * sizeof(*inst_names));
+
+    for (i = 1, next = rcf_pch_conf_root();
+         (i < p_oid->len) && (next != NULL);
+        )
+    {
+        obj = next;
+        if (strcmp(obj->sub_id, p_ids[i].subid) == 0)
+        {
+            if (i == 1)
+            {
+                if (strcmp(p_ids[i].name, rcf_ch_conf_agent()) != 0)
+                {
+                    break;
+                }
+            }
+            else if ((i - 2) < RCF_MAX_PARAMS)
+            {
+                inst_names[i - 2] = p_ids[i].name;
+            }
+            /* Go to the next subid */
+            ++i;
+            next = obj->son;
+        }
+        else
+        {
+            next = obj->brother;
+        }
+    }
+    if (i < p_oid->len)
+        return TE_ENOENT;
+
+    *p_obj = obj;
+    return 0;
+}
+
+/**
+ * Get value of the instance.
+ *
+ * @param obj           object of the instance
+ * @param oid           instance identifier
+ * @param p_oid         parsed instance identifier
+ * @param inst_names    instance names
+ * @param value         location for the value (@c RCF_MAX_VAL bytes)
+ *
+ * @return Status code
+ */
+static te_errno
+get_value(rcf_pch_cfg_object *obj, const char *oid, const cfg_oid *p_oid,
+          char **inst_names, char *value)
+{
+    te_errno rc;
+
+    *value = '\0';
+    if (obj->get == NULL)
+        return 0;
+
+    rc = (obj->get)(gid, oid, value, inst_names[0], inst_names[1],
+                    inst_names[2], inst_names[3], inst_names[4],
+                    inst_names[5], inst_names[6], inst_names[7],
+                    inst_names[8], inst_names[9]);
+    if (rc != 0)
+        return rc;
+
+    if (obj->subst != NULL)
+    {
+        rc = do_substitutions(obj, value, inst_names[p_oid->len - 3],
+                              (cfg_inst_subid *)(p_oid->ids));
+        if (rc != 0)
+            ERROR("Failed to replace value in %s rc=%r", value, rc);
+    }
+
+    return rc;
+}
+
+/**
+ * Check whether the identifier of configure get request ends with
+ * the suffix of a protocol extension.
+ *
+ * @param oid           identifier
+ * @param suffix        suffix
+ *
+ * @return @c true if @p oid ends with @p suffix
+ */
+static bool
+oid_has_suffix(const char *oid, const char *suffix)
+{
+    size_t len = strlen(oid);
+    size_t suffix_len = strlen(suffix);
+
+    return len > suffix_len && strcmp(oid + len - suffix_len, suffix) == 0;
+}
+
+/**
+ * Process bulk configure get request: get identifiers and values of the
+ * instance and all its descendants.
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param oid             instance identifier followed by
+ *                        @ref RCF_PROTO_CFG_BULK_SUFFIX
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+process_bulk_get(struct rcf_comm_connection *conn, char *cbuf,
+                 size_t buflen, size_t answer_plen, const char *oid)
+{
+    char        wildcard[CFG_OID_MAX];
+    char        copy[CFG_OID_MAX];
+    char       *inst_names[RCF_MAX_PARAMS];
+    char        value[RCF_MAX_VAL];
+    te_string   answer = TE_STRING_INIT;
+    olist      *list = NULL;
+    olist      *entry;
+    te_errno    rc;
+
+    ENTRY("OID='%s'", oid);
+
+    /* Wildcard identifier is the request one without trailing '=' */
+    if (strlen(oid) >= sizeof(wildcard))
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
+    te_strlcpy(wildcard, oid, strlen(oid));
+    strcpy(copy, wildcard);
+
+    rc = create_wildcard_inst_list(rcf_pch_conf_root(), NULL, copy,
+                                   wildcard, &list);
+    if (rc != 0)
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+
+    if (!is_group)
+        ++gid;
+
+    for (entry = list; entry != NULL && rc == 0; entry = entry->next)
+    {
+        cfg_oid            *p_oid = cfg_convert_oid_str(entry->oid);
+        rcf_pch_cfg_object *obj;
+
+        if (p_oid == NULL)
+        {
+            rc = TE_EFMT;
+            break;
+        }
+
+        rc = find_object(p_oid, &obj, inst_names);
+        if (rc == 0)
+            rc = get_value(obj, entry->oid, p_oid, inst_names, value);
+        cfg_free_oid(p_oid);
+
+        /* The instance may disappear after it is listed */
+        if (TE_RC_GET_ERROR(rc) == TE_ENOENT)
+        {
+            rc = 0;
+            continue;
+        }
+        if (rc != 0)
+        {
+            ERROR("Failed to get '%s' in bulk: %r", entry->oid, rc);
+            break;
+        }
+
+        te_string_append_buf(&answer, entry->oid, strlen(entry->oid) + 1);
+        te_string_append_buf(&answer, value, strlen(value) + 1);
+    }
+    free_list(list);
+
+    if (rc != 0)
+    {
+        te_string_free(&answer);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
+    }
+
+    /* Terminating empty identifier */
+    te_string_append_buf(&answer, NULL, 1);
+    rc = send_attachment(conn, cbuf, buflen, answer_plen, answer.ptr,
+                         answer.len);
+    te_string_free(&answer);
+
+    EXIT("%r", rc);
+
+    return rc;
+}
+
+/**
+ * Get sub-identifier of object or instance identifier.
+ *
+ * @param p_oid         identifier
+ * @param i             index of the sub-identifier
+ *
+ * @return Sub-identifier.
+ */
+static const char *
+oid_subid(const cfg_oid *p_oid, unsigned int i)
+{
+    return p_oid->inst ? ((cfg_inst_subid *)(p_oid->ids))[i].subid :
+                         ((cfg_object_subid *)(p_oid->ids))[i].subid;
+}
+
+/**
+ * Increment generations of all objects on the path to the object of
+ * the identifier.
+ *
+ * @param p_oid         object or instance identifier
+ */
+static void
+bump_generation(const cfg_oid *p_oid)
+{
+    rcf_pch_cfg_object *obj = rcf_pch_conf_root();
+    unsigned int        i;
+
+    for (i = 1; i < p_oid->len && obj != NULL; i++)
+    {
+        while (obj != NULL && strcmp(obj->sub_id, oid_subid(p_oid, i)) != 0)
+            obj = obj->brother;
+        if (obj == NULL)
+            break;
+
+        /* Changes may be reported from threads of Test Agent */
+        __atomic_add_fetch(&obj->generation, 1, __ATOMIC_RELAXED);
+        obj = obj->son;
+    }
+}
+
+/**
+ * Process subtree generation get request.
+ *
+ * @param conn            connection handle
+ * @param cbuf            command buffer
+ * @param buflen          length of the command buffer
+ * @param answer_plen     number of bytes in the command buffer
+ *                        to be copied to the answer
+ * @param oid             instance identifier followed by
+ *                        @ref RCF_PROTO_CFG_GEN_SUFFIX
+ *
+ * @return 0 or error returned by communication library
+ */
+static te_errno
+process_gen_get(struct rcf_comm_connection *conn, char *cbuf,
+                size_t buflen, size_t answer_plen, const char *oid)
+{
+    char                copy[CFG_OID_MAX];
+    char               *inst_names[RCF_MAX_PARAMS];
+    char                value[RCF_MAX_VAL];
+    char                ret_val[RCF_MAX_VAL * 2 + 2];
+    cfg_oid            *p_oid;
+    rcf_pch_cfg_object *obj;
+    rcf_pch_cfg_object *node;
+    bool                tracked = false;
+    unsigned int        i;
+
+    ENTRY("OID='%s'", oid);
+
+    if (strlen(oid) >= sizeof(copy))
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
+    te_strlcpy(copy, oid,
+               strlen(oid) - strlen(RCF_PROTO_CFG_GEN_SUFFIX) + 1);
+
+    p_oid = cfg_convert_oid_str(copy);
+    if (p_oid == NULL || !p_oid->inst)
+    {
+        cfg_free_oid(p_oid);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
+    }
+    if (find_object(p_oid, &obj, inst_names) != 0)
+    {
+        cfg_free_oid(p_oid);
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_ENOENT));
+    }
+
+    /* Changes are tracked if they are tracked in any ancestor */
+    for (i = 1, node = rcf_pch_conf_root(); node != NULL; i++)
+    {
+        while (node != NULL && strcmp(node->sub_id, oid_subid(p_oid, i)) != 0)
+            node = node->brother;
+        if (node == NULL)
+            break;
+
+        tracked = tracked || node->changes_tracked;
+        if (node == obj)
+            break;
+        node = node->son;
+    }
+    cfg_free_oid(p_oid);
+
+    if (!tracked)
+        SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EOPNOTSUPP));
+
+    /* Distinguish generations of different runs of Test Agent */
+    snprintf(value, sizeof(value), "%lx.%lx:%" PRIu64,
+             (unsigned long)getpid(), (unsigned long)start_time,
+             __atomic_load_n(&obj->generation, __ATOMIC_RELAXED));
+    write_str_in_quotes(ret_val, value, RCF_MAX_VAL);
+    SEND_ANSWER("0 %s", ret_val);
+}
+
 /* See description in rcf_pch.h */
 int
 rcf_pch_configure(struct rcf_comm_connection *conn,
@@ -960,11 +1309,8 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
     char *inst_names[RCF_MAX_PARAMS]; /* 10 */
 
     cfg_oid            *p_oid = NULL;
-    cfg_inst_subid     *p_ids;
     rcf_pch_cfg_object *obj = NULL;
-    rcf_pch_cfg_object *next;
     rcf_pch_cfg_object *commit_obj = NULL;
-    unsigned int        i;
     int                 rc;
 
     UNUSED(ba);
@@ -976,6 +1322,25 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
 
     if (oid != 0)
     {
+        if (op == RCF_CH_CFG_GET &&
+            oid_has_suffix(oid, RCF_PROTO_CFG_BULK_SUFFIX))
+        {
+            rc = process_bulk_get(conn, cbuf, buflen, answer_plen, oid);
+
+            EXIT("%r", rc);
+
+            return rc;
+        }
+        if (op == RCF_CH_CFG_GET &&
+            oid_has_suffix(oid, RCF_PROTO_CFG_GEN_SUFFIX))
+        {
+            rc = process_gen_get(conn, cbuf, buflen, answer_plen, oid);
+
+            EXIT("%r", rc);
+
+            return rc;
+        }
+
         /* Now parse the oid and look for the object */
         if ((strchr(oid, '*') != NULL) || (strstr(oid, OID_ETC) != NULL))
         {
@@ -1016,38 +1381,7 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
             SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EINVAL));
         }
 
-        memset(inst_names, 0, sizeof(inst_names));
-        p_ids = (cfg_inst_subid *)(p_oid->ids);
-
-        for (i = 1, obj = 0, next = rcf_pch_conf_root();
-             (i < p_oid->len) && (next != NULL);
-            )
-        {
-            obj = next;
-            if (strcmp(obj->sub_id, p_ids[i].subid) == 0)
-            {
-                if (i == 1)
-                {
-                    if (strcmp(p_ids[i].name, rcf_ch_conf_agent()) != 0)
-                    {
-                        break;
-                    }
-                }
-                else if ((i - 2) < (sizeof(inst_names) /
-                                    sizeof(inst_names[0])))
-                {
-                    inst_names[i - 2] = p_ids[i].name;
-                }
-                /* Go to the next subid */
-                ++i;
-                next = obj->son;
-            }
-            else
-            {
-                next = obj->brother;
-            }
-        }
-        if (i < p_oid->len)
+        if (find_object(p_oid, &obj, inst_names) != 0)
         {
             cfg_free_oid(p_oid);
             VERB("Requested OID not found");
@@ -1061,6 +1395,13 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                          obj->commit_parent : obj;
     }
 
+    /* The subtree is considered changed even if the change fails */
+    if (p_oid != NULL && (op == RCF_CH_CFG_SET || op == RCF_CH_CFG_ADD ||
+                          op == RCF_CH_CFG_DEL))
+    {
+        bump_generation(p_oid);
+    }
+
     if (!is_group)
         ++gid;
 
@@ -1089,25 +1430,11 @@ rcf_pch_configure(struct rcf_comm_connection *conn,
                 SEND_ANSWER("0");
             }
 
-            rc = (obj->get)(gid, oid, value, ALL_INST_NAMES);
+            rc = get_value(obj, oid, p_oid, inst_names, value);
+            cfg_free_oid(p_oid);
             if (rc != 0)
-            {
-                cfg_free_oid(p_oid);
                 SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
-            }
 
-            if (obj->subst != NULL)
-            {
-                rc = do_substitutions(obj, value, inst_names[i - 3], p_ids);
-                if (rc != 0)
-                {
-                    ERROR("Failed to replace value in %s rc=%r", value, rc);
-                    cfg_free_oid(p_oid);
-                    SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, rc));
-                }
-            }
-
-            cfg_free_oid(p_oid);
             write_str_in_quotes(ret_val, value, RCF_MAX_VAL);
             SEND_ANSWER("0 %s", ret_val);
             break;
@@ -1226,6 +1553,42 @@ rcf_pch_add_node(const char *father, rcf_pch_cfg_object *node)
     return 0;
 }
 
+/* See description in rcf_pch.h */
+te_errno
+rcf_pch_cfg_track_changes(const char *oid)
+{
+    rcf_pch_cfg_object *node;
+    te_errno            rc;
+
+    rc = rcf_pch_find_node(oid, &node);
+    if (rc != 0)
+    {
+        ERROR("%s(): failed to find '%s' in configuration tree",
+              __FUNCTION__, oid);
+        return rc;
+    }
+
+    node->changes_tracked = true;
+
+    return 0;
+}
+
+/* See description in rcf_pch.h */
+void
+rcf_pch_cfg_changed(const char *oid)
+{
+    cfg_oid *p_oid = cfg_convert_oid_str(oid);
+
+    if (p_oid == NULL)
+    {
+        ERROR("%s(): OID '%s' cannot be resolved", __FUNCTION__, oid);
+        return;
+    }
+
+    bump_generation(p_oid);
+    cfg_free_oid(p_oid);
+}
+
 /** Find family of the node */
 static rcf_pch_cfg_object *
 find_father(rcf_pch_cfg_object *node, rcf_pch_cfg_object *ancestor,
@@ -4,6 +4,11 @@
  *
  * Default fget and fput commands handlers implementation.
  *
+ * Both commands may be limited to a part of the file, so that large
+ * files are transferred by a number of commands and interrupted
+ * transfer may be resumed. File contents are sent directly from
+ * the file to the connection if the system allows it.
+ *
  * Copyright (C) 2004-2022 OKTET Labs Ltd. All rights reserved.
  */
 
@@ -35,6 +40,9 @@
 #ifdef HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
+#ifdef HAVE_LIMITS_H
+#include <limits.h>
+#endif
 
 #include "rcf_pch_internal.h"
 
@@ -45,19 +53,31 @@
 #include "agentlib.h"
 #include "rcf_pch.h"
 
-/* See description in rcf_ch_api.h */
+/* See description in rcf_pch.h */
 int
 rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
              size_t answer_plen, const uint8_t *ba, size_t cmdlen,
              rcf_op_t op, const char *filename)
+{
+    return rcf_pch_file_range(conn, cbuf, buflen, answer_plen, ba, cmdlen,
+                              op, filename, 0, UINT64_MAX);
+}
+
+/* See description in rcf_pch.h */
+int
+rcf_pch_file_range(struct rcf_comm_connection *conn, char *cbuf,
+                   size_t buflen, size_t answer_plen, const uint8_t *ba,
+                   size_t cmdlen, rcf_op_t op, const char *filename,
+                   uint64_t offset, uint64_t length)
 {
     size_t  reply_buflen = buflen - answer_plen;
     int     rc;
     int     fd = -1;
 
     ENTRY("conn=0x%x cbuf='%s' buflen=%u answer_plen=%u ba=0x%x "
-          "cmdlen=%u op=%d filename=%s\n", conn, cbuf, buflen,
-          answer_plen, ba, cmdlen, op, filename);
+          "cmdlen=%u op=%d filename=%s offset=%llu length=%llu\n",
+          conn, cbuf, buflen, answer_plen, ba, cmdlen, op, filename,
+          (unsigned long long)offset, (unsigned long long)length);
     VERB("Default file processing handler is executed");
 
     if (op == RCFOP_FDEL)
@@ -70,8 +90,9 @@ rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
         SEND_ANSWER("0");
     }
 
-    fd = open(filename, op == RCFOP_FPUT ? (O_WRONLY | O_CREAT | O_TRUNC)
-                                      : O_RDONLY,
+    fd = open(filename, op != RCFOP_FPUT ? O_RDONLY :
+                        offset == 0 ? (O_WRONLY | O_CREAT | O_TRUNC) :
+                                      (O_WRONLY | O_CREAT),
               S_IRWXU | S_IRWXG | S_IRWXO);
     if (fd < 0)
     {
@@ -80,6 +101,17 @@ rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
         goto reject;
     }
 
+    /* The rest of the file is replaced when transfer is resumed */
+    if (op == RCFOP_FPUT && offset != 0 &&
+        (ftruncate(fd, offset) != 0 ||
+         lseek(fd, offset, SEEK_SET) == (off_t)-1))
+    {
+        rc = TE_OS_RC(TE_RCF_PCH, errno);
+        ERROR("Failed to resume writing to file '%s' at %llu: %r",
+              filename, (unsigned long long)offset, rc);
+        goto reject;
+    }
+
     if (op == RCFOP_FPUT)
     {
         size_t  rest = (cmdlen > buflen) ? (cmdlen - buflen) : 0;
@@ -139,7 +171,7 @@ rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
     else
     {
         struct stat stat_buf;
-        int         len;
+        uint64_t    size;
 
         if (fstat(fd, &stat_buf) != 0)
         {
@@ -148,8 +180,19 @@ rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
             goto reject;
         }
 
+        size = (uint64_t)stat_buf.st_size > offset ?
+               MIN(length, (uint64_t)stat_buf.st_size - offset) : 0;
+        /* Attachment length is limited on both sides of the connection */
+        if (size > INT_MAX)
+        {
+            ERROR("File '%s' is too large to be transferred by one "
+                  "command", filename);
+            rc = TE_RC(TE_RCF_PCH, TE_EFBIG);
+            goto reject;
+        }
+
         if ((size_t)snprintf(cbuf + answer_plen, reply_buflen,
-                             "0 attach %u", (unsigned int)stat_buf.st_size)
+                             "0 attach %u", (unsigned int)size)
                 >= reply_buflen)
         {
             ERROR("Command buffer too small for reply");
@@ -158,17 +201,12 @@ rcf_pch_file(struct rcf_comm_connection *conn, char *cbuf, size_t buflen,
         }
         RCF_CH_LOCK;
         rc = rcf_comm_agent_reply(conn, cbuf, strlen(cbuf) + 1);
-        while ((rc == 0) && ((len = read(fd, cbuf, buflen)) > 0))
-        {
-            stat_buf.st_size -= len;
-            rc = rcf_comm_agent_reply(conn, cbuf, len);
-        }
+        if (rc == 0)
+            rc = rcf_comm_agent_reply_file(conn, fd, offset, size);
         RCF_CH_UNLOCK;
         close(fd);
-        if ((rc == 0) && (stat_buf.st_size != 0))
-        {
-            ERROR("Failed to read file '%s'", filename);
-        }
+        if (rc != 0)
+            ERROR("Failed to send file '%s': %r", filename, rc);
         EXIT("%r", rc);
         return rc;
     }
@@ -106,6 +106,47 @@ extern char *strdup(const char *s);
 extern long long int strtoll(const char *nptr, char **endptr, int base);
 #endif
 
+/**
+ * Start threads executing commands which may be processed concurrently
+ * with other ones (see rcf_pch_workers_submit()).
+ */
+extern void rcf_pch_workers_init(void);
+
+/**
+ * Wait for queued commands to be processed and stop worker threads.
+ */
+extern void rcf_pch_workers_fini(void);
+
+/**
+ * Pass a command to the worker pool if it may be processed concurrently
+ * with other commands. The caller should acknowledge such a command with
+ * @c TE_EACK; a worker sends the final answer.
+ *
+ * @param conn          connection handle
+ * @param cbuf          command buffer
+ * @param buflen        length of the command buffer
+ * @param answer_plen   number of bytes in the command buffer to be
+ *                      copied to the answer
+ * @param ba            pointer to the first byte of binary attachment
+ *                      in the command buffer or @c NULL
+ * @param cmdlen        full length of the command including binary
+ *                      attachment
+ * @param op            operation code
+ * @param filename      command argument in the command buffer
+ *                      (file name for file operations)
+ * @param offset        offset of the part of the file
+ * @param length        maximum length of the part of the file
+ *
+ * @return @c true if the command is accepted by the pool, @c false if
+ *         it should be processed by the caller.
+ */
+extern bool rcf_pch_workers_submit(struct rcf_comm_connection *conn,
+                                   const char *cbuf, size_t buflen,
+                                   size_t answer_plen, const uint8_t *ba,
+                                   size_t cmdlen, rcf_op_t op,
+                                   const char *filename, uint64_t offset,
+                                   uint64_t length);
+
 /** Data corresponding to one RPC server */
 struct rpcserver;
 
@@ -41,6 +41,7 @@
 #include "rcf_common.h"
 #include "rcf_pch.h"
 #include "rcf_ch_api.h"
+#include "rcf_proto_bin.h"
 
 /* See description in rch_pch.h */
 int
@@ -70,6 +71,9 @@ rcf_pch_vread(struct rcf_comm_connection *conn,
     }
 #endif
 
+    if (type == RCF_STRING && strcmp(var, RCF_PROTO_VAR) == 0)
+        SEND_ANSWER("0 \"%s\"", RCF_PROTO_SUPPORTED);
+
     if ((addr = rcf_ch_symbol_addr(var, 0)) == NULL)
     {
 #ifdef HAVE_STDLIB_H
@@ -234,6 +238,19 @@ rcf_pch_vwrite(struct rcf_comm_connection *conn,
     }
 #endif
 
+    if (type == RCF_STRING && strcmp(var, RCF_PROTO_VAR) == 0)
+    {
+        /* Both encodings are always accepted, RCF chooses which to use */
+        const char *proto = va_arg(ap, const char *);
+
+        va_end(ap);
+        if (strcmp(proto, RCF_PROTO_TEXT) != 0 &&
+            strcmp(proto, TE_PROTO_BINARY) != 0)
+            SEND_ANSWER("%d", TE_RC(TE_RCF_PCH, TE_EPROTONOSUPPORT));
+
+        SEND_ANSWER("0");
+    }
+
     if ((addr = rcf_ch_symbol_addr(var, 0)) == NULL)
     {
 #ifdef HAVE_STDLIB_H
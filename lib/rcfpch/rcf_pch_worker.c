@@ -0,0 +1,251 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RCF Portable Command Handler
+ *
+ * Pool of threads executing commands which may be processed concurrently
+ * with other commands received from the Test Engine.
+ *
+ * Such a command is acknowledged with @c TE_EACK immediately, so that RCF
+ * unlocks the connection and sends further commands, and the final answer
+ * with the same SID is sent by a worker when the command is done (RCF
+ * matches answers to requests by SID, so they may come in any order).
+ * The pool may be disabled by setting @c TE_RCF_PCH_WORKERS environment
+ * variable to zero, then all commands are processed one by one.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <pthread.h>
+
+#include "rcf_pch_internal.h"
+
+#include "te_alloc.h"
+#include "te_errno.h"
+#include "te_defs.h"
+#include "te_queue.h"
+#include "te_str.h"
+#include "comm_agent.h"
+#include "rcf_pch.h"
+#include "rcf_ch_api.h"
+
+/** Default number of worker threads */
+#define RCF_PCH_WORKERS_DEFAULT     2
+
+/** Maximum number of worker threads */
+#define RCF_PCH_WORKERS_MAX         16
+
+/** Command passed to the worker pool */
+typedef struct rcf_pch_job {
+    TAILQ_ENTRY(rcf_pch_job) links;     /**< Queue links */
+
+    struct rcf_comm_connection *conn;   /**< Connection to the TEN */
+    rcf_op_t    op;                     /**< Operation code */
+    char       *cbuf;                   /**< Copy of the command buffer */
+    size_t      buflen;                 /**< Length of the buffer */
+    size_t      answer_plen;            /**< Length of the answer prefix */
+    size_t      cmdlen;                 /**< Length of the command with
+                                             attachment */
+    uint8_t    *ba;                     /**< Binary attachment in @a cbuf
+                                             or @c NULL */
+    char       *filename;               /**< File name in @a cbuf */
+    uint64_t    offset;                 /**< Offset of the file part */
+    uint64_t    length;                 /**< Length of the file part */
+} rcf_pch_job;
+
+/** Queue of commands waiting for a worker */
+static TAILQ_HEAD(, rcf_pch_job) jobs = TAILQ_HEAD_INITIALIZER(jobs);
+
+/** Lock protecting the queue */
+static pthread_mutex_t jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Condition signalled when a job is queued or the pool is stopped */
+static pthread_cond_t jobs_cond = PTHREAD_COND_INITIALIZER;
+
+/** Worker threads */
+static pthread_t workers[RCF_PCH_WORKERS_MAX];
+/** Number of started worker threads */
+static unsigned int workers_num = 0;
+/** Whether the pool is being stopped */
+static bool workers_stop = false;
+
+/**
+ * Execute a command from the worker pool.
+ *
+ * @param job       Command
+ */
+static void
+rcf_pch_job_exec(rcf_pch_job *job)
+{
+    int rc;
+
+    switch (job->op)
+    {
+        case RCFOP_FPUT:
+        case RCFOP_FGET:
+        case RCFOP_FDEL:
+            rc = rcf_pch_file_range(job->conn, job->cbuf, job->buflen,
+                                    job->answer_plen, job->ba, job->cmdlen,
+                                    job->op, job->filename, job->offset,
+                                    job->length);
+            break;
+
+        default:
+            ERROR("Unexpected command %d in the worker pool", job->op);
+            rc = TE_RC(TE_RCF_PCH, TE_EINVAL);
+            break;
+    }
+
+    if (rc != 0)
+        ERROR("Failed to process command in the worker pool: %r", rc);
+}
+
+/**
+ * Worker thread routine.
+ *
+ * @param arg       Unused
+ *
+ * @return @c NULL
+ */
+static void *
+rcf_pch_worker(void *arg)
+{
+    rcf_pch_job *job;
+
+    UNUSED(arg);
+
+    pthread_mutex_lock(&jobs_lock);
+    while (true)
+    {
+        job = TAILQ_FIRST(&jobs);
+        if (job == NULL)
+        {
+            if (workers_stop)
+                break;
+            pthread_cond_wait(&jobs_cond, &jobs_lock);
+            continue;
+        }
+        TAILQ_REMOVE(&jobs, job, links);
+        pthread_mutex_unlock(&jobs_lock);
+
+        rcf_pch_job_exec(job);
+        free(job->cbuf);
+        free(job);
+
+        pthread_mutex_lock(&jobs_lock);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+
+    return NULL;
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_workers_init(void)
+{
+    const char   *env = getenv("TE_RCF_PCH_WORKERS");
+    unsigned int  num = RCF_PCH_WORKERS_DEFAULT;
+    te_errno      rc;
+
+    if (env != NULL &&
+        (te_strtoui(env, 0, &num) != 0 || num > RCF_PCH_WORKERS_MAX))
+    {
+        WARN("Invalid TE_RCF_PCH_WORKERS value '%s', %u workers are used",
+             env, RCF_PCH_WORKERS_DEFAULT);
+        num = RCF_PCH_WORKERS_DEFAULT;
+    }
+
+    workers_stop = false;
+    for (workers_num = 0; workers_num < num; workers_num++)
+    {
+        rc = pthread_create(&workers[workers_num], NULL, rcf_pch_worker,
+                            NULL);
+        if (rc != 0)
+        {
+            WARN("Failed to start command worker thread: %r",
+                 TE_OS_RC(TE_RCF_PCH, rc));
+            break;
+        }
+    }
+
+    if (workers_num == 0)
+        RING("Commands are processed sequentially");
+    else
+        VERB("%u command worker threads are started", workers_num);
+}
+
+/* See description in rcf_pch_internal.h */
+void
+rcf_pch_workers_fini(void)
+{
+    unsigned int i;
+
+    if (workers_num == 0)
+        return;
+
+    pthread_mutex_lock(&jobs_lock);
+    workers_stop = true;
+    pthread_cond_broadcast(&jobs_cond);
+    pthread_mutex_unlock(&jobs_lock);
+
+    for (i = 0; i < workers_num; i++)
+        pthread_join(workers[i], NULL);
+
+    workers_num = 0;
+}
+
+/* See description in rcf_pch_internal.h */
+bool
+rcf_pch_workers_submit(struct rcf_comm_connection *conn, const char *cbuf,
+                       size_t buflen, size_t answer_plen,
+                       const uint8_t *ba, size_t cmdlen, rcf_op_t op,
+                       const char *filename, uint64_t offset,
+                       uint64_t length)
+{
+    rcf_pch_job *job;
+
+    if (workers_num == 0)
+        return false;
+
+    switch (op)
+    {
+        case RCFOP_FPUT:
+        case RCFOP_FGET:
+        case RCFOP_FDEL:
+            /* The whole attachment must be received already */
+            if (cmdlen > buflen)
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    job = TE_ALLOC(sizeof(*job));
+    job->cbuf = TE_ALLOC(buflen);
+    memcpy(job->cbuf, cbuf, buflen);
+    job->conn = conn;
+    job->op = op;
+    job->buflen = buflen;
+    job->answer_plen = answer_plen;
+    job->cmdlen = cmdlen;
+    job->ba = (ba == NULL) ? NULL :
+              (uint8_t *)job->cbuf + (ba - (const uint8_t *)cbuf);
+    job->filename = job->cbuf + (filename - cbuf);
+    job->offset = offset;
+    job->length = length;
+
+    pthread_mutex_lock(&jobs_lock);
+    TAILQ_INSERT_TAIL(&jobs, job, links);
+    pthread_cond_signal(&jobs_cond);
+    pthread_mutex_unlock(&jobs_lock);
+
+    return true;
+}
@@ -29,6 +29,7 @@
  * [:@attr_name{copy_timeout}=@attr_val{<timeout>}]
  * [:@attr_name{copy_tries}=@attr_val{<number_of_tries>}]
  * [:@attr_name{kill_timeout}=@attr_val{<timeout>}]
+ * [:@attr_name{image_cache}[=@attr_val{<directory>}]]
  * [:@attr_val{sudo}][:@attr_val{<shell>}][:@attr_val{<parameters>}]
  * </pre>
  *
@@ -61,6 +62,13 @@
  *   start-up procedure fails;
  * - @attr_name{kill_timeout} - specifies the maximum time duration
  *   (in seconds) that is allowed for Test Agent termination procedure;
+ * - @attr_name{image_cache} - keep Test Agent image files in the cache
+ *   directory on the host (private @path{te_ta_image_cache} directory in
+ *   @path{$XDG_CACHE_HOME} or @path{~/.cache} of the user by default)
+ *   addressed by SHA-256 of their content and copy only files missing
+ *   in the cache. Uploaded files are checked with @prog{sha256sum} on
+ *   the host. Run directory is created from the cache on the host, if it
+ *   fails, the image is copied without the cache;
  * - @attr_val{sudo} - specify this option when we need to run agent under
  *   @prog{sudo} (with root privileges). This can be necessary if Test Agent
  *   access resources that require privileged permissions (for example
@@ -179,8 +187,19 @@
 #if HAVE_SYS_WAIT_H
 #include <sys/wait.h>
 #endif
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#if HAVE_POLL_H
+#include <poll.h>
+#endif
 
 #include <dirent.h>
+#include <fcntl.h>
+
+#if HAVE_LIBCRYPTO
+#include <openssl/evp.h>
+#endif
 
 #include "te_alloc.h"
 #include "te_defs.h"
@@ -190,6 +209,7 @@
 #include "te_sleep.h"
 #include "te_string.h"
 #include "te_str.h"
+#include "te_file.h"
 #include "te_kvpair.h"
 #include "te_proto.h"
 #include "rcf_api.h"
@@ -238,6 +258,16 @@
 
 #define RCFUNIX_DEF_CORE_PATTERN "/var/tmp/core.te.%h-%p-%t"
 
+/**
+ * Default directory of TA image cache on Test Agent hosts (expanded by
+ * shell on the host, so that each user has its own cache)
+ */
+#define RCFUNIX_IMAGE_CACHE_DEF \
+    "\"${XDG_CACHE_HOME:-$HOME/.cache}/te_ta_image_cache\""
+
+/** Length of hexadecimal SHA-256 digest */
+#define RCFUNIX_HASH_LEN        64
+
 /*
  * This library is appropriate for usual and proxy UNIX agents.
  * All agents which type has postfix "ctl" are assumed as proxy.
@@ -263,6 +293,10 @@ typedef struct unix_ta {
     char    key[RCF_MAX_PATH];      /**< Private ssh key file */
     char    user[RCF_MAX_PATH];     /**< User to be used (with @) */
     char    ssh_proxy[RCF_MAX_NAME];/**< SSH proxy host */
+    char    image_cache[RCF_MAX_PATH]; /**< TA image cache directory on
+                                            the host or empty string for
+                                            the default one */
+    bool    use_image_cache;        /**< Copy TA image via the cache */
 
     unsigned int    ssh_port;       /**< 0 or special SSH port to use */
     unsigned int    copy_timeout;   /**< TA image copy timeout */
@@ -307,6 +341,15 @@ typedef struct unix_ta {
     rcfunix_tce_state_t         tce_state;
 } unix_ta;
 
+/**
+ * Lock serialising creation of shell command processes and updates of
+ * the TA list file since RCF may start or finish several Test Agents
+ * concurrently. While a process is being created, the child end of its
+ * pipe is not close-on-exec and must not be inherited by processes
+ * created by other threads (otherwise the parent never gets EOF).
+ */
+static pthread_mutex_t rcfunix_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /** Free resources allocated for TA control structure */
 static void
 rcfunix_ta_free(unix_ta *ta)
@@ -317,6 +360,27 @@ rcfunix_ta_free(unix_ta *ta)
     free(ta);
 }
 
+/**
+ * Thread-safe wrapper of te_shell_cmd().
+ *
+ * @param cmd           Command to execute
+ * @param in_fd         Location for stdin file descriptor or @c NULL
+ * @param out_fd        Location for stdout file descriptor or @c NULL
+ *
+ * @return PID of the process or @c -1.
+ */
+static pid_t
+rcfunix_shell_cmd(const char *cmd, int *in_fd, int *out_fd)
+{
+    pid_t pid;
+
+    pthread_mutex_lock(&rcfunix_lock);
+    pid = te_shell_cmd(cmd, -1, in_fd, out_fd, NULL);
+    pthread_mutex_unlock(&rcfunix_lock);
+
+    return pid;
+}
+
 /**
  * Execute the command without forever blocking.
  *
@@ -349,7 +413,7 @@ system_with_timeout(int timeout, te_string *out, const char *fmt, ...)
         return TE_RC(TE_RCF_UNIX, TE_ENOMEM);
     }
 
-    pid = te_shell_cmd(cmd, -1, TE_EXEC_CHILD_DEV_NULL_FD, &fd, NULL);
+    pid = rcfunix_shell_cmd(cmd, TE_EXEC_CHILD_DEV_NULL_FD, &fd);
     if (pid < 0 || fd < 0)
     {
         rc = TE_OS_RC(TE_RCF_UNIX, errno);
@@ -360,17 +424,10 @@ system_with_timeout(int timeout, te_string *out, const char *fmt, ...)
 
     while (1)
     {
-        struct timeval tv;
-        fd_set set;
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
         ssize_t read_rc;
 
-        tv.tv_sec = timeout;
-        tv.tv_usec = 0;
-
-        FD_ZERO(&set);
-        FD_SET(fd, &set);
-
-        if (select(fd + 1, &set, 0, 0, &tv) == 0)
+        if (poll(&pfd, 1, TE_SEC2MS(timeout)) == 0)
         {
             ERROR("Command <%s> timed out", cmd);
             if (close(fd) != 0)
@@ -792,9 +849,8 @@ start_core_watcher(unix_ta *ta, const char *core_pattern, bool all)
     RING("Command to start core_watcher: %s",
          te_string_value(&cmd));
 
-    ta->core_watcher_pid = te_shell_cmd(te_string_value(&cmd), -1,
-                                        &ta->core_watcher_in,
-                                        NULL, NULL);
+    ta->core_watcher_pid = rcfunix_shell_cmd(te_string_value(&cmd),
+                                             &ta->core_watcher_in, NULL);
     te_string_free(&cmd);
 
     if (ta->core_watcher_pid < 0)
@@ -875,6 +931,534 @@ stop_core_watcher(unix_ta *ta)
     ta->core_watcher_pid = -1;
 }
 
+#if HAVE_LIBCRYPTO
+/** Description of TA image for copying via the cache */
+typedef struct rcfunix_image {
+    te_string       script;     /**< Commands creating run directory
+                                     "$D" from cache "$C" */
+    te_string       objects;    /**< Lines "<hash> <local path>" */
+    te_string       hashes;     /**< Space-separated hashes */
+    unsigned int    n_files;    /**< Number of regular files */
+    uint64_t        size;       /**< Total size of regular files */
+} rcfunix_image;
+
+/**
+ * Convert digest to hexadecimal string.
+ *
+ * @param md            Digest
+ * @param md_len        Digest length
+ * @param hash          Buffer of @ref RCFUNIX_HASH_LEN + 1 bytes
+ */
+static void
+rcfunix_hash2str(const unsigned char *md, unsigned int md_len, char *hash)
+{
+    unsigned int i;
+
+    for (i = 0; i < md_len && 2 * i < RCFUNIX_HASH_LEN; i++)
+        sprintf(hash + 2 * i, "%02x", md[i]);
+}
+
+/**
+ * Calculate SHA-256 of the file content.
+ *
+ * @param path          File path
+ * @param hash          Buffer of @ref RCFUNIX_HASH_LEN + 1 bytes
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_hash_file(const char *path, char *hash)
+{
+    unsigned char   buf[64 * 1024];
+    unsigned char   md[EVP_MAX_MD_SIZE];
+    unsigned int    md_len;
+    EVP_MD_CTX     *ctx;
+    ssize_t         len;
+    te_errno        rc = 0;
+    int             fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_UNIX, errno);
+        ERROR("Cannot open '%s': %r", path, rc);
+        return rc;
+    }
+
+    ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+    while ((len = read(fd, buf, sizeof(buf))) > 0)
+        EVP_DigestUpdate(ctx, buf, len);
+    if (len < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_UNIX, errno);
+        ERROR("Cannot read '%s': %r", path, rc);
+    }
+    else
+    {
+        EVP_DigestFinal_ex(ctx, md, &md_len);
+        rcfunix_hash2str(md, md_len, hash);
+    }
+    EVP_MD_CTX_free(ctx);
+    close(fd);
+
+    return rc;
+}
+
+/**
+ * Append path in the run directory to the script.
+ *
+ * @param script        Script
+ * @param rel           Path relative to the run directory
+ */
+static void
+rcfunix_image_path(te_string *script, const char *rel)
+{
+    te_string_append(script, "\"$D\"/");
+    te_string_append_shell_arg_as_is(script, rel);
+}
+
+/**
+ * Scan the directory of TA image recursively. Entries are processed in
+ * alphabetical order, so that the script does not depend on order of
+ * entries in the directory.
+ *
+ * @param img           TA image description
+ * @param root          TA image directory
+ * @param rel           Directory relative to @p root (empty for @p root)
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_image_scan(rcfunix_image *img, const char *root, const char *rel)
+{
+    te_string       dir = TE_STRING_INIT;
+    te_string       path = TE_STRING_INIT;
+    te_string       full = TE_STRING_INIT;
+    struct dirent **names = NULL;
+    struct stat     st;
+    char            hash[RCFUNIX_HASH_LEN + 1];
+    char            target[RCF_MAX_PATH];
+    ssize_t         len;
+    te_errno        rc = 0;
+    int             n;
+    int             i;
+
+    te_string_append(&dir, "%s/%s", root, rel);
+    n = scandir(dir.ptr, &names, NULL, alphasort);
+    if (n < 0)
+    {
+        rc = TE_OS_RC(TE_RCF_UNIX, errno);
+        ERROR("Cannot scan TA image directory '%s': %r", dir.ptr, rc);
+        te_string_free(&dir);
+        return rc;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        const char *name = names[i]->d_name;
+
+        if (rc != 0 || strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+        te_string_reset(&path);
+        te_string_append(&path, "%s%s%s", rel, *rel == '\0' ? "" : "/",
+                         name);
+        te_string_reset(&full);
+        te_string_append(&full, "%s/%s", root, path.ptr);
+
+        if (lstat(full.ptr, &st) != 0)
+        {
+            rc = TE_OS_RC(TE_RCF_UNIX, errno);
+            ERROR("Cannot stat '%s': %r", full.ptr, rc);
+        }
+        else if (S_ISDIR(st.st_mode))
+        {
+            te_string_append(&img->script, "mkdir ");
+            rcfunix_image_path(&img->script, path.ptr);
+            te_string_append(&img->script, "\n");
+            rc = rcfunix_image_scan(img, root, path.ptr);
+        }
+        else if (S_ISLNK(st.st_mode))
+        {
+            len = readlink(full.ptr, target, sizeof(target) - 1);
+            if (len < 0)
+            {
+                rc = TE_OS_RC(TE_RCF_UNIX, errno);
+                ERROR("Cannot read link '%s': %r", full.ptr, rc);
+                continue;
+            }
+            target[len] = '\0';
+
+            te_string_append(&img->script, "ln -s ");
+            te_string_append_shell_arg_as_is(&img->script, target);
+            te_string_append(&img->script, " ");
+            rcfunix_image_path(&img->script, path.ptr);
+            te_string_append(&img->script, "\n");
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            if ((rc = rcfunix_hash_file(full.ptr, hash)) != 0)
+                continue;
+
+            te_string_append(&img->script, "cp \"$C/objects/%s\" ", hash);
+            rcfunix_image_path(&img->script, path.ptr);
+            te_string_append(&img->script, "\nchmod %o ",
+                             (unsigned int)(st.st_mode & 07777));
+            rcfunix_image_path(&img->script, path.ptr);
+            te_string_append(&img->script, "\n");
+
+            te_string_append(&img->objects, "%s %s\n", hash, full.ptr);
+            te_string_append(&img->hashes, " %s", hash);
+            img->n_files++;
+            img->size += st.st_size;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+        free(names[i]);
+    free(names);
+    te_string_free(&dir);
+    te_string_free(&path);
+    te_string_free(&full);
+
+    return rc;
+}
+
+/**
+ * Run the script on the Test Agent host or locally.
+ *
+ * @param ta            Test Agent
+ * @param remote        Run the script on the Test Agent host
+ * @param script        Script
+ * @param out           Location for the script output or @c NULL
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_run_script(unix_ta *ta, bool remote, const te_string *script,
+                   te_string *out)
+{
+    const char *tmp_dir = getenv("TE_TMP");
+    char       *path;
+    te_errno    rc;
+
+    path = te_file_create_unique("%s/rcfunix_%s_", NULL,
+                                 tmp_dir != NULL ? tmp_dir : "/tmp",
+                                 ta->ta_name);
+    if (path == NULL)
+        return TE_RC(TE_RCF_UNIX, TE_EFAIL);
+
+    rc = te_file_write_string(script, 0, O_TRUNC, 0, "%s", path);
+    if (rc == 0)
+    {
+        if (remote)
+        {
+            rc = system_with_timeout(ta->copy_timeout, out, "%ssh -s%s <%s",
+                                     ta->cmd_prefix.ptr, ta->cmd_suffix,
+                                     path);
+        }
+        else
+        {
+            rc = system_with_timeout(ta->copy_timeout, out, "sh %s", path);
+        }
+    }
+
+    unlink(path);
+    free(path);
+
+    return rc;
+}
+
+/**
+ * Append an argument of sftp batch command. Characters which have
+ * special meaning for sftp (including glob characters) are escaped.
+ *
+ * @param batch         Batch
+ * @param arg           Argument
+ */
+static void
+rcfunix_sftp_arg(te_string *batch, const char *arg)
+{
+    for (; *arg != '\0'; arg++)
+    {
+        if (strchr(" \t\\'\"*?[]#", *arg) != NULL)
+            te_string_append(batch, "\\");
+        te_string_append(batch, "%c", *arg);
+    }
+}
+
+/**
+ * Upload files missing in TA image cache on the host.
+ *
+ * @param ta            Test Agent
+ * @param img           TA image description
+ * @param cache         Cache directory on the host
+ * @param missing       Hashes of missing files (one per line)
+ * @param tag           Suffix of temporary names of uploaded files
+ * @param n_copied      Location for number of uploaded files
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_image_upload(unix_ta *ta, const rcfunix_image *img,
+                     const char *cache, const char *missing,
+                     const char *tag, unsigned int *n_copied)
+{
+    te_string   batch = TE_STRING_INIT;
+    te_string   done = TE_STRING_INIT;
+    te_string   local = TE_STRING_INIT;
+    te_string   remote = TE_STRING_INIT;
+    const char *line;
+    const char *end;
+    te_errno    rc;
+
+    *n_copied = 0;
+    for (line = img->objects.ptr; line != NULL && *line != '\0';
+         line = end + 1)
+    {
+        char hash[RCFUNIX_HASH_LEN + 1];
+
+        end = strchr(line, '\n');
+        te_strlcpy(hash, line, sizeof(hash));
+        /* Files with the same content are uploaded once */
+        if (strstr(missing, hash) == NULL ||
+            strstr(te_string_value(&done), hash) != NULL)
+            continue;
+
+        te_string_reset(&local);
+        te_string_append_buf(&local, line + RCFUNIX_HASH_LEN + 1,
+                             end - line - RCFUNIX_HASH_LEN - 1);
+        te_string_reset(&remote);
+        te_string_append(&remote, "%s/objects/%s.%s", cache, hash, tag);
+        if (ta->is_local)
+        {
+            te_string_append(&batch, "cp ");
+            te_string_append_shell_args_as_is(&batch, local.ptr,
+                                              remote.ptr, NULL);
+            te_string_append(&batch, " || exit 1\n");
+        }
+        else
+        {
+            te_string_append(&batch, "put ");
+            rcfunix_sftp_arg(&batch, local.ptr);
+            te_string_append(&batch, " ");
+            rcfunix_sftp_arg(&batch, remote.ptr);
+            te_string_append(&batch, "\n");
+        }
+        te_string_append(&done, "%s ", hash);
+        (*n_copied)++;
+    }
+
+    if (*n_copied == 0)
+    {
+        rc = 0;
+    }
+    else if (ta->is_local)
+    {
+        rc = rcfunix_run_script(ta, false, &batch, NULL);
+    }
+    else
+    {
+        const char *tmp_dir = getenv("TE_TMP");
+        char       *path;
+
+        path = te_file_create_unique("%s/rcfunix_%s_", NULL,
+                                     tmp_dir != NULL ? tmp_dir : "/tmp",
+                                     ta->ta_name);
+        if (path == NULL)
+        {
+            rc = TE_RC(TE_RCF_UNIX, TE_EFAIL);
+        }
+        else
+        {
+            rc = te_file_write_string(&batch, 0, O_TRUNC, 0, "%s", path);
+            if (rc == 0)
+            {
+                char ssh_port_str[16] = "";
+
+                if (ta->ssh_port != 0)
+                {
+                    TE_SPRINTF(ssh_port_str, "-P %u ", ta->ssh_port);
+                }
+                rc = system_with_timeout(ta->copy_timeout, NULL,
+                                         "sftp -q -b %s %s%s", path,
+                                         ssh_port_str, ta->ssh_opts.ptr);
+            }
+            unlink(path);
+            free(path);
+        }
+    }
+
+    te_string_free(&batch);
+    te_string_free(&done);
+    te_string_free(&local);
+    te_string_free(&remote);
+
+    return rc;
+}
+
+/**
+ * Copy TA image to the run directory via TA image cache on the host.
+ * Files are transferred only if they are missing in the cache.
+ *
+ * @param ta            Test Agent
+ * @param ta_type_dir   Directory of TA image
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_copy_image_cached(unix_ta *ta, const char *ta_type_dir)
+{
+    rcfunix_image   img = {
+        .script = TE_STRING_INIT,
+        .objects = TE_STRING_INIT,
+        .hashes = TE_STRING_INIT,
+    };
+    te_string       cmd = TE_STRING_INIT;
+    te_string       out = TE_STRING_INIT;
+    te_string       cache = TE_STRING_INIT;
+    unsigned char   md[EVP_MAX_MD_SIZE];
+    unsigned int    md_len;
+    char            bundle[RCFUNIX_HASH_LEN + 1];
+    const char     *missing;
+    const char     *tag;
+    unsigned int    n_copied = 0;
+    te_errno        rc;
+
+    if ((rc = rcfunix_image_scan(&img, ta_type_dir, "")) != 0)
+        goto out;
+
+    /* The bundle is identified by the script creating the run directory */
+    EVP_Digest(te_string_value(&img.script), img.script.len, md, &md_len,
+               EVP_sha256(), NULL);
+    rcfunix_hash2str(md, md_len, bundle);
+
+    /*
+     * Get the cache directory (the first line) and the list of files
+     * missing in the cache. The default cache directory is private.
+     */
+    te_string_append(&cmd, "command -v sha256sum >/dev/null || exit 1\n"
+                     "umask 077\nC=");
+    if (ta->image_cache[0] == '\0')
+    {
+        te_string_append(&cmd, "%s\n"
+                         "mkdir -p \"$C/objects\" && test -O \"$C\" && "
+                         "chmod 700 \"$C\" || exit 1\n",
+                         RCFUNIX_IMAGE_CACHE_DEF);
+    }
+    else
+    {
+        te_string_append_shell_arg_as_is(&cmd, ta->image_cache);
+        te_string_append(&cmd, "\nmkdir -p \"$C/objects\" || exit 1\n");
+    }
+    te_string_append(&cmd,
+                     "echo \"$C\"\n"
+                     "for h in%s; do\n"
+                     "    test -f \"$C/objects/$h\" || echo $h\n"
+                     "done\n", te_string_value(&img.hashes));
+    rc = rcfunix_run_script(ta, !ta->is_local, &cmd, &out);
+    if (rc != 0 || (missing = strchr(te_string_value(&out), '\n')) == NULL)
+    {
+        if (rc == 0)
+            rc = TE_RC(TE_RCF_UNIX, TE_EFAIL);
+        ERROR("Failed to check TA image cache on %s: %r", ta->host, rc);
+        goto out;
+    }
+    te_string_append_buf(&cache, out.ptr, missing - out.ptr);
+    missing++;
+
+    tag = strrchr(ta->run_dir, '/') + 1;
+    if (*missing != '\0')
+    {
+        rc = rcfunix_image_upload(ta, &img, cache.ptr, missing, tag,
+                                  &n_copied);
+        if (rc != 0)
+        {
+            ERROR("Failed to upload TA image files to the cache '%s' "
+                  "on %s: %r", cache.ptr, ta->host, rc);
+            goto out;
+        }
+    }
+
+    /*
+     * Check uploaded files and move them to the cache, then create
+     * the run directory from the cache. Files in the cache may be
+     * removed at any time, so the run directory is removed on failure.
+     */
+    te_string_reset(&cmd);
+    te_string_append(&cmd, "set -e\nC=");
+    te_string_append_shell_arg_as_is(&cmd, cache.ptr);
+    te_string_append(&cmd, "\nD=");
+    te_string_append_shell_arg_as_is(&cmd, ta->run_dir);
+    te_string_append(&cmd,
+                     "\nfor f in \"$C\"/objects/*.%s; do\n"
+                     "    test -f \"$f\" || continue\n"
+                     "    h=\"${f##*/}\"\n"
+                     "    h=\"${h%%.%s}\"\n"
+                     "    s=$(sha256sum <\"$f\")\n"
+                     "    if test \"${s%%%% *}\" != \"$h\"; then\n"
+                     "        rm -f \"$f\"\n"
+                     "        echo \"Corrupted TA image file $h\" >&2\n"
+                     "        exit 1\n"
+                     "    fi\n"
+                     "    mv -f \"$f\" \"$C/objects/$h\"\n"
+                     "done\n"
+                     "mkdir \"$D\"\n"
+                     "trap 'rm -rf \"$D\"' EXIT\n"
+                     "%s"
+                     "trap - EXIT\n", tag, tag,
+                     te_string_value(&img.script));
+    rc = rcfunix_run_script(ta, !ta->is_local, &cmd, NULL);
+    if (rc != 0)
+    {
+        ERROR("Failed to create TA run directory from the cache '%s' "
+              "on %s: %r", cache.ptr, ta->host, rc);
+        goto out;
+    }
+
+    RING("TA image %s (%u files, %llu bytes) is copied via the cache "
+         "'%s' on %s: %u files transferred", bundle, img.n_files,
+         (unsigned long long)img.size, cache.ptr, ta->host, n_copied);
+
+out:
+    te_string_free(&img.script);
+    te_string_free(&img.objects);
+    te_string_free(&img.hashes);
+    te_string_free(&cmd);
+    te_string_free(&out);
+    te_string_free(&cache);
+
+    return rc;
+}
+#endif /* HAVE_LIBCRYPTO */
+
+/**
+ * Copy TA image to the run directory.
+ *
+ * @param ta            Test Agent
+ * @param ta_type_dir   Directory of TA image
+ * @param cmd           Command to copy TA image without the cache
+ *
+ * @return Status code.
+ */
+static te_errno
+rcfunix_copy_image(unix_ta *ta, const char *ta_type_dir, const char *cmd)
+{
+#if HAVE_LIBCRYPTO
+    if (ta->use_image_cache &&
+        rcfunix_copy_image_cached(ta, ta_type_dir) == 0)
+        return 0;
+
+    if (ta->use_image_cache)
+        WARN("TA image is copied to %s without the cache", ta->host);
+#else
+    UNUSED(ta_type_dir);
+#endif
+
+    return system_with_timeout(ta->copy_timeout, NULL, "%s", cmd);
+}
+
 /**
  * Start the Test Agent. Note that it's not necessary
  * to restart the proxy Test Agents after rebooting of
@@ -908,11 +1492,11 @@ rcfunix_start(const char *ta_name, const char *ta_type,
     char       *tmp;
     const char *shell;
     const char *val;
-    char       *ta_list_file;
     const char *ld_preload = NULL;
     bool shell_is_bash = true;
 
     unsigned int timestamp;
+    unsigned int ta_seqno;
 
     if (ta_name == NULL || ta_type == NULL ||
         ta_name[0] == '\0' || strlen(ta_name) >= RCF_MAX_NAME ||
@@ -968,14 +1552,16 @@ rcfunix_start(const char *ta_name, const char *ta_type,
     if (logname == NULL)
         logname = "";
     timestamp = (unsigned int)time(NULL);
+    /* Test Agents may be started concurrently */
+    ta_seqno = __atomic_add_fetch(&seqno, 1, __ATOMIC_RELAXED);
     if (snprintf(ta->run_dir, sizeof(ta->run_dir), "/tmp/%.*s_%s_%u_%u_%u",
                  rcfunix_ta_type_prefix_len(ta_type), ta_type, logname,
-                 (unsigned int)getpid(), timestamp, ++seqno) >=
+                 (unsigned int)getpid(), timestamp, ta_seqno) >=
         (int)sizeof(ta->run_dir))
     {
         ERROR("Failed to compose TA run directory '/tmp/%s_%s_%u_%u_%u' - "
               "provided buffer too small",
-              ta_type, logname, (unsigned int)getpid(), timestamp, seqno);
+              ta_type, logname, (unsigned int)getpid(), timestamp, ta_seqno);
         te_string_free(&cfg_str);
         rcfunix_ta_free(ta);
         return TE_ESMALLBUF;
@@ -1072,6 +1658,16 @@ rcfunix_start(const char *ta_name, const char *ta_type,
         ta->ext_rcf_listener = true;
     }
 
+    if ((val = te_kvpairs_get(conf, "image_cache")) != NULL)
+    {
+#if HAVE_LIBCRYPTO
+        ta->use_image_cache = true;
+        te_strlcpy(ta->image_cache, val, sizeof(ta->image_cache));
+#else
+        WARN("TA image cache is not supported, the image is copied");
+#endif
+    }
+
     shell = te_kvpairs_get(conf, "shell");
 
     /*
@@ -1165,7 +1761,7 @@ rcfunix_start(const char *ta_name, const char *ta_type,
 
         for (rc = TE_RC(TE_RCF_UNIX, TE_EFAIL), i = 0; i < ta->copy_tries; i++)
         {
-            rc = system_with_timeout(ta->copy_timeout, NULL, "%s", cmd.ptr);
+            rc = rcfunix_copy_image(ta, ta_type_dir, cmd.ptr);
             if (rc == 0)
                 break;
             te_sleep(sleep_sec);
@@ -1321,8 +1917,8 @@ rcfunix_start(const char *ta_name, const char *ta_type,
     RING("Command to start TA: %s", cmd.ptr);
     if (!(*flags & TA_FAKE) &&
         ((ta->start_pid =
-          te_shell_cmd(cmd.ptr, -1, TE_EXEC_CHILD_DEV_NULL_FD,
-                       NULL, NULL)) <= 0))
+          rcfunix_shell_cmd(cmd.ptr, TE_EXEC_CHILD_DEV_NULL_FD,
+                            NULL)) <= 0))
     {
         rc = TE_OS_RC(TE_RCF_UNIX, errno);
         ERROR("Failed to start TA %s: %r", ta_name, rc);
@@ -1338,19 +1934,6 @@ rcfunix_start(const char *ta_name, const char *ta_type,
 
     *handle = (rcf_talib_handle)ta;
 
-    if ((ta_list_file = getenv("TE_TA_LIST_FILE")) != NULL)
-    {
-        FILE *f = fopen(ta_list_file, "a");
-        if (f != NULL)
-        {
-            fprintf(f, "%s\t\t%s\t\t%s\t\t%s",
-                    ta->ta_name, ta->host, ta->ta_type, ta->run_dir);
-            fclose(f);
-        }
-        else
-            ERROR("Failed to open '%s' for writing", ta_list_file);
-    }
-
     return 0;
 
 bad_conf:
@@ -1488,6 +2071,48 @@ rcfunix_close(rcf_talib_handle handle, fd_set *select_set)
     return rcf_net_engine_close(&(((unix_ta *)handle)->conn), select_set);
 }
 
+/**
+ * Add the Test Agent to the list of started Test Agents in the file
+ * specified by TE_TA_LIST_FILE environment variable (if any). The whole
+ * line is written at once since Test Agents may be connected
+ * concurrently.
+ *
+ * @param ta            Test Agent
+ * @param connected     Whether connection to the Test Agent is established
+ */
+static void
+rcfunix_ta_list_add(const unix_ta *ta, bool connected)
+{
+    const char *ta_list_fn = getenv("TE_TA_LIST_FILE");
+    FILE       *f;
+
+    if (ta_list_fn == NULL)
+        return;
+
+    pthread_mutex_lock(&rcfunix_lock);
+    f = fopen(ta_list_fn, "a");
+    if (f == NULL)
+    {
+        ERROR("Failed to open '%s' for writing", ta_list_fn);
+    }
+    else
+    {
+        if (connected)
+        {
+            fprintf(f, "%s\t\t%s\t\t%s\t\t%s\t\t%lu\n",
+                    ta->ta_name, ta->host, ta->ta_type, ta->run_dir,
+                    (long unsigned int)ta->pid);
+        }
+        else
+        {
+            fprintf(f, "%s\t\t%s\t\t%s\t\t%s\t\t<ERROR>\n",
+                    ta->ta_name, ta->host, ta->ta_type, ta->run_dir);
+        }
+        fclose(f);
+    }
+    pthread_mutex_unlock(&rcfunix_lock);
+}
+
 /**
  * Establish connection with the Test Agent. Note that it's not necessary
  * to perform real reconnect to proxy Test Agents after rebooting of
@@ -1521,28 +2146,8 @@ rcfunix_connect(rcf_talib_handle handle, fd_set *select_set,
     char                *env_retry_max;
     char                *endptr;
 
-    char                *ta_list_fn;
-    FILE                *ta_list_f = NULL;
-
     (void)select_tm;
 
-#define TA_LIST_F_ERROR \
-    do {                                          \
-        if (ta_list_f != NULL)                    \
-        {                                         \
-            fprintf(ta_list_f, "\t\t<ERROR>\n");  \
-            fclose(ta_list_f);                    \
-            ta_list_f = NULL;                     \
-        }                                         \
-    } while (0)
-
-    if ((ta_list_fn = getenv("TE_TA_LIST_FILE")) != NULL)
-    {
-        ta_list_f = fopen(ta_list_fn, "a");
-        if (ta_list_f == NULL)
-            ERROR("Failed to open '%s' for writing", ta_list_fn);
-    }
-
     env_retry_max = getenv("RCF_TA_MAX_CONN_ATTEMPTS");
     if (env_retry_max != NULL)
     {
@@ -1589,7 +2194,7 @@ rcfunix_connect(rcf_talib_handle handle, fd_set *select_set,
     } while (rc != 0 && --tries > 0);
     if (rc != 0)
     {
-        TA_LIST_F_ERROR;
+        rcfunix_ta_list_add(ta, false);
         return rc;
     }
 
@@ -1597,17 +2202,12 @@ rcfunix_connect(rcf_talib_handle handle, fd_set *select_set,
         (ta->pid = strtol(buf + 4, &tmp, 10), *tmp != 0))
     {
         ta->pid = 0;
-        TA_LIST_F_ERROR;
+        rcfunix_ta_list_add(ta, false);
         return TE_RC(TE_RCF, TE_EINVAL);
     }
 
     INFO("PID of TA %s is %d", ta->ta_name, ta->pid);
-    if (ta_list_f != NULL)
-    {
-        fprintf(ta_list_f, "\t\t%lu\n", (long unsigned int)ta->pid);
-        fclose(ta_list_f);
-        ta_list_f = NULL;
-    }
+    rcfunix_ta_list_add(ta, true);
 
     return 0;
 }
@@ -1671,6 +2271,20 @@ rcfunix_is_ready(rcf_talib_handle handle)
                rcf_net_engine_is_ready(((unix_ta *)handle)->conn);
 }
 
+/**
+ * Get file descriptor of the Test Agent connection.
+ *
+ * @param handle        TA handle
+ *
+ * @return File descriptor or @c -1 if there is no connection
+ */
+static int
+rcfunix_get_fd(rcf_talib_handle handle)
+{
+    return (handle == NULL) ? -1 :
+               rcf_net_engine_get_fd(((unix_ta *)handle)->conn);
+}
+
 /**
  * Receive one commend (possibly with attachment) from the Test Agent
  * or its part.
@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Configurator database scalability
+ *
+ * Measure rates of adding, finding and deleting instances in a large
+ * synthetic configuration tree.
+ */
+
+/** @page cs-db_scale Configurator database scalability
+ *
+ * @objective Check that instances of a large configuration tree are
+ *            added, found and deleted correctly and measure the rates.
+ *
+ * @param instances     Number of leaf instances in the tree
+ * @param fanout        Number of leaf instances per parent instance
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/db_scale"
+
+#include "te_config.h"
+
+#include <sys/time.h>
+
+#include "te_mi_log.h"
+#include "conf_api.h"
+#include "tapi_test.h"
+
+/** Root of the synthetic tree */
+#define DB_SCALE_ROOT   "/volatile:/cache:"
+
+/**
+ * Get time elapsed since the start.
+ *
+ * @param tv_start      Start time
+ *
+ * @return Elapsed time in seconds
+ */
+static double
+elapsed_since(const struct timeval *tv_start)
+{
+    struct timeval tv_end;
+    double         elapsed;
+
+    gettimeofday(&tv_end, NULL);
+    elapsed = (tv_end.tv_sec - tv_start->tv_sec) +
+              (tv_end.tv_usec - tv_start->tv_usec) / 1000000.0;
+
+    return elapsed > 0 ? elapsed : 1e-6;
+}
+
+/**
+ * Log rate of operations.
+ *
+ * @param logger        MI logger
+ * @param name          Name of operations
+ * @param count         Number of operations
+ * @param elapsed       Time spent in seconds
+ */
+static void
+log_rate(te_mi_logger *logger, const char *name, unsigned int count,
+         double elapsed)
+{
+    RING("%u %s operations took %.3f seconds (%.0f operations/sec)",
+         count, name, elapsed, count / elapsed);
+
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, name,
+                          TE_MI_MEAS_AGGR_SINGLE, count / elapsed,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int    instances;
+    unsigned int    fanout;
+    unsigned int    parents;
+    unsigned int    i;
+    cfg_handle      handle;
+    struct timeval  tv_start;
+    te_mi_logger   *logger = NULL;
+    bool            added = false;
+
+    TEST_START;
+
+    TEST_GET_UINT_PARAM(instances);
+    TEST_GET_UINT_PARAM(fanout);
+
+    if (fanout == 0)
+        TEST_FAIL("Fanout must be positive");
+    parents = (instances + fanout - 1) / fanout;
+
+    CHECK_RC(te_mi_logger_meas_create("configurator", &logger));
+
+    TEST_STEP("Add the tree of instances");
+    added = true;
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < instances; i++)
+    {
+        if (i % fanout == 0)
+        {
+            CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                                          DB_SCALE_ROOT "/foo:%u",
+                                          i / fanout));
+        }
+        CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                                      DB_SCALE_ROOT "/foo:%u/bar:%u",
+                                      i / fanout, i % fanout));
+    }
+    log_rate(logger, "add", instances + parents, elapsed_since(&tv_start));
+
+    TEST_STEP("Find all instances of the tree");
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < instances; i++)
+    {
+        CHECK_RC(cfg_find_fmt(&handle, DB_SCALE_ROOT "/foo:%u/bar:%u",
+                              i / fanout, i % fanout));
+    }
+    log_rate(logger, "find", instances, elapsed_since(&tv_start));
+
+    TEST_STEP("Check that missing instances are not found");
+    rc = cfg_find_fmt(&handle, DB_SCALE_ROOT "/foo:%u/bar:0", parents);
+    if (TE_RC_GET_ERROR(rc) != TE_ENOENT)
+        TEST_VERDICT("Missing instance is found or lookup failed: %r", rc);
+
+    TEST_STEP("Delete the tree of instances");
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < parents; i++)
+    {
+        CHECK_RC(cfg_del_instance_fmt(true, DB_SCALE_ROOT "/foo:%u", i));
+    }
+    log_rate(logger, "delete", parents, elapsed_since(&tv_start));
+    added = false;
+
+    TEST_STEP("Check that deleted instances are not found");
+    rc = cfg_find_fmt(&handle, DB_SCALE_ROOT "/foo:0/bar:0");
+    if (TE_RC_GET_ERROR(rc) != TE_ENOENT)
+        TEST_VERDICT("Deleted instance is found or lookup failed: %r", rc);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    if (added)
+    {
+        for (i = 0; i < parents; i++)
+            cfg_del_instance_fmt(true, DB_SCALE_ROOT "/foo:%u", i);
+    }
+
+    te_mi_logger_destroy(logger);
+
+    TEST_END;
+}
@@ -0,0 +1,361 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Configurator pattern matching
+ *
+ * Check objects and instances found by patterns with wildcards.
+ */
+
+/** @page cs-find_pattern Configurator pattern matching
+ *
+ * @objective Check that objects and instances found by patterns with
+ *            wildcards are the same and in the same order as the ones
+ *            found by matching each OID of the database.
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/find_pattern"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include "te_vector.h"
+#include "conf_api.h"
+#include "conf_oid.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/** Root of instances added by the test */
+#define FIND_PATTERN_ROOT   "/volatile:/cache:"
+
+/** Prefix of names of environment variables added by the test */
+#define FIND_PATTERN_ENV    "TE_FIND_PATTERN_"
+
+/** Names of @b foo instances in order of addition */
+static const char *foo_names[] = { "b1", "a1", "ab1", "a", "aa" };
+
+/** Names of @b bar instances added to @b foo instances ending with 1 */
+static const char *bar_names[] = { "x1y", "y", "xy" };
+
+/** Object patterns */
+static const char *obj_patterns[] = {
+    "/volatile/cache/*",
+    "/volatile/*/foo/*",
+    "/volatile/cache/foo/*u*",
+    "/volatile/cache/foo/*x",
+    "/*/cache/f*1",
+};
+
+/** Instance patterns */
+static const char *inst_patterns[] = {
+    FIND_PATTERN_ROOT "/foo:*",
+    FIND_PATTERN_ROOT "/foo:*1",
+    FIND_PATTERN_ROOT "/foo:*a",
+    FIND_PATTERN_ROOT "/foo:a*1",
+    FIND_PATTERN_ROOT "/foo:a*a",
+    FIND_PATTERN_ROOT "/foo:a*",
+    FIND_PATTERN_ROOT "/foo:*/bar:*",
+    FIND_PATTERN_ROOT "/foo:*1/bar:x*y",
+    FIND_PATTERN_ROOT "/foo:*/bar:*y",
+    FIND_PATTERN_ROOT "/foo:a*/bar:x*1*",
+    FIND_PATTERN_ROOT "/f*:*/*:*",
+    FIND_PATTERN_ROOT "/*o:a*/bar:y",
+    FIND_PATTERN_ROOT "/foo:b1/bar:y",
+};
+
+/**
+ * Patterns of environment variables, each is checked with the Test Agent
+ * name and with a wildcard instead of it.
+ */
+static const char *env_patterns[] = {
+    FIND_PATTERN_ENV "*",
+    "*" FIND_PATTERN_ENV "A",
+    FIND_PATTERN_ENV "A",
+    FIND_PATTERN_ENV "*B",
+};
+
+/** Object or instance of the database */
+typedef struct db_entry {
+    cfg_handle  handle; /**< Handle */
+    cfg_oid    *oid;    /**< Parsed OID */
+} db_entry;
+
+/**
+ * Decide if the string matches the pattern. A pattern starting with
+ * @c '*' matches any string. Otherwise only the first @c '*' of
+ * the pattern is a wildcard matching any sequence of characters.
+ *
+ * @param pattern       Pattern
+ * @param str           String
+ *
+ * @return @c true if the string matches.
+ */
+static bool
+str_match(const char *pattern, const char *str)
+{
+    const char *star = strchr(pattern, '*');
+    size_t      prefix_len;
+    size_t      suffix_len;
+
+    if (star == NULL)
+        return strcmp(pattern, str) == 0;
+    if (star == pattern)
+        return true;
+
+    prefix_len = star - pattern;
+    suffix_len = strlen(star + 1);
+
+    return strlen(str) >= prefix_len + suffix_len &&
+           strncmp(pattern, str, prefix_len) == 0 &&
+           strcmp(star + 1, str + strlen(str) - suffix_len) == 0;
+}
+
+/**
+ * Decide if OID matches the pattern component by component.
+ *
+ * @param pattern       Parsed pattern
+ * @param oid           Parsed OID
+ *
+ * @return @c true if the OID matches.
+ */
+static bool
+oid_match(const cfg_oid *pattern, const cfg_oid *oid)
+{
+    int i;
+
+    if (pattern->inst != oid->inst || pattern->len != oid->len)
+        return false;
+
+    for (i = 0; i < pattern->len; i++)
+    {
+        if (pattern->inst)
+        {
+            const cfg_inst_subid *p = (cfg_inst_subid *)pattern->ids + i;
+            const cfg_inst_subid *s = (cfg_inst_subid *)oid->ids + i;
+
+            if (!str_match(p->subid, s->subid) ||
+                !str_match(p->name, s->name))
+                return false;
+        }
+        else
+        {
+            const cfg_object_subid *p =
+                (cfg_object_subid *)pattern->ids + i;
+            const cfg_object_subid *s = (cfg_object_subid *)oid->ids + i;
+
+            if (!str_match(p->subid, s->subid))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get all objects or instances of the database in order of their
+ * handles.
+ *
+ * @param inst          Whether to get instances
+ * @param entries       Vector of db_entry to fill in
+ */
+static void
+get_db_entries(bool inst, te_vec *entries)
+{
+    cfg_handle     *handles = NULL;
+    unsigned int    num;
+    unsigned int    i;
+
+    CHECK_RC(cfg_find_pattern(inst ? "*:*" : "*", &num, &handles));
+    for (i = 0; i < num; i++)
+    {
+        db_entry  entry = { .handle = handles[i] };
+        char     *oid;
+
+        CHECK_RC(cfg_get_oid_str(handles[i], &oid));
+        entry.oid = cfg_convert_oid_str(oid);
+        if (entry.oid == NULL)
+            TEST_FAIL("Failed to parse OID '%s'", oid);
+        free(oid);
+        TE_VEC_APPEND(entries, entry);
+    }
+    free(handles);
+}
+
+/**
+ * Free objects or instances got by get_db_entries().
+ *
+ * @param entries       Vector of db_entry
+ */
+static void
+free_db_entries(te_vec *entries)
+{
+    db_entry *entry;
+
+    TE_VEC_FOREACH(entries, entry)
+        cfg_free_oid(entry->oid);
+    te_vec_free(entries);
+}
+
+/**
+ * Check that the pattern matches the same objects or instances as
+ * matching of each OID does and in the same order.
+ *
+ * @param pattern       Pattern
+ * @param entries       All objects or all instances of the database
+ */
+static void
+check_pattern(const char *pattern, const te_vec *entries)
+{
+    cfg_oid        *parsed;
+    cfg_handle     *handles = NULL;
+    unsigned int    num;
+    unsigned int    found = 0;
+    const db_entry *entry;
+
+    CHECK_RC(cfg_find_pattern(pattern, &num, &handles));
+    parsed = cfg_convert_oid_str(pattern);
+    if (parsed == NULL)
+        TEST_FAIL("Failed to parse pattern '%s'", pattern);
+
+    TE_VEC_FOREACH(entries, entry)
+    {
+        if (!oid_match(parsed, entry->oid))
+            continue;
+
+        if (found >= num || handles[found] != entry->handle)
+        {
+            TEST_VERDICT("Pattern '%s' gives unexpected %s of matches",
+                         pattern, found >= num ? "number" : "order");
+        }
+        found++;
+    }
+    if (found != num)
+    {
+        TEST_VERDICT("Pattern '%s' gives %u matches instead of %u",
+                     pattern, num, found);
+    }
+
+    RING("Pattern '%s' gives %u matches", pattern, num);
+    cfg_free_oid(parsed);
+    free(handles);
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    te_vec          objs = TE_VEC_INIT(db_entry);
+    te_vec          insts = TE_VEC_INIT(db_entry);
+    te_string       pattern = TE_STRING_INIT;
+    unsigned int    n_foo = 0;
+    bool            env_added = false;
+    bool            env_removed = false;
+    unsigned int    i;
+    unsigned int    j;
+
+    TEST_START;
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Add instances with names which are not sorted and share "
+              "prefixes and suffixes");
+    for (i = 0; i < TE_ARRAY_LEN(foo_names); i++)
+    {
+        CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                                      FIND_PATTERN_ROOT "/foo:%s",
+                                      foo_names[i]));
+        n_foo++;
+
+        if (foo_names[i][strlen(foo_names[i]) - 1] != '1')
+            continue;
+
+        for (j = 0; j < TE_ARRAY_LEN(bar_names); j++)
+        {
+            CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(NONE, NULL),
+                                          FIND_PATTERN_ROOT "/foo:%s/bar:%s",
+                                          foo_names[i], bar_names[j]));
+        }
+    }
+
+    TEST_STEP("Add environment variables on the Test Agent");
+    env_added = true;
+    CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(STRING, "1"),
+                                  "/agent:%s/env:" FIND_PATTERN_ENV "B",
+                                  pco_iut->ta));
+    CHECK_RC(cfg_add_instance_fmt(NULL, CFG_VAL(STRING, "1"),
+                                  "/agent:%s/env:" FIND_PATTERN_ENV "A",
+                                  pco_iut->ta));
+
+    TEST_STEP("Get OIDs of all objects and instances in order of "
+              "their handles");
+    get_db_entries(false, &objs);
+    get_db_entries(true, &insts);
+
+    TEST_STEP("Schedule removal of one of environment variables");
+    CHECK_RC(cfg_del_instance_local_fmt(false,
+                                        "/agent:%s/env:" FIND_PATTERN_ENV
+                                        "A", pco_iut->ta));
+    env_removed = true;
+
+    TEST_STEP("Check that object patterns give the objects with matching "
+              "OIDs in the same order");
+    for (i = 0; i < TE_ARRAY_LEN(obj_patterns); i++)
+        check_pattern(obj_patterns[i], &objs);
+
+    TEST_STEP("Check that instance patterns with leading, middle and "
+              "several wildcards give the instances with matching OIDs "
+              "in the same order including the instance scheduled for "
+              "removal");
+    for (i = 0; i < TE_ARRAY_LEN(inst_patterns); i++)
+        check_pattern(inst_patterns[i], &insts);
+    for (i = 0; i < TE_ARRAY_LEN(env_patterns); i++)
+    {
+        te_string_reset(&pattern);
+        te_string_append(&pattern, "/agent:%s/env:%s", pco_iut->ta,
+                         env_patterns[i]);
+        check_pattern(pattern.ptr, &insts);
+
+        te_string_reset(&pattern);
+        te_string_append(&pattern, "/agent:*/env:%s", env_patterns[i]);
+        check_pattern(pattern.ptr, &insts);
+    }
+
+    TEST_STEP("Commit removal of the environment variable");
+    env_removed = false;
+    CHECK_RC(cfg_commit_fmt("/agent:%s", pco_iut->ta));
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (env_removed)
+        CLEANUP_CHECK_RC(cfg_commit_fmt("/agent:%s", pco_iut->ta));
+    if (env_added)
+    {
+        cfg_del_instance_fmt(false, "/agent:%s/env:" FIND_PATTERN_ENV "A",
+                             pco_iut->ta);
+        cfg_del_instance_fmt(false, "/agent:%s/env:" FIND_PATTERN_ENV "B",
+                             pco_iut->ta);
+    }
+    for (i = 0; i < n_foo; i++)
+    {
+        CLEANUP_CHECK_RC(cfg_del_instance_fmt(true, FIND_PATTERN_ROOT
+                                              "/foo:%s", foo_names[i]));
+    }
+    free_db_entries(&objs);
+    free_db_entries(&insts);
+    te_string_free(&pattern);
+
+    TEST_END;
+}
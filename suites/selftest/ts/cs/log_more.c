@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Testing reports of pending log messages of a Test Agent
+ *
+ * Check that RCF passes the flag of pending log messages reported by
+ * a Test Agent to the Logger.
+ */
+
+/** @page cs-log_more Reports of pending log messages of a Test Agent
+ *
+ * @objective Check that bulks of log got from a Test Agent which has
+ *            more messages than fit into a bulk are reported to have
+ *            more messages to pass.
+ *
+ * @param messages      Number of messages logged by the Test Agent
+ *
+ * @note Bulks got by the test are not passed to the Logger.
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/log_more"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include <unistd.h>
+
+#include "rcf_api.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    unsigned int    messages;
+    char            oid[RCF_MAX_ID];
+    char            val[RCF_MAX_VAL];
+    char            log_file[RCF_MAX_PATH];
+    unsigned int    n_more = 0;
+    unsigned int    n_bulks = 0;
+    bool            more;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_UINT_PARAM(messages);
+
+    TEST_STEP("Make the Test Agent log @p messages at once.");
+    TE_SPRINTF(oid, "/agent:%s/selftest:/log_burst:", pco_iut->ta);
+    TE_SPRINTF(val, "%u", messages);
+    CHECK_RC(rcf_ta_cfg_set(pco_iut->ta, 0, oid, val));
+
+    TEST_STEP("Get bulks of log from the Test Agent until it reports "
+              "that there are no more messages to pass.");
+    do {
+        *log_file = '\0';
+        rc = rcf_ta_get_log_ext(pco_iut->ta, log_file, &more);
+        if (rc == TE_RC(TE_RCF_PCH, TE_ENOENT))
+            break;
+        CHECK_RC(rc);
+
+        if (unlink(log_file) != 0)
+            WARN("Failed to remove '%s': %r", log_file, TE_OS_RC(TE_TAPI,
+                                                                 errno));
+        n_bulks++;
+        if (more)
+            n_more++;
+    } while (more);
+
+    RING("%u bulks of log are got, %u of them report more messages",
+         n_bulks, n_more);
+
+    TEST_STEP("Check that at least one bulk reports more messages.");
+    if (n_more == 0)
+        TEST_VERDICT("Pending log messages are not reported");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    TEST_END;
+}
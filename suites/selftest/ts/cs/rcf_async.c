@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Query Test Agents with asynchronous RCF requests
+ *
+ * Compare rate of configuration commands sent to all Test Agents one
+ * by one and sent at once with asynchronous RCF API.
+ */
+
+/** @page cs-rcf_async Query Test Agents with asynchronous RCF requests
+ *
+ * @objective Check that asynchronous configuration requests to all Test
+ *            Agents get the same values as synchronous ones and compare
+ *            their rates.
+ *
+ * @param iterations    Number of rounds of commands to all Test Agents
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/rcf_async"
+
+#include "te_config.h"
+
+#include <sys/time.h>
+
+#include "te_mi_log.h"
+#include "rcf_api.h"
+#include "tapi_test.h"
+
+/** Maximum number of Test Agents queried by the test */
+#define MAX_AGENTS  32
+
+/** Test Agent queried by the test */
+typedef struct agent {
+    const char *name;                   /**< Test Agent name */
+    char        oid[RCF_MAX_ID];        /**< Object instance to get */
+    char        value[RCF_MAX_VAL];     /**< Value got synchronously */
+} agent;
+
+/**
+ * Get time elapsed since the start.
+ *
+ * @param tv_start      Start time
+ *
+ * @return Elapsed time in seconds
+ */
+static double
+elapsed_since(const struct timeval *tv_start)
+{
+    struct timeval tv_end;
+    double         elapsed;
+
+    gettimeofday(&tv_end, NULL);
+    elapsed = (tv_end.tv_sec - tv_start->tv_sec) +
+              (tv_end.tv_usec - tv_start->tv_usec) / 1000000.0;
+
+    return elapsed > 0 ? elapsed : 1e-6;
+}
+
+/**
+ * Query all Test Agents one by one.
+ *
+ * @param agents        Test Agents
+ * @param n_agents      Number of Test Agents
+ * @param iterations    Number of rounds
+ *
+ * @return Number of commands per second
+ */
+static double
+query_sync(agent *agents, unsigned int n_agents, unsigned int iterations)
+{
+    struct timeval tv_start;
+    double         elapsed;
+    unsigned int   i;
+    unsigned int   j;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < iterations; i++)
+    {
+        for (j = 0; j < n_agents; j++)
+        {
+            CHECK_RC(rcf_ta_cfg_get(agents[j].name, 0, agents[j].oid,
+                                    agents[j].value,
+                                    sizeof(agents[j].value)));
+        }
+    }
+    elapsed = elapsed_since(&tv_start);
+
+    RING("%u synchronous commands took %.3f seconds (%.0f commands/sec)",
+         iterations * n_agents, elapsed, iterations * n_agents / elapsed);
+
+    return iterations * n_agents / elapsed;
+}
+
+/**
+ * Query all Test Agents at once and check the values.
+ *
+ * @param agents        Test Agents
+ * @param n_agents      Number of Test Agents
+ * @param iterations    Number of rounds
+ *
+ * @return Number of commands per second
+ */
+static double
+query_async(agent *agents, unsigned int n_agents, unsigned int iterations)
+{
+    rcf_async      *reqs[MAX_AGENTS];
+    char            value[RCF_MAX_VAL];
+    struct timeval  tv_start;
+    double          elapsed;
+    unsigned int    i;
+    unsigned int    j;
+    te_errno        rc;
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < iterations; i++)
+    {
+        for (j = 0; j < n_agents; j++)
+        {
+            CHECK_RC(rcf_ta_cfg_get_async(agents[j].name, 0, agents[j].oid,
+                                          &reqs[j]));
+        }
+
+        while ((rc = rcf_async_wait_any(reqs, n_agents, &j)) !=
+               TE_RC(TE_RCF_API, TE_ENOENT))
+        {
+            CHECK_RC(rc);
+            CHECK_RC(rcf_async_cfg_get_value(reqs[j], value, sizeof(value)));
+            rcf_async_free(reqs[j]);
+            reqs[j] = NULL;
+
+            if (strcmp(value, agents[j].value) != 0)
+            {
+                ERROR("Agent %s: synchronous value '%s', asynchronous "
+                      "value '%s'", agents[j].name, agents[j].value, value);
+                TEST_VERDICT("Asynchronous request got wrong value");
+            }
+        }
+    }
+    elapsed = elapsed_since(&tv_start);
+
+    RING("%u asynchronous commands took %.3f seconds (%.0f commands/sec)",
+         iterations * n_agents, elapsed, iterations * n_agents / elapsed);
+
+    return iterations * n_agents / elapsed;
+}
+
+int
+main(int argc, char **argv)
+{
+    char            ta_list[RCF_MAX_VAL];
+    size_t          ta_list_len = sizeof(ta_list);
+    agent           agents[MAX_AGENTS];
+    unsigned int    n_agents = 0;
+    unsigned int    iterations;
+    const char     *ta;
+    double          rate_sync;
+    double          rate_async;
+    te_mi_logger   *logger = NULL;
+
+    TEST_START;
+
+    TEST_GET_UINT_PARAM(iterations);
+
+    TEST_STEP("Find Test Agents providing uname release");
+    CHECK_RC(rcf_get_ta_list(ta_list, &ta_list_len));
+    for (ta = ta_list; ta < ta_list + ta_list_len && *ta != '\0' &&
+                       n_agents < MAX_AGENTS; ta += strlen(ta) + 1)
+    {
+        agent *a = &agents[n_agents];
+
+        a->name = ta;
+        TE_SPRINTF(a->oid, "/agent:%s/uname:/release:", ta);
+        if (rcf_ta_cfg_get(ta, 0, a->oid, a->value, sizeof(a->value)) == 0)
+            n_agents++;
+    }
+    if (n_agents == 0)
+        TEST_SKIP("No Test Agents provide uname release");
+    RING("%u Test Agents are queried", n_agents);
+
+    TEST_STEP("Query Test Agents one by one");
+    rate_sync = query_sync(agents, n_agents, iterations);
+
+    TEST_STEP("Query Test Agents at once with asynchronous requests and "
+              "check that values are the same");
+    rate_async = query_async(agents, n_agents, iterations);
+
+    TEST_STEP("Log commands rates");
+    CHECK_RC(te_mi_logger_meas_create("rcf", &logger));
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, "sync",
+                          TE_MI_MEAS_AGGR_SINGLE, rate_sync,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, "async",
+                          TE_MI_MEAS_AGGR_SINGLE, rate_async,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    te_mi_logger_destroy(logger);
+
+    TEST_END;
+}
@@ -0,0 +1,159 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Compare text and binary encodings of RCF commands
+ *
+ * Measure rate of configuration commands processed by a Test Agent
+ * using text and binary encodings of Test Protocol commands.
+ */
+
+/** @page cs-rcf_proto Compare text and binary encodings of RCF commands
+ *
+ * @objective Check that configuration commands work with both encodings
+ *            of Test Protocol commands and compare their rates.
+ *
+ * @param iterations    Number of commands sent with each encoding
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/rcf_proto"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include <sys/time.h>
+
+#include "te_mi_log.h"
+#include "rcf_api.h"
+#include "rcf_proto_bin.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/**
+ * Send configuration get commands with the given encoding.
+ *
+ * @param ta            Test Agent name
+ * @param proto         Encoding name
+ * @param oid           Object instance to get
+ * @param iterations    Number of commands
+ * @param val           Buffer for the value
+ * @param len           Length of the buffer
+ *
+ * @return Number of commands per second
+ */
+static double
+measure_proto(const char *ta, const char *proto, const char *oid,
+              unsigned int iterations, char *val, size_t len)
+{
+    struct timeval tv_start;
+    struct timeval tv_end;
+    double         elapsed;
+    unsigned int   i;
+
+    CHECK_RC(rcf_ta_set_var(ta, 0, RCF_PROTO_VAR, RCF_STRING, proto));
+
+    gettimeofday(&tv_start, NULL);
+    for (i = 0; i < iterations; i++)
+        CHECK_RC(rcf_ta_cfg_get(ta, 0, oid, val, len));
+    gettimeofday(&tv_end, NULL);
+
+    elapsed = (tv_end.tv_sec - tv_start.tv_sec) +
+              (tv_end.tv_usec - tv_start.tv_usec) / 1000000.0;
+    if (elapsed <= 0)
+        elapsed = 1e-6;
+
+    RING("%u commands in %s encoding took %.3f seconds (%.0f commands/sec)",
+         iterations, proto, elapsed, iterations / elapsed);
+
+    return iterations / elapsed;
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    unsigned int    iterations;
+    char            protos[RCF_MAX_VAL];
+    char            oid[RCF_MAX_ID];
+    char            val_text[RCF_MAX_VAL];
+    char            val_bin[RCF_MAX_VAL];
+    double          rate_text;
+    double          rate_bin;
+    te_mi_logger   *logger = NULL;
+    const char     *orig_proto;
+    bool            proto_changed = false;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_UINT_PARAM(iterations);
+
+    TEST_STEP("Check that the Test Agent supports binary encoding");
+    CHECK_RC(rcf_ta_get_var(pco_iut->ta, 0, RCF_PROTO_VAR, RCF_STRING,
+                            sizeof(protos), protos));
+    RING("Encodings supported by %s: %s", pco_iut->ta, protos);
+    if (strstr(protos, TE_PROTO_BINARY) == NULL)
+        TEST_SKIP("Binary encoding is not supported by the Test Agent");
+
+    /*
+     * Reading the variable gives supported encodings, so the encoding
+     * in use is determined the same way as RCF chooses it.
+     */
+    orig_proto = getenv("TE_RCF_PROTOCOL");
+    if (orig_proto == NULL || strcmp(orig_proto, RCF_PROTO_TEXT) != 0)
+        orig_proto = TE_PROTO_BINARY;
+
+    TE_SPRINTF(oid, "/agent:%s/uname:/release:", pco_iut->ta);
+
+    TEST_STEP("Send configuration commands in text encoding");
+    proto_changed = true;
+    rate_text = measure_proto(pco_iut->ta, RCF_PROTO_TEXT, oid, iterations,
+                              val_text, sizeof(val_text));
+
+    TEST_STEP("Send configuration commands in binary encoding");
+    rate_bin = measure_proto(pco_iut->ta, TE_PROTO_BINARY, oid, iterations,
+                             val_bin, sizeof(val_bin));
+
+    TEST_STEP("Check that both encodings give the same value");
+    if (strcmp(val_text, val_bin) != 0)
+    {
+        ERROR("Text encoding value '%s', binary encoding value '%s'",
+              val_text, val_bin);
+        TEST_VERDICT("Values obtained with different encodings differ");
+    }
+
+    TEST_STEP("Log commands rates");
+    CHECK_RC(te_mi_logger_meas_create("rcf", &logger));
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, RCF_PROTO_TEXT,
+                          TE_MI_MEAS_AGGR_SINGLE, rate_text,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_RPS, TE_PROTO_BINARY,
+                          TE_MI_MEAS_AGGR_SINGLE, rate_bin,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    te_mi_logger_destroy(logger);
+    if (proto_changed)
+    {
+        CLEANUP_CHECK_RC(rcf_ta_set_var(pco_iut->ta, 0, RCF_PROTO_VAR,
+                                        RCF_STRING, orig_proto));
+    }
+
+    TEST_END;
+}
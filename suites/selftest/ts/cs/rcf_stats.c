@@ -0,0 +1,176 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Testing statistics of requests processed by RCF
+ *
+ * Check the report of RCF statistics got with rcf_get_stats().
+ */
+
+/** @page cs-rcf_stats Statistics of requests processed by RCF
+ *
+ * @objective Check that RCF counts configuration requests to a Test Agent
+ *            and reports consistent latency percentiles of them.
+ *
+ * @param iterations    Number of configuration requests
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME "cs/rcf_stats"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include <inttypes.h>
+
+#include "rcf_api.h"
+#include "rcf_internal.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+
+/**
+ * Get the number of configuration get requests to the Test Agent from
+ * the RCF statistics report and check latency percentiles of them.
+ *
+ * @param ta            Test Agent name
+ *
+ * @return Number of requests.
+ */
+static uint64_t
+check_stats(const char *ta)
+{
+    char           *report = NULL;
+    char           *line;
+    char           *saveptr = NULL;
+    te_string       prefix = TE_STRING_INIT;
+    bool            ta_found = false;
+    bool            op_found = false;
+    uint64_t        requests = 0;
+    uint64_t        errors;
+    unsigned int    stages = 0;
+
+    CHECK_RC(rcf_get_stats(ta, &report));
+    RING("RCF statistics of %s:\n%s", ta, report);
+
+    te_string_append(&prefix, "TA %s:", ta);
+    for (line = strtok_r(report, "\n", &saveptr); line != NULL;
+         line = strtok_r(NULL, "\n", &saveptr))
+    {
+        char     stage[16];
+        uint64_t mean;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t max;
+
+        if (strncmp(line, "TA ", strlen("TA ")) == 0)
+        {
+            ta_found = ta_found ||
+                       strncmp(line, prefix.ptr, prefix.len) == 0;
+            continue;
+        }
+
+        if (strncmp(line, "    ", strlen("    ")) != 0)
+        {
+            const char *op = rcf_op_to_string(RCFOP_CONFGET);
+
+            op_found = strncmp(line + strlen("  "), op, strlen(op)) == 0 &&
+                       line[strlen("  ") + strlen(op)] == ':';
+            if (op_found &&
+                sscanf(line + strlen("  ") + strlen(op) + 1,
+                       "%" SCNu64 " requests, %" SCNu64 " errors",
+                       &requests, &errors) != 2)
+            {
+                TEST_FAIL("Malformed line of statistics: '%s'", line);
+            }
+            continue;
+        }
+
+        if (!op_found)
+            continue;
+
+        if (sscanf(line, "%15s mean %" SCNu64 " p50 %" SCNu64
+                   " p90 %" SCNu64 " p99 %" SCNu64 " max %" SCNu64 " us",
+                   stage, &mean, &p50, &p90, &p99, &max) != 6)
+            TEST_FAIL("Malformed line of statistics: '%s'", line);
+
+        if (mean > max || p50 > p90 || p90 > p99 || p99 > max)
+        {
+            TEST_VERDICT("Inconsistent latency of configuration get "
+                         "requests is reported for stage '%s'", stage);
+        }
+        stages++;
+    }
+
+    if (!ta_found)
+        TEST_VERDICT("Statistics of the Test Agent are not reported");
+    if (requests > 0 && stages == 0)
+        TEST_VERDICT("Latency of configuration get requests is not "
+                     "reported");
+
+    te_string_free(&prefix);
+    free(report);
+
+    return requests;
+}
+
+int
+main(int argc, char **argv)
+{
+    rcf_rpc_server *pco_iut = NULL;
+    unsigned int    iterations;
+    char            oid[RCF_MAX_ID];
+    char            val[RCF_MAX_VAL];
+    char           *report = NULL;
+    uint64_t        before;
+    uint64_t        after;
+    unsigned int    i;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+    TEST_GET_UINT_PARAM(iterations);
+
+    TEST_STEP("Get statistics of configuration get requests to "
+              "the Test Agent.");
+    before = check_stats(pco_iut->ta);
+
+    TEST_STEP("Send @p iterations configuration get requests.");
+    TE_SPRINTF(oid, "/agent:%s/uname:/release:", pco_iut->ta);
+    for (i = 0; i < iterations; i++)
+        CHECK_RC(rcf_ta_cfg_get(pco_iut->ta, 0, oid, val, sizeof(val)));
+
+    TEST_STEP("Check that the requests are counted and percentiles of "
+              "their latency do not exceed the maximum.");
+    after = check_stats(pco_iut->ta);
+    if (after < before + iterations)
+    {
+        TEST_VERDICT("%" PRIu64 " configuration get requests are counted "
+                     "instead of at least %u", after - before, iterations);
+    }
+
+    TEST_STEP("Check that statistics of unknown Test Agent are not "
+              "reported.");
+    if (TE_RC_GET_ERROR(rcf_get_stats("no_such_ta", &report)) != TE_ENOENT)
+        TEST_VERDICT("Statistics of unknown Test Agent are reported");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    free(report);
+
+    TEST_END;
+}
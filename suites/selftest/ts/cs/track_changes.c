@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Testing synchronisation of subtrees with tracked changes
+ */
+
+/** @page cs-track_changes Synchronisation of subtrees with tracked changes
+ *
+ * @objective Check that Configurator skips synchronisation of a Test
+ *            Agent subtree with tracked changes if it is not changed
+ *            and does not skip it if it is changed.
+ *
+ * @par Scenario:
+ */
+
+#define TE_TEST_NAME "cs/track_changes"
+
+#ifndef TEST_START_VARS
+#define TEST_START_VARS TEST_START_ENV_VARS
+#endif
+
+#ifndef TEST_START_SPECIFIC
+#define TEST_START_SPECIFIC TEST_START_ENV
+#endif
+
+#ifndef TEST_END_SPECIFIC
+#define TEST_END_SPECIFIC TEST_END_ENV
+#endif
+
+#include "te_config.h"
+
+#include "te_str.h"
+#include "tapi_test.h"
+#include "tapi_env.h"
+#include "conf_api.h"
+#include "rcf_api.h"
+
+/**
+ * Synchronise the selftest subtree and get the number of get requests
+ * of @b get_count processed by the Test Agent since the previous call
+ * excluding the request of this call.
+ *
+ * @param ta            Test Agent name
+ * @param count         Number of get requests got by the previous call
+ *                      (updated)
+ *
+ * @return Number of get requests done by the synchronisation.
+ */
+static unsigned int
+sync_and_count(const char *ta, unsigned int *count)
+{
+    char         buf[RCF_MAX_VAL];
+    char         oid[RCF_MAX_ID];
+    unsigned int prev = *count;
+
+    CHECK_RC(cfg_synchronize_fmt(true, "/agent:%s/selftest:", ta));
+
+    TE_SPRINTF(oid, "/agent:%s/selftest:/get_count:", ta);
+    CHECK_RC(rcf_ta_cfg_get(ta, 0, oid, buf, sizeof(buf)));
+    CHECK_RC(te_strtoui(buf, 10, count));
+
+    return *count - prev - 1;
+}
+
+int
+main(int argc, char *argv[])
+{
+    rcf_rpc_server *pco_iut = NULL;
+    char            oid[RCF_MAX_ID];
+    unsigned int    count = 0;
+    uint32_t        value;
+    bool            changed = false;
+
+    TEST_START;
+
+    TEST_GET_PCO(pco_iut);
+
+    TE_SPRINTF(oid, "/agent:%s/selftest:/incr_obj:/a:", pco_iut->ta);
+
+    TEST_STEP("Synchronise selftest subtree to remember its generation.");
+    sync_and_count(pco_iut->ta, &count);
+
+    TEST_STEP("Synchronise selftest subtree again and check that "
+              "synchronisation is skipped: @b get_count is not got.");
+    if (sync_and_count(pco_iut->ta, &count) != 0)
+        TEST_VERDICT("Unchanged subtree is synchronised");
+
+    TEST_STEP("Change @b incr_obj on the Test Agent bypassing "
+              "Configurator.");
+    changed = true;
+    CHECK_RC(rcf_ta_cfg_set(pco_iut->ta, 0, oid, "1"));
+
+    TEST_STEP("Synchronise selftest subtree and check that it is "
+              "synchronised: @b get_count is got and the new value of "
+              "@b incr_obj is known to Configurator.");
+    if (sync_and_count(pco_iut->ta, &count) == 0)
+        TEST_VERDICT("Changed subtree is not synchronised");
+
+    CHECK_RC(cfg_get_uint32(&value, "%s", oid));
+    if (value != 1)
+        TEST_VERDICT("Changed value is not synchronised");
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    if (changed)
+    {
+        CLEANUP_CHECK_RC(rcf_ta_cfg_set(pco_iut->ta, 0, oid, "0"));
+        CLEANUP_CHECK_RC(cfg_synchronize_fmt(true, "/agent:%s/selftest:",
+                                             pco_iut->ta));
+    }
+
+    TEST_END;
+}
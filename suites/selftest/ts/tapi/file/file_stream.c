@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief RPC Test Suite
+ *
+ * Transfer file to and from Agent by parts.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+/** @page file_stream Test for transferring file by parts
+ *
+ * @objective Check that a file is transferred to and from Test Agent by
+ *            rcf_ta_put_file_stream() and rcf_ta_get_file_stream() and
+ *            that interrupted transfer is resumed.
+ *
+ * @param len    length of the file in bytes
+ *
+ * @par Scenario:
+ *
+ */
+
+#define TE_TEST_NAME    "file_stream"
+
+#include "file_suite.h"
+#include "te_file.h"
+#include "rcf_api.h"
+
+/**
+ * Check that the local file has the expected contents.
+ *
+ * @param lfile     File name
+ * @param buf       Expected contents
+ * @param len       Expected length
+ */
+static void
+check_local_file(const char *lfile, const char *buf, size_t len)
+{
+    te_string contents = TE_STRING_INIT;
+
+    CHECK_RC(te_file_read_string(&contents, true, 0, "%s", lfile));
+    if (!te_compare_bufs(buf, len, 1, contents.ptr, contents.len,
+                         TE_LL_ERROR))
+        TEST_VERDICT("Received file differs from the sent one");
+
+    te_string_free(&contents);
+}
+
+int
+main(int argc, char **argv)
+{
+    char           *lfile = NULL;
+    te_string       rfile = TE_STRING_INIT;
+    te_string       lfile_get = TE_STRING_INIT;
+    rcf_rpc_server *pco_iut = NULL;
+    size_t          len = 0;
+    void           *buf = NULL;
+
+    TEST_START;
+    TEST_GET_UINT_PARAM(len);
+    TEST_GET_PCO(pco_iut);
+
+    TEST_STEP("Generate a file on TEN");
+    buf = te_make_buf_by_len(len);
+    CHECK_NOT_NULL(lfile = tapi_file_create(len, buf, true));
+
+    TEST_STEP("Put the file on TA by parts");
+    tapi_file_make_name(&rfile);
+    rc = rcf_ta_put_file_stream(pco_iut->ta, 0, lfile, rfile.ptr, 0);
+    if (rc != 0)
+        TEST_VERDICT("rcf_ta_put_file_stream() failed; errno=%r", rc);
+
+    TEST_STEP("Resume putting the file from its middle");
+    rc = rcf_ta_put_file_stream(pco_iut->ta, 0, lfile, rfile.ptr, len / 2);
+    if (rc != 0)
+        TEST_VERDICT("Resumed rcf_ta_put_file_stream() failed; errno=%r", rc);
+
+    TEST_STEP("Get the file from TA by parts and check its contents");
+    tapi_file_make_pathname(&lfile_get);
+    rc = rcf_ta_get_file_stream(pco_iut->ta, 0, rfile.ptr, lfile_get.ptr, 0);
+    if (rc != 0)
+        TEST_VERDICT("rcf_ta_get_file_stream() failed; errno=%r", rc);
+    check_local_file(lfile_get.ptr, buf, len);
+
+    TEST_STEP("Cut the received file, resume getting it and check "
+              "its contents");
+    if (truncate(lfile_get.ptr, len / 2) != 0)
+        TEST_FAIL("Failed to truncate '%s'", lfile_get.ptr);
+    rc = rcf_ta_get_file_stream(pco_iut->ta, 0, rfile.ptr, lfile_get.ptr,
+                                len / 2);
+    if (rc != 0)
+        TEST_VERDICT("Resumed rcf_ta_get_file_stream() failed; errno=%r", rc);
+    check_local_file(lfile_get.ptr, buf, len);
+
+    TEST_SUCCESS;
+
+cleanup:
+
+    CLEANUP_CHECK_RC(tapi_file_ta_unlink_fmt(pco_iut->ta, "%s", rfile.ptr));
+
+    if (lfile != NULL && unlink(lfile) != 0)
+        ERROR("File '%s' is not deleted", lfile);
+    if (lfile_get.ptr != NULL)
+        unlink(lfile_get.ptr);
+
+    free(lfile);
+    te_string_free(&rfile);
+    te_string_free(&lfile_get);
+    free(buf);
+
+    TEST_END;
+}
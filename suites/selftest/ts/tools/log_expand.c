@@ -0,0 +1,357 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for te_raw_log_expand()
+ *
+ * Testing correctness and performance of log messages expansion.
+ */
+
+/** @page tools_log_expand te_raw_log_expand() test
+ *
+ * @objective Check that log messages are expanded correctly and
+ *            measure the expansion speed on a corpus of log messages.
+ *
+ * @param corpus            Raw log to take messages from (optional),
+ *                          the raw log of the current run by default.
+ * @param max_corpus_size   Maximum number of bytes read from @p corpus.
+ * @param n_packets         Number of messages with packet dumps added
+ *                          to the corpus.
+ * @param n_iterations      How many times the corpus is expanded.
+ *
+ * @par Test sequence:
+ *
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/log_expand"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include "tapi_test.h"
+#include "te_bufs.h"
+#include "te_raw_log.h"
+#include "te_mi_log.h"
+#include "te_vector.h"
+#include "log_msg_view.h"
+
+/** Maximum length of a packet dumped in generated messages */
+#define MAX_PACKET_LEN 1514
+
+/** A message of the corpus */
+typedef struct corpus_msg {
+    size_t offset;  /**< Offset of the message in the corpus buffer */
+    size_t len;     /**< Length of the message */
+} corpus_msg;
+
+/** Append a field with a length prefix to a raw log message */
+static void
+append_field(te_string *msg, const void *data, size_t len)
+{
+    te_log_nfl nfl = htons(len);
+
+    te_string_append_buf(msg, (const char *)&nfl, sizeof(nfl));
+    te_string_append_buf(msg, data, len);
+}
+
+/**
+ * Append a raw log message with the given format string and
+ * arguments to a buffer.
+ *
+ * @param msg       Buffer.
+ * @param fmt       Format string.
+ * @param n_args    Number of arguments.
+ * @param args      Arguments.
+ * @param lens      Lengths of arguments.
+ */
+static void
+append_msg(te_string *msg, const char *fmt, unsigned int n_args,
+           const void **args, const size_t *lens)
+{
+    static const char hdr[TE_LOG_MSG_COMMON_HDR_SZ + sizeof(te_log_id)] =
+        { TE_LOG_VERSION };
+    te_log_nfl   eor = htons(TE_LOG_RAW_EOR_LEN);
+    unsigned int i;
+
+    te_string_append_buf(msg, hdr, sizeof(hdr));
+    append_field(msg, "Agt_A", strlen("Agt_A"));
+    append_field(msg, "Sniffer", strlen("Sniffer"));
+    append_field(msg, fmt, strlen(fmt));
+    for (i = 0; i < n_args; i++)
+        append_field(msg, args[i], lens[i]);
+    te_string_append_buf(msg, (const char *)&eor, sizeof(eor));
+}
+
+/**
+ * Dump memory byte by byte as %Tm[[n].[w]] conversion is expected to do.
+ */
+static void
+ref_mem_dump(te_string *str, const uint8_t *data, size_t len,
+             unsigned int tuple_width, unsigned int n_tuples)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (tuple_width * n_tuples != 0 &&
+            i % (tuple_width * n_tuples) == 0)
+            te_string_append(str, "\n  ");
+        else if (i == 0)
+            te_string_append(str, "\n  ");
+        else if (tuple_width != 0 && i % tuple_width == 0)
+            te_string_append(str, " ");
+        te_string_append(str, "%02X", data[i]);
+    }
+    te_string_append(str, "\n\n");
+}
+
+/** Expand a single message and compare the result with the expected one */
+static void
+check_expand(const te_string *msg, const char *exp)
+{
+    te_string    result = TE_STRING_INIT;
+    log_msg_view view;
+
+    CHECK_RC(te_raw_log_parse(msg->ptr, msg->len, &view));
+    CHECK_RC(te_raw_log_expand(&view, &result));
+    if (strcmp(result.ptr, exp) != 0)
+    {
+        ERROR("Got:\n%s\nExpected:\n%s", result.ptr, exp);
+        te_string_free(&result);
+        TEST_VERDICT("Unexpected expansion of '%.*s'",
+                     view.fmt_len, view.fmt);
+    }
+    te_string_free(&result);
+}
+
+/** Check dumps of random memory of different lengths and layouts */
+static void
+check_mem_dumps(void)
+{
+    static const unsigned int layouts[][2] = {
+        {1, 16}, {2, 8}, {4, 4}, {3, 5}, {16, 1}, {1, 1}, {0, 4}, {4, 0},
+    };
+    uint8_t      data[100];
+    size_t       len;
+    unsigned int i;
+
+    te_fill_buf(data, sizeof(data));
+    for (i = 0; i < TE_ARRAY_LEN(layouts); i++)
+    {
+        te_string    fmt = TE_STRING_INIT;
+
+        te_string_append(&fmt, "Dump:%%Tm[[%u].[%u]]",
+                         layouts[i][1], layouts[i][0]);
+        for (len = 0; len <= sizeof(data); len++)
+        {
+            te_string   msg = TE_STRING_INIT;
+            te_string   exp = TE_STRING_INIT;
+            const void *arg = data;
+
+            append_msg(&msg, fmt.ptr, 1, &arg, &len);
+            te_string_append(&exp, "Dump:");
+            ref_mem_dump(&exp, data, len, layouts[i][0], layouts[i][1]);
+            check_expand(&msg, exp.ptr);
+
+            te_string_free(&msg);
+            te_string_free(&exp);
+        }
+        te_string_free(&fmt);
+    }
+}
+
+/**
+ * Split a raw log into messages.
+ *
+ * @param buf       Raw log contents.
+ * @param msgs      Where to add messages.
+ */
+static void
+split_raw_log(const te_string *buf, te_vec *msgs)
+{
+    const uint8_t *data = (const uint8_t *)buf->ptr;
+    size_t         offset = sizeof(te_log_version);
+
+    if (buf->len == 0 || data[0] != TE_LOG_VERSION)
+        TEST_FAIL("Raw log of unsupported format");
+
+    while (offset < buf->len)
+    {
+        corpus_msg msg = { .offset = offset };
+        size_t     pos;
+        te_log_nfl nfl;
+
+        pos = offset + TE_LOG_MSG_COMMON_HDR_SZ + sizeof(te_log_id);
+        do {
+            if (pos + sizeof(nfl) > buf->len)
+                return;
+            memcpy(&nfl, data + pos, sizeof(nfl));
+            nfl = ntohs(nfl);
+            pos += sizeof(nfl);
+            if (nfl != TE_LOG_RAW_EOR_LEN)
+                pos += nfl;
+        } while (nfl != TE_LOG_RAW_EOR_LEN);
+
+        if (pos > buf->len)
+            return;
+        msg.len = pos - offset;
+        TE_VEC_APPEND(msgs, msg);
+        offset = pos;
+    }
+}
+
+/** Read the beginning of a raw log */
+static void
+read_raw_log(const char *path, size_t max_size, te_string *buf)
+{
+    FILE   *f;
+    size_t  n;
+
+    CHECK_RC(te_string_reserve(buf, max_size + 1));
+    f = fopen(path, "r");
+    if (f == NULL)
+        TEST_FAIL("Failed to open raw log '%s'", path);
+    n = fread(buf->ptr, 1, max_size, f);
+    fclose(f);
+    buf->len = n;
+    buf->ptr[n] = '\0';
+}
+
+/** Get time in seconds */
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char   *corpus;
+    unsigned int  max_corpus_size;
+    unsigned int  n_packets;
+    unsigned int  n_iterations;
+    te_string     buf = TE_STRING_INIT;
+    te_string     text = TE_STRING_INIT;
+    te_vec        msgs = TE_VEC_INIT(corpus_msg);
+    corpus_msg   *msg;
+    te_mi_logger *logger = NULL;
+    size_t        n_raw_msgs;
+    size_t        out_len = 0;
+    double        elapsed;
+    unsigned int  i;
+
+    TEST_START;
+    TEST_GET_OPT_STRING_PARAM(corpus);
+    TEST_GET_UINT_PARAM(max_corpus_size);
+    TEST_GET_UINT_PARAM(n_packets);
+    TEST_GET_UINT_PARAM(n_iterations);
+
+    TEST_STEP("Check expansion of literal text and conversions");
+    {
+        static const uint8_t pkt[] = {0, 0x7f, 0x80, 0xff};
+        te_string   msg = TE_STRING_INIT;
+        uint32_t    val = htonl(42);
+        const void *args[] = { &val, "eth0", pkt };
+        size_t      lens[] = { sizeof(val), strlen("eth0"), sizeof(pkt) };
+
+        append_msg(&msg, "Got %u packets on %s, last one is:%Tm",
+                   TE_ARRAY_LEN(args), args, lens);
+        check_expand(&msg, "Got 42 packets on eth0, last one is:"
+                     "\n  00 7F 80 FF\n\n");
+        te_string_free(&msg);
+    }
+
+    TEST_STEP("Check memory dumps of different lengths and layouts");
+    check_mem_dumps();
+
+    TEST_STEP("Read messages from the raw log");
+    if (corpus == NULL)
+        corpus = getenv("TE_LOG_RAW");
+    if (corpus == NULL)
+        TEST_FAIL("TE_LOG_RAW is not defined");
+    read_raw_log(corpus, max_corpus_size, &buf);
+    split_raw_log(&buf, &msgs);
+    n_raw_msgs = te_vec_size(&msgs);
+    RING("%zu messages are read from '%s'", n_raw_msgs, corpus);
+
+    TEST_STEP("Add messages with packet dumps and check them");
+    for (i = 0; i < n_packets; i++)
+    {
+        uint8_t     pkt[MAX_PACKET_LEN];
+        uint32_t    len = rand_range(60, MAX_PACKET_LEN);
+        uint32_t    nlen = htonl(len);
+        const void *args[] = { &nlen, "eth0", pkt };
+        size_t      lens[] = { sizeof(nlen), strlen("eth0"), len };
+        corpus_msg  pkt_msg = { .offset = buf.len };
+        te_string   msg = TE_STRING_INIT;
+        te_string   exp = TE_STRING_INIT;
+
+        te_fill_buf(pkt, len);
+        append_msg(&msg, "Received %u bytes on %s:%Tm",
+                   TE_ARRAY_LEN(args), args, lens);
+        te_string_append(&exp, "Received %u bytes on eth0:", len);
+        ref_mem_dump(&exp, pkt, len, 1, 16);
+        check_expand(&msg, exp.ptr);
+
+        te_string_append_buf(&buf, msg.ptr, msg.len);
+        pkt_msg.len = msg.len;
+        TE_VEC_APPEND(&msgs, pkt_msg);
+
+        te_string_free(&msg);
+        te_string_free(&exp);
+    }
+
+    if (te_vec_size(&msgs) == 0)
+        TEST_FAIL("Corpus is empty");
+
+    TEST_STEP("Measure expansion speed");
+    elapsed = now();
+    for (i = 0; i < n_iterations; i++)
+    {
+        TE_VEC_FOREACH(&msgs, msg)
+        {
+            log_msg_view view;
+
+            CHECK_RC(te_raw_log_parse(buf.ptr + msg->offset, msg->len,
+                                      &view));
+            te_string_reset(&text);
+            CHECK_RC(te_raw_log_expand(&view, &text));
+            out_len += text.len;
+        }
+    }
+    elapsed = now() - elapsed;
+
+    RING("%zu messages (%zu from the raw log, %u with packet dumps) are "
+         "expanded %u times in %.3f seconds: %.0f messages/s, %.1f MB/s "
+         "of text", te_vec_size(&msgs), n_raw_msgs, n_packets, n_iterations,
+         elapsed, te_vec_size(&msgs) * n_iterations / elapsed,
+         out_len / elapsed / 1e6);
+
+    TEST_STEP("Log the measurements");
+    CHECK_RC(te_mi_logger_meas_create("log_expand", &logger));
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_FREQ, "Messages",
+                          TE_MI_MEAS_AGGR_SINGLE,
+                          te_vec_size(&msgs) * n_iterations / elapsed,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+    te_mi_logger_add_meas(logger, NULL, TE_MI_MEAS_THROUGHPUT, "Text",
+                          TE_MI_MEAS_AGGR_SINGLE, out_len * 8 / elapsed,
+                          TE_MI_MEAS_MULTIPLIER_PLAIN);
+
+    TEST_SUCCESS;
+
+cleanup:
+    te_mi_logger_destroy(logger);
+    te_vec_free(&msgs);
+    te_string_free(&buf);
+    te_string_free(&text);
+
+    TEST_END;
+}
@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (C) 2026 OKTET Labs Ltd. All rights reserved. */
+/** @file
+ * @brief Test for parallel output preparation in RGT
+ *
+ * Testing that the output of rgt-core does not depend on the number
+ * of jobs preparing messages for output.
+ */
+
+/** @page tools_rgt_jobs rgt-core --jobs test
+ *
+ * @objective Check that rgt-core in postponed mode produces the same
+ *            output with and without @c --jobs on a raw log with
+ *            filtered messages and offloaded message queues.
+ *
+ * @param n_messages    Number of messages logged by the test.
+ * @param duration      Time in seconds during which the messages are
+ *                      logged (it should be long enough for rgt-core
+ *                      to offload message queues).
+ * @param jobs          Number of jobs passed to rgt-core.
+ *
+ * @par Test sequence:
+ *
+ */
+
+/** Logging subsystem entity name */
+#define TE_TEST_NAME    "tools/rgt_jobs"
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <arpa/inet.h>
+
+#include "tapi_test.h"
+#include "te_file.h"
+#include "te_raw_log.h"
+
+/** Name of the user whose messages are excluded by the filter */
+#define FILTERED_USER   "Filtered"
+
+/** Filter excluding verbose messages and messages of FILTERED_USER */
+#define FILTER_XML \
+    "<?xml version=\"1.0\"?>\n"                         \
+    "<filters>\n"                                       \
+    "  <entity-filter>\n"                               \
+    "    <exclude level=\"VERB\"/>\n"                   \
+    "    <exclude>\n"                                   \
+    "      <user name=\"" FILTERED_USER "\"/>\n"        \
+    "    </exclude>\n"                                  \
+    "  </entity-filter>\n"                              \
+    "</filters>\n"
+
+/**
+ * Get the length of the part of a raw log consisting of complete
+ * messages (the raw log of the current run may end with a message
+ * which is not written completely yet).
+ *
+ * @param buf       Raw log contents.
+ *
+ * @return Length of complete messages including the log version.
+ */
+static size_t
+raw_log_complete_len(const te_string *buf)
+{
+    const uint8_t *data = (const uint8_t *)buf->ptr;
+    size_t         offset = sizeof(te_log_version);
+
+    if (buf->len == 0 || data[0] != TE_LOG_VERSION)
+        TEST_FAIL("Raw log of unsupported format");
+
+    while (offset < buf->len)
+    {
+        size_t     pos;
+        te_log_nfl nfl;
+
+        pos = offset + TE_LOG_MSG_COMMON_HDR_SZ + sizeof(te_log_id);
+        do {
+            if (pos + sizeof(nfl) > buf->len)
+                return offset;
+            memcpy(&nfl, data + pos, sizeof(nfl));
+            nfl = ntohs(nfl);
+            pos += sizeof(nfl);
+            if (nfl != TE_LOG_RAW_EOR_LEN)
+                pos += nfl;
+        } while (nfl != TE_LOG_RAW_EOR_LEN);
+
+        if (pos > buf->len)
+            return offset;
+        offset = pos;
+    }
+
+    return offset;
+}
+
+/**
+ * Run rgt-core in postponed mode.
+ *
+ * @param dir       Directory with the raw log and the filter, output and
+ *                  offloaded queues are put there as well.
+ * @param jobs      Number of jobs (@c 0 to run without @c --jobs).
+ * @param output    Where to append the output.
+ */
+static void
+run_rgt_core(const char *dir, unsigned int jobs, te_string *output)
+{
+    te_string cmd = TE_STRING_INIT;
+    te_string tmpdir = TE_STRING_INIT;
+    te_string filter = TE_STRING_INIT;
+    te_string raw_log = TE_STRING_INIT;
+    te_string out = TE_STRING_INIT;
+    int       status;
+
+    te_string_append(&tmpdir, "%s/offload%u", dir, jobs);
+    te_string_append(&filter, "%s/filter.xml", dir);
+    te_string_append(&raw_log, "%s/log.raw", dir);
+    te_string_append(&out, "%s/log%u.xml", dir, jobs);
+
+    if (mkdir(tmpdir.ptr, S_IRWXU) != 0)
+        TEST_FAIL("Failed to create '%s': %s", tmpdir.ptr, strerror(errno));
+
+    te_string_append(&cmd, "rgt-core -m postponed --incomplete-log ");
+    te_string_append_shell_args_as_is(&cmd, "-f", filter.ptr,
+                                      "--tmpdir", tmpdir.ptr, NULL);
+    if (jobs != 0)
+        te_string_append(&cmd, " --jobs %u", jobs);
+    te_string_append(&cmd, " ");
+    te_string_append_shell_args_as_is(&cmd, raw_log.ptr, out.ptr, NULL);
+
+    RING("Running '%s'", cmd.ptr);
+    status = system(cmd.ptr);
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        TEST_VERDICT("rgt-core %s failed", jobs == 0 ? "without jobs" :
+                     "with jobs");
+
+    CHECK_RC(te_file_read_string(output, true, 0, "%s", out.ptr));
+    if (output->len == 0)
+        TEST_VERDICT("rgt-core output is empty");
+
+    te_string_free(&cmd);
+    te_string_free(&tmpdir);
+    te_string_free(&filter);
+    te_string_free(&raw_log);
+    te_string_free(&out);
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned int  n_messages;
+    unsigned int  duration;
+    unsigned int  jobs;
+    const char   *raw_log;
+    const char   *tmpdir = getenv("TMPDIR");
+    char         *dir = NULL;
+    te_string     path = TE_STRING_INIT;
+    te_string     buf = TE_STRING_INIT;
+    te_string     filter = TE_STRING_INIT;
+    te_string     seq_out = TE_STRING_INIT;
+    te_string     par_out = TE_STRING_INIT;
+    unsigned int  i;
+
+    if (tmpdir == NULL)
+        tmpdir = "/tmp";
+
+    TEST_START;
+    TEST_GET_UINT_PARAM(n_messages);
+    TEST_GET_UINT_PARAM(duration);
+    TEST_GET_UINT_PARAM(jobs);
+
+    raw_log = getenv("TE_LOG_RAW");
+    if (raw_log == NULL)
+        TEST_FAIL("TE_LOG_RAW is not defined");
+
+    te_string_append(&path, "%s/te_rgt_jobs_XXXXXX", tmpdir);
+    dir = mkdtemp(path.ptr);
+    if (dir == NULL)
+        TEST_FAIL("Failed to create a temporary directory: %s",
+                  strerror(errno));
+
+    TEST_STEP("Log messages of different levels and users during "
+              "@p duration seconds");
+    for (i = 0; i < n_messages; i++)
+    {
+        static const unsigned int levels[] = {
+            TE_LL_RING, TE_LL_INFO, TE_LL_VERB, TE_LL_WARN,
+        };
+
+        if (i % 5 == 0)
+            LGR_MESSAGE(TE_LL_RING, FILTERED_USER, "Message %u", i);
+        else
+            LGR_MESSAGE(levels[i % TE_ARRAY_LEN(levels)], TE_LGR_USER,
+                        "Message %u of %u", i, n_messages);
+        usleep((useconds_t)duration * 1000000 / n_messages);
+    }
+
+    TEST_STEP("Take complete messages of the raw log of the current run");
+    CHECK_RC(te_file_read_string(&buf, true, 0, "%s", raw_log));
+    te_string_cut(&buf, buf.len - raw_log_complete_len(&buf));
+    CHECK_RC(te_file_write_string(&buf, 0, O_CREAT | O_TRUNC, S_IRUSR |
+                                  S_IWUSR, "%s/log.raw", dir));
+    RING("%zu bytes of the raw log are taken", buf.len);
+
+    te_string_append(&filter, "%s", FILTER_XML);
+    CHECK_RC(te_file_write_string(&filter, 0, O_CREAT | O_TRUNC, S_IRUSR |
+                                  S_IWUSR, "%s/filter.xml", dir));
+
+    TEST_STEP("Run rgt-core without @c --jobs");
+    run_rgt_core(dir, 0, &seq_out);
+
+    TEST_STEP("Run rgt-core with @c --jobs @p jobs");
+    run_rgt_core(dir, jobs, &par_out);
+
+    TEST_STEP("Check that the outputs are the same");
+    if (!te_compare_bufs(seq_out.ptr, seq_out.len, 1,
+                         par_out.ptr, par_out.len, 0))
+    {
+        TEST_VERDICT("rgt-core output depends on the number of jobs: "
+                     "%zu bytes without jobs, %zu bytes with %u jobs",
+                     seq_out.len, par_out.len, jobs);
+    }
+
+    TEST_SUCCESS;
+
+cleanup:
+    if (dir != NULL)
+    {
+        te_string cmd = TE_STRING_INIT;
+
+        te_string_append(&cmd, "rm -rf ");
+        te_string_append_shell_arg_as_is(&cmd, dir);
+        if (system(cmd.ptr) != 0)
+            WARN("Failed to remove '%s'", dir);
+        te_string_free(&cmd);
+    }
+    te_string_free(&path);
+    te_string_free(&buf);
+    te_string_free(&filter);
+    te_string_free(&seq_out);
+    te_string_free(&par_out);
+
+    TEST_END;
+}
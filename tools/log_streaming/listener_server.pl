@@ -4,8 +4,9 @@ use strict;
 use warnings;
 
 use Mojolicious::Lite;
-use Mojo::JSON qw(true false);
+use Mojo::JSON qw(true false decode_json);
 use JSON qw(to_json);
+use IO::Uncompress::Gunzip qw(gunzip $GunzipError);
 
 my @clients;
 
@@ -14,11 +15,29 @@ my $stop = false;
 
 open my $log, ">", "weblog";
 
+# Get request body, decompress it if the listener is configured
+# to compress requests
+sub req_body {
+    my ($c) = @_;
+    my $body = $c->req->body;
+    my $encoding = $c->req->headers->content_encoding // '';
+
+    if ($encoding eq 'gzip') {
+        my $data;
+
+        gunzip(\$body => \$data) or die "gunzip failed: $GunzipError";
+        $body = $data;
+    }
+
+    return $body;
+}
+
 post '/init' => sub {
     my ($c) = @_;
 
-    my $json = $c->req->json;
-    app->log->debug("got an init with the following message:\n", $c->req->body);
+    my $body = req_body($c);
+    my $json = decode_json($body);
+    app->log->debug("got an init with the following message:\n", $body);
 
     print $log "INIT\n";
     print $log to_json($json, {utf8 => 1, pretty => 1});
@@ -35,11 +54,11 @@ post '/feed' => sub {
     my ($c) = @_;
     my $run = $c->param('run');
 
-    my $data = $c->req->body;
+    my $data = req_body($c);
     app->log->debug("got some feed for run $run:\n", $data);
 
     print $log "FEED\n";
-    print $log to_json($c->req->json, {utf8 => 1, pretty => 1});
+    print $log to_json(decode_json($data), {utf8 => 1, pretty => 1});
     print $log "\n";
 
     $_->write("event: feed\ndata: $data\n\n") for @clients;
@@ -53,7 +72,7 @@ post '/finish' => sub {
     app->log->debug("run $run finished");
 
     print $log "FINISH\n";
-    print $log to_json($c->req->json, {utf8 => 1, pretty => 1});
+    print $log to_json(decode_json(req_body($c)), {utf8 => 1, pretty => 1});
     print $log "\n";
 
     $_->write("event: finish\n\n") for @clients;
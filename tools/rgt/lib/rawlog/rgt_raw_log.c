@@ -0,0 +1,509 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Implementation of API to read raw logs written compressed or not
+ *
+ * A compressed raw log is read via a custom stream (see fopencookie())
+ * decompressing it on the fly. The stream keeps the data returned by
+ * the last read, so that seeking back within the stdio buffer (which
+ * is done by RGT on every message read) does not require decompression
+ * from the segment start.
+ *
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+
+#include "te_defs.h"
+#include "te_raw_log.h"
+#include "rgt_raw_log.h"
+
+/** The first bytes of a gzip member */
+static const uint8_t gzip_magic[] = { 0x1f, 0x8b };
+
+#if HAVE_ZLIB_H
+
+/** Size of the compressed data buffer */
+#define RAW_LOG_IN_BUF_SIZE     (1 << 16)
+
+/** Amount of data decompressed at once when skipping */
+#define RAW_LOG_SKIP_CHUNK      (1 << 16)
+
+/** Compressed raw log stream state */
+typedef struct raw_log_gz {
+    FILE       *f;              /**< Compressed raw log file */
+    char       *seg_path;       /**< Segments file path */
+    z_stream    zs;             /**< Decompression stream */
+    uint8_t     in[RAW_LOG_IN_BUF_SIZE];    /**< Compressed data */
+
+    uint64_t    zpos;           /**< Offset of the next decompressed
+                                     byte */
+    uint64_t    pos;            /**< Current offset of the stream */
+    uint8_t    *hist;           /**< The last decompressed data
+                                     preceding @p zpos */
+    size_t      hist_len;       /**< Length of @p hist data */
+    size_t      hist_size;      /**< Size of @p hist buffer */
+
+    te_raw_log_segment_entry   *segs;   /**< Segments */
+    size_t                      n_segs; /**< Number of segments */
+} raw_log_gz;
+
+/**
+ * Make sure that the buffer of the last decompressed data has
+ * the required size.
+ *
+ * @param c         Stream state
+ * @param size      Required size
+ *
+ * @return @c 0 on success, @c -1 on failure
+ */
+static int
+gz_hist_reserve(raw_log_gz *c, size_t size)
+{
+    uint8_t *hist;
+
+    if (c->hist_size >= size)
+        return 0;
+
+    hist = realloc(c->hist, size);
+    if (hist == NULL)
+        return -1;
+
+    c->hist = hist;
+    c->hist_size = size;
+    return 0;
+}
+
+/**
+ * Decompress the next portion of data.
+ *
+ * @param c         Stream state
+ * @param buf       Buffer for decompressed data
+ * @param size      Buffer size
+ *
+ * @return Number of bytes decompressed (@c 0 if no more data is
+ *         available now) or @c -1 on failure.
+ */
+static ssize_t
+gz_inflate(raw_log_gz *c, uint8_t *buf, size_t size)
+{
+    size_t produced;
+    int    rc;
+
+    c->zs.next_out = buf;
+    c->zs.avail_out = size;
+    while (c->zs.avail_out > 0)
+    {
+        if (c->zs.avail_in == 0)
+        {
+            size_t n = fread(c->in, 1, sizeof(c->in), c->f);
+
+            if (n == 0)
+            {
+                if (ferror(c->f))
+                    return -1;
+                /* The file may grow, so the next read may get more */
+                clearerr(c->f);
+                break;
+            }
+            c->zs.next_in = c->in;
+            c->zs.avail_in = n;
+        }
+
+        rc = inflate(&c->zs, Z_NO_FLUSH);
+        if (rc == Z_STREAM_END)
+        {
+            /* The next segment follows */
+            inflateReset(&c->zs);
+        }
+        else if (rc != Z_OK && rc != Z_BUF_ERROR)
+        {
+            errno = EIO;
+            return -1;
+        }
+    }
+
+    produced = size - c->zs.avail_out;
+    c->zpos += produced;
+    return produced;
+}
+
+/**
+ * Get the offset of a segment start in the decompressed data.
+ *
+ * @param seg       Segment entry
+ *
+ * @return Offset in the host byte order.
+ */
+static uint64_t
+gz_seg_raw_offset(const te_raw_log_segment_entry *seg)
+{
+    return ((uint64_t)ntohl(seg->raw_offset_hi) << 32) |
+           ntohl(seg->raw_offset_lo);
+}
+
+/**
+ * Find the last segment starting not after the offset.
+ *
+ * @param c         Stream state
+ * @param target    Offset of decompressed data
+ * @param raw       Location for the segment decompressed data offset
+ * @param file      Location for the segment offset in the file
+ */
+static void
+gz_seg_find(raw_log_gz *c, uint64_t target, uint64_t *raw, uint64_t *file)
+{
+    size_t lo = 0;
+    size_t hi;
+
+    *raw = 0;
+    *file = 0;
+
+    /* Segments may be added while the raw log is being written */
+    if (c->n_segs == 0 ||
+        gz_seg_raw_offset(&c->segs[c->n_segs - 1]) < target)
+    {
+        FILE  *f = fopen(c->seg_path, "r");
+        void  *segs;
+        long   len;
+
+        if (f != NULL)
+        {
+            if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0 &&
+                (segs = realloc(c->segs, len)) != NULL)
+            {
+                c->segs = segs;
+                rewind(f);
+                c->n_segs = fread(c->segs, sizeof(*c->segs),
+                                  len / sizeof(*c->segs), f);
+            }
+            fclose(f);
+        }
+    }
+
+    hi = c->n_segs;
+    while (lo < hi)
+    {
+        size_t   mid = lo + (hi - lo) / 2;
+        uint64_t mid_raw = gz_seg_raw_offset(&c->segs[mid]);
+
+        if (mid_raw <= target)
+        {
+            *raw = mid_raw;
+            *file = ((uint64_t)ntohl(c->segs[mid].file_offset_hi) << 32) |
+                    ntohl(c->segs[mid].file_offset_lo);
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+}
+
+/**
+ * Move the stream to the offset of decompressed data or to the end
+ * of data if it is not available.
+ *
+ * @param c         Stream state
+ * @param target    Offset of decompressed data
+ *
+ * @return @c 0 on success, @c -1 on failure
+ */
+static int
+gz_skip(raw_log_gz *c, uint64_t target)
+{
+    uint64_t raw;
+    uint64_t file;
+    ssize_t  n;
+
+    if (target >= c->zpos - c->hist_len && target <= c->zpos)
+    {
+        c->pos = target;
+        return 0;
+    }
+
+    gz_seg_find(c, target, &raw, &file);
+    if (target < c->zpos - c->hist_len || raw > c->zpos)
+    {
+        if (fseeko(c->f, file, SEEK_SET) != 0)
+            return -1;
+        inflateReset(&c->zs);
+        c->zs.avail_in = 0;
+        c->zpos = raw;
+        c->hist_len = 0;
+    }
+
+    if (gz_hist_reserve(c, RAW_LOG_SKIP_CHUNK) != 0)
+        return -1;
+
+    while (c->zpos < target)
+    {
+        n = gz_inflate(c, c->hist, MIN(target - c->zpos,
+                                       RAW_LOG_SKIP_CHUNK));
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            break;
+        c->hist_len = n;
+    }
+
+    c->pos = c->zpos;
+    return 0;
+}
+
+/** Read function of the compressed raw log stream */
+static ssize_t
+gz_read(void *cookie, char *buf, size_t size)
+{
+    raw_log_gz *c = cookie;
+    ssize_t     n;
+
+    /* Return the data preceding the current seek position first */
+    if (c->pos < c->zpos)
+    {
+        n = MIN(size, c->zpos - c->pos);
+        memcpy(buf, c->hist + c->hist_len - (c->zpos - c->pos), n);
+        c->pos += n;
+        return n;
+    }
+
+    n = gz_inflate(c, (uint8_t *)buf, size);
+    if (n > 0)
+    {
+        if (gz_hist_reserve(c, n) != 0)
+            return -1;
+        memcpy(c->hist, buf, n);
+        c->hist_len = n;
+        c->pos = c->zpos;
+    }
+
+    return n;
+}
+
+/** Seek function of the compressed raw log stream */
+static int
+gz_seek(void *cookie, off64_t *offset, int whence)
+{
+    raw_log_gz *c = cookie;
+    int64_t     target;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            target = *offset;
+            break;
+
+        case SEEK_CUR:
+            target = c->pos + *offset;
+            break;
+
+        case SEEK_END:
+            if (gz_skip(c, UINT64_MAX) != 0)
+                return -1;
+            target = c->zpos + *offset;
+            break;
+
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+
+    if (target < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (gz_skip(c, target) != 0)
+        return -1;
+    if (c->pos != (uint64_t)target)
+    {
+        /* Seeking beyond the end of data is not supported */
+        errno = EINVAL;
+        return -1;
+    }
+
+    *offset = c->pos;
+    return 0;
+}
+
+/** Close function of the compressed raw log stream */
+static int
+gz_close(void *cookie)
+{
+    raw_log_gz *c = cookie;
+    int         rc;
+
+    inflateEnd(&c->zs);
+    rc = fclose(c->f);
+    free(c->seg_path);
+    free(c->segs);
+    free(c->hist);
+    free(c);
+
+    return rc;
+}
+
+/**
+ * Create a stream decompressing raw log.
+ *
+ * @param f         Compressed raw log file (it is closed on failure)
+ * @param path      Raw log file path
+ *
+ * @return Stream or @c NULL on failure.
+ */
+static FILE *
+gz_open(FILE *f, const char *path)
+{
+    static const cookie_io_functions_t funcs = {
+        .read = gz_read,
+        .write = NULL,
+        .seek = gz_seek,
+        .close = gz_close,
+    };
+
+    raw_log_gz *c;
+    FILE       *stream;
+
+    rewind(f);
+
+    c = calloc(1, sizeof(*c));
+    if (c == NULL)
+        goto fail;
+
+    c->f = f;
+    if (asprintf(&c->seg_path, "%s%s",
+                 path, TE_RAW_LOG_SEGMENTS_SUFFIX) < 0)
+    {
+        c->seg_path = NULL;
+        goto fail;
+    }
+
+    /* Window bits are increased by 16 to accept gzip format only */
+    if (inflateInit2(&c->zs, MAX_WBITS + 16) != Z_OK)
+    {
+        errno = ENOMEM;
+        goto fail;
+    }
+
+    stream = fopencookie(c, "r", funcs);
+    if (stream == NULL)
+    {
+        inflateEnd(&c->zs);
+        goto fail;
+    }
+
+    return stream;
+
+fail:
+    if (c != NULL)
+        free(c->seg_path);
+    free(c);
+    fclose(f);
+    return NULL;
+}
+
+#endif /* HAVE_ZLIB_H */
+
+/* See the description in rgt_raw_log.h */
+FILE *
+rgt_raw_log_open(const char *path)
+{
+    uint8_t  magic[sizeof(gzip_magic)];
+    FILE    *f;
+
+    f = fopen(path, "r");
+    if (f == NULL)
+        return NULL;
+
+    if (fread(magic, sizeof(magic), 1, f) == 1 &&
+        memcmp(magic, gzip_magic, sizeof(magic)) == 0)
+    {
+#if HAVE_ZLIB_H
+        return gz_open(f, path);
+#else
+        fclose(f);
+        errno = EOPNOTSUPP;
+        return NULL;
+#endif
+    }
+
+    rewind(f);
+    return f;
+}
+
+/* See the description in rgt_raw_log.h */
+int
+rgt_raw_log_map_open(const char *path, rgt_raw_log_map *map)
+{
+    struct stat  st;
+    void        *data;
+    int          fd;
+    int          saved_errno;
+
+    map->data = NULL;
+    map->len = 0;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    if (fstat(fd, &st) < 0)
+        goto fail;
+
+    if (st.st_size == 0)
+    {
+        errno = ENODATA;
+        goto fail;
+    }
+
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+        goto fail;
+    close(fd);
+
+    if (st.st_size >= (off_t)sizeof(gzip_magic) &&
+        memcmp(data, gzip_magic, sizeof(gzip_magic)) == 0)
+    {
+        munmap(data, st.st_size);
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    map->data = data;
+    map->len = st.st_size;
+
+    return 0;
+
+fail:
+    saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return -1;
+}
+
+/* See the description in rgt_raw_log.h */
+void
+rgt_raw_log_map_close(rgt_raw_log_map *map)
+{
+    if (map->data != NULL)
+        munmap((void *)map->data, map->len);
+
+    map->data = NULL;
+    map->len = 0;
+}
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief API to read raw logs written compressed or not
+ *
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_RGT_RAW_LOG_H__
+#define __TE_RGT_RAW_LOG_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/** Raw log mapped into memory */
+typedef struct rgt_raw_log_map {
+    const uint8_t  *data;   /**< Raw log data */
+    size_t          len;    /**< Length of raw log data */
+} rgt_raw_log_map;
+
+/**
+ * Open raw log file for reading. If the raw log is compressed by
+ * the Logger (see te_raw_log_segment_entry), the returned stream
+ * provides decompressed data. Offsets passed to fseeko() and returned
+ * by ftello() refer to decompressed data as well, segments file is
+ * used to seek without decompression of the whole log.
+ *
+ * Reading of a compressed raw log which is being written may be
+ * continued after EOF as with a regular file.
+ *
+ * @param path      Raw log file path
+ *
+ * @return Stream to be closed with fclose() or @c NULL on failure
+ *         (errno is set).
+ */
+extern FILE *rgt_raw_log_open(const char *path);
+
+/**
+ * Map raw log file into memory, so that it is read without copying
+ * data via stdio buffers. It is intended for processing of a complete
+ * raw log, the data appended to the file later are not visible.
+ *
+ * @param path      Raw log file path
+ * @param map       Where to save the mapping
+ *
+ * @return @c 0 on success, @c -1 on failure (errno is set). @c ENOTSUP
+ *         means that the raw log is compressed, @c ENODATA means that
+ *         it is empty; rgt_raw_log_open() should be used then.
+ */
+extern int rgt_raw_log_map_open(const char *path, rgt_raw_log_map *map);
+
+/**
+ * Unmap raw log mapped with rgt_raw_log_map_open().
+ *
+ * @param map       Mapping (it is cleared)
+ */
+extern void rgt_raw_log_map_close(rgt_raw_log_map *map);
+
+#endif /* __TE_RGT_RAW_LOG_H__ */
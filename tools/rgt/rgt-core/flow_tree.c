@@ -28,6 +28,7 @@
 #include "filter.h"
 #include "log_format.h"
 #include "memory.h"
+#include "msg_pipeline.h"
 #include "logger_defs.h"
 
 #if HAVE_UNISTD_H
@@ -1458,7 +1459,7 @@ wrapper_process_regular_msg(gpointer data, gpointer user_data)
 
     if (reg_msg_proc != NULL)
     {
-        msg = log_msg_read(msg_ptr);
+        msg = msg_pipeline_read(msg_ptr);
 
         if (~msg->level & TE_LL_CONTROL)
         {
@@ -1507,15 +1508,18 @@ wrapper_process_regular_msg(gpointer data, gpointer user_data)
     }
 }
 
-static void flow_tree_wander(node_t *cur_node);
+static void flow_tree_wander(node_t *cur_node, GFunc msg_cb,
+                             bool events);
 
 /**
  * Auxiliary function used by flow_tree_wander() to process a node.
  *
  * @param cur_node    Node to process.
+ * @param msg_cb      Callback to call for messages to be output.
+ * @param events      Whether to call control event callbacks.
  */
 static void
-flow_tree_wander_aux(node_t *cur_node)
+flow_tree_wander_aux(node_t *cur_node, GFunc msg_cb, bool events)
 {
     enum node_fltr_mode duration_filter_res = NFMODE_INCLUDE;
 
@@ -1533,13 +1537,13 @@ flow_tree_wander_aux(node_t *cur_node)
         if (duration_filter_res == NFMODE_INCLUDE)
 #endif
         {
-            if (ctrl_msg_proc[CTRL_EVT_START][cur_node->type] != NULL)
+            if (events &&
+                ctrl_msg_proc[CTRL_EVT_START][cur_node->type] != NULL)
                 ctrl_msg_proc[CTRL_EVT_START][cur_node->type](
                     cur_node->user_data, &cur_node->ctrl_data);
 
             /* Output messages that belongs to the node */
-            msg_queue_foreach(&cur_node->msg_att,
-                              wrapper_process_regular_msg, NULL);
+            msg_queue_foreach(&cur_node->msg_att, msg_cb, NULL);
         }
     }
 
@@ -1551,7 +1555,7 @@ flow_tree_wander_aux(node_t *cur_node)
         for (i = 0; i < cur_node->n_branches; i++)
         {
             /* Call branch-start routine */
-            if (cur_node->fmode == NFMODE_INCLUDE &&
+            if (events && cur_node->fmode == NFMODE_INCLUDE &&
                 cur_node->user_data != NULL)
             {
                 if (ctrl_msg_proc[CTRL_EVT_START][NT_BRANCH] != NULL)
@@ -1559,10 +1563,11 @@ flow_tree_wander_aux(node_t *cur_node)
                         cur_node->user_data, &cur_node->ctrl_data);
             }
 
-            flow_tree_wander(cur_node->branches[i].first_el);
+            flow_tree_wander(cur_node->branches[i].first_el, msg_cb,
+                             events);
 
             /* Call branch-end routine */
-            if (cur_node->fmode == NFMODE_INCLUDE &&
+            if (events && cur_node->fmode == NFMODE_INCLUDE &&
                 cur_node->user_data != NULL)
             {
                 if (ctrl_msg_proc[CTRL_EVT_END][NT_BRANCH] != NULL)
@@ -1572,7 +1577,7 @@ flow_tree_wander_aux(node_t *cur_node)
         }
     }
 
-    if (cur_node->fmode == NFMODE_INCLUDE &&
+    if (events && cur_node->fmode == NFMODE_INCLUDE &&
         cur_node->user_data != NULL &&
         duration_filter_res == NFMODE_INCLUDE)
     {
@@ -1584,29 +1589,54 @@ flow_tree_wander_aux(node_t *cur_node)
 
     /* Output messages that were after the node */
     if (cur_node->parent->fmode == NFMODE_INCLUDE)
-    {
-        msg_queue_foreach(&cur_node->msg_after_att,
-                          wrapper_process_regular_msg, NULL);
-    }
+        msg_queue_foreach(&cur_node->msg_after_att, msg_cb, NULL);
 }
 
 /**
  * Performs wandering over the subtree started from cur_node.
  *
  * @param  cur_node   Root of the subtree to be wander.
+ * @param  msg_cb     Callback to call for messages to be output.
+ * @param  events     Whether to call control event callbacks.
  *
  * @return  Nothing.
  */
 static void
-flow_tree_wander(node_t *cur_node)
+flow_tree_wander(node_t *cur_node, GFunc msg_cb, bool events)
 {
     while (cur_node != NULL)
     {
-        flow_tree_wander_aux(cur_node);
+        flow_tree_wander_aux(cur_node, msg_cb, events);
         cur_node = cur_node->next;
     }
 }
 
+/**
+ * Go through the flow tree calling a callback for the messages to be
+ * output.
+ *
+ * @param msg_cb      Callback to call for messages to be output.
+ * @param events      Whether to call control event callbacks.
+ */
+static void
+flow_tree_walk(GFunc msg_cb, bool events)
+{
+    /* Output messages that belongs to the root node */
+    if (root->fmode == NFMODE_INCLUDE)
+        msg_queue_foreach(&root->msg_att, msg_cb, NULL);
+
+    /* Usually n_branches of the root session is equlas to 1 */
+    if (root->n_branches > 0)
+    {
+        /* @todo Add some more branches here ! just for cycle */
+        flow_tree_wander(root->branches[0].first_el, msg_cb, events);
+    }
+
+    /* Output messages that were after the root node */
+    if (root->fmode == NFMODE_INCLUDE)
+        msg_queue_foreach(&root->msg_after_att, msg_cb, NULL);
+}
+
 /**
  * Goes through the flow tree and calls callback functions for each node.
  * First it calls start node callback, then calls message processing
@@ -1637,24 +1667,14 @@ flow_tree_trace(void)
            timestamp_cmp_cnt);
 #endif
 
-    /* Output messages that belongs to the root node */
-    if (root->fmode == NFMODE_INCLUDE)
-        msg_queue_foreach(&root->msg_att,
-                          wrapper_process_regular_msg, NULL);
-
-    /* Usually n_branches of the root session is equlas to 1 */
-    if (root->n_branches > 0)
-    {
-        /* @todo Add some more branches here ! just for cycle */
-        flow_tree_wander(root->branches[0].first_el);
-    }
+    flow_tree_walk(wrapper_process_regular_msg, true);
+}
 
-    /* Output messages that were after the root node */
-    if (root->fmode == NFMODE_INCLUDE)
-    {
-        msg_queue_foreach(&root->msg_after_att,
-                          wrapper_process_regular_msg, NULL);
-    }
+/* See the description in flow_tree.h */
+void
+flow_tree_trace_msgs(GFunc cb)
+{
+    flow_tree_walk(cb, false);
 }
 
 static gint
@@ -116,6 +116,17 @@ void flow_tree_attach_message(log_msg *msg);
  */
 void flow_tree_trace(void);
 
+/**
+ * Goes through the flow tree in the same way as flow_tree_trace() but
+ * calls only a given callback for each message which flow_tree_trace()
+ * passes to the regular message processing callback. It does not modify
+ * the tree, so it may be called by another thread during
+ * flow_tree_trace().
+ *
+ * @param cb    Callback called with log_msg_ptr as the first argument.
+ */
+void flow_tree_trace_msgs(GFunc cb);
+
 
 #ifdef FLOW_TREE_LIBRARY_DEBUG
 
@@ -35,7 +35,9 @@ universal_read(FILE *fd, void *buf, size_t count, rgt_io_mode_t io_mode, const c
     struct stat statbuf;
     ino_t old_inode;
 
-    if (fstat(fileno(fd), &statbuf) < 0)
+    /* Compressed raw log is read via a stream without file descriptor */
+    if (fileno(fd) < 0 ? stat(rawlog_fname, &statbuf) < 0 :
+                         fstat(fileno(fd), &statbuf) < 0)
         return 0;
     old_inode = statbuf.st_ino;
 
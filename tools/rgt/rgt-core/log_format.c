@@ -18,7 +18,13 @@ rgt_define_rlf_format(rgt_gen_ctx_t *ctx, char **err)
     uint8_t version;
 
     /* The first byte of Raw log file contains raw log file version */
-    if (universal_read(ctx->rawlog_fd, &version, 1, ctx->io_mode, ctx->rawlog_fname) != 1)
+    if (ctx->rawlog_map.data != NULL)
+    {
+        version = ctx->rawlog_map.data[0];
+        ctx->rawlog_map_pos = 1;
+    }
+    else if (universal_read(ctx->rawlog_fd, &version, 1, ctx->io_mode,
+                            ctx->rawlog_fname) != 1)
     {
         /* Postponed mode: File has zero size */
         if (err != NULL)
@@ -29,7 +35,8 @@ rgt_define_rlf_format(rgt_gen_ctx_t *ctx, char **err)
     switch (version)
     {
         case RGT_RLF_V1:
-            return fetch_log_msg_v1;
+            return ctx->rawlog_map.data != NULL ? fetch_log_msg_v1_map :
+                                                  fetch_log_msg_v1;
 
         default:
             if (err != NULL)
@@ -39,3 +46,26 @@ rgt_define_rlf_format(rgt_gen_ctx_t *ctx, char **err)
 
     return NULL;
 }
+
+/* The description see in log_format.h */
+int
+rgt_seek_log_msg(rgt_gen_ctx_t *ctx, off_t offset)
+{
+    if (ctx->rawlog_map.data != NULL)
+    {
+        ctx->rawlog_map_pos = offset;
+        return 0;
+    }
+
+    return fseeko(ctx->rawlog_fd, offset, SEEK_SET);
+}
+
+/* The description see in log_format.h */
+off_t
+rgt_tell_log_msg(rgt_gen_ctx_t *ctx)
+{
+    if (ctx->rawlog_map.data != NULL)
+        return ctx->rawlog_map_pos;
+
+    return ftello(ctx->rawlog_fd);
+}
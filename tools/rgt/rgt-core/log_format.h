@@ -58,6 +58,42 @@ rgt_define_rlf_format(rgt_gen_ctx_t *ctx, char **err);
  */
 int fetch_log_msg_v1(struct log_msg **msg, rgt_gen_ctx_t *ctx);
 
+/**
+ * Extracts the next log message from a raw log file version 1 mapped
+ * into memory (see rgt_gen_ctx_t::rawlog_map). It behaves in the same
+ * way as fetch_log_msg_v1() but does not use stdio.
+ *
+ * @param msg  Storage for log message to be extracted.
+ * @param ctx  Rgt utility context.
+ *
+ * @return  Status of the operation.
+ *
+ * @retval  1   Message is successfully read from Raw log file
+ * @retval  0   There is no log messages left.
+ */
+int fetch_log_msg_v1_map(struct log_msg **msg, rgt_gen_ctx_t *ctx);
+
+/**
+ * Set the offset in the raw log of the log message to be extracted
+ * next.
+ *
+ * @param ctx     Rgt utility context.
+ * @param offset  Offset of the log message.
+ *
+ * @return @c 0 on success, @c -1 on failure.
+ */
+int rgt_seek_log_msg(rgt_gen_ctx_t *ctx, off_t offset);
+
+/**
+ * Get the offset in the raw log of the log message to be extracted
+ * next.
+ *
+ * @param ctx     Rgt utility context.
+ *
+ * @return Offset or @c -1 on failure.
+ */
+off_t rgt_tell_log_msg(rgt_gen_ctx_t *ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
 #include "rgt_common.h"
 #include "io.h"
 #include "memory.h"
+#include "log_msg_view.h"
 
 /** Indeces of the error events */
 enum e_error_msg_index {
@@ -34,7 +35,7 @@ enum e_error_msg_index {
  * This variable contains error index that expresses possible error
  * of the operation to be performed.
  */
-static enum e_error_msg_index cur_error_index;
+static __thread enum e_error_msg_index cur_error_index;
 
 /**
  * This is an array of error messages each corresponding
@@ -117,6 +118,65 @@ static struct debug_msg {
 #error SIZEOF_TE_LOG_NFL is expected to be 1, 2 or 4
 #endif
 
+/* Macro to convert log level from network to host byte order. */
+#if SIZEOF_TE_LOG_LEVEL == 2
+#define RGT_LEVEL_NTOH(val_) \
+    do {                    \
+        val_ = ntohs(val_); \
+    } while (0)
+#elif SIZEOF_TE_LOG_LEVEL == 4
+#define RGT_LEVEL_NTOH(val_) \
+    do {                    \
+        val_ = ntohl(val_); \
+    } while (0)
+#elif SIZEOF_TE_LOG_LEVEL == 1
+/* Do nothing in case of 1 byte */
+#define RGT_LEVEL_NTOH(val_)
+#else
+#error SIZEOF_TE_LOG_LEVEL is expected to be 1, 2, or 4
+#endif
+
+/* Macro to convert log ID from network to host byte order. */
+#if SIZEOF_TE_LOG_ID == 4
+#define RGT_LOG_ID_NTOH(val_) \
+    do {                    \
+        val_ = ntohl(val_); \
+    } while (0)
+#elif SIZEOF_TE_LOG_ID == 2
+#define RGT_LOG_ID_NTOH(val_) \
+    do {                    \
+        val_ = ntohs(val_); \
+    } while (0)
+#elif SIZEOF_TE_LOG_ID == 1
+/* Do nothing in case of 1 byte */
+#define RGT_LOG_ID_NTOH(val_)
+#else
+#error SIZEOF_TE_LOG_ID is expected to be 1, 2, or 4
+#endif
+
+/**
+ * Set log level of a message.
+ *
+ * @param msg       Log message.
+ * @param level     Log level.
+ * @param ctx       Rgt utility context.
+ */
+static void
+set_log_level(log_msg *msg, te_log_level level, rgt_gen_ctx_t *ctx)
+{
+    msg->level_str = te_log_level2str(level);
+    if (msg->level_str == NULL)
+    {
+        /* Print error message but continue processing */
+        LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_UNKNOWN_LOGLEVEL);
+        PRINT_ERROR;
+
+        msg->level_str = "UNKNOWN";
+    }
+
+    msg->level = level;
+}
+
 /**
  * Extracts the next log message from a raw log file version 1.
  * The format of raw log file version 1 can be found in
@@ -191,28 +251,12 @@ fetch_log_msg_v1(log_msg **msg, rgt_gen_ctx_t *ctx)
     /* Read log level */
     LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_LOGLEVEL);
     READ(fd, &log_level, sizeof(log_level));
-#if SIZEOF_TE_LOG_LEVEL == 2
-    log_level = ntohs(log_level);
-#elif SIZEOF_TE_LOG_LEVEL == 4
-    log_level = ntohl(log_level);
-#elif SIZEOF_TE_LOG_LEVEL == 1
-    /* Do nothing */
-#else
-#error SIZEOF_TE_LOG_LEVEL is expected to be 1, 2, or 4
-#endif
+    RGT_LEVEL_NTOH(log_level);
 
     /* Read log ID */
     LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_LOG_ID);
     READ(fd, &log_id, sizeof(log_id));
-#if SIZEOF_TE_LOG_ID == 4
-    log_id = ntohl(log_id);
-#elif SIZEOF_TE_LOG_ID == 2
-    log_id = ntohs(log_id);
-#elif SIZEOF_TE_LOG_ID == 1
-    /* Do nothing */
-#else
-#error SIZEOF_TE_LOG_ID is expected to be 1, 2, or 4
-#endif
+    RGT_LOG_ID_NTOH(log_id);
 
     LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_ENTITY_NAME);
     /* Read entity name length */
@@ -285,19 +329,177 @@ fetch_log_msg_v1(log_msg **msg, rgt_gen_ctx_t *ctx)
     (*msg)->cur_arg = (*msg)->args;
     (*msg)->txt_msg = NULL;
 
-    (*msg)->level_str = te_log_level2str(log_level);
-    if ((*msg)->level_str == NULL)
+    set_log_level(*msg, log_level, ctx);
+
+    obstk = NULL;
+
+    return 1;
+}
+
+/**
+ * Get a pointer to the next bytes of the mapped raw log and move
+ * the position past them. If the raw log is truncated, an error
+ * is reported and the function returns @c 0.
+ */
+#define MAP_GET(_ptr, _len) \
+    do {                                                            \
+        if (map->len - pos < (size_t)(_len))                        \
+        {                                                           \
+            /* Error: File is truncated */                          \
+            PRINT_ERROR;                                            \
+            ctx->rawlog_map_pos = map->len;                         \
+            return 0;                                               \
+        }                                                           \
+        (_ptr) = map->data + pos;                                   \
+        pos += (_len);                                              \
+    } while (0)
+
+/** Read an integer field of the mapped raw log. */
+#define MAP_READ(_val) \
+    do {                                        \
+        const uint8_t *p_;                      \
+                                                \
+        MAP_GET(p_, sizeof(_val));              \
+        memcpy(&(_val), p_, sizeof(_val));      \
+    } while (0)
+
+/** Read a string field of the mapped raw log. */
+#define MAP_READ_STR(_len, _str) \
+    do {                                        \
+        const uint8_t *p_;                      \
+                                                \
+        MAP_READ(_len);                         \
+        RGT_NFL_NTOH(_len);                     \
+        MAP_GET(p_, (_len));                    \
+        (_str) = (const char *)p_;              \
+    } while (0)
+
+/**
+ * Parse the next log message of a raw log mapped into memory.
+ *
+ * @param ctx   Rgt utility context.
+ * @param view  View to be filled in, its pointers refer to the mapped
+ *              raw log.
+ *
+ * @return  @c 1 on success, @c 0 if there are no messages left or
+ *          the message is truncated.
+ *
+ * @se It throws an exception if the message version is wrong.
+ */
+static int
+map_log_msg_view(rgt_gen_ctx_t *ctx, log_msg_view *view)
+{
+    const rgt_raw_log_map *map = &ctx->rawlog_map;
+    size_t                 pos = ctx->rawlog_map_pos;
+    const uint8_t         *arg;
+    te_log_nfl             nflen;
+
+    ctx->rawlog_fpos = pos;
+    if (pos >= map->len)
+        return 0;
+
+    view->start = map->data + pos;
+    MAP_READ(view->version);
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_VERSION);
+    if (view->version != TE_LOG_VERSION)
     {
-        /* Print error message but continue processing */
-        LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_UNKNOWN_LOGLEVEL);
         PRINT_ERROR;
+        THROW_EXCEPTION;
+    }
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_TIMESTAMP);
+    MAP_READ(view->ts_sec);
+    view->ts_sec = ntohl(view->ts_sec);
+    MAP_READ(view->ts_usec);
+    view->ts_usec = ntohl(view->ts_usec);
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_LOGLEVEL);
+    MAP_READ(view->level);
+    RGT_LEVEL_NTOH(view->level);
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_LOG_ID);
+    MAP_READ(view->log_id);
+    RGT_LOG_ID_NTOH(view->log_id);
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_ENTITY_NAME);
+    MAP_READ_STR(view->entity_len, view->entity);
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_USER_NAME);
+    MAP_READ_STR(view->user_len, view->user);
+
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_FORMAT_STRING);
+    MAP_READ_STR(view->fmt_len, view->fmt);
 
-        (*msg)->level_str = "UNKNOWN";
+    LOG_FORMAT_DEBUG_SET(RLF_V1_RLM_ARG_LEN);
+    view->args = map->data + pos;
+    while (true)
+    {
+        MAP_READ(nflen);
+        RGT_NFL_NTOH(nflen);
+        if (nflen == TE_LOG_RAW_EOR_LEN)
+            break;
+        MAP_GET(arg, nflen);
     }
 
-    (*msg)->level = log_level;
+    view->length = map->data + pos - (const uint8_t *)view->start;
+    ctx->rawlog_map_pos = pos;
 
-    obstk = NULL;
+    return 1;
+}
+
+#undef MAP_READ_STR
+#undef MAP_READ
+#undef MAP_GET
+
+/* The description see in log_format.h */
+int
+fetch_log_msg_v1_map(log_msg **msg, rgt_gen_ctx_t *ctx)
+{
+    log_msg_view    view;
+    const uint8_t  *ptr;
+    te_log_nfl      nflen;
+    msg_arg       **arg;
+    struct obstack *obstk;
+
+    if (map_log_msg_view(ctx, &view) == 0)
+        return 0;
+
+    /* Strings are copied since they are not null-terminated in the log */
+    *msg = alloc_log_msg();
+    obstk = (*msg)->obstk;
+
+    (*msg)->entity = obstack_copy0(obstk, view.entity, view.entity_len);
+    (*msg)->user = obstack_copy0(obstk, view.user, view.user_len);
+    (*msg)->fmt_str = obstack_copy0(obstk, view.fmt, view.fmt_len);
+
+    (*msg)->args_count = 0;
+    arg = &((*msg)->args);
+    ptr = view.args;
+    while (true)
+    {
+        memcpy(&nflen, ptr, sizeof(nflen));
+        RGT_NFL_NTOH(nflen);
+        ptr += sizeof(nflen);
+        if (nflen == TE_LOG_RAW_EOR_LEN)
+            break;
+
+        *arg = (msg_arg *)obstack_alloc(obstk, sizeof(msg_arg));
+        (*arg)->len = nflen;
+        (*arg)->val = (uint8_t *)obstack_copy0(obstk, ptr, nflen);
+        ptr += nflen;
+
+        arg = &((*arg)->next);
+        (*msg)->args_count++;
+    }
+    *arg = NULL;
+
+    (*msg)->id = view.log_id;
+    (*msg)->timestamp[0] = view.ts_sec;
+    (*msg)->timestamp[1] = view.ts_usec;
+    (*msg)->cur_arg = (*msg)->args;
+    (*msg)->txt_msg = NULL;
+
+    set_log_level(*msg, view.level, ctx);
 
     return 1;
 }
@@ -27,6 +27,7 @@
 
 #include "te_string.h"
 #include "te_vector.h"
+#include "log_msg_view.h"
 
 f_process_ctrl_log_msg ctrl_msg_proc[CTRL_EVT_LAST][NT_LAST] = { NULL };
 f_process_reg_log_msg  reg_msg_proc = NULL;
@@ -1588,7 +1589,6 @@ rgt_expand_log_msg(log_msg *msg)
                     int  n_tuples;
                     int  tuple_width;
                     int  cur_pos = 0;
-                    char one_byte_str[3];
                     int  default_format = false;
                     int  k;
                     int rc = 10;
@@ -1637,14 +1637,15 @@ rgt_expand_log_msg(log_msg *msg)
                              j < n_tuples && cur_pos < arg->len;
                              j++)
                         {
-                            for (k = 0;
-                                 (k < tuple_width) && (cur_pos < arg->len);
-                                 k++, cur_pos++)
+                            k = MIN(tuple_width, arg->len - cur_pos);
+                            if (k > 0)
                             {
-                                snprintf(one_byte_str, sizeof(one_byte_str),
-                                         "%02X",
-                                         *(arg->val + cur_pos));
-                                obstack_grow(msg->obstk, one_byte_str, 2);
+                                obstack_blank(msg->obstk, 2 * k);
+                                te_raw_log_hex_encode(
+                                    (char *)obstack_next_free(msg->obstk) -
+                                        2 * k,
+                                    arg->val + cur_pos, k);
+                                cur_pos += k;
                             }
                             obstack_1grow(msg->obstk, ' ');
                         }
@@ -1709,7 +1710,7 @@ log_msg_read(log_msg_ptr *msg_ptr)
 {
     log_msg *msg = NULL;
 
-    fseeko(rgt_ctx.rawlog_fd, msg_ptr->offset, SEEK_SET);
+    rgt_seek_log_msg(&rgt_ctx, msg_ptr->offset);
     if (rgt_ctx.fetch_log_msg(&msg, &rgt_ctx) == 0)
     {
         FMT_TRACE("Failed to reload log message from %lld",
@@ -8,9 +8,10 @@
 
 /**
  * Pointer to an obstack that is used for allocation of log_msg data
- * structure.
+ * structure. It is per-thread since messages are read by several
+ * threads in postponed mode (see msg_pipeline.h).
  */
-static struct obstack *log_msg_obstk = NULL;
+static __thread struct obstack *log_msg_obstk = NULL;
 
 /**
  * Pointer to an obstack that is used for allocation of node_info data
@@ -42,7 +43,9 @@ obstack_initialize(void)
     if ((obstk = (struct obstack *)malloc(sizeof(struct obstack))) == NULL)
         return NULL;
 
-    obstack_alloc_failed_handler = &internal_obstack_alloc_failed;
+    /* Avoid writing the global variable when threads use obstacks */
+    if (obstack_alloc_failed_handler != &internal_obstack_alloc_failed)
+        obstack_alloc_failed_handler = &internal_obstack_alloc_failed;
     obstack_init(obstk);
 
     return obstk;
@@ -0,0 +1,454 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment: Parallel preparation of messages for output.
+ *
+ * Implementation of the pipeline preparing regular messages for
+ * postponed mode output in advance.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "rgt_common.h"
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "log_msg.h"
+#include "flow_tree.h"
+#include "memory.h"
+#include "postponed_mode.h"
+#include "log_format.h"
+#include "rgt_raw_log.h"
+#include "msg_pipeline.h"
+
+/** State of a queued message */
+typedef enum msg_slot_state {
+    MSG_SLOT_QUEUED,    /**< The message waits for a worker */
+    MSG_SLOT_BUSY,      /**< The message is being prepared */
+    MSG_SLOT_READY,     /**< The message is prepared */
+    MSG_SLOT_FAILED,    /**< The message cannot be prepared */
+} msg_slot_state;
+
+/** Queued message */
+typedef struct msg_slot {
+    log_msg_ptr     ptr;        /**< Message pointer */
+    msg_slot_state  state;      /**< State of the message */
+    te_log_level    level;      /**< Log level of the message */
+    char           *buf;        /**< XML head, XML body and user name
+                                     of the message separated by
+                                     '\0' */
+    size_t          buf_size;   /**< Size of @p buf */
+    size_t          body_off;   /**< Offset of XML body in @p buf */
+    size_t          user_off;   /**< Offset of user name in @p buf */
+} msg_slot;
+
+/** Whether the pipeline is running */
+static bool pipeline_running = false;
+
+/** Lock protecting the queue */
+static pthread_mutex_t pipeline_lock = PTHREAD_MUTEX_INITIALIZER;
+/** Condition signalled when a slot is released by the consumer */
+static pthread_cond_t slot_released = PTHREAD_COND_INITIALIZER;
+/** Condition signalled when a message is queued */
+static pthread_cond_t slot_queued = PTHREAD_COND_INITIALIZER;
+/** Condition signalled when a message is prepared */
+static pthread_cond_t slot_ready = PTHREAD_COND_INITIALIZER;
+
+/** Ring of queued messages */
+static msg_slot *slots = NULL;
+/** Number of slots in the ring */
+static size_t n_slots = 0;
+/** Number of messages queued by the producer */
+static uint64_t n_queued = 0;
+/** Number of messages taken by workers */
+static uint64_t n_taken = 0;
+/** Number of messages released by the consumer */
+static uint64_t n_released = 0;
+/** Whether the consumer holds the slot following the released ones */
+static bool slot_held = false;
+/** Whether the producer has gone through the whole flow tree */
+static bool producer_done = false;
+/** Whether the pipeline threads should terminate */
+static bool pipeline_stopping = false;
+
+/** Worker thread data */
+typedef struct msg_worker {
+    pthread_t       thread;     /**< Thread */
+    rgt_gen_ctx_t   ctx;        /**< Context with the raw log opened
+                                     by the worker */
+    struct obstack *obstk;      /**< Obstack for formatting */
+} msg_worker;
+
+/** Producer thread */
+static pthread_t producer;
+/** Worker threads */
+static msg_worker *workers = NULL;
+/** Number of running worker threads */
+static unsigned int n_workers = 0;
+/** Number of allocated workers */
+static unsigned int n_workers_max = 0;
+
+/**
+ * Queue a message (callback for flow_tree_trace_msgs()).
+ *
+ * @param data          Message pointer.
+ * @param user_data     Unused.
+ */
+static void
+pipeline_queue(gpointer data, gpointer user_data)
+{
+    log_msg_ptr *msg_ptr = (log_msg_ptr *)data;
+    msg_slot    *slot;
+
+    UNUSED(user_data);
+
+    pthread_mutex_lock(&pipeline_lock);
+    while (n_queued - n_released >= n_slots && !pipeline_stopping)
+        pthread_cond_wait(&slot_released, &pipeline_lock);
+
+    if (pipeline_stopping)
+    {
+        pthread_mutex_unlock(&pipeline_lock);
+        /* Stop going through the flow tree */
+        THROW_EXCEPTION;
+    }
+
+    slot = &slots[n_queued % n_slots];
+    slot->ptr = *msg_ptr;
+    slot->state = MSG_SLOT_QUEUED;
+    n_queued++;
+
+    pthread_cond_signal(&slot_queued);
+    pthread_mutex_unlock(&pipeline_lock);
+}
+
+/** Producer thread going through the flow tree */
+static void *
+pipeline_producer(void *arg)
+{
+    UNUSED(arg);
+
+    if (setjmp(rgt_mainjmp) == 0)
+        flow_tree_trace_msgs(pipeline_queue);
+
+    pthread_mutex_lock(&pipeline_lock);
+    producer_done = true;
+    pthread_cond_broadcast(&slot_queued);
+    pthread_cond_broadcast(&slot_ready);
+    pthread_mutex_unlock(&pipeline_lock);
+
+    return NULL;
+}
+
+/**
+ * Read a queued message from the raw log and format it.
+ *
+ * @param ctx       Context with the raw log opened by the worker.
+ * @param obstk     Obstack of the worker.
+ * @param slot      Slot with the queued message.
+ *
+ * @return @c true on success, @c false on failure.
+ */
+static bool
+pipeline_prepare(rgt_gen_ctx_t *ctx, struct obstack *obstk,
+                 msg_slot *slot)
+{
+    log_msg *msg = NULL;
+    char    *out;
+    size_t   len;
+
+    if (setjmp(rgt_mainjmp) != 0)
+        return false;
+
+    if (rgt_seek_log_msg(ctx, slot->ptr.offset) != 0 ||
+        ctx->fetch_log_msg(&msg, ctx) == 0)
+    {
+        FMT_TRACE("Failed to reload log message from %lld",
+                  (long long int)slot->ptr.offset);
+        return false;
+    }
+
+    postponed_format_msg_head(obstk, msg);
+    obstack_1grow(obstk, '\0');
+    slot->body_off = obstack_object_size(obstk);
+    postponed_format_msg_body(obstk, msg);
+    obstack_1grow(obstk, '\0');
+    slot->user_off = obstack_object_size(obstk);
+    obstack_grow0(obstk, msg->user, strlen(msg->user));
+    slot->level = msg->level;
+    free_log_msg(msg);
+
+    len = obstack_object_size(obstk);
+    out = (char *)obstack_finish(obstk);
+    if (len > slot->buf_size)
+    {
+        char *buf = realloc(slot->buf, len);
+
+        if (buf == NULL)
+        {
+            obstack_free(obstk, out);
+            TRACE("Out of memory\n");
+            return false;
+        }
+        slot->buf = buf;
+        slot->buf_size = len;
+    }
+    memcpy(slot->buf, out, len);
+    obstack_free(obstk, out);
+
+    return true;
+}
+
+/** Worker thread reading and formatting queued messages */
+static void *
+pipeline_worker(void *arg)
+{
+    msg_worker *worker = (msg_worker *)arg;
+    msg_slot   *slot;
+    bool        ok = true;
+
+    /*
+     * Mapped raw log is shared by workers, otherwise each worker reads
+     * the raw log with its own stream.
+     */
+    if (worker->ctx.rawlog_map.data == NULL)
+        worker->ctx.rawlog_fd = rgt_raw_log_open(worker->ctx.rawlog_fname);
+    if (worker->ctx.rawlog_fd == NULL)
+    {
+        perror(worker->ctx.rawlog_fname);
+        ok = false;
+    }
+    else if (setjmp(rgt_mainjmp) != 0)
+    {
+        ok = false;
+    }
+    else
+    {
+        initialize_log_msg_pool();
+    }
+
+    pthread_mutex_lock(&pipeline_lock);
+    while (true)
+    {
+        while (n_taken == n_queued && !producer_done && !pipeline_stopping)
+            pthread_cond_wait(&slot_queued, &pipeline_lock);
+
+        if (pipeline_stopping || n_taken == n_queued)
+            break;
+
+        slot = &slots[n_taken % n_slots];
+        slot->state = MSG_SLOT_BUSY;
+        n_taken++;
+        pthread_mutex_unlock(&pipeline_lock);
+
+        /* After a failure the consumer stops at the failed message */
+        if (ok)
+            ok = pipeline_prepare(&worker->ctx, worker->obstk, slot);
+
+        pthread_mutex_lock(&pipeline_lock);
+        slot->state = ok ? MSG_SLOT_READY : MSG_SLOT_FAILED;
+        pthread_cond_broadcast(&slot_ready);
+    }
+    pthread_mutex_unlock(&pipeline_lock);
+
+    destroy_log_msg_pool();
+    if (worker->ctx.rawlog_map.data == NULL &&
+        worker->ctx.rawlog_fd != NULL)
+        fclose(worker->ctx.rawlog_fd);
+
+    return NULL;
+}
+
+/** Release the pipeline resources */
+static void
+pipeline_free(void)
+{
+    size_t i;
+
+    if (slots != NULL)
+    {
+        for (i = 0; i < n_slots; i++)
+            free(slots[i].buf);
+        free(slots);
+        slots = NULL;
+    }
+    n_slots = 0;
+
+    if (workers != NULL)
+    {
+        for (i = 0; i < n_workers_max; i++)
+        {
+            if (workers[i].obstk != NULL)
+                obstack_destroy(workers[i].obstk);
+        }
+        free(workers);
+        workers = NULL;
+    }
+    n_workers_max = 0;
+    n_workers = 0;
+}
+
+/* See the description in msg_pipeline.h */
+void
+msg_pipeline_start(unsigned int jobs)
+{
+    sigset_t     mask;
+    sigset_t     old_mask;
+    unsigned int i;
+    int          rc;
+
+    n_slots = (size_t)jobs * MSG_PIPELINE_SLOTS_PER_JOB;
+    slots = calloc(n_slots, sizeof(*slots));
+    workers = calloc(jobs, sizeof(*workers));
+    if (slots == NULL || workers == NULL)
+    {
+        TRACE("Out of memory, messages are prepared sequentially\n");
+        pipeline_free();
+        return;
+    }
+
+    n_workers_max = jobs;
+    for (i = 0; i < jobs; i++)
+    {
+        /*
+         * The context is copied before tracing starts to modify it.
+         * Obstacks are created here since obstack_initialize() is not
+         * thread-safe.
+         */
+        workers[i].ctx = rgt_ctx;
+        workers[i].obstk = obstack_initialize();
+        if (workers[i].obstk == NULL)
+        {
+            TRACE("Out of memory, messages are prepared sequentially\n");
+            pipeline_free();
+            return;
+        }
+    }
+
+    n_queued = n_taken = n_released = 0;
+    slot_held = false;
+    producer_done = false;
+    pipeline_stopping = false;
+
+    /* Signals are handled by the main thread */
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+
+    rc = pthread_create(&producer, NULL, pipeline_producer, NULL);
+    if (rc == 0)
+    {
+        pipeline_running = true;
+
+        for (n_workers = 0; n_workers < jobs; n_workers++)
+        {
+            rc = pthread_create(&workers[n_workers].thread, NULL,
+                                pipeline_worker, &workers[n_workers]);
+            if (rc != 0)
+                break;
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    if (rc != 0)
+    {
+        FMT_TRACE("Failed to create pipeline thread: %s", strerror(rc));
+        if (n_workers == 0)
+        {
+            TRACE("Messages are prepared sequentially\n");
+            if (pipeline_running)
+                msg_pipeline_stop();
+            else
+                pipeline_free();
+        }
+    }
+}
+
+/* See the description in msg_pipeline.h */
+log_msg *
+msg_pipeline_read(log_msg_ptr *msg_ptr)
+{
+    log_msg  *msg;
+    msg_slot *slot;
+
+    if (!pipeline_running)
+        return log_msg_read(msg_ptr);
+
+    pthread_mutex_lock(&pipeline_lock);
+
+    /* The previous message is not used anymore */
+    if (slot_held)
+    {
+        n_released++;
+        slot_held = false;
+        pthread_cond_signal(&slot_released);
+    }
+
+    slot = &slots[n_released % n_slots];
+    while ((n_queued == n_released ||
+            slot->state == MSG_SLOT_QUEUED ||
+            slot->state == MSG_SLOT_BUSY) &&
+           !(n_queued == n_released && producer_done))
+    {
+        pthread_cond_wait(&slot_ready, &pipeline_lock);
+    }
+
+    if (n_queued == n_released)
+    {
+        pthread_mutex_unlock(&pipeline_lock);
+        FMT_TRACE("Failed to prepare log message from %lld",
+                  (long long int)msg_ptr->offset);
+        THROW_EXCEPTION;
+    }
+    if (slot->state == MSG_SLOT_FAILED)
+    {
+        pthread_mutex_unlock(&pipeline_lock);
+        THROW_EXCEPTION;
+    }
+    if (slot->ptr.offset != msg_ptr->offset)
+    {
+        pthread_mutex_unlock(&pipeline_lock);
+        FMT_TRACE("Log message from %lld is prepared instead of %lld",
+                  (long long int)slot->ptr.offset,
+                  (long long int)msg_ptr->offset);
+        THROW_EXCEPTION;
+    }
+
+    slot_held = true;
+    pthread_mutex_unlock(&pipeline_lock);
+
+    msg = alloc_log_msg();
+    msg->level = slot->level;
+    msg->user = slot->buf + slot->user_off;
+    msg->timestamp[0] = msg_ptr->timestamp[0];
+    msg->timestamp[1] = msg_ptr->timestamp[1];
+    msg->xml_head = slot->buf;
+    msg->xml_body = slot->buf + slot->body_off;
+
+    return msg;
+}
+
+/* See the description in msg_pipeline.h */
+void
+msg_pipeline_stop(void)
+{
+    unsigned int i;
+
+    if (!pipeline_running)
+        return;
+
+    pthread_mutex_lock(&pipeline_lock);
+    pipeline_stopping = true;
+    pthread_cond_broadcast(&slot_released);
+    pthread_cond_broadcast(&slot_queued);
+    pthread_cond_broadcast(&slot_ready);
+    pthread_mutex_unlock(&pipeline_lock);
+
+    pthread_join(producer, NULL);
+    for (i = 0; i < n_workers; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    pipeline_free();
+
+    pipeline_running = false;
+}
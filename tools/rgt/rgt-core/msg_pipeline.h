@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment: Parallel preparation of messages for output.
+ *
+ * In postponed mode the most of time is spent on reading regular
+ * messages from the raw log again and on formatting them in XML while
+ * the flow tree is traced. The pipeline does it in advance: a producer
+ * thread goes through the flow tree in the same order as the tracing
+ * and queues message pointers, several worker threads read and format
+ * the queued messages, and the tracing (which still generates the whole
+ * output in order) takes prepared messages from the queue.
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#ifndef __TE_RGT_MSG_PIPELINE_H__
+#define __TE_RGT_MSG_PIPELINE_H__
+
+#include "rgt_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of queued messages per worker thread */
+#define MSG_PIPELINE_SLOTS_PER_JOB 256
+
+/**
+ * Start threads preparing messages for flow_tree_trace() in postponed
+ * mode. It should be called after the flow tree is built.
+ *
+ * @param jobs      Number of threads reading and formatting messages.
+ */
+extern void msg_pipeline_start(unsigned int jobs);
+
+/**
+ * Get a message to be output. If the pipeline is running, the message
+ * is taken from the queue and has only level, user name and prepared
+ * XML (see xml_head and xml_body fields of log_msg) filled in; they
+ * are valid until the next call. Otherwise the message is read from
+ * the raw log.
+ *
+ * @param msg_ptr   Message pointer.
+ *
+ * @return Message (should be released with free_log_msg()).
+ *
+ * @se It generates an exception on failure.
+ */
+extern log_msg *msg_pipeline_read(log_msg_ptr *msg_ptr);
+
+/**
+ * Stop the pipeline threads and release the resources.
+ */
+extern void msg_pipeline_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TE_RGT_MSG_PIPELINE_H__ */
@@ -18,11 +18,14 @@
 #include <ctype.h>
 #endif
 
+#include <pthread.h>
+
 #include "log_msg.h"
 #include "postponed_mode.h"
 #include "memory.h"
 
 #include "te_errno.h"
+#include "log_msg_view.h"
 
 
 static int logs_opened = 0;
@@ -30,6 +33,12 @@ static int logs_closed = 1;
 
 static struct obstack *log_obstk = NULL;
 
+/**
+ * Lock protecting conversion of error codes to strings which may use
+ * static buffers while messages are formatted by several threads.
+ */
+static pthread_mutex_t rc_str_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static int postponed_process_test_start(node_info_t *node,
                                         ctrl_msg_data *data);
 static int postponed_process_test_end(node_info_t *node,
@@ -52,6 +61,7 @@ static int postponed_process_open(void);
 static int postponed_process_close(void);
 
 static void output_regular_log_msg(log_msg *msg);
+static void format_regular_log_msg(struct obstack *obstk, log_msg *msg);
 
 void
 postponed_mode_init(f_process_ctrl_log_msg
@@ -74,34 +84,47 @@ postponed_mode_init(f_process_ctrl_log_msg
     root_proc[CTRL_EVT_END] = postponed_process_close;
 }
 
+/** Size of a buffer for timestamp formatted by format_ts() */
+#define TIME_BUF_LEN 40
+
+/**
+ * Format a timestamp. It may be called from any thread.
+ *
+ * @param buf       Buffer of #TIME_BUF_LEN bytes.
+ * @param ts        Timestamp.
+ */
 static void
-print_ts(FILE *fd, uint32_t *ts)
+format_ts(char *buf, uint32_t *ts)
 {
-#define TIME_BUF_LEN 40
     time_t     time_block;
-    char       time_buf[TIME_BUF_LEN];
-    struct tm  tm, *tm_tmp;
+    struct tm  tm;
     size_t     res;
 
     time_block = ts[0];
-    if ((tm_tmp = localtime(&time_block)) == NULL)
+    if (localtime_r(&time_block, &tm) == NULL)
     {
         fprintf(stderr, "Incorrect timestamp specified\n");
         THROW_EXCEPTION;
     }
-    memcpy(&tm, tm_tmp, sizeof(tm));
 #if 0
     /* Long date/time format (date & time) */
-    res = strftime(time_buf, TIME_BUF_LEN, "%b %d %T", &tm);
+    res = strftime(buf, TIME_BUF_LEN, "%b %d %T", &tm);
 #else
     /* Short date/time format (only time) */
-    res = strftime(time_buf, TIME_BUF_LEN, "%T", &tm);
+    res = strftime(buf, TIME_BUF_LEN, "%T", &tm);
 #endif
 
     assert(res > 0);
-    fprintf(fd, "%s.%03u", time_buf, ts[1] / 1000);
+    snprintf(buf + res, TIME_BUF_LEN - res, ".%03u", ts[1] / 1000);
+}
+
+static void
+print_ts(FILE *fd, uint32_t *ts)
+{
+    char time_buf[TIME_BUF_LEN];
 
-#undef TIME_BUF_LEN
+    format_ts(time_buf, ts);
+    fputs(time_buf, fd);
 }
 
 static void
@@ -137,15 +160,25 @@ print_ts_info(node_info_t *node)
  * @note Space is inserted before attribute name, but not
  *       after its value.
  *
+ * @param obstk     Obstack to grow or @c NULL to write the attribute
+ *                  to the output file.
  * @param name      Name of the attribute.
  * @param value     Value of the attribute.
  */
 static void
-append_attr(const char *name, const char *value)
+append_attr(struct obstack *obstk, const char *name, const char *value)
 {
-    fprintf(rgt_ctx.out_fd, " %s=\"", name);
-    write_xml_string(NULL, value, true);
-    fprintf(rgt_ctx.out_fd, "\"");
+    if (obstk != NULL)
+        obstack_printf(obstk, " %s=\"", name);
+    else
+        fprintf(rgt_ctx.out_fd, " %s=\"", name);
+
+    write_xml_string(obstk, value, true);
+
+    if (obstk != NULL)
+        obstack_1grow(obstk, '"');
+    else
+        fputc('"', rgt_ctx.out_fd);
 }
 
 int
@@ -189,12 +222,12 @@ print_params(node_info_t *node)
         while (prm != NULL)
         {
             fprintf(rgt_ctx.out_fd, "<param");
-            append_attr("name", prm->name);
+            append_attr(NULL, "name", prm->name);
             if (prm->stem != NULL)
-                append_attr("stem", prm->stem);
+                append_attr(NULL, "stem", prm->stem);
             if (prm->field != NULL)
-                append_attr("field", prm->field);
-            append_attr("value", prm->val);
+                append_attr(NULL, "field", prm->field);
+            append_attr(NULL, "value", prm->val);
             fprintf(rgt_ctx.out_fd, "/>\n");
             prm = prm->next;
         }
@@ -213,7 +246,7 @@ print_reqs(node_info_t *node)
         while (p != NULL)
         {
             fprintf(rgt_ctx.out_fd, "<req");
-            append_attr("id", p->id);
+            append_attr(NULL, "id", p->id);
             fprintf(rgt_ctx.out_fd, "/>\n");
             p = p->next;
         }
@@ -285,9 +318,9 @@ postponed_process_start_event(node_info_t *node, const char *node_name,
         fprintf(rgt_ctx.out_fd, " plan_id=\"%d\"", node->plan_id);
 
     if (node->descr.name)
-        append_attr("name", node->descr.name);
+        append_attr(NULL, "name", node->descr.name);
     if (node->descr.hash != NULL)
-        append_attr("hash", node->descr.hash);
+        append_attr(NULL, "hash", node->descr.hash);
 
     switch (node->result.status)
     {
@@ -311,7 +344,7 @@ postponed_process_start_event(node_info_t *node, const char *node_name,
     }
 
     if (node->result.err)
-        append_attr("err", node->result.err);
+        append_attr(NULL, "err", node->result.err);
 
     fprintf(rgt_ctx.out_fd, ">\n");
 
@@ -483,9 +516,32 @@ postponed_process_branch_end(node_info_t *node, ctrl_msg_data *data)
     return 1;
 }
 
+/* See the description in postponed_mode.h */
+void
+postponed_format_msg_head(struct obstack *obstk, log_msg *msg)
+{
+    char time_buf[TIME_BUF_LEN];
+
+    obstack_printf(obstk, "<msg level=\"%s\"", msg->level_str);
+    append_attr(obstk, "entity", msg->entity);
+    append_attr(obstk, "user", msg->user);
+    format_ts(time_buf, msg->timestamp);
+    obstack_printf(obstk, " ts_val=\"%u.%06u\" ts=\"%s\"",
+                   msg->timestamp[0], msg->timestamp[1], time_buf);
+}
+
+/* See the description in postponed_mode.h */
+void
+postponed_format_msg_body(struct obstack *obstk, log_msg *msg)
+{
+    format_regular_log_msg(obstk, msg);
+}
+
 static int
 postponed_process_regular_msg(log_msg *msg)
 {
+    char *out_str;
+
     if (!logs_opened)
     {
         fprintf(rgt_ctx.out_fd, "<logs>");
@@ -493,15 +549,22 @@ postponed_process_regular_msg(log_msg *msg)
         logs_closed = 0;
     }
 
-    fprintf(rgt_ctx.out_fd, "<msg level=\"%s\"",
-            msg->level_str);
-    append_attr("entity", msg->entity);
-    append_attr("user", msg->user);
-    fprintf(rgt_ctx.out_fd, " ts_val=\"%u.%06u\" ts=\"",
-            msg->timestamp[0], msg->timestamp[1]);
-    print_ts(rgt_ctx.out_fd, msg->timestamp);
-    fprintf(rgt_ctx.out_fd, "\" nl=\"%d\">", msg->nest_lvl);
-    output_regular_log_msg(msg);
+    if (msg->xml_body != NULL)
+    {
+        fputs(msg->xml_head, rgt_ctx.out_fd);
+        fprintf(rgt_ctx.out_fd, " nl=\"%d\">", msg->nest_lvl);
+        fputs(msg->xml_body, rgt_ctx.out_fd);
+    }
+    else
+    {
+        postponed_format_msg_head(log_obstk, msg);
+        obstack_printf(log_obstk, " nl=\"%d\">", msg->nest_lvl);
+        format_regular_log_msg(log_obstk, msg);
+        obstack_1grow(log_obstk, '\0');
+        out_str = (char *)obstack_finish(log_obstk);
+        fputs(out_str, rgt_ctx.out_fd);
+        obstack_free(log_obstk, out_str);
+    }
     fprintf(rgt_ctx.out_fd, "</msg>\n");
 
     return 1;
@@ -520,30 +583,40 @@ print_message_info(log_msg *msg)
 static void
 output_regular_log_msg(log_msg *msg)
 {
-    msg_arg *arg;
-    int      i;
-    void    *obstk_base;
-
-/* @todo - It should be removed in the future! */
-#define OBSTACK_FLUSH() \
-    do {                                              \
-        char *out_str;                                \
-                                                      \
-        obstack_1grow(log_obstk, '\0');               \
-        out_str = (char *)obstack_finish(log_obstk);  \
-        fprintf(rgt_ctx.out_fd, "%s", out_str);            \
-        obstack_free(log_obstk, out_str);             \
-    } while (0)
+    char *out_str;
 
     if (log_obstk == NULL)
         return;
 
-    obstk_base = obstack_base(log_obstk);
+    format_regular_log_msg(log_obstk, msg);
+    obstack_1grow(log_obstk, '\0');
+    out_str = (char *)obstack_finish(log_obstk);
+    fputs(out_str, rgt_ctx.out_fd);
+    obstack_free(log_obstk, out_str);
+}
+
+/**
+ * Format text of a regular message in XML. It may be called from any
+ * thread.
+ *
+ * @param obstk     Obstack whose current object is grown by the text.
+ * @param msg       Message.
+ */
+static void
+format_regular_log_msg(struct obstack *obstk, log_msg *msg)
+{
+    msg_arg *arg;
+    int      i;
+    int      start;
+    int      len;
+    int      br_len = strlen("<br/>");
+
+    start = obstack_object_size(obstk);
     log_msg_init_arg(msg);
 
     if (msg->txt_msg != NULL)
     {
-        write_xml_string(log_obstk, msg->txt_msg, false);
+        write_xml_string(obstk, msg->txt_msg, false);
     }
     else
     {
@@ -553,7 +626,7 @@ output_regular_log_msg(log_msg *msg)
             {
                 if (msg->fmt_str[i + 1] == '%')
                 {
-                    obstack_1grow(log_obstk, '%');
+                    obstack_1grow(obstk, '%');
                     i++;
                     continue;
                 }
@@ -562,7 +635,7 @@ output_regular_log_msg(log_msg *msg)
                 {
                     /* Too few arguments in the message */
                     /* Simply write the rest of format string to the log */
-                    write_xml_string(log_obstk, msg->fmt_str + i, false);
+                    write_xml_string(obstk, msg->fmt_str + i, false);
                     break;
                 }
 
@@ -577,13 +650,13 @@ output_regular_log_msg(log_msg *msg)
                         val = ntohl(*(uint32_t *)arg->val);
                         if (val > UCHAR_MAX)
                         {
-                            obstack_printf(log_obstk, "&lt;0x%08x&gt;",
+                            obstack_printf(obstk, "&lt;0x%08x&gt;",
                                            val);
                         }
                         else
                         {
                             c_buf[0] = (char)val;
-                            write_xml_string(log_obstk, c_buf, false);
+                            write_xml_string(obstk, c_buf, false);
                         }
 
                         i++;
@@ -602,7 +675,7 @@ output_regular_log_msg(log_msg *msg)
                         *((uint32_t *)arg->val) =
                         ntohl(*(uint32_t *)arg->val);
 
-                        obstack_printf(log_obstk, format,
+                        obstack_printf(obstk, format,
                                        *((uint32_t *)arg->val));
                         i++;
 
@@ -617,7 +690,7 @@ output_regular_log_msg(log_msg *msg)
                         /* Address should be 4 bytes aligned */
                         assert(arg->len % 4 == 0);
 
-                        obstack_grow(log_obstk, "0x", strlen("0x"));
+                        obstack_grow(obstk, "0x", strlen("0x"));
                         for (j = 0; j < arg->len / 4; j++)
                         {
                             val = *(((uint32_t *)arg->val) + j);
@@ -629,7 +702,7 @@ output_regular_log_msg(log_msg *msg)
                             }
                             val = ntohl(val);
 
-                            obstack_printf(log_obstk, "%08x", val);
+                            obstack_printf(obstk, "%08x", val);
                         }
 
                         i++;
@@ -639,7 +712,7 @@ output_regular_log_msg(log_msg *msg)
 
                     case 's':
                     {
-                        write_xml_string(log_obstk, (const char *)arg->val,
+                        write_xml_string(obstk, (const char *)arg->val,
                                          false);
                         i++;
 
@@ -654,14 +727,16 @@ output_regular_log_msg(log_msg *msg)
                         err = *((uint32_t *)arg->val) =
                         ntohl(*(uint32_t *)arg->val);
 
+                        pthread_mutex_lock(&rc_str_lock);
                         src = te_rc_mod2str(err);
                         if (strlen(src) > 0)
                         {
-                            write_xml_string(log_obstk, src, false);
-                            obstack_1grow(log_obstk, '-');
+                            write_xml_string(obstk, src, false);
+                            obstack_1grow(obstk, '-');
                         }
-                        write_xml_string(log_obstk, te_rc_err2str(err),
+                        write_xml_string(obstk, te_rc_err2str(err),
                                          false);
+                        pthread_mutex_unlock(&rc_str_lock);
                         i++;
 
                         continue;
@@ -673,7 +748,6 @@ output_regular_log_msg(log_msg *msg)
                         int  n_tuples;
                         int  tuple_width;
                         int  cur_pos = 0;
-                        char one_byte_str[3];
                         int  default_format = false;
                         int  k;
 
@@ -682,12 +756,12 @@ output_regular_log_msg(log_msg *msg)
                             (msg->fmt_str + i))
                         {
                             /* Start file tag */
-                            obstack_printf(log_obstk,
+                            obstack_printf(obstk,
                                            "<file name=\"%s\">", "TODO");
-                            write_xml_string(log_obstk,
+                            write_xml_string(obstk,
                                              (const char *)arg->val, false);
                             /* End file tag */
-                            obstack_grow(log_obstk, "</file>",
+                            obstack_grow(obstk, "</file>",
                                          strlen("</file>"));
 
                             /* shift to the end of "%Tf" */
@@ -711,7 +785,7 @@ output_regular_log_msg(log_msg *msg)
                             break;
                         }
 
-                        obstack_grow(log_obstk,
+                        obstack_grow(obstk,
                                      "<mem-dump>", strlen("<mem-dump>"));
                         if (sscanf(msg->fmt_str + i, "%%Tm[[%d].[%d]]",
                                    &n_tuples, &tuple_width) != 2)
@@ -723,7 +797,7 @@ output_regular_log_msg(log_msg *msg)
 
                         while (cur_pos < arg->len)
                         {
-                            obstack_grow(log_obstk, "<row>",
+                            obstack_grow(obstk, "<row>",
                                          strlen("<row>"));
                             /* Start a memory table row */
                             for (j = 0;
@@ -731,27 +805,27 @@ output_regular_log_msg(log_msg *msg)
                                  j++)
                             {
                                 /* Start a block in a row */
-                                obstack_grow(log_obstk, "<elem>",
+                                obstack_grow(obstk, "<elem>",
                                              strlen("<elem>"));
-                                for (k = 0;
-                                     k < tuple_width && cur_pos < arg->len;
-                                     k++, cur_pos++)
+                                k = MIN(tuple_width, arg->len - cur_pos);
+                                if (k > 0)
                                 {
-                                    snprintf(one_byte_str,
-                                             sizeof(one_byte_str),
-                                             "%02X", *(arg->val + cur_pos));
-                                    obstack_grow(log_obstk,
-                                                 one_byte_str, 2);
+                                    obstack_blank(obstk, 2 * k);
+                                    te_raw_log_hex_encode(
+                                        (char *)obstack_next_free(obstk) -
+                                            2 * k,
+                                        arg->val + cur_pos, k);
+                                    cur_pos += k;
                                 }
                                 /* End a block in a row */
-                                obstack_grow(log_obstk, "</elem>",
+                                obstack_grow(obstk, "</elem>",
                                              strlen("</elem>"));
                             }
                             /* End a memory table row */
-                            obstack_grow(log_obstk, "</row>",
+                            obstack_grow(obstk, "</row>",
                                          strlen("</row>"));
                         }
-                        obstack_grow(log_obstk, "</mem-dump>",
+                        obstack_grow(obstk, "</mem-dump>",
                                      strlen("</mem-dump>"));
 
                         /* shift to the end of "%Tm" */
@@ -788,29 +862,29 @@ output_regular_log_msg(log_msg *msg)
                     /* FALLTHROUGH */
 
                 case '\n':
-                    obstack_grow(log_obstk, "<br/>", 5);
+                    obstack_grow(obstk, "<br/>", 5);
                     break;
 
                 case '<':
-                    obstack_grow(log_obstk, "&lt;", 4);
+                    obstack_grow(obstk, "&lt;", 4);
                     break;
 
                 case '>':
-                    obstack_grow(log_obstk, "&gt;", 4);
+                    obstack_grow(obstk, "&gt;", 4);
                     break;
 
                 case '&':
-                    obstack_grow(log_obstk, "&amp;", 5);
+                    obstack_grow(obstk, "&amp;", 5);
                     break;
 
                 default:
                     if (msg->fmt_str[i] == '\t' || isprint(msg->fmt_str[i]))
                     {
-                        obstack_1grow(log_obstk, msg->fmt_str[i]);
+                        obstack_1grow(obstk, msg->fmt_str[i]);
                     }
                     else
                     {
-                        obstack_printf(log_obstk, "&lt;0x%02x&gt;",
+                        obstack_printf(obstk, "&lt;0x%02x&gt;",
                                        (unsigned char)msg->fmt_str[i]);
                     }
                     break;
@@ -819,31 +893,19 @@ output_regular_log_msg(log_msg *msg)
         } /* for */
     } /* if (msg->txt_msg != NULL) */
 
-    if (obstack_next_free(log_obstk) != obstk_base)
+    /*
+     * Truncate trailing end of line characters:
+     * @todo - maybe it's better not to make this by default.
+     */
+    len = obstack_object_size(obstk) - start;
+    while (len >= br_len &&
+           strncmp((char *)obstack_base(obstk) + start + len - br_len,
+                   "<br/>", br_len) == 0)
     {
-        char *out_str;
-        int   str_len;
-        int   br_len = strlen("<br/>");
-
-        obstack_1grow(log_obstk, '\0');
-        str_len = obstack_object_size(log_obstk);
-        out_str = (char *)obstack_finish(log_obstk);
-
-        /*
-         * Truncate trailing end of line characters:
-         * @todo - maybe it's better not to make this by default.
-         */
-        i = br_len + 1;
-        while ((str_len >= i) &&
-                strncmp((out_str + str_len - i), "<br/>", br_len) == 0)
-        {
-            i += br_len;
-        }
-        *(out_str + str_len + br_len - i) = '\0';
-
-        fprintf(rgt_ctx.out_fd, "%s", out_str);
-        obstack_free(log_obstk, out_str);
+        len -= br_len;
     }
+    obstack_blank_fast(obstk,
+                       -(int)(obstack_object_size(obstk) - start - len));
 
     return;
 }
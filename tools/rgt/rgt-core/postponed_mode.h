@@ -22,6 +22,27 @@ extern void postponed_mode_init(f_process_ctrl_log_msg
                                 f_process_log_root
                                     root_proc[CTRL_EVT_LAST]);
 
+/**
+ * Format the beginning of XML element of a regular message: element
+ * name and all the attributes except for nesting level. It may be
+ * called from any thread.
+ *
+ * @param obstk     Obstack whose current object is grown.
+ * @param msg       Message.
+ */
+extern void postponed_format_msg_head(struct obstack *obstk,
+                                      log_msg *msg);
+
+/**
+ * Format text of a regular message in XML. It may be called from any
+ * thread.
+ *
+ * @param obstk     Obstack whose current object is grown.
+ * @param msg       Message.
+ */
+extern void postponed_format_msg_body(struct obstack *obstk,
+                                      log_msg *msg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -78,6 +78,7 @@ extern "C" {
 #endif /* HAVE_NETINET_IN_H */
 
 #include "io.h"
+#include "rgt_raw_log.h"
 
 #include "te_defs.h"
 #include "te_raw_log.h"
@@ -115,8 +116,12 @@ extern "C" {
 /*                  RGT-specific definitions                             */
 /*************************************************************************/
 
-/** The stack context of the main procedure */
-extern jmp_buf rgt_mainjmp;
+/**
+ * The stack context of the main procedure. It is thread-local, so
+ * that an exception generated by a helper thread (see msg_pipeline.h)
+ * is handled by the thread itself.
+ */
+extern __thread jmp_buf rgt_mainjmp;
 
 /* Generates an exception from any point of RGT */
 #define THROW_EXCEPTION \
@@ -168,6 +173,11 @@ typedef int (* f_fetch_log_msg)(struct log_msg **msg,
 typedef struct rgt_gen_ctx {
     char          *rawlog_fname; /**< Raw log file name */
     FILE          *rawlog_fd; /**< Raw log file pointer */
+    rgt_raw_log_map rawlog_map; /**< Raw log mapped into memory (it is
+                                     not used in live mode and for
+                                     compressed raw logs) */
+    off_t          rawlog_map_pos; /**< Position of the next message in
+                                        mapped raw log */
     off_t          rawlog_size; /**< Size of Raw log file,
                                      has sense only in postponed mode */
     off_t          rawlog_fpos; /**< Position in raw log file on
@@ -220,6 +230,9 @@ typedef struct rgt_gen_ctx {
 
     bool verb; /**< Whether to use verbose output or not */
     int             current_nest_lvl;  /**< Current nesting level */
+
+    unsigned int    jobs; /**< Number of threads preparing messages
+                               for output in postponed mode */
 } rgt_gen_ctx_t;
 
 
@@ -291,6 +304,13 @@ typedef struct log_msg {
 
     char         *txt_msg;      /**< Processed fmt_str + args */
     int           nest_lvl;     /**< Nesting level */
+
+    const char   *xml_head;     /**< XML attributes of the message
+                                     prepared in advance (see
+                                     msg_pipeline.h) or @c NULL */
+    const char   *xml_body;     /**< XML representation of the message
+                                     text prepared in advance or
+                                     @c NULL */
 } log_msg;
 
 /**
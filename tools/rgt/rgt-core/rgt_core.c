@@ -30,6 +30,8 @@
 #include "index_mode.h"
 #include "junit_mode.h"
 #include "mi_mode.h"
+#include "msg_pipeline.h"
+#include "rgt_raw_log.h"
 
 /*
  * Define PACKAGE, VERSION and TE_COPYRIGHT just for the case it's build
@@ -58,7 +60,7 @@ rgt_gen_ctx_t rgt_ctx;
  * The stack context of the main procedure.
  * It is used for exception generations
  */
-jmp_buf rgt_mainjmp;
+__thread jmp_buf rgt_mainjmp;
 
 
 /**
@@ -135,6 +137,7 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
         RGT_OPT_INCOMPLETE_LOG,
         RGT_OPT_TMPDIR,
         RGT_OPT_STOP_AT_ENTITY,
+        RGT_OPT_JOBS,
         RGT_OPT_VERBOSE,
         RGT_OPT_VERSION,
     };
@@ -176,6 +179,10 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
           "Stop processing at the first message with a given entity.",
           "ENTITY" },
 
+        { "jobs", 'j', POPT_ARG_STRING, NULL, RGT_OPT_JOBS,
+          "Number of threads preparing messages for output in "
+          RGT_OP_MODE_POSTPONED_STR " mode (1 by default).", "NUM" },
+
         { NULL, 'V', POPT_ARG_NONE, NULL, RGT_OPT_VERBOSE,
           "Verbose trace.", NULL },
 
@@ -280,6 +287,27 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
 
                 break;
 
+            case RGT_OPT_JOBS:
+            {
+                char          *jobs = poptGetOptArg(optCon);
+                char          *end;
+                unsigned long  val;
+
+                if (jobs == NULL)
+                    usage(optCon, 1, "Specify number of jobs", NULL);
+
+                errno = 0;
+                val = strtoul(jobs, &end, 10);
+                if (errno != 0 || *end != '\0' || val == 0 || val > 1024)
+                {
+                    usage(optCon, 1, "Specify number of jobs",
+                          "from 1 to 1024");
+                }
+                ctx->jobs = val;
+                free(jobs);
+                break;
+            }
+
             case RGT_OPT_VERBOSE:
                 ctx->verb = true;
                 break;
@@ -307,7 +335,7 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
     }
 
     /* Try to open Raw log file */
-    if ((ctx->rawlog_fd = fopen(rawlog_fname, "r")) == NULL)
+    if ((ctx->rawlog_fd = rgt_raw_log_open(rawlog_fname)) == NULL)
     {
         perror(rawlog_fname);
         poptFreeContext(optCon);
@@ -316,9 +344,20 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
 
     if (ctx->op_mode != RGT_OP_MODE_LIVE)
     {
-        fseeko(ctx->rawlog_fd, 0LL, SEEK_END);
-        ctx->rawlog_size = ftello(ctx->rawlog_fd);
-        fseeko(ctx->rawlog_fd, 0LL, SEEK_SET);
+        /*
+         * Complete raw log is read from memory if possible, otherwise
+         * (e.g. if it is compressed) the stream is used.
+         */
+        if (rgt_raw_log_map_open(rawlog_fname, &ctx->rawlog_map) == 0)
+        {
+            ctx->rawlog_size = ctx->rawlog_map.len;
+        }
+        else
+        {
+            fseeko(ctx->rawlog_fd, 0LL, SEEK_END);
+            ctx->rawlog_size = ftello(ctx->rawlog_fd);
+            fseeko(ctx->rawlog_fd, 0LL, SEEK_SET);
+        }
     }
 
     ctx->out_fd = stdout;
@@ -407,10 +446,12 @@ process_cmd_line_opts(int argc, char **argv, rgt_gen_ctx_t *ctx)
 static void free_resources(int signo)
 {
     /* log_parser_free_resources(); */
+    msg_pipeline_stop();
     flow_tree_destroy();
     rgt_filter_destroy();
     destroy_node_info_pool();
     destroy_log_msg_pool();
+    rgt_raw_log_map_close(&rgt_ctx.rawlog_map);
     fclose(rgt_ctx.rawlog_fd);
     fclose(rgt_ctx.out_fd);
 
@@ -487,7 +528,7 @@ main(int argc, char **argv)
                 fclose(rgt_ctx.rawlog_fd);
                 rgt_ctx.rawlog_fd = NULL;
 
-                rgt_ctx.rawlog_fd = fopen(rgt_ctx.rawlog_fname, "r");
+                rgt_ctx.rawlog_fd = rgt_raw_log_open(rgt_ctx.rawlog_fname);
                 if (rgt_ctx.rawlog_fd == NULL)
                 {
                     fprintf(stderr, "Can not open new tmp_raw_log file");
@@ -535,8 +576,14 @@ main(int argc, char **argv)
             if (rgt_ctx.proc_incomplete)
                 rgt_emulate_accurate_close(latest_ts);
 
+            if (rgt_ctx.op_mode == RGT_OP_MODE_POSTPONED &&
+                rgt_ctx.jobs > 1)
+                msg_pipeline_start(rgt_ctx.jobs);
+
             /* Process flow tree (call callback routines for each node) */
             flow_tree_trace();
+
+            msg_pipeline_stop();
         }
 
         if (log_root_proc[CTRL_EVT_END] != NULL)
@@ -601,6 +648,7 @@ rgt_ctx_set_defaults(rgt_gen_ctx_t *ctx)
     ctx->proc_incomplete = false;
     ctx->verb = false;
     ctx->tmp_dir = NULL;
+    ctx->jobs = 1;
     ctx->current_nest_lvl = 0;
 }
 
@@ -617,7 +665,7 @@ rgt_update_progress_bar(rgt_gen_ctx_t *ctx)
     if (ctx->op_mode == RGT_OP_MODE_LIVE || !ctx->verb)
         return;
 
-    offset = ftello(ctx->rawlog_fd);
+    offset = rgt_tell_log_msg(ctx);
     fprintf(stderr, "\r%ld%%",
             (long)(((long long)offset * 100L) / ctx->rawlog_size));
 }
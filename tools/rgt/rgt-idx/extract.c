@@ -0,0 +1,329 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/** @file
+ * @brief Test Environment: RGT - log extraction by Logger index utility
+ *
+ * Copyright (C) 2026 OKTET Labs Ltd. All rights reserved.
+ */
+
+#include "te_config.h"
+
+#if HAVE_STDINT_H
+#include <stdint.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <getopt.h>
+#include <arpa/inet.h>
+
+#include "te_defs.h"
+#include "te_raw_log.h"
+
+#include "common.h"
+#include "rgt_raw_log.h"
+
+#define COPY_BUF_SIZE   65536
+#define OUTPUT_BUF_SIZE 16384
+
+/**
+ * Get raw log offset from a Logger index entry.
+ *
+ * @param entry     Index entry.
+ *
+ * @return Offset in the host byte order.
+ */
+static uint64_t
+entry_offset(const te_raw_log_index_entry *entry)
+{
+    return ((uint64_t)ntohl(entry->offset_hi) << 32) |
+           ntohl(entry->offset_lo);
+}
+
+
+/**
+ * Copy a part of the input log to the output.
+ *
+ * @param input     The stream to read from.
+ * @param output    The stream to write to.
+ * @param start     Offset of the part start.
+ * @param end       Offset of the part end or @c UINT64_MAX to copy
+ *                  till EOF.
+ * @param buf       Copy buffer of #COPY_BUF_SIZE bytes.
+ *
+ * @return @c true if the part was copied successfully, @c false otherwise.
+ */
+static bool
+copy_part(FILE *input, FILE *output, uint64_t start, uint64_t end,
+          uint8_t *buf)
+{
+    size_t len;
+
+    if (fseeko(input, (off_t)start, SEEK_SET) != 0)
+    {
+        ERROR("Failed to seek to input position %" PRIu64 ": %s",
+              start, strerror(errno));
+        return false;
+    }
+
+    while (start < end)
+    {
+        len = fread(buf, 1, MIN(end - start, COPY_BUF_SIZE), input);
+        if (len == 0)
+        {
+            if (ferror(input))
+            {
+                ERROR("Failed reading input at %" PRIu64 ": %s",
+                      start, strerror(errno));
+                return false;
+            }
+            if (end != UINT64_MAX)
+            {
+                ERROR("Unexpected EOF of input at %" PRIu64, start);
+                return false;
+            }
+            break;
+        }
+
+        if (fwrite(buf, len, 1, output) != 1)
+        {
+            ERROR("Failed writing output: %s", strerror(errno));
+            return false;
+        }
+        start += len;
+    }
+
+    return true;
+}
+
+
+static int
+run(const char *input_name, const char *index_name,
+    const char *output_name, te_log_id id)
+{
+    int                     result      = 1;
+    FILE                   *input       = NULL;
+    FILE                   *index       = NULL;
+    FILE                   *output      = NULL;
+    void                   *output_buf  = NULL;
+    uint8_t                *copy_buf    = NULL;
+    te_raw_log_index_entry  entry;
+    bool                    in_part     = false;
+    uint64_t                part_start  = 0;
+    uint8_t                 version;
+
+    input = rgt_raw_log_open(input_name);
+    if (input == NULL)
+        ERROR_CLEANUP("Failed to open \"%s\": %s",
+                      input_name, strerror(errno));
+
+    index = fopen(index_name, "r");
+    if (index == NULL)
+        ERROR_CLEANUP("Failed to open \"%s\": %s",
+                      index_name, strerror(errno));
+
+    /* Open output */
+    if (output_name[0] == '-' && output_name[1] == '\0')
+        output = stdout;
+    else
+    {
+        output = fopen(output_name, "w");
+        if (output == NULL)
+            ERROR_CLEANUP("Failed to open \"%s\": %s",
+                          output_name, strerror(errno));
+    }
+
+    /* Set output buffer */
+    output_buf = malloc(OUTPUT_BUF_SIZE);
+    setvbuf(output, output_buf, _IOFBF, OUTPUT_BUF_SIZE);
+
+    copy_buf = malloc(COPY_BUF_SIZE);
+    if (copy_buf == NULL)
+        ERROR_CLEANUP("Failed to allocate copy buffer");
+
+    /* Read, verify and output log file version */
+    if (fread(&version, sizeof(version), 1, input) != 1)
+        ERROR_CLEANUP("Failed to read log file version: %s",
+                      feof(input) ? "unexpected EOF" : strerror(errno));
+    if (version != 1)
+        ERROR_CLEANUP("Unsupported log file version %hhu", version);
+    if (fwrite(&version, sizeof(version), 1, output) != 1)
+        ERROR_CLEANUP("Failed writing output: %s", strerror(errno));
+
+    /*
+     * All the messages between two consecutive index entries have
+     * the log ID of the first one, so copy the parts of the log
+     * started by the entries with the requested ID.
+     */
+    while (fread(&entry, sizeof(entry), 1, index) == 1)
+    {
+        bool matches = (ntohl(entry.id) == id);
+
+        if (in_part && !matches)
+        {
+            if (!copy_part(input, output, part_start,
+                           entry_offset(&entry), copy_buf))
+                goto cleanup;
+            in_part = false;
+        }
+        else if (!in_part && matches)
+        {
+            part_start = entry_offset(&entry);
+            in_part = true;
+        }
+    }
+    if (ferror(index))
+        ERROR_CLEANUP("Failed reading index: %s", strerror(errno));
+
+    if (in_part &&
+        !copy_part(input, output, part_start, UINT64_MAX, copy_buf))
+        goto cleanup;
+
+    if (fflush(output) != 0)
+        ERROR_CLEANUP("Failed flushing output: %s", strerror(errno));
+
+    result = 0;
+
+cleanup:
+
+    free(copy_buf);
+    if (output != NULL)
+        fclose(output);
+    free(output_buf);
+    if (index != NULL)
+        fclose(index);
+    if (input != NULL)
+        fclose(input);
+
+    return result;
+}
+
+
+static int
+usage(FILE *stream, const char *progname)
+{
+    return
+        fprintf(
+            stream,
+            "Usage: %s [OPTION]... INPUT_LOG ID [OUTPUT_LOG]\n"
+            "Extract messages with the log ID from a TE log using "
+            "the index written\nby the Logger alongside it.\n"
+            "\n"
+            "With no OUTPUT_LOG, or when OUTPUT_LOG is -, "
+            "write standard output.\n"
+            "\n"
+            "Options:\n"
+            "  -i, --index=FILE the Logger index file "
+            "(INPUT_LOG" TE_RAW_LOG_INDEX_SUFFIX " by default)\n"
+            "  -h, --help       this help message\n"
+            "\n",
+            progname);
+}
+
+
+typedef enum opt_val {
+    OPT_VAL_HELP        = 'h',
+    OPT_VAL_INDEX       = 'i',
+} opt_val;
+
+
+int
+main(int argc, char * const argv[])
+{
+    static const struct option  long_opt_list[] = {
+        {.name      = "help",
+         .has_arg   = no_argument,
+         .flag      = NULL,
+         .val       = OPT_VAL_HELP},
+        {.name      = "index",
+         .has_arg   = required_argument,
+         .flag      = NULL,
+         .val       = OPT_VAL_INDEX},
+        {.name      = NULL,
+         .has_arg   = 0,
+         .flag      = NULL,
+         .val       = 0}
+    };
+    static const char          *short_opt_list = "hi:";
+
+    int             c;
+    int             result;
+    const char     *input_name  = NULL;
+    const char     *index_name  = NULL;
+    const char     *output_name = "-";
+    char           *index_buf   = NULL;
+    char           *end;
+    unsigned long   id;
+
+    /*
+     * Read command line arguments
+     */
+    while ((c = getopt_long(argc, argv,
+                            short_opt_list, long_opt_list, NULL)) >= 0)
+    {
+        switch (c)
+        {
+            case OPT_VAL_HELP:
+                usage(stdout, program_invocation_short_name);
+                return 0;
+                break;
+            case OPT_VAL_INDEX:
+                index_name = optarg;
+                break;
+            case '?':
+                usage(stderr, program_invocation_short_name);
+                return 1;
+                break;
+        }
+    }
+
+    if (argc - optind < 2)
+        ERROR_USAGE_RETURN("Not enough arguments");
+    input_name = argv[optind++];
+    errno = 0;
+    id = strtoul(argv[optind], &end, 0);
+    if (errno != 0 || *argv[optind] == '\0' || *end != '\0' ||
+        id > UINT32_MAX)
+        ERROR_USAGE_RETURN("Invalid log ID \"%s\"", argv[optind]);
+    optind++;
+    if (optind < argc)
+    {
+        output_name = argv[optind++];
+        if (optind < argc)
+            ERROR_USAGE_RETURN("Too many arguments");
+    }
+
+    /*
+     * Verify command line arguments
+     */
+    if (*input_name == '\0')
+        ERROR_USAGE_RETURN("Empty input file name");
+    if (*output_name == '\0')
+        ERROR_USAGE_RETURN("Empty output file name");
+
+    if (index_name == NULL)
+    {
+        if (asprintf(&index_buf, "%s%s",
+                     input_name, TE_RAW_LOG_INDEX_SUFFIX) < 0)
+        {
+            ERROR("Failed to allocate index file name");
+            return 1;
+        }
+        index_name = index_buf;
+    }
+    else if (*index_name == '\0')
+    {
+        ERROR_USAGE_RETURN("Empty index file name");
+    }
+
+    /*
+     * Run
+     */
+    result = run(input_name, index_name, output_name, id);
+    free(index_buf);
+
+    return result;
+}
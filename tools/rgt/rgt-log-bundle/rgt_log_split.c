@@ -38,6 +38,7 @@ struct pcap_file_header {
 #include "te_string.h"
 #include "te_raw_log.h"
 #include "rgt_log_bundle_common.h"
+#include "rgt_raw_log.h"
 #include "te_sniffers.h"
 #include "te_queue.h"
 
@@ -368,6 +369,12 @@ static off_t cur_block_frag_offset = -1;
 /** Offset of the last processed message in raw log */
 static off_t last_msg_offset = -1;
 
+/**
+ * Raw log mapped into memory, messages are copied from it directly
+ * if it is mapped (it is not for compressed raw logs).
+ */
+static rgt_raw_log_map raw_log_map = { NULL, 0 };
+
 /**
  * Append a new log message to appropriate log fragment file.
  *
@@ -480,7 +487,23 @@ append_to_frag(int node_id, fragment_type frag_type,
     }
     last_msg_offset = offset;
 
-    CHECK_RC(file2file(f_frag, f_raw_log, -1, offset, length));
+    if (raw_log_map.data != NULL)
+    {
+        if (offset < 0 || length < 0 ||
+            (uint64_t)offset > raw_log_map.len ||
+            (uint64_t)length > raw_log_map.len - offset)
+        {
+            ERROR("%s(): message at offset %" PRId64 " of length %"
+                  PRId64 " is out of raw log", __FUNCTION__,
+                  offset, length);
+            RGT_ERROR_JUMP;
+        }
+        CHECK_FWRITE(raw_log_map.data + offset, 1, length, f_frag);
+    }
+    else
+    {
+        CHECK_RC(file2file(f_frag, f_raw_log, -1, offset, length));
+    }
 
     RGT_ERROR_SECTION;
 
@@ -1189,7 +1212,11 @@ split_raw_log(FILE *f_raw_log, FILE *f_index, FILE *f_recover,
             ERROR("Wrong record in raw log index at line %ld", line);
             RGT_ERROR_JUMP;
         }
-        if (rc < 9)
+        if (rc < 9 && raw_log_map.data != NULL)
+        {
+            length = raw_log_map.len - offset;
+        }
+        else if (rc < 9)
         {
             CHECK_OS_RC(raw_fp = ftello(f_raw_log));
             CHECK_OS_RC(fseeko(f_raw_log, 0LL, SEEK_END));
@@ -1575,7 +1602,20 @@ main(int argc, char **argv)
 
     CHECK_RC(process_cmd_line_opts(argc, argv));
 
-    CHECK_FOPEN(f_raw_log, raw_log_path, "r");
+    f_raw_log = rgt_raw_log_open(raw_log_path);
+    if (f_raw_log == NULL)
+    {
+        ERROR("Failed to open raw log '%s', errno=%d ('%s')",
+              raw_log_path, errno, strerror(errno));
+        RGT_ERROR_JUMP;
+    }
+    if (rgt_raw_log_map_open(raw_log_path, &raw_log_map) != 0 &&
+        errno != ENOTSUP && errno != ENODATA)
+    {
+        ERROR("Failed to map raw log '%s', errno=%d ('%s')",
+              raw_log_path, errno, strerror(errno));
+        RGT_ERROR_JUMP;
+    }
     CHECK_FOPEN(f_index, index_path, "r");
 
     CHECK_FOPEN_FMT(f_recover, "w", "%s/recover_list", output_path);
@@ -1594,6 +1634,7 @@ main(int argc, char **argv)
 
     CHECK_FCLOSE(f_raw_gist);
     CHECK_FCLOSE(f_frags_list);
+    rgt_raw_log_map_close(&raw_log_map);
     CHECK_FCLOSE(f_raw_log);
     CHECK_FCLOSE(f_index);
     CHECK_FCLOSE(f_recover);